@@ -0,0 +1,182 @@
+#ifndef ALEPH_BENCHMARKS_BENCHMARK_HH__
+#define ALEPH_BENCHMARKS_BENCHMARK_HH__
+
+#include <aleph/utilities/Timer.hh>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace aleph
+{
+
+namespace benchmarks
+{
+
+/**
+  @returns Peak resident set size of the current process in kilobytes,
+  or zero if the value cannot be determined on the current platform.
+*/
+
+inline long peakResidentSetSize()
+{
+  rusage usage;
+
+  if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+    return 0;
+
+#ifdef __APPLE__
+  // Mac OS X reports the value in bytes instead of kilobytes
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+/** Measurements of a single stage of a benchmark */
+struct Result
+{
+  std::string stage;
+  std::string dataset;
+
+  unsigned repetitions = 0;
+
+  double minimum = std::numeric_limits<double>::max(); ///< Minimum wall time in milliseconds
+  double maximum = 0.0;                                ///< Maximum wall time in milliseconds
+  double mean    = 0.0;                                ///< Mean wall time in milliseconds
+
+  long peakRSS   = 0;                                  ///< Peak resident set size in kilobytes after the stage
+
+  /** Additional size information about the stage, e.g. number of simplices */
+  std::size_t size = 0;
+};
+
+/**
+  @class Benchmark
+  @brief Simple harness for timing stages of a calculation
+
+  Every stage is executed for a fixed number of repetitions. For each
+  stage, minimum, mean, and maximum wall times are reported, together
+  with the peak resident set size of the process. Results are printed
+  to `std::cerr` as they become available and may be written in JSON
+  format afterwards, so that they may be tracked over time.
+*/
+
+class Benchmark
+{
+public:
+  explicit Benchmark( unsigned repetitions )
+    : _repetitions( std::max( repetitions, 1u ) )
+  {
+  }
+
+  /**
+    Runs a stage of the benchmark. The functor is called for every
+    repetition and is expected to return the size of its result, e.g.
+    the number of simplices that have been created. This is used for
+    reporting and prevents the compiler from removing the calculation.
+  */
+
+  template <class Functor> void run( const std::string& stage, const std::string& dataset, Functor&& functor )
+  {
+    Result result;
+    result.stage       = stage;
+    result.dataset     = dataset;
+    result.repetitions = _repetitions;
+
+    for( unsigned i = 0; i < _repetitions; i++ )
+    {
+      utilities::Timer timer;
+
+      result.size = functor();
+
+      auto elapsed   = timer.elapsed_ms();
+      result.minimum = std::min( result.minimum, elapsed );
+      result.maximum = std::max( result.maximum, elapsed );
+      result.mean   += elapsed / _repetitions;
+    }
+
+    result.peakRSS = peakResidentSetSize();
+
+    std::cerr << "* " << dataset << "/" << stage << ": "
+              << result.mean << "ms (min: " << result.minimum << "ms, max: " << result.maximum << "ms)"
+              << ", size: " << result.size
+              << ", peak RSS: " << result.peakRSS << "kB\n";
+
+    _results.push_back( result );
+  }
+
+  const std::vector<Result>& results() const noexcept
+  {
+    return _results;
+  }
+
+private:
+  unsigned _repetitions;
+  std::vector<Result> _results;
+};
+
+/**
+  Writes the results of a benchmark to an output stream, using the JSON
+  format. The parameters are stored as name--value pairs and are meant
+  to identify the configuration of the benchmark.
+*/
+
+inline void writeJSON( std::ostream& o,
+                       const Benchmark& benchmark,
+                       const std::vector< std::pair<std::string, std::string> >& parameters )
+{
+  std::string level = "  ";
+
+  o << "{\n";
+
+  o << level << "\"parameters\": {\n";
+
+  for( auto it = parameters.begin(); it != parameters.end(); ++it )
+  {
+    if( it != parameters.begin() )
+      o << ",\n";
+
+    o << level << level << "\"" << it->first << "\": \"" << it->second << "\"";
+  }
+
+  o << "\n"
+    << level << "},\n";
+
+  o << level << "\"results\": [\n";
+
+  auto&& results = benchmark.results();
+
+  for( auto it = results.begin(); it != results.end(); ++it )
+  {
+    if( it != results.begin() )
+      o << ",\n";
+
+    o << level << level << "{ "
+      << "\"stage\": \""      << it->stage       << "\", "
+      << "\"dataset\": \""    << it->dataset     << "\", "
+      << "\"repetitions\": "  << it->repetitions << ", "
+      << "\"size\": "         << it->size        << ", "
+      << "\"min_ms\": "       << it->minimum     << ", "
+      << "\"mean_ms\": "      << it->mean        << ", "
+      << "\"max_ms\": "       << it->maximum     << ", "
+      << "\"peak_rss_kb\": "  << it->peakRSS
+      << " }";
+  }
+
+  o << "\n"
+    << level << "]\n"
+    << "}\n";
+}
+
+} // namespace benchmarks
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,434 @@
+/*
+  This is a benchmark shipped by 'Aleph - A Library for Exploring
+  Persistent Homology'.
+
+  It times each stage of the persistent homology pipeline, i.e. point
+  cloud loading, Vietoris--Rips skeleton construction and expansion,
+  boundary matrix creation and dualization, all reduction algorithms,
+  persistence diagram extraction, and all persistence diagram distances.
+
+  All input data are generated synthetically, using samples from a
+  sphere and a torus, a weighted random graph, and random persistence
+  diagrams. All generators use the same fixed seed, which may be changed
+  on the command-line, so the data of different runs are comparable.
+  Sizes and the number of repetitions may be configured on the
+  command-line as well. Results are written to STDERR in a human-readable
+  format and, optionally, to a JSON file for regression tracking.
+
+  Usage:
+
+    benchmark_persistence_pipeline [--points N] [--epsilon E]
+                                   [--dimension D] [--vertices V]
+                                   [--probability P] [--diagram-size M]
+                                   [--repetitions K] [--seed S]
+                                   [--output FILE]
+*/
+
+#include <benchmarks/Benchmark.hh>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+#include <aleph/geometry/SphereSampling.hh>
+#include <aleph/geometry/TorusSampling.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <aleph/persistenceDiagrams/Calculation.hh>
+#include <aleph/persistenceDiagrams/Distances.hh>
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/RandomGraph.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/representations/Compressed.hh>
+#include <aleph/topology/representations/Vector.hh>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <getopt.h>
+
+using DataType           = double;
+using Distance           = aleph::geometry::distances::Euclidean<DataType>;
+using PointCloud         = aleph::containers::PointCloud<DataType>;
+using Diagram            = aleph::PersistenceDiagram<DataType>;
+using Index              = unsigned;
+
+using namespace aleph;
+using namespace aleph::benchmarks;
+using namespace aleph::persistentHomology::algorithms;
+
+/**
+  Benchmarks all stages of the pipeline that operate on a simplicial
+  complex in filtration order, i.e. boundary matrix creation, matrix
+  dualization, reduction, and persistence diagram extraction.
+*/
+
+template <class SimplicialComplex> void benchmarkComplex( Benchmark& benchmark, const std::string& dataset, const SimplicialComplex& K )
+{
+  using Vector     = topology::representations::Vector<Index>;
+  using Compressed = topology::representations::Compressed<Index>;
+
+  using namespace topology;
+
+  BoundaryMatrix<Vector> M;
+
+  benchmark.run( "makeBoundaryMatrix", dataset, [&] ()
+  {
+    M = makeBoundaryMatrix<Vector>( K );
+    return static_cast<std::size_t>( M.getNumColumns() );
+  } );
+
+  BoundaryMatrix<Vector> D;
+
+  benchmark.run( "dualize", dataset, [&] ()
+  {
+    D = M.dualize();
+    return static_cast<std::size_t>( D.getNumColumns() );
+  } );
+
+  PersistencePairing<Index> pairing;
+
+  benchmark.run( "reduction/Standard", dataset, [&] ()
+  {
+    pairing = calculatePersistencePairing<Standard>( M );
+    return pairing.size();
+  } );
+
+  benchmark.run( "reduction/Standard (dualized)", dataset, [&] ()
+  {
+    pairing = calculatePersistencePairing<Standard>( D );
+    return pairing.size();
+  } );
+
+  benchmark.run( "reduction/StandardRectangular", dataset, [&] ()
+  {
+    pairing = calculatePersistencePairing<StandardRectangular>( M );
+    return pairing.size();
+  } );
+
+  benchmark.run( "reduction/StandardRectangular (dualized)", dataset, [&] ()
+  {
+    pairing = calculatePersistencePairing<StandardRectangular>( D );
+    return pairing.size();
+  } );
+
+  benchmark.run( "reduction/Twist", dataset, [&] ()
+  {
+    pairing = calculatePersistencePairing<Twist>( M );
+    return pairing.size();
+  } );
+
+  benchmark.run( "reduction/Twist (dualized)", dataset, [&] ()
+  {
+    pairing = calculatePersistencePairing<Twist>( D );
+    return pairing.size();
+  } );
+
+  {
+    auto C = makeBoundaryMatrix<Compressed>( K ).dualize();
+
+    benchmark.run( "reduction/Twist (dualized, compressed)", dataset, [&] ()
+    {
+      return calculatePersistencePairing<Twist>( C ).size();
+    } );
+  }
+
+  benchmark.run( "makePersistenceDiagrams", dataset, [&] ()
+  {
+    auto diagrams = makePersistenceDiagrams( pairing, K );
+    return diagrams.size();
+  } );
+}
+
+/**
+  Benchmarks all stages of the Vietoris--Rips pipeline for a point
+  cloud, including storing and loading the point cloud.
+*/
+
+void benchmarkPointCloud( Benchmark& benchmark,
+                          const std::string& dataset,
+                          const PointCloud& pointCloud,
+                          DataType epsilon,
+                          unsigned dimension )
+{
+  using Wrapper           = geometry::BruteForce<PointCloud, Distance>;
+  using RipsSkeleton      = geometry::RipsSkeleton<Wrapper>;
+  using SimplicialComplex = typename RipsSkeleton::SimplicialComplex;
+  using Simplex           = typename SimplicialComplex::ValueType;
+
+  {
+    auto filename = "/tmp/aleph_benchmark_" + dataset + ".txt";
+
+    {
+      std::ofstream out( filename );
+      out << pointCloud;
+    }
+
+    benchmark.run( "load", dataset, [&] ()
+    {
+      auto loadedPointCloud = containers::load<DataType>( filename );
+      return loadedPointCloud.size();
+    } );
+
+    std::remove( filename.c_str() );
+  }
+
+  Wrapper wrapper( pointCloud );
+  SimplicialComplex skeleton;
+
+  benchmark.run( "RipsSkeleton", dataset, [&] ()
+  {
+    RipsSkeleton ripsSkeleton;
+    skeleton = ripsSkeleton( wrapper, epsilon );
+
+    return skeleton.size();
+  } );
+
+  SimplicialComplex K;
+
+  benchmark.run( "RipsExpander", dataset, [&] ()
+  {
+    geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+    K = ripsExpander( skeleton, dimension );
+    K = ripsExpander.assignMaximumWeight( K );
+
+    K.sort( topology::filtrations::Data<Simplex>() );
+    return K.size();
+  } );
+
+  benchmarkComplex( benchmark, dataset, K );
+}
+
+/**
+  Benchmarks the clique persistence pipeline of a weighted random
+  graph, following the Vietoris--Rips expansion of the graph.
+*/
+
+void benchmarkRandomGraph( Benchmark& benchmark, unsigned n, double p, unsigned dimension, unsigned seed )
+{
+  using SimplicialComplex = decltype( topology::generateWeightedRandomGraph( n, p ) );
+  using Simplex           = typename SimplicialComplex::ValueType;
+
+  std::string dataset = "random_graph";
+
+  SimplicialComplex G;
+
+  benchmark.run( "generateWeightedRandomGraph", dataset, [&] ()
+  {
+    // Every repetition generates the same graph
+    std::mt19937 rng( seed );
+
+    G = topology::generateWeightedRandomGraph( n, p, rng );
+    return G.size();
+  } );
+
+  SimplicialComplex K;
+
+  benchmark.run( "RipsExpander", dataset, [&] ()
+  {
+    geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+    K = ripsExpander( G, dimension );
+    K = ripsExpander.assignMaximumWeight( K );
+
+    K.sort( topology::filtrations::Data<Simplex>() );
+    return K.size();
+  } );
+
+  benchmarkComplex( benchmark, dataset, K );
+}
+
+/**
+  Creates a random persistence diagram with points drawn uniformly from
+  the unit square, all of which are situated above the diagonal. This
+  follows the `create_persistence_diagrams` example.
+*/
+
+Diagram createRandomPersistenceDiagram( unsigned n, std::mt19937& rng )
+{
+  std::uniform_real_distribution<DataType> distribution( DataType(0), DataType(1) );
+
+  Diagram D;
+
+  for( unsigned i = 0; i < n; i++ )
+  {
+    auto x = distribution( rng );
+    auto y = distribution( rng );
+
+    if( x > y )
+      std::swap( x,y );
+
+    D.add( x,y );
+  }
+
+  return D;
+}
+
+/** Benchmarks all distance functions for persistence diagrams */
+void benchmarkDiagramDistances( Benchmark& benchmark, unsigned m, unsigned seed )
+{
+  std::mt19937 rng( seed );
+
+  auto D1 = createRandomPersistenceDiagram( m, rng );
+  auto D2 = createRandomPersistenceDiagram( m, rng );
+
+  std::string dataset = "random_diagrams";
+
+  // The functors do not return a size, so the number of points in
+  // both diagrams is reported instead. The distances are accumulated
+  // to ensure that the calculation is not removed.
+  DataType sum = DataType();
+
+  benchmark.run( "bottleneckDistance", dataset, [&] ()
+  {
+    sum += distances::bottleneckDistance( D1, D2 );
+    return D1.size() + D2.size();
+  } );
+
+  benchmark.run( "wassersteinDistance", dataset, [&] ()
+  {
+    sum += distances::wassersteinDistance( D1, D2 );
+    return D1.size() + D2.size();
+  } );
+
+  benchmark.run( "hausdorffDistance", dataset, [&] ()
+  {
+    sum += distances::hausdorffDistance( D1, D2 );
+    return D1.size() + D2.size();
+  } );
+
+  benchmark.run( "nearestNeighbourDistance", dataset, [&] ()
+  {
+    sum += distances::nearestNeighbourDistance( D1, D2 );
+    return D1.size() + D2.size();
+  } );
+
+  if( sum < DataType() )
+    std::cerr << "* Warning: Negative sum of distances\n";
+}
+
+int main( int argc, char** argv )
+{
+  static option commandLineOptions[] = {
+    { "points"      , required_argument, nullptr, 'n' },
+    { "epsilon"     , required_argument, nullptr, 'e' },
+    { "dimension"   , required_argument, nullptr, 'd' },
+    { "vertices"    , required_argument, nullptr, 'v' },
+    { "probability" , required_argument, nullptr, 'p' },
+    { "diagram-size", required_argument, nullptr, 'm' },
+    { "repetitions" , required_argument, nullptr, 'k' },
+    { "seed"        , required_argument, nullptr, 's' },
+    { "output"      , required_argument, nullptr, 'o' },
+    { nullptr       , 0                , nullptr,  0  }
+  };
+
+  unsigned n         = 200;
+  DataType epsilon   = DataType(0.5);
+  unsigned dimension = 2;
+  unsigned vertices  = 100;
+  double probability = 0.3;
+  unsigned m         = 100;
+  unsigned k         = 3;
+  unsigned seed      = 42;
+
+  std::string output;
+
+  int option = 0;
+  while( ( option = getopt_long( argc, argv, "n:e:d:v:p:m:k:s:o:", commandLineOptions, nullptr ) ) != -1 )
+  {
+    switch( option )
+    {
+    case 'n':
+      n = static_cast<unsigned>( std::stoul(optarg) );
+      break;
+    case 'e':
+      epsilon = static_cast<DataType>( std::stod(optarg) );
+      break;
+    case 'd':
+      dimension = static_cast<unsigned>( std::stoul(optarg) );
+      break;
+    case 'v':
+      vertices = static_cast<unsigned>( std::stoul(optarg) );
+      break;
+    case 'p':
+      probability = std::stod(optarg);
+      break;
+    case 'm':
+      m = static_cast<unsigned>( std::stoul(optarg) );
+      break;
+    case 'k':
+      k = static_cast<unsigned>( std::stoul(optarg) );
+      break;
+    case 's':
+      seed = static_cast<unsigned>( std::stoul(optarg) );
+      break;
+    case 'o':
+      output = optarg;
+      break;
+    default:
+      break;
+    }
+  }
+
+  Benchmark benchmark( k );
+
+  // Every data set uses its own generator, so changing the size of one
+  // data set does not affect the others.
+
+  {
+    std::mt19937 rng( seed );
+
+    auto pointCloud = geometry::makeSphere( geometry::sphereSampling<DataType>( n, rng ), DataType(1) );
+    benchmarkPointCloud( benchmark, "sphere", pointCloud, epsilon, dimension );
+  }
+
+  {
+    std::mt19937 rng( seed );
+
+    auto pointCloud = geometry::makeTorus( geometry::torusRejectionSampling( DataType(1), DataType(0.5), n, rng ), DataType(1), DataType(0.5) );
+    benchmarkPointCloud( benchmark, "torus", pointCloud, epsilon, dimension );
+  }
+
+  benchmarkRandomGraph( benchmark, vertices, probability, dimension, seed );
+  benchmarkDiagramDistances( benchmark, m, seed );
+
+  if( !output.empty() )
+  {
+    std::ofstream out( output );
+    if( !out )
+    {
+      std::cerr << "* Unable to open output file '" << output << "'\n";
+      return -1;
+    }
+
+    writeJSON( out, benchmark,
+               {
+                 { "points"      , std::to_string( n )           },
+                 { "epsilon"     , std::to_string( epsilon )     },
+                 { "dimension"   , std::to_string( dimension )   },
+                 { "vertices"    , std::to_string( vertices )    },
+                 { "probability" , std::to_string( probability ) },
+                 { "diagram-size", std::to_string( m )           },
+                 { "repetitions" , std::to_string( k )           },
+                 { "seed"        , std::to_string( seed )        }
+               } );
+  }
+}
@@ -68,10 +68,13 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <stdexcept>
 #include <tuple>
+#include <vector>
 
 #include <cmath>
+#include <cstring>
 
 namespace py = pybind11;
 
@@ -89,13 +92,96 @@ using StepFunction       = aleph::math::StepFunction<DataType>;
 // Select a default value of calculating nearest neighbours. This is
 // only relevant for those functions that create complexes from data
 // that is unstructured.
-template <class Distance> using NearestNeighbours
+template <class Distance, class Container = PointCloud> using NearestNeighbours
 #ifdef ALEPH_WITH_FLANN
-  = aleph::geometry::FLANN<PointCloud, Distance>;
+  = aleph::geometry::FLANN<Container, Distance>;
 #else
-  = aleph::geometry::BruteForce<PointCloud, Distance>;
+  = aleph::geometry::BruteForce<Container, Distance>;
 #endif
 
+/**
+  Wraps a two-dimensional buffer of type T in a point cloud. Buffers
+  whose rows are contiguous are used without copying, and the point
+  cloud keeps them alive; other layouts, such as transposed arrays, are
+  copied.
+*/
+
+template <class T> aleph::containers::PointCloud<T> makePointCloud( std::shared_ptr<py::buffer_info> bufferInfo )
+{
+  using PointCloud = aleph::containers::PointCloud<T>;
+
+  auto n = static_cast<std::size_t>( bufferInfo->shape[0] );
+  auto d = static_cast<std::size_t>( bufferInfo->shape[1] );
+
+  auto rowStride    = bufferInfo->strides[0];
+  auto columnStride = bufferInfo->strides[1];
+  auto size         = static_cast<py::ssize_t>( sizeof(T) );
+
+  bool contiguous =    columnStride == size
+                    && rowStride    >= static_cast<py::ssize_t>( d ) * size
+                    && rowStride    %  size == 0;
+
+  if( contiguous )
+    return PointCloud( reinterpret_cast<T*>( bufferInfo->ptr ), n, d, static_cast<std::size_t>( rowStride / size ), bufferInfo );
+
+  PointCloud pointCloud( n, d );
+
+  auto bytes = reinterpret_cast<const char*>( bufferInfo->ptr );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    std::vector<T> p( d );
+
+    for( std::size_t j = 0; j < d; j++ )
+    {
+      std::memcpy( &p[j],
+                   bytes + static_cast<py::ssize_t>( i ) * rowStride + static_cast<py::ssize_t>( j ) * columnStride,
+                   sizeof(T) );
+    }
+
+    pointCloud.set( i, p.begin(), p.end() );
+  }
+
+  return pointCloud;
+}
+
+/**
+  Calculates the persistence diagrams of the Vietoris--Rips complex of a
+  two-dimensional buffer of type T. Distances are accumulated with the
+  precision of DataType, and the diagrams are converted to DataType.
+*/
+
+template <class T> std::vector<PersistenceDiagram> calculatePersistenceDiagramsOfBuffer( std::shared_ptr<py::buffer_info> bufferInfo,
+                                                                                         DataType epsilon,
+                                                                                         unsigned dimension )
+{
+  using Distance = aleph::geometry::distances::Euclidean<T, DataType>;
+
+  auto pointCloud = makePointCloud<T>( bufferInfo );
+  dimension       = dimension > 0 ? dimension : static_cast<unsigned>( pointCloud.dimension() + 1 );
+
+  auto K = aleph::geometry::buildVietorisRipsComplex(
+    NearestNeighbours<Distance, aleph::containers::PointCloud<T> >( pointCloud ),
+    static_cast<T>( epsilon ),
+    dimension
+  );
+
+  std::vector<PersistenceDiagram> result;
+
+  for( auto&& D : aleph::calculatePersistenceDiagrams( K ) )
+  {
+    PersistenceDiagram E;
+    E.setDimension( D.dimension() );
+
+    for( auto&& p : D )
+      E.add( static_cast<DataType>( p.x() ), static_cast<DataType>( p.y() ) );
+
+    result.push_back( E );
+  }
+
+  return result;
+}
+
 void wrapSimplex( py::module& m )
 {
   py::class_<Simplex>(m, "Simplex")
@@ -447,37 +533,22 @@ void wrapPersistentHomologyCalculation( py::module& m )
   m.def( "calculatePersistenceDiagrams",
     [] ( py::buffer buffer, DataType epsilon, unsigned dimension )
     {
-      py::buffer_info bufferInfo = buffer.request();
+      // The buffer information is shared with the point cloud, which
+      // keeps the buffer alive and permits using its memory directly.
+      auto bufferInfo = std::make_shared<py::buffer_info>( buffer.request() );
 
-      if( bufferInfo.ndim != 2 || bufferInfo.shape.size() != 2 )
+      if( bufferInfo->ndim != 2 || bufferInfo->shape.size() != 2 )
         throw std::runtime_error( "Only two-dimensional buffers are supported" );
 
-      if( bufferInfo.format != py::format_descriptor<DataType>::format() )
+      // Single precision buffers are used directly, which halves the
+      // memory bandwidth of all distance calculations. Distances are
+      // still accumulated in double precision.
+      if( bufferInfo->format == py::format_descriptor<float>::format() )
+        return calculatePersistenceDiagramsOfBuffer<float>( bufferInfo, epsilon, dimension );
+      else if( bufferInfo->format == py::format_descriptor<DataType>::format() )
+        return calculatePersistenceDiagramsOfBuffer<DataType>( bufferInfo, epsilon, dimension );
+      else
         throw std::runtime_error( "Unexpected format" );
-
-      auto n = bufferInfo.shape[0];
-      auto d = bufferInfo.shape[1];
-
-      PointCloud pointCloud(
-        static_cast<std::size_t>(n),
-        static_cast<std::size_t>(d)
-      );
-
-      DataType* target = pointCloud.data();
-      DataType* source = reinterpret_cast<DataType*>( bufferInfo.ptr );
-
-      std::copy( source, source + n*d, target );
-
-      using Distance = aleph::geometry::distances::Euclidean<DataType>;
-      dimension      = dimension > 0 ? dimension : static_cast<unsigned>( pointCloud.dimension() + 1 );
-
-      auto K         = aleph::geometry::buildVietorisRipsComplex(
-        NearestNeighbours<Distance>( pointCloud ),
-        epsilon,
-        dimension
-      );
-
-      return aleph::calculatePersistenceDiagrams( K );
     },
     "buffer"_a,
     "epsilon"_a   = DataType(),
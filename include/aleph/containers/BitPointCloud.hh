@@ -0,0 +1,225 @@
+#ifndef ALEPH_CONTAINERS_BIT_POINT_CLOUD_HH__
+#define ALEPH_CONTAINERS_BIT_POINT_CLOUD_HH__
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace aleph
+{
+
+namespace containers
+{
+
+/**
+  @class BitPointCloud
+  @brief Point cloud of binary vectors, stored as packed bits
+
+  Stores every coordinate of a binary vector, such as a fingerprint, as
+  a single bit. Points are padded to a multiple of 64 bits, with unused
+  bits set to zero. Compared to a point cloud with floating point values,
+  this requires 32 or 64 times less memory, and distances can be
+  calculated word by word.
+
+  In order to be usable with the nearest neighbour classes, the point
+  cloud exposes its words: every point consists of dimension() elements
+  of type ElementType. The number of coordinates of every point is given
+  by bits(). This class should be used along with the packed Hamming
+  distance functor, aleph::geometry::distances::PackedHamming.
+*/
+
+class BitPointCloud
+{
+public:
+
+  // Type of the words that store the coordinates. This is also the type
+  // that is used for distances between points.
+  using ElementType = std::uint64_t;
+
+  // Ditto for the index type, which is consistent with the other point
+  // cloud classes.
+  using IndexType = std::size_t;
+
+  /** Number of bits that are stored in one word */
+  static constexpr std::size_t bitsPerWord = 64;
+
+  /**
+    Lightweight view of the words of a single point. The view is only
+    valid as long as the point cloud is not modified.
+  */
+
+  class Point
+  {
+  public:
+    using value_type     = ElementType;
+    using iterator       = const ElementType*;
+    using const_iterator = const ElementType*;
+
+    Point( const ElementType* begin, const ElementType* end )
+      : _begin( begin )
+      , _end( end )
+    {
+    }
+
+    const_iterator begin() const noexcept { return _begin; }
+    const_iterator end()   const noexcept { return _end;   }
+
+    std::size_t size() const noexcept
+    {
+      return static_cast<std::size_t>( _end - _begin );
+    }
+
+  private:
+    const ElementType* _begin;
+    const ElementType* _end;
+  };
+
+  BitPointCloud()
+    : _n( 0 )
+    , _bits( 0 )
+    , _words( 0 )
+  {
+  }
+
+  /** Creates a point cloud of n points with the given number of bits, all of which are zero */
+  BitPointCloud( std::size_t n, std::size_t bits )
+    : _n( n )
+    , _bits( bits )
+    , _words( ( bits + bitsPerWord - 1 ) / bitsPerWord )
+    , _points( _n * _words )
+  {
+  }
+
+  // Equality comparison -----------------------------------------------
+
+  bool operator==( const BitPointCloud& other ) const noexcept
+  {
+    return    _n      == other._n
+           && _bits   == other._bits
+           && _points == other._points;
+  }
+
+  // Attributes --------------------------------------------------------
+
+  IndexType size() const noexcept
+  {
+    return _n;
+  }
+
+  /** @returns Number of words per point */
+  IndexType dimension() const noexcept
+  {
+    return _words;
+  }
+
+  /** @returns Number of words between two consecutive points */
+  IndexType stride() const noexcept
+  {
+    return _words;
+  }
+
+  /** @returns Number of bits, i.e. coordinates, per point */
+  IndexType bits() const noexcept
+  {
+    return _bits;
+  }
+
+  bool empty() const noexcept
+  {
+    return _n == 0;
+  }
+
+  // Point access ------------------------------------------------------
+
+  const ElementType* data() const noexcept
+  {
+    return _points.data();
+  }
+
+  /**
+    Sets $i$th point of point cloud from a range of values, each of which
+    is interpreted as a single bit. Throws if the index is invalid or if
+    the number of values does not match the number of bits.
+  */
+
+  template <class InputIterator> void set( IndexType i,
+                                           InputIterator begin, InputIterator end )
+  {
+    if( i >= this->size() )
+      throw std::runtime_error( "Invalid index" );
+
+    auto distance = std::distance( begin, end );
+
+    if( static_cast<IndexType>( distance ) != this->bits() )
+      throw std::runtime_error( "Incorrect number of dimensions" );
+
+    auto words = _points.begin() + static_cast<std::ptrdiff_t>( i * _words );
+    std::fill( words, words + static_cast<std::ptrdiff_t>( _words ), ElementType() );
+
+    std::size_t j = 0;
+    for( auto it = begin; it != end; ++it, ++j )
+    {
+      if( *it )
+        words[ static_cast<std::ptrdiff_t>( j / bitsPerWord ) ] |= ElementType(1) << ( j % bitsPerWord );
+    }
+  }
+
+  /** @overload set() */
+  void set( IndexType i, const std::initializer_list<int>& il )
+  {
+    this->set( i, il.begin(), il.end() );
+  }
+
+  /**
+    Gets the $i$th point of the point cloud as a sequence of zeroes and
+    ones. It will be stored via an output iterator. Incorrect indices will
+    result in an exception.
+  */
+
+  template <class OutputIterator> void get( IndexType i,
+                                            OutputIterator result ) const
+  {
+    if( i >= this->size() )
+      throw std::runtime_error( "Invalid index" );
+
+    for( std::size_t j = 0; j < _bits; j++ )
+      *result++ = this->bit( i, j );
+  }
+
+  /** @returns Value of bit j of point i, without any range checks */
+  bool bit( IndexType i, std::size_t j ) const noexcept
+  {
+    return ( _points[ i * _words + j / bitsPerWord ] >> ( j % bitsPerWord ) ) & 1u;
+  }
+
+  /** Returns a view of the words of the $i$th point, without any range checks */
+  Point point( IndexType i ) const noexcept
+  {
+    auto begin = _points.data() + i * _words;
+    return Point( begin, begin + _words );
+  }
+
+  /** @overload point() */
+  Point operator[]( IndexType i ) const noexcept
+  {
+    return this->point( i );
+  }
+
+private:
+  std::size_t _n;     ///< Number of points
+  std::size_t _bits;  ///< Number of bits per point
+  std::size_t _words; ///< Number of words per point
+
+  std::vector<ElementType> _points;
+};
+
+} // namespace containers
+
+} // namespace aleph
+
+#endif
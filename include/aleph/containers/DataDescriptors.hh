@@ -2,11 +2,16 @@
 #define ALEPH_CONTAINERS_DATA_DESCRIPTORS_HH__
 
 #include <cmath>
+#include <cstddef>
 
 #include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
 #include <vector>
 
 #include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/DistanceMatrix.hh>
 #include <aleph/geometry/NearestNeighbours.hh>
 
 #include <aleph/geometry/distances/Euclidean.hh>
@@ -26,132 +31,312 @@ namespace containers
   to central points in a point cloud without having to define the actual
   centre of it. The order parameter can be used to decrease how much the
   small distances influence the result.
+
+  Points are processed in blocks, so that the points of a block remain
+  in the cache while they are being compared to all other points. Blocks
+  are distributed among all threads if OpenMP is available.
 */
 
 template <class Distance, class Container> std::vector<double> eccentricities( const Container& container,
                                                                                unsigned order = 1 )
 {
-  auto n = container.size();
-  auto d = container.dimension();
+  std::size_t n = container.size();
+  std::size_t d = container.dimension();
 
   // Ensures that subsequent algorithms always operate on a non-empty
   // range of iterators.
   if( n == 0 )
     return {};
 
-  std::vector<double> eccentricities;
-  eccentricities.reserve( n );
+  std::vector<double> eccentricities( n );
 
   Distance dist;
   aleph::geometry::distances::Traits<Distance> traits;
 
-  for( decltype(n) i = 0; i < n; i++ )
-  {
-    auto p = container[i];
+  const std::size_t blockSize = 64;
+  const std::size_t numBlocks = ( n + blockSize - 1 ) / blockSize;
 
-    std::vector<double> distances;
-    distances.reserve( n );
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( numBlocks ); s++ )
+  {
+    auto i0 = static_cast<std::size_t>( s ) * blockSize;
+    auto i1 = std::min( n, i0 + blockSize );
 
-    double eccentricity = 0.0;
+    // Sums are accumulated per point over all blocks, which preserves the
+    // order of the summation.
+    std::vector< aleph::math::KahanSummation<double> > sums( i1 - i0, 0.0 );
+    std::vector<double> maxima( i1 - i0, 0.0 );
 
-    for( decltype(n) j = 0; j < n; j++ )
+    for( std::size_t j0 = 0; j0 < n; j0 += blockSize )
     {
-      if( i != j )
+      auto j1 = std::min( n, j0 + blockSize );
+
+      for( std::size_t i = i0; i < i1; i++ )
       {
-        auto q        = container[j];
-        auto distance = dist( p.begin(),
-                              q.begin(),
-                              d );
+        auto p = container.point( i );
+
+        for( std::size_t j = j0; j < j1; j++ )
+        {
+          if( i == j )
+            continue;
+
+          auto distance = traits.from( dist( p.begin(),
+                                             container.point( j ).begin(),
+                                             d ) );
+
+          if( order > 0 )
+          {
+            distance      = std::pow( distance, decltype(distance)( order ) ) / decltype(distance)(n);
+            sums[i - i0] += distance;
+          }
+          else
+            maxima[i - i0] = std::max( maxima[i - i0], static_cast<double>( distance ) );
+        }
+      }
+    }
 
-        distance = traits.from( distance );
+    for( std::size_t i = i0; i < i1; i++ )
+    {
+      if( order > 0 )
+        eccentricities[i] = std::pow( static_cast<double>( sums[i - i0] ), 1.0 / order );
+      else
+        eccentricities[i] = maxima[i - i0];
+    }
+  }
 
-        if( order > 0 )
-          distance = std::pow( distance, decltype(distance)( order ) ) / decltype(distance)(n);
+  return eccentricities;
+}
 
-        distances.push_back( distance );
-      }
-    }
+/**
+  Truncated Gaussian density estimation for all pairs of points, which is
+  used if no wrapper for nearest neighbours has been specified.
 
-    if( order > 0 )
+  @see estimateDensityTruncatedGaussian( const Container&, double )
+*/
+
+template <class Container> std::vector<double> estimateDensityTruncatedGaussian( const Container& container, double bandwidth, void* )
+{
+  std::size_t n = container.size();
+  std::size_t d = container.dimension();
+
+  const auto bandwidthSquare = bandwidth * bandwidth;
+
+  std::vector<double> densities( n );
+
+  aleph::geometry::distances::Euclidean<typename Container::ElementType, double> distanceFunctor;
+
+  const std::size_t blockSize = 64;
+  const std::size_t numBlocks = ( n + blockSize - 1 ) / blockSize;
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( numBlocks ); s++ )
+  {
+    auto i0 = static_cast<std::size_t>( s ) * blockSize;
+    auto i1 = std::min( n, i0 + blockSize );
+
+    std::vector< aleph::math::KahanSummation<double> > sums( i1 - i0, 0.0 );
+
+    for( std::size_t j0 = 0; j0 < n; j0 += blockSize )
     {
-      eccentricity = aleph::math::accumulate_kahan( distances.begin(), distances.end(), 0.0 );
-      eccentricity = std::pow( eccentricity, 1.0 / order );
+      auto j1 = std::min( n, j0 + blockSize );
+
+      for( std::size_t i = i0; i < i1; i++ )
+      {
+        auto p = container.point( i );
+
+        for( std::size_t j = j0; j < j1; j++ )
+        {
+          auto distance = distanceFunctor( p.begin(),
+                                           container.point( j ).begin(),
+                                           d );
+          if( distance <= bandwidthSquare )
+            sums[i - i0] += std::exp( -1.0 * distance / ( 2.0 * bandwidth ) );
+        }
+      }
     }
-    else
-      eccentricity = *std::max_element( distances.begin(), distances.end() );
 
-    eccentricities.push_back( eccentricity );
+    for( std::size_t i = i0; i < i1; i++ )
+      densities[i] = sums[i - i0] / static_cast<double>(n);
   }
 
-  return eccentricities;
+  return densities;
 }
 
 /**
-  Density estimation using a truncated Gaussian estimator. Points whose
-  Euclidean distance is smaller than the bandwidth will not be used for
-  estimating the density.
+  Truncated Gaussian density estimation using a radius query of a wrapper
+  for nearest neighbours.
+
+  @see estimateDensityTruncatedGaussian( const Container&, double )
 */
 
-template <class Container> std::vector<double> estimateDensityTruncatedGaussian( const Container& container, double bandwidth )
+template <class Container, class Wrapper> std::vector<double> estimateDensityTruncatedGaussian( const Container& container, double bandwidth, Wrapper* )
 {
-  auto n = container.size();
-  auto d = container.dimension();
+  std::size_t n = container.size();
+  std::size_t d = container.dimension();
 
   const auto bandwidthSquare = bandwidth * bandwidth;
 
-  std::vector<double> densities;
-  densities.reserve( n );
+  using IndexType   = typename Wrapper::IndexType;
+  using ElementType = typename Wrapper::ElementType;
+
+  std::vector< std::vector<IndexType> > indices;
+  std::vector< std::vector<ElementType> > distances;
+
+  // Radius queries exclude points whose distance is equal to the radius,
+  // and the wrapper may calculate distances with a different precision.
+  // The relative error of a squared distance that is accumulated over d
+  // coordinates is bounded by d units of roundoff, so enlarging the radius
+  // by a margin proportional to the dimension ensures that the query
+  // reports all points within the bandwidth. The neighbours are then
+  // filtered with the same criterion as above, so the results do not
+  // depend on the wrapper.
+  auto epsilon = static_cast<double>( std::numeric_limits<ElementType>::epsilon() );
+  auto margin  = 4.0 * static_cast<double>( d + 2 ) * epsilon;
+  auto radius  = std::nextafter( static_cast<ElementType>( bandwidth * ( 1.0 + margin ) ),
+                                 std::numeric_limits<ElementType>::max() );
 
-  aleph::geometry::distances::Euclidean<double> distanceFunctor;
+  Wrapper nnWrapper( container );
+  nnWrapper.radiusSearch( radius, indices, distances );
 
-  for( decltype(n) i = 0; i < n; i++ )
+  std::vector<double> densities( n );
+
+  aleph::geometry::distances::Euclidean<typename Container::ElementType, double> distanceFunctor;
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 16)
+#endif
+  for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( n ); s++ )
   {
-    auto p                                      = container[i];
+    auto i = static_cast<std::size_t>( s );
+    auto p = container.point( i );
+
     aleph::math::KahanSummation<double> density = 0.0;
 
-    for( decltype(n) j = 0; j < n; j++ )
+    // Sums in the same order as above, so the results are identical
+    std::sort( indices[i].begin(), indices[i].end() );
+
+    for( auto&& j : indices[i] )
     {
-      auto q        = container[j];
       auto distance = distanceFunctor( p.begin(),
-                                       q.begin(),
+                                       container.point( static_cast<std::size_t>( j ) ).begin(),
                                        d );
       if( distance <= bandwidthSquare )
         density += std::exp( -1.0 * distance / ( 2.0 * bandwidth ) );
     }
 
-    densities.push_back( density / static_cast<double>(n) );
+    densities[i] = density / static_cast<double>(n);
   }
 
   return densities;
 }
 
 /**
-  Density estimator using the distance to a measure density estimator as
-  introduced by Chazal et al. in:
+  Density estimation using a truncated Gaussian estimator. Only points
+  whose Euclidean distance is at most the bandwidth contribute to the
+  density of a point.
+
+  Distances are calculated and accumulated in double precision, even if
+  the container uses single precision. Points are processed in parallel
+  blocks, similar to eccentricities().
+
+  The second template parameter optionally specifies a wrapper for
+  nearest neighbours, such as geometry::KDTree, which has to use the
+  Euclidean distance. In this case, only the neighbours within the
+  bandwidth are enumerated, instead of all pairs of points. If the
+  wrapper is exact, such as geometry::KDTree, the results are the same in
+  both cases, even if the wrapper calculates distances in single
+  precision; in particular, points whose distance is equal to the
+  bandwidth are used in both cases.
+*/
 
-      Persistence-based clustering in Riemannian manifolds
+template <class Container, class Wrapper = void> std::vector<double> estimateDensityTruncatedGaussian( const Container& container, double bandwidth )
+{
+  return estimateDensityTruncatedGaussian( container, bandwidth, static_cast<Wrapper*>( nullptr ) );
+}
 
-  This density estimator is capable of using different distance
-  functors.
+/**
+  Distance to a measure density estimation for the default wrapper, which
+  calculates all distances of a point directly.
+
+  @see estimateDensityDistanceToMeasure( const Container&, unsigned, Distance )
 */
 
-template <
-  class Distance,
-  class Container,
-  class Wrapper = geometry::BruteForce<Container, Distance>
-> std::vector<double> estimateDensityDistanceToMeasure( const Container& container,
-                                                        unsigned k,
-                                                        Distance /* distance */ = Distance() )
+template <class Distance, class Container> std::vector<double> estimateDensityDistanceToMeasure( const Container& container,
+                                                                                                 unsigned k,
+                                                                                                 Distance distance,
+                                                                                                 geometry::BruteForce<Container, Distance>* )
+{
+  std::size_t n = container.size();
+  std::size_t d = container.dimension();
+  std::size_t m = std::min( n, static_cast<std::size_t>( k ) );
+
+  using ElementType = typename Container::ElementType;
+
+  std::vector<double> densities( n );
+  aleph::geometry::distances::Traits<Distance> traits;
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    std::vector<ElementType> distances( n );
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 16)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( n ); s++ )
+    {
+      auto i = static_cast<std::size_t>( s );
+      auto p = container.point( i );
+
+      for( std::size_t j = 0; j < n; j++ )
+      {
+        distances[j] = static_cast<ElementType>( traits.from( distance( p.begin(),
+                                                                        container.point( j ).begin(),
+                                                                        d ) ) );
+      }
+
+      // Only the smallest distances are required, in ascending order, so
+      // the summation is consistent with the other wrappers.
+      std::partial_sort( distances.begin(), distances.begin() + static_cast<std::ptrdiff_t>( m ), distances.end() );
+
+      double density  = aleph::math::accumulate_kahan( distances.begin(), distances.begin() + static_cast<std::ptrdiff_t>( m ), 0.0 );
+      density         = -density;
+      density        /= static_cast<double>( n );
+
+      densities[i] = density;
+    }
+  }
+
+  return densities;
+}
+
+/**
+  Distance to a measure density estimation using a query for the nearest
+  neighbours of a wrapper.
+
+  @see estimateDensityDistanceToMeasure( const Container&, unsigned, Distance )
+*/
+
+template <class Distance, class Container, class Wrapper> std::vector<double> estimateDensityDistanceToMeasure( const Container& container,
+                                                                                                                unsigned k,
+                                                                                                                Distance /* distance */,
+                                                                                                                Wrapper* )
 {
   auto n = container.size();
 
   std::vector<double> densities;
   densities.reserve( n );
 
-  using IndexType = typename Wrapper::IndexType;
+  using IndexType   = typename Wrapper::IndexType;
+  using ElementType = typename Wrapper::ElementType;
 
   std::vector< std::vector<IndexType> > indices;
-  std::vector< std::vector<double> > distances;
+  std::vector< std::vector<ElementType> > distances;
 
   Wrapper nnWrapper( container );
   nnWrapper.neighbourSearch( k, indices, distances );
@@ -168,6 +353,38 @@ template <
   return densities;
 }
 
+/**
+  Density estimator using the distance to a measure density estimator as
+  introduced by Chazal et al. in:
+
+      Persistence-based clustering in Riemannian manifolds
+
+  This density estimator is capable of using different distance
+  functors. By default, all distances of a point are calculated in
+  parallel, and only the smallest ones are sorted. Other wrappers for
+  nearest neighbours, such as geometry::KDTree, avoid calculating all
+  distances, which is preferable for low-dimensional data.
+*/
+
+template <
+  class Distance,
+  class Container,
+  class Wrapper = geometry::BruteForce<Container, Distance>
+> std::vector<double> estimateDensityDistanceToMeasure( const Container& container,
+                                                        unsigned k,
+                                                        Distance distance = Distance() )
+{
+  return estimateDensityDistanceToMeasure( container, k, distance, static_cast<Wrapper*>( nullptr ) );
+}
+
+/**
+  Calculates the lens data depth of every point, i.e. the number of pairs
+  of other points whose lune contains the point. The distances are first
+  calculated in parallel by geometry::distanceMatrix(). Afterwards, the
+  points are distributed among all threads, with every thread counting
+  the lunes that contain its points.
+*/
+
 template
 <
   class Distance,
@@ -175,48 +392,164 @@ template
 >
 std::vector<unsigned> estimateLensDataDepth( const Container& container, Distance distance = Distance() )
 {
-  auto n = container.size();
-  auto d = container.dimension();
+  std::size_t n = container.size();
+
+  auto distances = aleph::geometry::distanceMatrix( container, distance );
+  auto data      = distances.data();
 
-  using ResultType = typename Distance::ResultType;
+  std::vector<unsigned> counts( n );
 
-  aleph::math::SymmetricMatrix<ResultType> distances( n );
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    std::vector<typename Distance::ResultType> row( n );
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 16)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( n ); s++ )
+    {
+      auto k = static_cast<std::size_t>( s );
+
+      for( std::size_t i = 0; i < n; i++ )
+        row[i] = distances(i,k);
+
+      unsigned count = 0;
+
+      for( std::size_t i = 0; i < n; i++ )
+      {
+        if( i == k )
+          continue;
+
+        // Upper triangular part of the ith row of the matrix
+        auto distances_i = data + distances.rowOffset( i );
+
+        for( std::size_t j = i+1; j < n; j++ )
+        {
+          if( j == k )
+            continue;
+
+          // The maximum of the distance values is smaller than the
+          // distance between the points. Hence, the lune of points
+          // i and j contains point k.
+          if( std::max( row[i], row[j] ) <= distances_i[j] )
+            ++count;
+        }
+      }
+
+      counts[k] = count;
+    }
+  }
+
+  return counts;
+}
+
+/**
+  Approximates the lens data depth of every point by sampling pairs of
+  points uniformly at random. The number of sampled lunes that contain a
+  point is scaled by the total number of pairs, which results in an
+  unbiased estimate of the lens data depth. In contrast to the exact
+  calculation, no distance matrix is required, and the running time is
+  linear in the number of points for a fixed number of samples.
+
+  Samples are drawn with a fixed seed, so the results are reproducible,
+  and they are processed in parallel if OpenMP is available. The exact
+  lens data depth is calculated if the number of samples is not smaller
+  than the number of pairs.
+
+  @param container  Container whose lens data depth is approximated
+  @param numSamples Number of sampled pairs of points
+  @param distance   Distance functor
+  @param seed       Seed for the random number generator
+
+  @returns Estimated lens data depth of every point
+*/
+
+template
+<
+  class Distance,
+  class Container
+>
+std::vector<unsigned> estimateLensDataDepth( const Container& container,
+                                             std::size_t numSamples,
+                                             Distance distance = Distance(),
+                                             unsigned seed = std::mt19937::default_seed )
+{
+  std::size_t n        = container.size();
+  std::size_t d        = container.dimension();
+  std::size_t numPairs = n * ( n - std::min( n, std::size_t(1) ) ) / 2;
+
+  if( numSamples >= numPairs )
+    return estimateLensDataDepth( container, distance );
+
+  std::vector< std::pair<std::size_t, std::size_t> > pairs;
+  pairs.reserve( numSamples );
 
-  for( decltype(n) i = 0; i < n; i++ )
   {
-    for( decltype(n) j = i+1; j < n; j++ )
+    std::mt19937 rng( seed );
+    std::uniform_int_distribution<std::size_t> distribution( 0, n - 1 );
+
+    while( pairs.size() < numSamples )
     {
-      distances(i,j) = distance( container[i].begin(),
-                                 container[j].begin(),
-                                 d );
+      auto i = distribution( rng );
+      auto j = distribution( rng );
+
+      if( i != j )
+        pairs.push_back( std::make_pair( i, j ) );
     }
   }
 
-  std::vector<unsigned> counts( n );
+  std::vector<std::size_t> hits( n );
 
-  for( decltype(n) i = 0; i < n; i++ )
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
   {
-    for( decltype(n) j = i+1; j < n; j++ )
+    std::vector<std::size_t> localHits( n );
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 4)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( numSamples ); s++ )
     {
-      auto criticalDistance = distances(i,j);
+      auto i = pairs[ static_cast<std::size_t>( s ) ].first;
+      auto j = pairs[ static_cast<std::size_t>( s ) ].second;
+      auto p = container.point( i );
+      auto q = container.point( j );
+
+      auto criticalDistance = distance( p.begin(), q.begin(), d );
 
-      for( decltype(n) k = 0; k < n; k++ )
+      for( std::size_t k = 0; k < n; k++ )
       {
         if( k == i || k == j )
           continue;
 
-        auto distance_i = distances(i,k);
-        auto distance_j = distances(j,k);
+        auto r          = container.point( k );
+        auto distance_i = distance( p.begin(), r.begin(), d );
+        auto distance_j = distance( q.begin(), r.begin(), d );
 
-        // The maximum of the distance values is smaller than the
-        // distance between the points. Hence, the lune of points
-        // i and j contains point k.
         if( std::max( distance_i, distance_j ) <= criticalDistance )
-          ++counts[k];
+          ++localHits[k];
       }
     }
+
+#ifdef _OPENMP
+    #pragma omp critical
+#endif
+    {
+      for( std::size_t k = 0; k < n; k++ )
+        hits[k] += localHits[k];
+    }
   }
 
+  std::vector<unsigned> counts( n );
+
+  auto scale = static_cast<double>( numPairs ) / static_cast<double>( numSamples );
+
+  for( std::size_t k = 0; k < n; k++ )
+    counts[k] = static_cast<unsigned>( std::round( static_cast<double>( hits[k] ) * scale ) );
+
   return counts;
 }
 
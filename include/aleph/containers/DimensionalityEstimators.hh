@@ -308,11 +308,11 @@ template <
 
   for( std::size_t i = 0; i < n; i++ )
   {
-    auto&& p = container[i];
+    auto&& p = container.point( i );
 
     for( std::size_t j = i+1; j < n; j++ )
     {
-      auto&& q  = container[j];
+      auto&& q  = container.point( j );
       auto dist = distance( p.begin(), q.begin(), d );
 
       boost::add_edge( VertexDescriptor(i),
@@ -383,7 +383,7 @@ template <
       std::size_t i = 0;
       for( auto&& index : localIndices )
       {
-        auto&& p = container[index];
+        auto&& p = container.point( index );
 
         data[i].assign( p.begin(), p.end() );
 
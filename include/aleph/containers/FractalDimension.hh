@@ -51,11 +51,11 @@ template <
 
   for( decltype(n) i = 0; i < n; i++ )
   {
-    auto&& p = container[i];
+    auto&& p = container.point( i );
 
     for( decltype(n) j = i+1; j < n; j++ )
     {
-      auto&& q      = container[j];
+      auto&& q      = container.point( j );
       auto distance = dist( p.begin(),
                             q.begin(),
                             d );
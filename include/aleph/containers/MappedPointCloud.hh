@@ -0,0 +1,317 @@
+#ifndef ALEPH_CONTAINERS_MAPPED_POINT_CLOUD_HH__
+#define ALEPH_CONTAINERS_MAPPED_POINT_CLOUD_HH__
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/utilities/MemoryMappedFile.hh>
+#include <aleph/utilities/String.hh>
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace aleph
+{
+
+namespace containers
+{
+
+/**
+  @namespace numpy
+  @brief     Helper functions for the NumPy format
+*/
+
+namespace numpy
+{
+
+/**
+  @returns Type descriptor of NumPy for a given type, for example "f8"
+  for double. The byte order is not part of the descriptor.
+*/
+
+template <class T> std::string typeDescriptor()
+{
+  static_assert( std::is_arithmetic<T>::value, "NumPy arrays require an arithmetic type" );
+
+  char kind = std::is_floating_point<T>::value ? 'f' : ( std::is_signed<T>::value ? 'i' : 'u' );
+  return std::string( 1, kind ) + std::to_string( sizeof(T) );
+}
+
+/** @returns true if the current machine uses little endian byte order */
+inline bool isLittleEndian() noexcept
+{
+  const std::uint16_t x = 1;
+  unsigned char c       = 0;
+
+  std::memcpy( &c, &x, 1 );
+  return c == 1;
+}
+
+/**
+  Extracts the value of a key from the header of a NumPy file. The header
+  is a Python dictionary literal, so the value extends up to the next
+  comma that is not enclosed in parentheses.
+*/
+
+inline std::string headerValue( const std::string& header, const std::string& key )
+{
+  auto position = header.find( "'" + key + "'" );
+
+  if( position == std::string::npos )
+    throw std::runtime_error( "NumPy header does not contain key '" + key + "'" );
+
+  position = header.find( ':', position );
+
+  if( position == std::string::npos )
+    throw std::runtime_error( "Invalid NumPy header" );
+
+  std::string value;
+  int depth = 0;
+
+  for( auto it = header.begin() + static_cast<std::ptrdiff_t>( position + 1 ); it != header.end(); ++it )
+  {
+    if( *it == '(' )
+      ++depth;
+    else if( *it == ')' )
+      --depth;
+    else if( ( *it == ',' && depth == 0 ) || *it == '}' )
+      break;
+
+    value.push_back( *it );
+  }
+
+  return utilities::trim( value );
+}
+
+} // namespace numpy
+
+/**
+  Loads a point cloud from a NumPy file, i.e. a file in the `.npy` format.
+  The file is mapped into memory, so loading does not copy any data, and
+  the point cloud keeps the mapping alive. Modifications of the point
+  cloud are never written back to the file.
+
+  The array must be stored in C order, and its type must correspond to
+  the type of the point cloud. One-dimensional arrays are loaded as a
+  point cloud of dimension one.
+
+  @param filename Input filename
+  @returns Point cloud that refers to the contents of the file
+
+  @throws std::runtime_error if the file cannot be mapped or if its format
+  is not supported
+*/
+
+template <class T> PointCloud<T> loadNumPy( const std::string& filename )
+{
+  auto file = std::make_shared<utilities::MemoryMappedFile>( filename );
+
+  const char* data = file->data();
+  auto size        = file->size();
+
+  if( size < 10 || std::memcmp( data, "\x93NUMPY", 6 ) != 0 )
+    throw std::runtime_error( "File '" + filename + "' is not a NumPy file" );
+
+  auto major = static_cast<unsigned char>( data[6] );
+
+  std::size_t headerOffset = major == 1 ? 10 : 12;
+  std::size_t headerLength = 0;
+
+  if( size < headerOffset )
+    throw std::runtime_error( "Invalid NumPy header" );
+
+  // The length of the header is stored in little endian byte order
+  for( std::size_t i = headerOffset; i > 8; i-- )
+    headerLength = ( headerLength << 8 ) | static_cast<unsigned char>( data[i-1] );
+
+  if( headerOffset + headerLength > size )
+    throw std::runtime_error( "Invalid NumPy header" );
+
+  std::string header( data + headerOffset, headerLength );
+
+  auto descriptor   = numpy::headerValue( header, "descr" );
+  auto fortranOrder = numpy::headerValue( header, "fortran_order" );
+  auto shape        = numpy::headerValue( header, "shape" );
+
+  if( descriptor.size() < 3 )
+    throw std::runtime_error( "Invalid NumPy type descriptor" );
+
+  // Removes the quotes around the descriptor. The first character of the
+  // descriptor specifies the byte order, which must correspond to the
+  // byte order of the current machine unless it is irrelevant.
+  descriptor     = descriptor.substr( 1, descriptor.size() - 2 );
+  auto byteOrder = descriptor.front();
+  auto type      = descriptor.substr( 1 );
+
+  if( type != numpy::typeDescriptor<T>() )
+    throw std::runtime_error( "NumPy type '" + descriptor + "' does not match type of point cloud" );
+
+  if( ( byteOrder == '<' && !numpy::isLittleEndian() ) || ( byteOrder == '>' && numpy::isLittleEndian() ) )
+    throw std::runtime_error( "Byte order of NumPy file is not supported" );
+
+  if( fortranOrder != "False" )
+    throw std::runtime_error( "NumPy arrays in Fortran order are not supported" );
+
+  std::vector<std::size_t> dimensions;
+
+  for( const char* it = shape.c_str(); *it; )
+  {
+    if( std::isdigit( static_cast<unsigned char>( *it ) ) )
+    {
+      char* next = nullptr;
+      dimensions.push_back( static_cast<std::size_t>( std::strtoull( it, &next, 10 ) ) );
+      it = next;
+    }
+    else
+      ++it;
+  }
+
+  if( dimensions.empty() || dimensions.size() > 2 )
+    throw std::runtime_error( "Only one-dimensional and two-dimensional NumPy arrays are supported" );
+
+  auto n      = dimensions.front();
+  auto d      = dimensions.size() == 2 ? dimensions.back() : 1;
+  auto offset = headerOffset + headerLength;
+
+  if( offset + n * d * sizeof(T) > size )
+    throw std::runtime_error( "NumPy file '" + filename + "' is truncated" );
+
+  auto points = reinterpret_cast<T*>( file->data() + offset );
+
+  // The format guarantees an aligned offset, but files from other sources
+  // may not adhere to this; their contents have to be copied.
+  if( reinterpret_cast<std::uintptr_t>( points ) % alignof(T) != 0 )
+  {
+    PointCloud<T> pointCloud( n, d );
+    std::memcpy( pointCloud.data(), file->data() + offset, n * d * sizeof(T) );
+
+    return pointCloud;
+  }
+
+  return PointCloud<T>( points, n, d, d, file );
+}
+
+/**
+  Stores a point cloud in a NumPy file, i.e. in the `.npy` format. The
+  point cloud is stored as a two-dimensional array in C order.
+
+  @param filename   Output filename
+  @param pointCloud Point cloud to store
+
+  @throws std::runtime_error if the file cannot be written
+*/
+
+template <class T> void saveNumPy( const std::string& filename, const PointCloud<T>& pointCloud )
+{
+  std::ofstream out( filename, std::ios::binary );
+
+  if( !out )
+    throw std::runtime_error( "Unable to open '" + filename + "' for writing" );
+
+  std::string header = "{'descr': '"
+                     + std::string( 1, sizeof(T) == 1 ? '|' : ( numpy::isLittleEndian() ? '<' : '>' ) )
+                     + numpy::typeDescriptor<T>()
+                     + "', 'fortran_order': False, 'shape': ("
+                     + std::to_string( pointCloud.size() ) + ", "
+                     + std::to_string( pointCloud.dimension() ) + "), }";
+
+  // The data must start at a multiple of 64 bytes, and the header has to
+  // be terminated by a newline character.
+  auto length = 10 + header.size() + 1;
+  header.append( ( 64 - length % 64 ) % 64, ' ' );
+  header.push_back( '\n' );
+
+  out.write( "\x93NUMPY\x01\x00", 8 );
+
+  unsigned char headerLength[2] = {
+    static_cast<unsigned char>( header.size() & 0xFF ),
+    static_cast<unsigned char>( header.size() >> 8 )
+  };
+
+  out.write( reinterpret_cast<const char*>( headerLength ), 2 );
+  out.write( header.data(), static_cast<std::streamsize>( header.size() ) );
+
+  for( std::size_t i = 0; i < pointCloud.size(); i++ )
+  {
+    auto p = pointCloud.point( i );
+    out.write( reinterpret_cast<const char*>( p.data() ), static_cast<std::streamsize>( p.size() * sizeof(T) ) );
+  }
+
+  if( !out )
+    throw std::runtime_error( "Unable to write to '" + filename + "'" );
+}
+
+/**
+  Loads a point cloud from a raw binary file, which contains the
+  coordinates of all points in the native byte order of the machine,
+  without any header. The file is mapped into memory, so loading does
+  not copy any data.
+
+  @param filename  Input filename
+  @param dimension Dimension of the point cloud
+
+  @returns Point cloud that refers to the contents of the file
+
+  @throws std::runtime_error if the file cannot be mapped or if its size
+  is not a multiple of the size of a point
+*/
+
+template <class T> PointCloud<T> loadRaw( const std::string& filename, std::size_t dimension )
+{
+  if( dimension == 0 )
+    throw std::runtime_error( "Dimension of raw point cloud must not be zero" );
+
+  auto file = std::make_shared<utilities::MemoryMappedFile>( filename );
+
+  if( file->size() % ( dimension * sizeof(T) ) != 0 )
+    throw std::runtime_error( "Size of file '" + filename + "' does not match dimension" );
+
+  auto n = file->size() / ( dimension * sizeof(T) );
+
+  if( n == 0 )
+    return PointCloud<T>();
+
+  return PointCloud<T>( reinterpret_cast<T*>( file->data() ), n, dimension, dimension, file );
+}
+
+/**
+  Stores a point cloud in a raw binary file, using the native byte order
+  of the machine. The dimension of the point cloud is not stored.
+
+  @param filename   Output filename
+  @param pointCloud Point cloud to store
+
+  @throws std::runtime_error if the file cannot be written
+*/
+
+template <class T> void saveRaw( const std::string& filename, const PointCloud<T>& pointCloud )
+{
+  std::ofstream out( filename, std::ios::binary );
+
+  if( !out )
+    throw std::runtime_error( "Unable to open '" + filename + "' for writing" );
+
+  for( std::size_t i = 0; i < pointCloud.size(); i++ )
+  {
+    auto p = pointCloud.point( i );
+    out.write( reinterpret_cast<const char*>( p.data() ), static_cast<std::streamsize>( p.size() * sizeof(T) ) );
+  }
+
+  if( !out )
+    throw std::runtime_error( "Unable to write to '" + filename + "'" );
+}
+
+} // namespace containers
+
+} // namespace aleph
+
+#endif
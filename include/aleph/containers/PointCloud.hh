@@ -5,12 +5,18 @@
 #include <fstream>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <cstddef>
+#include <cstring>
 
+#include <aleph/utilities/MemoryMappedFile.hh>
 #include <aleph/utilities/String.hh>
 
 namespace aleph
@@ -23,6 +29,8 @@ template <class T> class PointCloud
 {
 public:
 
+  static_assert( std::is_arithmetic<T>::value, "Point clouds require an arithmetic type" );
+
   // Exporting the type of elements stored in the point cloud. This is
   // used by other algorithms to prevent casting.
   using ElementType = T;
@@ -31,30 +39,138 @@ public:
   // configurable, but I do not see a pressing reason to do so.
   using IndexType = std::size_t;
 
+  /**
+    Alignment of the storage in bytes. This is sufficient for all vector
+    instruction sets, including AVX-512, and corresponds to the size of a
+    cache line on most processors.
+  */
+
+  static constexpr std::size_t alignment = 64;
+
+  /**
+    Non-owning view of a single point of the point cloud, consisting of a
+    pointer to its first coordinate and its dimension. The view is only
+    valid as long as the point cloud is neither modified nor destroyed.
+    In contrast to operator[], obtaining a view does not allocate memory,
+    so it should be used in all loops over pairs of points.
+  */
+
+  class Point
+  {
+  public:
+    using value_type     = T;
+    using iterator       = const T*;
+    using const_iterator = const T*;
+
+    Point( const T* begin, std::size_t size )
+      : _begin( begin )
+      , _size( size )
+    {
+    }
+
+    const_iterator begin() const noexcept { return _begin;         }
+    const_iterator end()   const noexcept { return _begin + _size; }
+
+    const T* data() const noexcept
+    {
+      return _begin;
+    }
+
+    std::size_t size() const noexcept
+    {
+      return _size;
+    }
+
+    const T& operator[]( std::size_t i ) const noexcept
+    {
+      return _begin[i];
+    }
+
+  private:
+    const T* _begin;
+    std::size_t _size;
+  };
+
   PointCloud()
     : _n( 0 )
     , _d( 0 )
+    , _stride( 0 )
     , _points( nullptr )
   {
   }
 
-  PointCloud( std::size_t n, std::size_t d )
+  /**
+    Creates a new point cloud of n points in d dimensions, all of whose
+    coordinates are zero.
+
+    @param n       Number of points
+    @param d       Dimension
+    @param padding If set, every point starts at an aligned address. To
+    this end, the dimension is padded with zeroes to a multiple of the
+    alignment. The padding does not change any distances, so kernels may
+    process stride() coordinates per point instead of dimension().
+  */
+
+  PointCloud( std::size_t n, std::size_t d, bool padding = false )
     : _n( n )
     , _d( d )
-    , _points( new T[ _n * _d ] )
+    , _stride( padding ? paddedDimension( d ) : d )
+    , _points( nullptr )
   {
+    this->allocate();
+
     // Zero-initialization. This may not be the most efficient way of
     // doing it, in particular if a client has some data to pass, but
-    // it ensures consistency.
-    std::fill( _points, _points + _n * _d, T() );
+    // it ensures consistency. It also ensures that the padding, if
+    // any, is zero.
+    std::fill( _points, _points + _n * _stride, T() );
+  }
+
+  /**
+    Creates a point cloud that uses external memory without copying it,
+    for example a memory-mapped file or a buffer of another library. The
+    point cloud may modify the memory.
+
+    @param points  Pointer to the first coordinate of the first point
+    @param n       Number of points
+    @param d       Dimension
+    @param stride  Number of elements between the first coordinates of two
+    consecutive points; must not be smaller than the dimension
+    @param storage Handle that keeps the external memory alive. It will be
+    shared by all point clouds that are moved from this one. Copies of the
+    point cloud always allocate their own memory, though.
+
+    @throws std::runtime_error if the stride is smaller than the dimension
+  */
+
+  PointCloud( T* points, std::size_t n, std::size_t d, std::size_t stride, std::shared_ptr<void> storage )
+    : _n( n )
+    , _d( d )
+    , _stride( stride )
+    , _storage( std::move( storage ) )
+    , _points( points )
+  {
+    if( _stride < _d )
+      throw std::runtime_error( "Stride must not be smaller than the dimension" );
   }
 
   PointCloud( const PointCloud& other )
     : _n( other._n )
     , _d( other._d )
-    , _points( new T[ _n * _d ] )
+    , _stride( other._stride )
+    , _points( nullptr )
   {
-    std::copy( other._points, other._points + _n * _d, _points );
+    this->allocate();
+
+    // Points are copied individually because external memory may not
+    // contain any padding after the last point.
+    std::fill( _points, _points + _n * _stride, T() );
+
+    for( std::size_t i = 0; i < _n; i++ )
+    {
+      auto p = other.point( i );
+      std::copy( p.begin(), p.end(), _points + i * _stride );
+    }
   }
 
   PointCloud( PointCloud&& other )
@@ -69,27 +185,34 @@ public:
     return *this;
   }
 
-  ~PointCloud()
-  {
-    delete[] _points;
-  }
-
   friend void swap( PointCloud& pc1, PointCloud& pc2 ) noexcept
   {
     using std::swap;
 
+    swap( pc1._storage, pc2._storage );
     swap( pc1._points, pc2._points );
     swap( pc1._n,      pc2._n );
     swap( pc1._d,      pc2._d );
+    swap( pc1._stride, pc2._stride );
   }
 
   // Equality comparison -----------------------------------------------
 
   bool operator==( const PointCloud<T>& other ) const noexcept
   {
-    return    _n == other._n
-           && _d == other._d
-           && std::equal( _points, _points + _n * _d, other._points );
+    if( _n != other._n || _d != other._d )
+      return false;
+
+    for( std::size_t i = 0; i < _n; i++ )
+    {
+      auto p = this->point( i );
+      auto q = other.point( i );
+
+      if( !std::equal( p.begin(), p.end(), q.begin() ) )
+        return false;
+    }
+
+    return true;
   }
 
   // Attributes --------------------------------------------------------
@@ -104,6 +227,17 @@ public:
     return _d;
   }
 
+  /**
+    @returns Number of elements between the first coordinates of two
+    consecutive points. This is equal to the dimension unless the point
+    cloud uses padding.
+  */
+
+  IndexType stride() const noexcept
+  {
+    return _stride;
+  }
+
   bool empty() const noexcept
   {
     return _n == 0;
@@ -113,12 +247,24 @@ public:
 
   // This is slightly evil. The function is not really "bit-wise"
   // constant because it still permits modifying the pointer that
-  // is being returned.
+  // is being returned. Consecutive points are stride() elements
+  // apart.
   T* data() const noexcept
   {
     return _points;
   }
 
+  /**
+    Returns a view of the $i$th point of the point cloud. This does not
+    check the index because it is meant to be used in performance-critical
+    code.
+  */
+
+  Point point( IndexType i ) const noexcept
+  {
+    return Point( _points + i * _stride, _d );
+  }
+
   /**
     Sets $i$th point of point cloud. Throws if the number of dimensions
     does not match the number of dimensions in the point cloud.
@@ -135,7 +281,7 @@ public:
     if( static_cast<IndexType>( distance ) != this->dimension() )
       throw std::runtime_error( "Incorrect number of dimensions" );
 
-    std::copy( begin, end, _points + this->dimension() * i );
+    std::copy( begin, end, _points + _stride * i );
   }
 
   /** @overload set() */
@@ -155,7 +301,7 @@ public:
     if( i >= this->size() )
       throw std::runtime_error( "Invalid index" );
 
-    auto offset = i * this->dimension();
+    auto offset = i * _stride;
 
     std::copy( _points + offset, _points + offset + this->dimension(),
                result );
@@ -216,93 +362,119 @@ public:
   }
 
 private:
-  std::size_t _n; ///< Number of points
-  std::size_t _d; ///< Dimension
 
-  T* _points;
+  /** @returns Dimension, rounded up to a multiple of the alignment */
+  static std::size_t paddedDimension( std::size_t d ) noexcept
+  {
+    auto k = alignment / sizeof(T);
+    return k > 0 ? ( ( d + k - 1 ) / k ) * k : d;
+  }
+
+  /** Allocates aligned storage for all points */
+  void allocate()
+  {
+    auto size  = _n * _stride * sizeof(T);
+    auto space = size + alignment;
+
+    _storage = std::shared_ptr<void>( new unsigned char[ space ],
+                                      [] ( void* p )
+                                      {
+                                        delete[] static_cast<unsigned char*>( p );
+                                      } );
+
+    void* pointer = _storage.get();
+    _points       = static_cast<T*>( std::align( alignment, size, pointer, space ) );
+  }
+
+  std::size_t _n;      ///< Number of points
+  std::size_t _d;      ///< Dimension
+  std::size_t _stride; ///< Number of elements per point, including padding
+
+  std::shared_ptr<void> _storage; ///< Storage, or handle of external memory
+  T* _points;                     ///< Pointer to the first point
 };
 
 /**
   Loads a new point cloud from a file. The file is supposed to be in
   ASCII format. Each row must specify one item of the data set.  The
   different attributes of each item are assumed to be separated by a
-  comma or white-space characters.
-*/
+  comma or white-space characters. Empty rows and rows starting with
+  '#' are ignored.
 
-template<class T> PointCloud<T> load( const std::string& filename )
-{
-  std::ifstream in( filename );
+  The file is mapped into memory, and all rows are parsed in parallel
+  if OpenMP is available.
 
-  if( !in )
-    return PointCloud<T>();
+  @param filename Input filename
 
-  auto lines = std::count( std::istreambuf_iterator<char>( in ),
-                           std::istreambuf_iterator<char>(),
-                           '\n' );
+  @returns Point cloud, which is empty if the file cannot be read
 
-  in.clear();
-  in.seekg( 0 );
+  @throws std::runtime_error if the rows of the file do not have the same
+  number of attributes
+*/
 
-  if( lines <= 0 )
-    return PointCloud<T>();
+template<class T> PointCloud<T> load( const std::string& filename )
+{
+  std::unique_ptr<utilities::MemoryMappedFile> file;
 
-  // Recount all lines in the file, removing comments and empty lines
-  // from the calculation. Else, the code below allocates many points
-  // that will remain empty.
+  try
   {
-    std::string line;
-    while( std::getline( in, line ) )
-    {
-      line = utilities::trim( line );
-      if( line.empty() || line.front() == '#' )
-        lines -= 1;
-    }
+    file.reset( new utilities::MemoryMappedFile( filename ) );
+  }
+  catch( std::runtime_error& )
+  {
+    return PointCloud<T>();
   }
 
-  in.clear();
-  in.seekg( 0 );
+  const char* data = file->data();
+  const char* end  = data + file->size();
 
-  std::size_t i = 0;
-  std::size_t d = 0;
-  std::size_t n = static_cast<std::size_t>( lines );
+  // Determine the boundaries of all rows that contain data. Rows that
+  // are empty or only contain separators are skipped, as are comments.
+  std::vector< std::pair<const char*, const char*> > rows;
 
-  std::string line;
+  for( const char* begin = data; begin != end; )
+  {
+    auto next = static_cast<const char*>( std::memchr( begin, '\n', static_cast<std::size_t>( end - begin ) ) );
+    next      = next ? next : end;
 
-  PointCloud<T> pointCloud;
+    auto first = std::find_if_not( begin, next, utilities::isNumberSeparator );
 
-  while( std::getline( in, line ) )
-  {
-    line        = utilities::trim( line );
-    auto tokens = utilities::split( line, std::string( "[:;,[:space:]]+" ) );
+    if( first != next && *first != '#' )
+      rows.emplace_back( first, next );
 
-    // Skip comment lines or empty lines; while this is somewhat
-    // superfluous in most files (at least it is unlikely that a
-    // line in the middle of the file will be empty), the loader
-    // should handle empty lines at the end of the file.
-    if( line.empty() || line.front() == '#' || tokens.empty() )
-      continue;
+    begin = next != end ? next + 1 : end;
+  }
 
-    if( d == 0 )
-    {
-      d          = tokens.size();
-      pointCloud = PointCloud<T>( n, d );
-    }
+  if( rows.empty() )
+    return PointCloud<T>();
 
-    std::vector<T> coordinates;
-    coordinates.reserve( d );
+  auto n = rows.size();
+  auto d = utilities::parseNumbers<T>( rows.front().first, rows.front().second, nullptr );
 
-    for( auto&& token : tokens )
-    {
-      T coordinate = utilities::convert<T>( token );
-      coordinates.push_back( coordinate );
-    }
+  PointCloud<T> pointCloud( n, d );
 
-    pointCloud.set( i,
-                    coordinates.begin(), coordinates.end() );
+  auto points         = pointCloud.data();
+  std::size_t invalid = 0;
 
-    ++i;
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static) reduction(+:invalid)
+#endif
+  for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( n ); s++ )
+  {
+    auto i   = static_cast<std::size_t>( s );
+    auto&& r = rows[i];
+
+    // Counting first ensures that no row writes to the coordinates of
+    // another row.
+    if( utilities::parseNumbers<T>( r.first, r.second, static_cast<T*>( nullptr ) ) != d )
+      ++invalid;
+    else
+      utilities::parseNumbers<T>( r.first, r.second, points + i * d );
   }
 
+  if( invalid > 0 )
+    throw std::runtime_error( "Incorrect number of dimensions" );
+
   return pointCloud;
 }
 
@@ -326,7 +498,7 @@ template <class T> std::ostream& operator<<( std::ostream& o, const aleph::conta
   auto n = pointCloud.size();
   for( decltype(n) i = 0; i < n; i++ )
   {
-    auto data = pointCloud[i];
+    auto data = pointCloud.point( i );
 
     for( auto it = data.begin(); it != data.end(); ++it )
     {
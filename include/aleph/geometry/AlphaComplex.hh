@@ -0,0 +1,257 @@
+#ifndef ALEPH_GEOMETRY_ALPHA_COMPLEX_HH__
+#define ALEPH_GEOMETRY_ALPHA_COMPLEX_HH__
+
+#include <aleph/geometry/DelaunayTriangulation.hh>
+
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cmath>
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+namespace detail
+{
+
+/**
+  Calculates all simplices of the alpha complex of a Delaunay
+  triangulation, following the algorithm of Edelsbrunner and Mücke.
+  Every cell is assigned the squared radius of its circumsphere. Going
+  down in dimension, a face inherits the smallest value of all cofaces
+  that it is *attached* to, i.e. whose remaining vertex is contained in
+  the smallest circumsphere of the face. All other faces are assigned
+  the squared radius of their smallest circumsphere.
+
+  @returns Unsorted simplices, weighted by the diameter of their balls
+*/
+
+template <class Simplex, std::size_t D> std::vector<Simplex> alphaSimplices( const DelaunayTriangulation<D>& triangulation )
+{
+  using DataType   = typename Simplex::DataType;
+  using VertexType = typename Simplex::VertexType;
+
+  // Simplices are identified by their sorted vertices. Unused entries
+  // are set to the largest index so that all simplices can use the same
+  // type of key.
+  using Key = std::array<std::size_t, D+1>;
+
+  struct KeyHash
+  {
+    std::size_t operator()( const Key& key ) const noexcept
+    {
+      std::size_t seed = 0;
+
+      for( auto&& v : key )
+        seed ^= std::hash<std::size_t>()( v ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+
+      return seed;
+    }
+  };
+
+  // Stores the squared radius of every simplex, i.e. its filtration
+  // value, along with its smallest circumsphere. The filtration value
+  // is only valid once it has been assigned.
+  struct Value
+  {
+    long double squaredRadius;
+    bool assigned;
+
+    long double squaredCircumradius;
+    std::array<long double, D> centre;
+  };
+
+  using Map = std::unordered_map<Key, Value, KeyHash>;
+
+  std::vector<Map> simplices( D+1 );
+
+  auto makeValue = [&triangulation] ( const Key& key, std::size_t k )
+  {
+    std::array<const double*, D+1> points;
+
+    for( std::size_t i = 0; i <= k; i++ )
+      points[i] = triangulation.point( key[i] );
+
+    Value value;
+    value.assigned            = false;
+    value.squaredCircumradius = detail::circumsphere( points.data(), k+1, D, value.centre.data() );
+    value.squaredRadius       = value.squaredCircumradius;
+
+    return value;
+  };
+
+  // Removes the vertex at the given position from a key of a simplex with
+  // k+1 vertices
+  auto makeFace = [] ( const Key& key, std::size_t k, std::size_t position )
+  {
+    Key face;
+    face.fill( std::numeric_limits<std::size_t>::max() );
+
+    std::copy( key.begin(), key.begin() + static_cast<std::ptrdiff_t>( position ), face.begin() );
+    std::copy( key.begin() + static_cast<std::ptrdiff_t>( position+1 ), key.begin() + static_cast<std::ptrdiff_t>( k+1 ), face.begin() + static_cast<std::ptrdiff_t>( position ) );
+
+    return face;
+  };
+
+  for( auto&& cell : triangulation.cells() )
+  {
+    Key key = cell;
+    std::sort( key.begin(), key.end() );
+
+    auto value     = makeValue( key, D );
+    value.assigned = true;
+
+    simplices[D].insert( std::make_pair( key, value ) );
+  }
+
+  for( std::size_t k = D; k >= 2; k-- )
+  {
+    auto&& cofaces = simplices[k];
+    auto&& faces   = simplices[k-1];
+
+    faces.reserve( cofaces.size() * ( k+1 ) / 2 );
+
+    for( auto&& pair : cofaces )
+    {
+      auto&& coface = pair.first;
+      auto value    = pair.second.squaredRadius;
+
+      for( std::size_t i = 0; i <= k; i++ )
+      {
+        auto face = makeFace( coface, k, i );
+        auto it   = faces.find( face );
+
+        if( it == faces.end() )
+          it = faces.insert( std::make_pair( face, makeValue( face, k-1 ) ) ).first;
+
+        auto&& v = it->second;
+
+        if( v.assigned )
+          v.squaredRadius = std::min( v.squaredRadius, value );
+
+        // The face is attached to the coface if the remaining vertex is
+        // inside its smallest circumsphere. Faces that are not attached to
+        // any coface keep the squared radius of this sphere.
+        else if( detail::squaredDistance( triangulation.point( coface[i] ), v.centre.data(), D ) < v.squaredCircumradius )
+        {
+          v.squaredRadius = value;
+          v.assigned      = true;
+        }
+      }
+    }
+  }
+
+  // Round-off errors must not result in faces that appear after their
+  // cofaces, so the values are increased where necessary.
+  for( std::size_t k = 2; k <= D; k++ )
+  {
+    for( auto&& pair : simplices[k] )
+      for( std::size_t i = 0; i <= k; i++ )
+        pair.second.squaredRadius = std::max( pair.second.squaredRadius, simplices[k-1].at( makeFace( pair.first, k, i ) ).squaredRadius );
+  }
+
+  std::vector<Simplex> result;
+  result.reserve( triangulation.size() + triangulation.duplicates().size() + simplices[1].size() + simplices[2].size() + simplices[D].size() );
+
+  for( std::size_t i = 0; i < triangulation.size(); i++ )
+    result.push_back( Simplex( static_cast<VertexType>( i ) ) );
+
+  // Copies of points are connected to their original point immediately,
+  // so that they do not create additional connected components.
+  for( auto&& pair : triangulation.duplicates() )
+    result.push_back( Simplex( { static_cast<VertexType>( pair.first ), static_cast<VertexType>( pair.second ) } ) );
+
+  for( std::size_t k = 1; k <= D; k++ )
+  {
+    for( auto&& pair : simplices[k] )
+    {
+      std::vector<VertexType> vertices;
+
+      for( std::size_t i = 0; i <= k; i++ )
+        vertices.push_back( static_cast<VertexType>( pair.first[i] ) );
+
+      result.push_back( Simplex( vertices.begin(), vertices.end(), static_cast<DataType>( 2 * std::sqrt( pair.second.squaredRadius ) ) ) );
+    }
+
+    // Release memory as early as possible
+    simplices[k] = Map();
+  }
+
+  return result;
+}
+
+} // namespace detail
+
+/**
+  Calculates the alpha complex of a two-dimensional or three-dimensional
+  point cloud. The alpha complex is a subcomplex of the Delaunay
+  triangulation of the point cloud. For a given radius, it contains all
+  simplices whose vertices have a non-empty intersection of their balls
+  *restricted* to their Voronoi cells. It is homotopy-equivalent to the
+  Čech complex of the same radius, but its size is linear in the number
+  of points for most inputs.
+
+  In order to be consistent with buildCechComplex(), the simplices are
+  weighted by the *diameter* of the respective ball. Hence, the alpha
+  complex and the Čech complex of a point cloud result in the same
+  persistence diagrams.
+
+  Copies of a point do not participate in the triangulation. They are
+  connected to the original point by an edge of weight zero.
+
+  @param container Container that stores the input data
+
+  @returns Simplicial complex, sorted according to the weights of its
+  simplices
+
+  @throws std::runtime_error if the point cloud is neither two-dimensional
+  nor three-dimensional, or if its Delaunay triangulation cannot be
+  calculated
+*/
+
+template <class Container> auto buildAlphaComplex( const Container& container ) -> topology::SimplicialComplex< topology::Simplex<typename Container::ElementType, typename Container::IndexType> >
+{
+  using ElementType       = typename Container::ElementType;
+  using IndexType         = typename Container::IndexType;
+  using Simplex           = topology::Simplex<ElementType, IndexType>;
+  using SimplicialComplex = topology::SimplicialComplex<Simplex>;
+
+  std::vector<Simplex> simplices;
+
+  switch( container.dimension() )
+  {
+  case 2:
+    simplices = detail::alphaSimplices<Simplex>( DelaunayTriangulation<2>( container ) );
+    break;
+  case 3:
+    simplices = detail::alphaSimplices<Simplex>( DelaunayTriangulation<3>( container ) );
+    break;
+  default:
+    throw std::runtime_error( "Alpha complexes are only available for two-dimensional and three-dimensional point clouds" );
+  }
+
+  SimplicialComplex K;
+  K.bulkLoad( std::move( simplices ), topology::filtrations::Data<Simplex>() );
+
+  return K;
+}
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
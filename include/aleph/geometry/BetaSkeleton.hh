@@ -40,7 +40,7 @@ public:
   {
   }
 
-  template <class T > bool contains( const std::vector<T>& other ) const
+  template <class Point> bool contains( const Point& other ) const
   {
     double distance = 0.0;
 
@@ -84,8 +84,8 @@ public:
 
   bool contains( Index r ) const
   {
-    return _pBall.contains( _container[r] )
-        && _qBall.contains( _container[r] );
+    return _pBall.contains( _container.point( r ) )
+        && _qBall.contains( _container.point( r ) );
   }
 
 private:
@@ -135,11 +135,11 @@ template <class Distance, class Container, class Index = std::size_t>
 
   for( Index i = 0; i < n; i++ )
   {
-    auto&& p = container[i];
+    auto&& p = container.point( i );
 
     for( Index j = i+1; j < container.size(); j++ )
     {
-      auto&& q  = container[j];
+      auto&& q  = container.point( j );
       auto dist = traits.from( distance( p.begin(), q.begin(), d ) );
 
       using namespace detail;
@@ -57,16 +57,18 @@ public:
       // really need to traverse all pairs.
       for( IndexType j = 0; j < this->size(); j++ )
       {
-        auto d = dist( _container[i].begin(),
-                       _container[j].begin(),
+        auto d = dist( _container.point( i ).begin(),
+                       _container.point( j ).begin(),
                        D );
 
         d = _traits.from( d );
 
+        // Distance functors may accumulate their results in a type with
+        // a higher precision than the one of the container.
         if( d < radius )
         {
           indices[i].push_back( j );
-          distances[i].push_back( d );
+          distances[i].push_back( static_cast<ElementType>( d ) );
         }
       }
     }
@@ -92,14 +94,14 @@ public:
       // really need to traverse all pairs.
       for( IndexType j = 0; j < this->size(); j++ )
       {
-        auto d = dist( _container[i].begin(),
-                       _container[j].begin(),
+        auto d = dist( _container.point( i ).begin(),
+                       _container.point( j ).begin(),
                        D );
 
         d = _traits.from( d );
 
         indices[i].push_back( j );
-        distances[i].push_back( d );
+        distances[i].push_back( static_cast<ElementType>( d ) );
       }
 
       std::sort( indices[i].begin(), indices[i].end(),
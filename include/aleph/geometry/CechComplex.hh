@@ -1,8 +1,6 @@
 #ifndef ALEPH_GEOMETRY_CECH_COMPLEX_HH__
 #define ALEPH_GEOMETRY_CECH_COMPLEX_HH__
 
-#include <aleph/math/Combinations.hh>
-
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
@@ -10,7 +8,9 @@
 
 #include <aleph/external/Miniball.hpp>
 
-#include <numeric>
+#include <algorithm>
+#include <limits>
+#include <utility>
 #include <vector>
 
 #include <cmath>
@@ -21,74 +21,313 @@ namespace aleph
 namespace geometry
 {
 
-template <class Container> auto buildCechComplex( const Container& container, typename Container::ElementType r ) -> topology::SimplicialComplex< topology::Simplex<typename Container::ElementType, typename Container::IndexType> >
+namespace detail
+{
+
+/**
+  Stores all simplices of a given dimension of a Čech complex, along
+  with their minimum enclosing balls. Simplices are stored in a flat
+  layout and in lexicographical order of their (ascending) vertices,
+  which permits searching for faces by binary search.
+*/
+
+template <class T, class I> struct CechLevel
+{
+  /** Number of vertices of every simplex */
+  std::size_t k = 0;
+
+  /** Vertices of all simplices, using k vertices per simplex */
+  std::vector<I> vertices;
+
+  /** Centres of the minimum enclosing balls, using d coordinates per simplex */
+  std::vector<T> centres;
+
+  /** Squared radii of the minimum enclosing balls */
+  std::vector<T> squaredRadii;
+
+  std::size_t size() const noexcept
+  {
+    return squaredRadii.size();
+  }
+
+  /** Appends all simplices of another level */
+  void append( const CechLevel& other )
+  {
+    vertices.insert( vertices.end(), other.vertices.begin(), other.vertices.end() );
+    centres.insert( centres.end(), other.centres.begin(), other.centres.end() );
+    squaredRadii.insert( squaredRadii.end(), other.squaredRadii.begin(), other.squaredRadii.end() );
+  }
+
+  /**
+    @returns Index of the simplex with the given vertices, or the size of
+    the level if no such simplex exists
+  */
+
+  std::size_t find( const I* begin ) const
+  {
+    std::size_t lower = 0;
+    std::size_t upper = this->size();
+
+    while( lower < upper )
+    {
+      auto middle = lower + ( upper - lower ) / 2;
+      auto first  = vertices.data() + middle * k;
+
+      if( std::lexicographical_compare( first, first + k, begin, begin + k ) )
+        lower = middle + 1;
+      else
+        upper = middle;
+    }
+
+    if( lower < this->size() && std::equal( begin, begin + k, vertices.data() + lower * k ) )
+      return lower;
+    else
+      return this->size();
+  }
+};
+
+/** @returns Squared Euclidean distance between two points of dimension d */
+template <class T> T squaredDistance( const T* p, const T* q, std::size_t d )
+{
+  T result = T();
+
+  for( std::size_t i = 0; i < d; i++ )
+    result += ( p[i] - q[i] ) * ( p[i] - q[i] );
+
+  return result;
+}
+
+} // namespace detail
+
+/**
+  Calculates the Čech complex of a point cloud for a given radius. A
+  simplex is part of the Čech complex if the minimum enclosing ball of
+  its vertices has a radius of at most r. Every simplex is weighted by
+  the *diameter* of this ball. Vertices have a weight of zero.
+
+  Since the vertices of a Čech simplex have a pairwise distance of at
+  most 2r, they form a clique of the Vietoris--Rips complex at 2r. The
+  calculation thus starts from all pairs of points that satisfy this
+  condition and expands them one dimension at a time. A candidate is
+  only considered if all of its faces belong to the complex. Moreover,
+  if the new vertex of a candidate lies in the minimum enclosing ball
+  of the face it extends, this ball is re-used; the Miniball algorithm
+  is only used otherwise. All candidates of a dimension are processed
+  in parallel if OpenMP is available.
+
+  @param container Container that stores the input data
+  @param r         Radius of the balls
+  @param dimension Maximum dimension of the simplices; by default, the
+                   expansion continues until no more simplices can be
+                   added
+
+  @returns Simplicial complex, sorted according to the weights of its
+  simplices
+*/
+
+template <class Container> auto buildCechComplex( const Container& container,
+                                                  typename Container::ElementType r,
+                                                  unsigned dimension = std::numeric_limits<unsigned>::max() ) -> topology::SimplicialComplex< topology::Simplex<typename Container::ElementType, typename Container::IndexType> >
 {
   using ElementType       = typename Container::ElementType;
   using IndexType         = typename Container::IndexType;
   using Simplex           = topology::Simplex<ElementType, IndexType>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
+  using Level             = detail::CechLevel<ElementType, IndexType>;
+
+  auto D = static_cast<std::size_t>( container.dimension() );
+  auto n = static_cast<std::size_t>( container.size() );
+  auto R = r * r;
+
+  // Copy all points into a single block of memory because the container
+  // is not required to provide one.
+  std::vector<ElementType> points;
+  points.reserve( n * D );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    auto&& p = container.point( static_cast<IndexType>( i ) );
+    points.insert( points.end(), p.begin(), p.begin() + static_cast<std::ptrdiff_t>( D ) );
+  }
 
-  // Set up vertices for a combinatorial search over *all* potential
-  // simplices.
-  std::vector<IndexType> vertices( container.size() );
-  std::iota( vertices.begin(), vertices.end(),
-             IndexType(0) );
+  auto point = [&points, &D] ( IndexType i )
+  {
+    return points.data() + static_cast<std::size_t>( i ) * D;
+  };
 
   std::vector<Simplex> simplices;
+  simplices.reserve( n );
 
   // Add 0-skeleton ----------------------------------------------------
 
-  for( auto&& vertex : vertices )
-    simplices.push_back( Simplex( vertex ) );
+  for( std::size_t i = 0; i < n; i++ )
+    simplices.push_back( Simplex( static_cast<IndexType>( i ) ) );
 
   // Add 1-skeleton ----------------------------------------------------
   //
-  // We could obtain this faster by using nearest-neighbour queries, but
-  // let's remain in the same domain and calculate the complex similarly
-  // in *every* dimension.
+  // The neighbours of every point are the points with a larger index
+  // whose distance is at most 2r. They are sorted in ascending order.
+
+  std::vector< std::vector<IndexType> > neighbours( n );
 
-  auto D               = container.dimension();
-  auto n               = container.size();
-  auto R               = r * r;
-  using DifferenceType = typename decltype(vertices)::difference_type;
-  using Iterator       = typename decltype(vertices)::const_iterator;
+  Level level;
+  level.k = 2;
 
-  for( unsigned d = 2; d <= n; d++ )
+  if( dimension >= 1 )
   {
-    auto previous_n = simplices.size();
+    std::vector<Level> edges( n );
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( n ); s++ )
+    {
+      auto i = static_cast<std::size_t>( s );
 
-    math::for_each_combination( vertices.begin(), vertices.begin() + DifferenceType(d), vertices.end(),
-      [&container, &simplices, &D, &R] ( Iterator first, Iterator last )
+      for( std::size_t j = i+1; j < n; j++ )
       {
-        std::vector< std::vector<ElementType> > points;
-        for( Iterator it = first; it != last; ++it )
-          points.push_back( container[ *it ] );
+        auto d = detail::squaredDistance( point( static_cast<IndexType>( i ) ), point( static_cast<IndexType>( j ) ), D );
 
-        using PointIterator      = typename decltype(points)::const_iterator;
-        using CoordinateIterator = typename std::vector<ElementType>::const_iterator;
-        using Miniball           = Miniball::Miniball< Miniball::CoordAccessor<PointIterator, CoordinateIterator> >;
+        // The minimum enclosing ball of an edge is centred at the midpoint
+        // of the edge.
+        if( d <= 4 * R )
+        {
+          neighbours[i].push_back( static_cast<IndexType>( j ) );
+
+          edges[i].vertices.push_back( static_cast<IndexType>( i ) );
+          edges[i].vertices.push_back( static_cast<IndexType>( j ) );
+
+          for( std::size_t l = 0; l < D; l++ )
+            edges[i].centres.push_back( ( point( static_cast<IndexType>( i ) )[l] + point( static_cast<IndexType>( j ) )[l] ) / 2 );
+
+          edges[i].squaredRadii.push_back( d / 4 );
+        }
+      }
+    }
+
+    for( auto&& edge : edges )
+      level.append( edge );
+  }
+
+  // Expansion ---------------------------------------------------------
+  //
+  // Every simplex is extended by all common neighbours of its vertices
+  // that are larger than its largest vertex. Since simplices and their
+  // neighbours are processed in lexicographical order, the next level
+  // remains sorted.
+
+  while( level.size() > 0 )
+  {
+    auto k = level.k;
+
+    for( std::size_t i = 0; i < level.size(); i++ )
+    {
+      auto first = level.vertices.begin() + static_cast<std::ptrdiff_t>( i * k );
+
+      // The simplex class expects vertices in arbitrary order, so we
+      // can use the ascending order of the level.
+      simplices.push_back( Simplex( first, first + static_cast<std::ptrdiff_t>( k ), ElementType( 2 * std::sqrt( level.squaredRadii[i] ) ) ) );
+    }
+
+    if( k > dimension )
+      break;
+
+    std::vector<Level> next( level.size() );
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( level.size() ); s++ )
+    {
+      auto i        = static_cast<std::size_t>( s );
+      auto vertices = level.vertices.data() + i * k;
+      auto centre   = level.centres.data() + i * D;
+
+      std::vector<IndexType> candidate( k + 1 );
+      std::vector<IndexType> face( k );
+      std::vector<const ElementType*> candidatePoints( k + 1 );
 
-        Miniball mb( static_cast<int>(D), points.begin(), points.end() );
-        if( mb.squared_radius() <= R )
+      std::copy( vertices, vertices + k, candidate.begin() );
+
+      for( auto&& u : neighbours[ static_cast<std::size_t>( vertices[k-1] ) ] )
+      {
+        bool isClique = std::all_of( vertices, vertices + k - 1, [&neighbours, &u] ( IndexType v )
+          {
+            auto&& N = neighbours[ static_cast<std::size_t>( v ) ];
+            return std::binary_search( N.begin(), N.end(), u );
+          }
+        );
+
+        if( !isClique )
+          continue;
+
+        candidate[k] = u;
+
+        // All faces that contain the new vertex have to be part of the
+        // complex; the remaining face is the current simplex. The radius
+        // of the largest face is a lower bound for the radius of the ball.
+        bool hasFaces      = true;
+        auto squaredRadius = level.squaredRadii[i];
+
+        for( std::size_t j = 0; j < k && hasFaces; j++ )
+        {
+          auto it = std::copy( candidate.begin(), candidate.begin() + static_cast<std::ptrdiff_t>( j ), face.begin() );
+          std::copy( candidate.begin() + static_cast<std::ptrdiff_t>( j+1 ), candidate.end(), it );
+
+          auto index = level.find( face.data() );
+          hasFaces   = index < level.size();
+
+          if( hasFaces )
+            squaredRadius = std::max( squaredRadius, level.squaredRadii[index] );
+        }
+
+        if( !hasFaces )
+          continue;
+
+        auto&& result = next[i];
+
+        // The ball of the current simplex contains the new vertex, so it is
+        // the ball of the coface as well. Its value is still bounded by the
+        // faces, since round-off errors may result in a face containing the
+        // new vertex whose ball is slightly larger.
+        if( detail::squaredDistance( centre, point( u ), D ) <= level.squaredRadii[i] )
         {
-          Simplex s( first, last, ElementType( 2 * std::sqrt( mb.squared_radius() ) ) );
-          simplices.push_back( s );
+          result.vertices.insert( result.vertices.end(), candidate.begin(), candidate.end() );
+          result.centres.insert( result.centres.end(), centre, centre + D );
+          result.squaredRadii.push_back( squaredRadius );
         }
+        else
+        {
+          std::transform( candidate.begin(), candidate.end(), candidatePoints.begin(), point );
+
+          using PointIterator = typename std::vector<const ElementType*>::const_iterator;
+          using Miniball      = Miniball::Miniball< Miniball::CoordAccessor<PointIterator, const ElementType*> >;
 
-        return false;
+          Miniball mb( static_cast<int>( D ), candidatePoints.begin(), candidatePoints.end() );
+
+          // Prevent round-off errors from creating a coface whose ball is
+          // smaller than that of one of its faces.
+          squaredRadius = std::max( squaredRadius, mb.squared_radius() );
+
+          if( squaredRadius <= R )
+          {
+            result.vertices.insert( result.vertices.end(), candidate.begin(), candidate.end() );
+            result.centres.insert( result.centres.end(), mb.center(), mb.center() + D );
+            result.squaredRadii.push_back( squaredRadius );
+          }
+        }
       }
-    );
+    }
 
-    // Check whether we can stop adding simplices. If no additional
-    // simplices have been created during the last iteration, there
-    // is no need to continue the iteration.
-    auto current_n = simplices.size();
-    if( previous_n == current_n )
-      break;
+    level = Level();
+    level.k = k + 1;
+
+    for( auto&& part : next )
+      level.append( part );
   }
 
-  SimplicialComplex K( simplices.begin(), simplices.end() );
-  K.sort( topology::filtrations::Data<Simplex>() );
+  SimplicialComplex K;
+  K.bulkLoad( std::move( simplices ), topology::filtrations::Data<Simplex>() );
 
   return K;
 }
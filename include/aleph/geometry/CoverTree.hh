@@ -1,20 +1,25 @@
 #ifndef ALEPH_GEOMETRY_COVER_TREE_HH__
 #define ALEPH_GEOMETRY_COVER_TREE_HH__
 
+#include <aleph/geometry/NearestNeighbours.hh>
+
+#include <aleph/geometry/distances/Traits.hh>
+
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <limits>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <ostream>
 #include <queue>
 #include <stack>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-// FIXME: remove after debugging
-#include <iostream>
-
 #include <cassert>
 #include <cmath>
 
@@ -37,12 +42,27 @@ namespace geometry
   This implementation attempts to be as generic as possible. It uses
   the simplified description of the cover tree, as given by Izbicki,
   Shelton in "Faster Cover Trees".
+
+  Points are inserted into a pointer-based tree, either one at a time or
+  as a batch, which assigns points to subtrees level by level. Calling
+  build() stores the tree in a flat array of nodes, which is required
+  for the queries of the tree. Every subtree occupies a contiguous range
+  of this array, and every node knows an upper bound of the distance to
+  the points in its subtree. This bound is used to prune the queries.
+
+  The metric may carry a state. It is copied for every query, so it
+  does not have to provide a `const` call operator.
 */
 
 template <class Point, class Metric> class CoverTree
 {
 public:
 
+  /** Type of the distances that are calculated by the metric */
+  using DistanceType = typename std::decay<
+    decltype( std::declval<Metric&>()( std::declval<const Point&>(), std::declval<const Point&>() ) )
+  >::type;
+
   /**
     Covering constant of the cover tree. It might make sense to change
     this later on in order to improve performance. Some papers set the
@@ -80,20 +100,14 @@ public:
       return _children.empty();
     }
 
-    void insert( const Point& p )
+    void insert( const Point& p, Metric& metric )
     {
-      auto d = Metric()( _point, p );
-
-      std::cerr << __FUNCTION__ << ": Inserting " << p << "\n";
-      std::cerr << __FUNCTION__ << ": Covering distance           = " << this->coveringDistance() << "\n";
-      std::cerr << __FUNCTION__ << ": Distance from point to root = " << d << "\n";
+      auto d = static_cast<double>( metric( _point, p ) );
 
       if( d > this->coveringDistance() )
       {
         while( d > 2 * this->coveringDistance() )
         {
-          std::cerr << __FUNCTION__ << ": Distance is bigger than covering distance; need to raise level of tree\n";
-
           // -----------------------------------------------------------
           //
           // Find a leaf node that can become the new root node with
@@ -133,16 +147,11 @@ public:
             }
           }
 
-          std::cerr << __FUNCTION__ << ": Found leaf node " << leaf->_point << "\n";
-
           // There is no leaf, so there is nothing to do and we just
           // skip to the bottom where we add the current node as the
           // new root of the tree.
           if( !leaf )
-          {
-            std::cerr << __FUNCTION__ << ": Unable to identify leaf node\n";
             break;
-          }
 
           assert( leaf );
           assert( parent );
@@ -190,9 +199,7 @@ public:
 
           // Since the root of the tree changed, we also have to update
           // the distance calculation.
-          d = Metric()( _point, p );
-
-          std::cerr << __FUNCTION__ << ": " << leaf->_point << " is the new root\n";
+          d = static_cast<double>( metric( _point, p ) );
         }
 
         // Make current point the new root -----------------------------
@@ -216,7 +223,7 @@ public:
         return;
       }
 
-      return insert_( p );
+      return insert_( p, metric );
     }
 
     /**
@@ -224,18 +231,16 @@ public:
       node into the tree.
     */
 
-    void insert_( const Point& p )
+    void insert_( const Point& p, Metric& metric )
     {
       for( auto&& child : _children )
       {
-        auto d = Metric()( child->_point, p );
+        auto d = static_cast<double>( metric( child->_point, p ) );
         if( d <= child->coveringDistance() )
         {
-          std::cerr << __FUNCTION__ << ": Recursive enumeration of the tree\n";
-
           // We found a node in which the new point can be inserted
           // *without* violating the covering invariant.
-          child->insert_( p );
+          child->insert_( p, metric );
           return;
         }
       }
@@ -260,30 +265,251 @@ public:
     std::vector< std::unique_ptr<Node> > _children;
   };
 
+  /**
+    Node of the flat representation of the tree. Nodes are stored in
+    depth-first order, so the first child of a node follows the node
+    itself, and its next sibling follows the end of its subtree.
+  */
+
+  struct FlatNode
+  {
+    Point        point;       //< The point stored in the node
+    long         level;       //< The level of the node
+    std::size_t  end;         //< Index after the last node of the subtree
+    DistanceType maxDistance; //< Upper bound of the distance to a point of the subtree
+  };
+
+  /** Creates an empty cover tree that uses the given metric */
+  explicit CoverTree( Metric metric = Metric() )
+    : _metric( metric )
+  {
+  }
+
+  /**
+    Creates a cover tree from a sequence of points and builds its flat
+    representation, such that the tree can be queried immediately.
+  */
+
+  template <class InputIterator> CoverTree( InputIterator begin, InputIterator end, Metric metric = Metric() )
+    : _metric( metric )
+  {
+    this->insert( begin, end );
+    this->build();
+  }
+
   /**
     Inserts a new point into the cover tree. If the tree is empty,
     the new point will become the root of the tree. Else, it shall
     be inserted according to the covering invariant.
+
+    The flat representation of the tree is invalidated, so build() has
+    to be called again prior to querying the tree.
   */
 
   void insert( const Point& p )
   {
+    _nodes.clear();
+
     if( !_root )
       _root = std::unique_ptr<Node>( new Node(p,0) );
     else
-      _root->insert( p );
+      _root->insert( p, _metric );
   }
 
   /**
-    Inserts a sequence of points into the cover tree. This is just
-    a convenience function; no parallelization---or other advanced
-    techniques---will be used.
+    Inserts a sequence of points into the cover tree. If the tree is
+    empty, it is constructed as a batch: the first point becomes the
+    root, whose level is chosen such that it covers all other points.
+    Afterwards, the points of every node are distributed among its
+    children, processing all nodes of a level in parallel if OpenMP is
+    available. Otherwise, the points are inserted one after the other.
+
+    The flat representation of the tree is invalidated, so build() has
+    to be called again prior to querying the tree.
   */
 
   template <class InputIterator> void insert( InputIterator begin, InputIterator end )
   {
-    for( auto it = begin; it != end; ++it )
-      this->insert( *it );
+    if( _root )
+    {
+      for( auto it = begin; it != end; ++it )
+        this->insert( *it );
+    }
+    else if( begin != end )
+    {
+      _nodes.clear();
+      this->construct( std::vector<Point>( begin, end ) );
+    }
+  }
+
+  /**
+    Stores the tree in a flat array of nodes and calculates an upper
+    bound of the distance of every node to the points in its subtree.
+    Following the triangle inequality, the bound of a node is the
+    largest sum of the distance to one of its children and the bound of
+    that child, so only the distance along every edge of the tree has to
+    be calculated. These distances are calculated in parallel if OpenMP
+    is available. This function has to be called after the last
+    insertion and prior to any query.
+  */
+
+  void build()
+  {
+    _nodes.clear();
+
+    if( !_root )
+      return;
+
+    // Flatten the tree ------------------------------------------------
+    //
+    // Store nodes in pre-order, along with the index of their parent,
+    // such that the size of every subtree can be accumulated in a
+    // single pass over the nodes in reverse order.
+
+    std::vector<std::size_t> parents;
+    std::stack< std::pair<const Node*, std::size_t> > nodes;
+
+    nodes.push( std::make_pair( _root.get(), std::size_t(0) ) );
+
+    while( !nodes.empty() )
+    {
+      auto node   = nodes.top().first;
+      auto parent = nodes.top().second;
+
+      nodes.pop();
+
+      auto index = _nodes.size();
+
+      _nodes.push_back( { node->_point, node->_level, 1, DistanceType() } );
+      parents.push_back( parent );
+
+      for( auto it = node->_children.rbegin(); it != node->_children.rend(); ++it )
+        nodes.push( std::make_pair( it->get(), index ) );
+    }
+
+    for( std::size_t i = _nodes.size() - 1; i > 0; i-- )
+      _nodes[ parents[i] ].end += _nodes[i].end;
+
+    for( std::size_t i = 0; i < _nodes.size(); i++ )
+      _nodes[i].end += i;
+
+    // Calculate distance bounds ---------------------------------------
+    //
+    // Children are stored after their parents, so traversing the nodes
+    // in reverse order ensures that the bound of every child is known
+    // before it is propagated to the parent.
+
+    std::vector<DistanceType> edgeDistances( _nodes.size() );
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 256)
+#endif
+    for( std::ptrdiff_t s = 1; s < static_cast<std::ptrdiff_t>( _nodes.size() ); s++ )
+    {
+      auto i           = static_cast<std::size_t>( s );
+      auto metric      = _metric;
+      edgeDistances[i] = metric( _nodes[ parents[i] ].point, _nodes[i].point );
+    }
+
+    for( std::size_t i = _nodes.size() - 1; i > 0; i-- )
+    {
+      auto&& bound = _nodes[ parents[i] ].maxDistance;
+      bound        = std::max( bound, DistanceType( edgeDistances[i] + _nodes[i].maxDistance ) );
+    }
+  }
+
+  /** @returns true if the flat representation of the tree is available */
+  bool isBuilt() const noexcept
+  {
+    return !_root || !_nodes.empty();
+  }
+
+  /** @returns Nodes of the flat representation of the tree */
+  const std::vector<FlatNode>& nodes() const noexcept
+  {
+    return _nodes;
+  }
+
+  // Queries -----------------------------------------------------------
+
+  /**
+    Finds the k nearest neighbours of a point. The neighbours are sorted
+    by their distance to the point. If the tree contains the point, it
+    will be reported as well.
+
+    @param p         Query point
+    @param k         Number of neighbours
+    @param points    Output parameter for the neighbours
+    @param distances Output parameter for the distances of the neighbours
+
+    @throws std::runtime_error if the tree has not been built
+  */
+
+  void neighbourSearch( const Point& p,
+                        unsigned k,
+                        std::vector<Point>& points,
+                        std::vector<DistanceType>& distances ) const
+  {
+    this->report( this->nearestNodes( p, k ), points, distances );
+  }
+
+  /**
+    Finds all points whose distance to a point is *less* than a given
+    radius. The points are sorted by their distance to the point.
+
+    @param p         Query point
+    @param radius    Radius of the query
+    @param points    Output parameter for the points
+    @param distances Output parameter for the distances of the points
+
+    @throws std::runtime_error if the tree has not been built
+  */
+
+  void radiusSearch( const Point& p,
+                     DistanceType radius,
+                     std::vector<Point>& points,
+                     std::vector<DistanceType>& distances ) const
+  {
+    this->report( this->nodesInRadius( p, radius ), points, distances );
+  }
+
+  /**
+    Finds the k nearest neighbours of a sequence of query points. The
+    queries are processed in parallel if OpenMP is available.
+
+    @see neighbourSearch()
+  */
+
+  void neighbourSearch( const std::vector<Point>& queries,
+                        unsigned k,
+                        std::vector< std::vector<Point> >& points,
+                        std::vector< std::vector<DistanceType> >& distances ) const
+  {
+    this->search( queries, points, distances, [this, &k] ( const Point& p )
+      {
+        return this->nearestNodes( p, k );
+      }
+    );
+  }
+
+  /**
+    Finds all points within a given radius for a sequence of query
+    points. The queries are processed in parallel if OpenMP is
+    available.
+
+    @see radiusSearch()
+  */
+
+  void radiusSearch( const std::vector<Point>& queries,
+                     DistanceType radius,
+                     std::vector< std::vector<Point> >& points,
+                     std::vector< std::vector<DistanceType> >& distances ) const
+  {
+    this->search( queries, points, distances, [this, &radius] ( const Point& p )
+      {
+        return this->nodesInRadius( p, radius );
+      }
+    );
   }
 
   // Pretty-printing function for the tree; this is only meant for
@@ -498,15 +724,9 @@ public:
 
         for( auto&& child : parent->_children )
         {
-          auto d = Metric()( parent->_point, child->_point );
+          auto d = Metric( _metric )( parent->_point, child->_point );
           if( d > parent->coveringDistance() )
-          {
-            std::cerr << __FUNCTION__ << ": Covering invariant is violated by ("
-                      << parent->_point << "," << child->_point << "): "
-                      << d << " > " << parent->coveringDistance() << "\n";
-
             return false;
-          }
 
           nodes.push( child.get() );
         }
@@ -548,16 +768,10 @@ public:
 
             auto&& p = (*it1)->_point;
             auto&& q = (*it2)->_point;
-            auto d   = Metric()(p, q);
+            auto d   = Metric( _metric )(p, q);
 
             if( d <= parent->separatingDistance() )
-            {
-              std::cerr << __FUNCTION__ << ": Separating invariant is violated by ("
-                        << p << "," << q << "): "
-                        << d << " > " << parent->separatingDistance() << "\n";
-
               return false;
-            }
           }
 
           // Add the child such that the next level of the tree can be
@@ -599,7 +813,6 @@ public:
   bool isHarmonic( const Point& p ) /* FIXME const */ noexcept
   {
     std::vector<double> distances;
-    std::vector<double> ancestorDistances;
 
     auto current  = _root.get();
     auto previous = _root.get();
@@ -609,19 +822,15 @@ public:
       // Need to evaluate the distance to the current node *once* at
       // this point. Since we select another `current` node later on
       // it is ensured that we only store the distance *once*.
-      auto d = Metric()( p, current->_point );
+      auto d = _metric( p, current->_point );
       if( d <= current->coveringDistance() )
         distances.push_back( static_cast<double>( d ) );
 
       for( auto&& child : current->_children )
       {
-        auto d = Metric()( p, child->_point );
+        auto d = _metric( p, child->_point );
         if( d <= child->coveringDistance() )
         {
-          ancestorDistances.push_back(
-            Metric()( _root->_point, child->_point )
-          );
-
           // Continue the recursion in the next level, using the current
           // node as a new root.
           current = child.get();
@@ -640,12 +849,6 @@ public:
         std::less_equal<double>()
       );
 
-    for( auto&& d : ancestorDistances )
-      std::cerr << "AD = " << d << "\n";
-
-    if( !harmonic )
-      std::cerr << __FUNCTION__ << ": " << current->_point << " is not harmonic\n";
-
     // FIXME: this is not the proper place for this check, but it is
     // easier at the moment
     if( distances.size() >= 2 )
@@ -665,8 +868,6 @@ public:
       // new root.
       if( l < this->level() )
       {
-        std::cerr << "Replacing root node with " << current->_point << "\n";
-
         auto allPoints = this->points();
 
         allPoints.erase(
@@ -676,10 +877,10 @@ public:
 
         // Sort points in *descending* distance from the new root node
         std::sort( allPoints.begin(), allPoints.end(),
-          [&current] ( const Point& p, const Point& q )
+          [this, &current] ( const Point& p, const Point& q )
           {
-            auto dp = Metric()( current->_point, p );
-            auto dq = Metric()( current->_point, q );
+            auto dp = _metric( current->_point, p );
+            auto dq = _metric( current->_point, q );
 
             return dp > dq;
           }
@@ -695,27 +896,46 @@ public:
     return harmonic;
   }
 
-  bool checkDistance( const Point& p ) const noexcept
+  /**
+    Follows the path of a point through the tree, descending into the
+    first child that covers the point, and reports the distances that
+    are encountered along this path.
+
+    @param p             Query point
+    @param rootDistances Output parameter for the distances between the
+                         root and every node of the path
+    @param edgeDistances Output parameter for the distances between the
+                         query point and every node of the path
+  */
+
+  void pathDistances( const Point& p,
+                      std::vector<double>& rootDistances,
+                      std::vector<double>& edgeDistances ) const
   {
-    std::vector<double> edgeDistances;
-    std::vector<double> rootDistances;
+    rootDistances.clear();
+    edgeDistances.clear();
+
+    if( !_root )
+      return;
+
+    auto metric = _metric;
 
     auto current  = _root.get();
     auto previous = _root.get();
 
     while( current )
     {
-      auto d = Metric()( p, current->_point );
+      auto d = metric( p, current->_point );
       if( d <= current->coveringDistance() )
         edgeDistances.push_back( static_cast<double>( d ) );
 
       for( auto&& child : current->_children )
       {
-        auto d = Metric()( p, child->_point );
+        auto d = metric( p, child->_point );
         if( d <= child->coveringDistance() )
         {
           rootDistances.push_back(
-            Metric()( _root->_point, child->_point )
+            static_cast<double>( metric( _root->_point, child->_point ) )
           );
 
           // Continue the recursion in the next level, using the current
@@ -731,19 +951,6 @@ public:
         previous = current;
     }
 
-    std::cerr << "Point = " << p << "\n";
-
-    std::cerr << "  root distances:\n";
-    for( auto&& d : rootDistances )
-      std::cerr << d << " ";
-    std::cerr << "\n";
-
-    std::cerr << "  edge distances:\n";
-    for( auto&& d : edgeDistances )
-      std::cerr << d << " ";
-    std::cerr << "\n";
-
-    return true;
   }
 
 private:
@@ -759,8 +966,391 @@ private:
     return std::pow( coveringConstant, static_cast<double>( level ) );
   }
 
+  /**
+    Constructs the tree from a batch of points. The first point becomes
+    the root, and its level is the smallest one that covers all points.
+    Every node then distributes its points among its children: a point
+    is assigned to the first child that covers it, or it becomes a new
+    child. This is the same choice as the one made by Node::insert_(),
+    so the tree satisfies all invariants. The nodes of every level are
+    independent of each other, so they are processed in parallel.
+  */
+
+  void construct( std::vector<Point> points )
+  {
+    auto root = points.front();
+
+    DistanceType maxDistance = DistanceType();
+
+    {
+      auto metric = _metric;
+
+      for( auto&& p : points )
+        maxDistance = std::max( maxDistance, metric( root, p ) );
+    }
+
+    long level = 0;
+
+    if( maxDistance > DistanceType() )
+    {
+      auto d = static_cast<double>( maxDistance );
+
+      while( d > this->coveringDistance( level ) )
+        ++level;
+
+      while( d <= this->coveringDistance( level - 1 ) )
+        --level;
+    }
+
+    _root = std::unique_ptr<Node>( new Node( root, level ) );
+
+    // Nodes of the current level, along with the points that have yet
+    // to be distributed among their children.
+    using Batch = std::pair< Node*, std::vector<Point> >;
+
+    std::vector<Batch> batches;
+    batches.push_back( Batch( _root.get(), std::vector<Point>( points.begin() + 1, points.end() ) ) );
+
+    while( !batches.empty() )
+    {
+      std::vector< std::vector<Batch> > children( batches.size() );
+
+#ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic)
+#endif
+      for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( batches.size() ); s++ )
+      {
+        auto i      = static_cast<std::size_t>( s );
+        auto metric = _metric;
+        auto node   = batches[i].first;
+
+        for( auto&& p : batches[i].second )
+        {
+          bool covered = false;
+
+          for( std::size_t c = 0; c < node->_children.size(); c++ )
+          {
+            auto&& child = node->_children[c];
+
+            if( static_cast<double>( metric( child->_point, p ) ) <= child->coveringDistance() )
+            {
+              children[i][c].second.push_back( p );
+              covered = true;
+              break;
+            }
+          }
+
+          if( !covered )
+          {
+            node->_children.push_back( std::unique_ptr<Node>( new Node( p, node->_level - 1 ) ) );
+            children[i].push_back( Batch( node->_children.back().get(), std::vector<Point>() ) );
+          }
+        }
+
+        batches[i].second.clear();
+        batches[i].second.shrink_to_fit();
+      }
+
+      batches.clear();
+
+      for( auto&& batch : children )
+      {
+        for( auto&& child : batch )
+        {
+          if( !child.second.empty() )
+            batches.push_back( std::move( child ) );
+        }
+      }
+    }
+  }
+
+  /** Pair of a distance and an index of the flat representation */
+  using Candidate = std::pair<DistanceType, std::size_t>;
+
+  /**
+    Finds the k nodes that are closest to a point. Subtrees are visited
+    in ascending order of the distance to their root. A subtree is only
+    visited if the largest distance of its root permits it to contain a
+    point that is closer than the current k-th neighbour.
+  */
+
+  std::vector<Candidate> nearestNodes( const Point& p, unsigned k ) const
+  {
+    if( !this->isBuilt() )
+      throw std::runtime_error( "Cover tree has to be built prior to querying it" );
+
+    std::vector<Candidate> result;
+
+    if( _nodes.empty() || k == 0 )
+      return result;
+
+    auto metric = _metric;
+
+    // Max-heap of the current neighbours; its top is the k-th neighbour
+    // once the heap is full.
+    std::priority_queue<Candidate> heap;
+
+    auto offer = [&heap, &k] ( const Candidate& candidate )
+    {
+      if( heap.size() < k )
+        heap.push( candidate );
+      else if( candidate < heap.top() )
+      {
+        heap.pop();
+        heap.push( candidate );
+      }
+    };
+
+    std::vector<Candidate> stack;
+    stack.push_back( std::make_pair( metric( p, _nodes.front().point ), std::size_t(0) ) );
+
+    offer( stack.back() );
+
+    while( !stack.empty() )
+    {
+      auto d = stack.back().first;
+      auto i = stack.back().second;
+
+      stack.pop_back();
+
+      if( heap.size() == k && d > heap.top().first + _nodes[i].maxDistance )
+        continue;
+
+      auto first = stack.size();
+
+      for( auto c = i+1; c < _nodes[i].end; c = _nodes[c].end )
+      {
+        stack.push_back( std::make_pair( metric( p, _nodes[c].point ), c ) );
+        offer( stack.back() );
+      }
+
+      // Closer children are visited first because they are more likely to
+      // decrease the distance to the k-th neighbour.
+      std::sort( stack.begin() + static_cast<std::ptrdiff_t>( first ), stack.end(), std::greater<Candidate>() );
+    }
+
+    result.reserve( heap.size() );
+
+    while( !heap.empty() )
+    {
+      result.push_back( heap.top() );
+      heap.pop();
+    }
+
+    std::reverse( result.begin(), result.end() );
+    return result;
+  }
+
+  /**
+    Finds all nodes whose distance to a point is less than the given
+    radius. A subtree is only visited if the largest distance of its
+    root permits it to contain such a node.
+  */
+
+  std::vector<Candidate> nodesInRadius( const Point& p, DistanceType radius ) const
+  {
+    if( !this->isBuilt() )
+      throw std::runtime_error( "Cover tree has to be built prior to querying it" );
+
+    std::vector<Candidate> result;
+
+    if( _nodes.empty() )
+      return result;
+
+    auto metric = _metric;
+
+    std::vector<Candidate> stack;
+    stack.push_back( std::make_pair( metric( p, _nodes.front().point ), std::size_t(0) ) );
+
+    while( !stack.empty() )
+    {
+      auto d = stack.back().first;
+      auto i = stack.back().second;
+
+      stack.pop_back();
+
+      if( d < radius )
+        result.push_back( std::make_pair( d, i ) );
+
+      if( d >= radius + _nodes[i].maxDistance )
+        continue;
+
+      for( auto c = i+1; c < _nodes[i].end; c = _nodes[c].end )
+        stack.push_back( std::make_pair( metric( p, _nodes[c].point ), c ) );
+    }
+
+    std::sort( result.begin(), result.end() );
+    return result;
+  }
+
+  /** Converts nodes of the flat representation into points and distances */
+  void report( const std::vector<Candidate>& candidates,
+               std::vector<Point>& points,
+               std::vector<DistanceType>& distances ) const
+  {
+    points.clear();
+    distances.clear();
+
+    points.reserve( candidates.size() );
+    distances.reserve( candidates.size() );
+
+    for( auto&& candidate : candidates )
+    {
+      points.push_back( _nodes[ candidate.second ].point );
+      distances.push_back( candidate.first );
+    }
+  }
+
+  /** Runs a query for a sequence of points, using OpenMP if available */
+  template <class Query> void search( const std::vector<Point>& queries,
+                                      std::vector< std::vector<Point> >& points,
+                                      std::vector< std::vector<DistanceType> >& distances,
+                                      Query query ) const
+  {
+    if( !this->isBuilt() )
+      throw std::runtime_error( "Cover tree has to be built prior to querying it" );
+
+    points.clear();
+    distances.clear();
+
+    points.resize( queries.size() );
+    distances.resize( queries.size() );
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( queries.size() ); s++ )
+    {
+      auto i = static_cast<std::size_t>( s );
+      this->report( query( queries[i] ), points[i], distances[i] );
+    }
+  }
+
+  /** Metric for distance calculations */
+  Metric _metric;
+
   /** Root pointer of the tree */
   std::unique_ptr<Node> _root;
+
+  /** Flat representation of the tree in depth-first order */
+  std::vector<FlatNode> _nodes;
+};
+
+/**
+  @class CoverTreeIndex
+  @brief Permits the calculation of nearest neighbours using a cover tree
+
+  This class creates a cover tree over the indices of the points in a
+  container, which makes it possible to use a cover tree whenever the
+  nearest neighbours interface is required, for example in order to
+  calculate a Vietoris--Rips skeleton. Since a cover tree only relies on
+  the triangle inequality, this works for arbitrary metrics, whereas a
+  kd-tree requires the distance to be evaluated coordinate-wise.
+
+  The points of the container are copied into a contiguous block of
+  memory upon construction. All queries are processed in parallel if
+  OpenMP is available.
+*/
+
+template <class Container, class DistanceFunctor>
+class CoverTreeIndex : public NearestNeighbours< CoverTreeIndex<Container, DistanceFunctor>, std::size_t, typename Container::ElementType >
+{
+public:
+  using IndexType       = std::size_t;
+  using ElementType     = typename Container::ElementType;
+  using Traits          = aleph::geometry::distances::Traits<DistanceFunctor>;
+  using Distance        = DistanceFunctor;
+
+  explicit CoverTreeIndex( const Container& container )
+    : _dimension( static_cast<std::size_t>( container.dimension() ) )
+    , _tree( Metric( this ) )
+  {
+    auto n = static_cast<std::size_t>( container.size() );
+
+    _points.reserve( n * _dimension );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      auto&& p = container.point( i );
+      _points.insert( _points.end(), p.begin(), p.begin() + static_cast<std::ptrdiff_t>( _dimension ) );
+    }
+
+    std::vector<IndexType> indices( n );
+    std::iota( indices.begin(), indices.end(), IndexType() );
+
+    _tree.insert( indices.begin(), indices.end() );
+    _tree.build();
+  }
+
+  // The metric of the tree refers to the current instance, so it must
+  // not be copied.
+  CoverTreeIndex( const CoverTreeIndex& )            = delete;
+  CoverTreeIndex& operator=( const CoverTreeIndex& ) = delete;
+
+  void radiusSearch( ElementType radius,
+                     std::vector< std::vector<IndexType> >& indices,
+                     std::vector< std::vector<ElementType> >& distances ) const
+  {
+    _tree.radiusSearch( this->queries(), radius, indices, distances );
+  }
+
+  void neighbourSearch( unsigned k,
+                        std::vector< std::vector<IndexType> >& indices,
+                        std::vector< std::vector<ElementType> >& distances ) const
+  {
+    _tree.neighbourSearch( this->queries(), k, indices, distances );
+  }
+
+  std::size_t size() const noexcept
+  {
+    return _dimension > 0 ? _points.size() / _dimension : 0;
+  }
+
+private:
+
+  /** Evaluates the distance functor for two indices */
+  class Metric
+  {
+  public:
+    explicit Metric( const CoverTreeIndex* index = nullptr )
+      : _index( index )
+    {
+    }
+
+    ElementType operator()( IndexType i, IndexType j ) const
+    {
+      auto&& points = _index->_points;
+      auto D        = _index->_dimension;
+
+      return static_cast<ElementType>( _traits.from( _distance( points.data() + i * D, points.data() + j * D, D ) ) );
+    }
+
+  private:
+    const CoverTreeIndex* _index;
+
+    DistanceFunctor _distance;
+    Traits          _traits;
+  };
+
+  /** @returns Indices of all points, used as queries */
+  std::vector<IndexType> queries() const
+  {
+    std::vector<IndexType> result( this->size() );
+
+    for( std::size_t i = 0; i < result.size(); i++ )
+      result[i] = i;
+
+    return result;
+  }
+
+  /** Dimension of the points */
+  std::size_t _dimension;
+
+  /** Coordinates of all points, stored contiguously */
+  std::vector<ElementType> _points;
+
+  /** Cover tree over the indices of the points */
+  CoverTree<IndexType, Metric> _tree;
 };
 
 } // namespace geometry
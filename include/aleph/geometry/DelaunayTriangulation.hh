@@ -0,0 +1,753 @@
+#ifndef ALEPH_GEOMETRY_DELAUNAY_TRIANGULATION_HH__
+#define ALEPH_GEOMETRY_DELAUNAY_TRIANGULATION_HH__
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cmath>
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+namespace detail
+{
+
+/**
+  Calculates the determinant of a small square matrix by Gaussian
+  elimination with partial pivoting. The matrix is modified.
+*/
+
+template <std::size_t N> long double determinant( std::array< std::array<long double, N>, N >& A )
+{
+  long double result = 1;
+
+  for( std::size_t j = 0; j < N; j++ )
+  {
+    std::size_t pivot = j;
+
+    for( std::size_t i = j+1; i < N; i++ )
+      if( std::abs( A[i][j] ) > std::abs( A[pivot][j] ) )
+        pivot = i;
+
+    if( A[pivot][j] == 0 )
+      return 0;
+
+    if( pivot != j )
+    {
+      std::swap( A[pivot], A[j] );
+      result = -result;
+    }
+
+    result *= A[j][j];
+
+    for( std::size_t i = j+1; i < N; i++ )
+    {
+      auto factor = A[i][j] / A[j][j];
+
+      for( std::size_t k = j+1; k < N; k++ )
+        A[i][k] -= factor * A[j][k];
+    }
+  }
+
+  return result;
+}
+
+/**
+  Calculates the smallest circumsphere of a simplex, i.e. the sphere
+  that passes through all vertices of the simplex and whose centre is
+  contained in the affine hull of the simplex.
+
+  @param points Coordinates of the vertices of the simplex
+  @param n      Number of vertices; at most four vertices are supported
+  @param D      Dimension of the ambient space
+  @param centre Output parameter for the D coordinates of the centre
+
+  @returns Squared radius of the sphere, or infinity if the vertices
+  are not affinely independent
+*/
+
+inline long double circumsphere( const double* const* points, std::size_t n, std::size_t D, long double* centre )
+{
+  auto k  = n - 1;
+  auto p0 = points[0];
+
+  // Solve the system G x = b, where G is the Gram matrix of all edges
+  // incident to the first vertex, and b contains the squared lengths
+  // of these edges. The centre is a linear combination of the edges.
+  std::array< std::array<long double, 4>, 3> G;
+
+  for( std::size_t i = 0; i < k; i++ )
+  {
+    for( std::size_t j = 0; j < k; j++ )
+    {
+      long double sum = 0;
+
+      for( std::size_t l = 0; l < D; l++ )
+        sum += ( static_cast<long double>( points[i+1][l] ) - p0[l] ) * ( static_cast<long double>( points[j+1][l] ) - p0[l] );
+
+      G[i][j] = 2 * sum;
+    }
+
+    G[i][k] = G[i][i] / 2;
+  }
+
+  for( std::size_t j = 0; j < k; j++ )
+  {
+    std::size_t pivot = j;
+
+    for( std::size_t i = j+1; i < k; i++ )
+      if( std::abs( G[i][j] ) > std::abs( G[pivot][j] ) )
+        pivot = i;
+
+    if( G[pivot][j] == 0 )
+      return std::numeric_limits<long double>::infinity();
+
+    std::swap( G[pivot], G[j] );
+
+    for( std::size_t i = 0; i < k; i++ )
+    {
+      if( i == j )
+        continue;
+
+      auto factor = G[i][j] / G[j][j];
+
+      for( std::size_t l = j; l <= k; l++ )
+        G[i][l] -= factor * G[j][l];
+    }
+  }
+
+  std::copy( p0, p0 + D, centre );
+
+  long double squaredRadius = 0;
+
+  for( std::size_t l = 0; l < D; l++ )
+  {
+    long double offset = 0;
+
+    for( std::size_t i = 0; i < k; i++ )
+      offset += G[i][k] / G[i][i] * ( static_cast<long double>( points[i+1][l] ) - p0[l] );
+
+    centre[l]     += offset;
+    squaredRadius += offset * offset;
+  }
+
+  return squaredRadius;
+}
+
+/** @overload circumsphere() */
+inline long double circumsphere( const std::vector<const double*>& points, std::size_t D, std::vector<long double>& centre )
+{
+  centre.resize( D );
+  return circumsphere( points.data(), points.size(), D, centre.data() );
+}
+
+/** @returns Squared distance between a point and a centre of a sphere */
+inline long double squaredDistance( const double* p, const long double* centre, std::size_t D )
+{
+  long double result = 0;
+
+  for( std::size_t l = 0; l < D; l++ )
+    result += ( p[l] - centre[l] ) * ( p[l] - centre[l] );
+
+  return result;
+}
+
+/** @overload squaredDistance() */
+inline long double squaredDistance( const double* p, const std::vector<long double>& centre )
+{
+  return squaredDistance( p, centre.data(), centre.size() );
+}
+
+} // namespace detail
+
+/**
+  @class DelaunayTriangulation
+  @brief Delaunay triangulation of a point cloud in two or three dimensions
+
+  The triangulation is calculated by incremental insertion following
+  the Bowyer--Watson algorithm: every new point removes all cells whose
+  circumsphere contains it, and the resulting cavity is re-triangulated
+  by connecting its boundary with the new point. Cells are located by a
+  randomized visibility walk, starting from the last cell that has been
+  created, while points are inserted along a space-filling curve. This
+  keeps the walks short for most inputs.
+
+  The convex hull is handled by an additional vertex at infinity, which
+  is part of all cells outside of the hull. These cells are not reported
+  by the triangulation.
+
+  Geometric predicates are evaluated in extended precision, but they are
+  not exact. Points with identical coordinates are only inserted once,
+  and the remaining copies are reported as duplicates.
+
+  @tparam D Dimension of the point cloud; must be 2 or 3
+*/
+
+template <std::size_t D> class DelaunayTriangulation
+{
+public:
+  static_assert( D == 2 || D == 3, "Delaunay triangulations are only available in two and three dimensions" );
+
+  /** Cell of the triangulation, described by the indices of its vertices */
+  using Cell = std::array<std::size_t, D+1>;
+
+  /**
+    Calculates the Delaunay triangulation of a point cloud.
+
+    @param container Container that stores the input data; it must have
+                     the same dimension as the triangulation
+
+    @throws std::runtime_error if the dimension of the container does not
+    match, if the point cloud is degenerate (e.g. all points are collinear),
+    or if the triangulation fails because of round-off errors
+  */
+
+  template <class Container> explicit DelaunayTriangulation( const Container& container )
+  {
+    if( static_cast<std::size_t>( container.dimension() ) != D )
+      throw std::runtime_error( "Dimension of point cloud does not match dimension of triangulation" );
+
+    auto n = static_cast<std::size_t>( container.size() );
+
+    _points.reserve( n * D );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      auto&& p = container.point( static_cast<decltype( container.size() )>( i ) );
+
+      for( std::size_t l = 0; l < D; l++ )
+        _points.push_back( static_cast<double>( *( p.begin() + static_cast<std::ptrdiff_t>( l ) ) ) );
+    }
+
+    this->triangulate();
+  }
+
+  /** @returns Number of points, including duplicates */
+  std::size_t size() const noexcept
+  {
+    return _points.size() / D;
+  }
+
+  /** @returns Coordinates of the point with the given index */
+  const double* point( std::size_t i ) const noexcept
+  {
+    return _points.data() + i * D;
+  }
+
+  /** @returns All finite cells of the triangulation */
+  std::vector<Cell> cells() const
+  {
+    std::vector<Cell> result;
+
+    for( std::size_t c = 0; c < _cells.size(); c++ )
+      if( _alive[c] && !this->isInfinite( c ) )
+        result.push_back( _cells[c] );
+
+    return result;
+  }
+
+  /**
+    @returns Pairs of indices of points that are not part of the
+    triangulation because they are copies of another point, together
+    with the index of this point
+  */
+
+  const std::vector< std::pair<std::size_t, std::size_t> >& duplicates() const noexcept
+  {
+    return _duplicates;
+  }
+
+private:
+  static constexpr std::size_t infinite = std::numeric_limits<std::size_t>::max();
+
+  using Points = std::array<const double*, D+1>;
+
+  /** Facet of the boundary of a cavity, given by a cell and the position of the opposite vertex */
+  using Facet = std::pair<std::size_t, std::size_t>;
+
+  /** Ridge of a new cell, i.e. a face of co-dimension two, used for linking new cells */
+  struct Ridge
+  {
+    std::array<std::size_t, D-1> vertices;
+    std::size_t cell;
+    std::size_t position;
+
+    bool operator<( const Ridge& other ) const noexcept
+    {
+      return vertices < other.vertices;
+    }
+  };
+
+  void triangulate()
+  {
+    auto n = this->size();
+
+    // Remove duplicates -----------------------------------------------
+
+    std::vector<std::size_t> indices( n );
+    std::iota( indices.begin(), indices.end(), std::size_t(0) );
+
+    std::stable_sort( indices.begin(), indices.end(), [this] ( std::size_t i, std::size_t j )
+      {
+        return std::lexicographical_compare( this->point(i), this->point(i) + D, this->point(j), this->point(j) + D );
+      }
+    );
+
+    std::vector<std::size_t> unique;
+    std::size_t original = 0;
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      if( i > 0 && std::equal( this->point( indices[i] ), this->point( indices[i] ) + D, this->point( indices[i-1] ) ) )
+        _duplicates.push_back( std::make_pair( indices[i], original ) );
+      else
+      {
+        original = indices[i];
+        unique.push_back( original );
+      }
+    }
+
+    // Spatial sort ----------------------------------------------------
+
+    this->sortSpatially( unique );
+
+    // Initial cell ----------------------------------------------------
+    //
+    // Find D+1 affinely independent points and create a first cell from
+    // them, along with the infinite cells of its facets.
+
+    std::vector<std::size_t> initial;
+
+    for( auto&& index : unique )
+    {
+      if( initial.size() == D+1 )
+        break;
+
+      initial.push_back( index );
+
+      std::vector<const double*> points;
+      for( auto&& i : initial )
+        points.push_back( this->point(i) );
+
+      std::vector<long double> centre;
+
+      if( initial.size() >= 2 && !std::isfinite( detail::circumsphere( points, D, centre ) ) )
+        initial.pop_back();
+    }
+
+    if( initial.size() != D+1 )
+      throw std::runtime_error( "Unable to triangulate degenerate point cloud" );
+
+    Cell first;
+    std::copy( initial.begin(), initial.end(), first.begin() );
+
+    if( this->orientation( first, D+1, nullptr ) < 0 )
+      std::swap( first[0], first[1] );
+
+    std::vector<std::size_t> created = { this->allocate( first ) };
+
+    for( std::size_t i = 0; i <= D; i++ )
+    {
+      // Swapping two finite vertices ensures that the orientation is
+      // positive when the infinite vertex is replaced by a point that
+      // lies outside of the hull.
+      Cell cell = first;
+      cell[i]   = infinite;
+
+      std::swap( cell[ ( i+1 ) % ( D+1 ) ], cell[ ( i+2 ) % ( D+1 ) ] );
+
+      created.push_back( this->allocate( cell ) );
+    }
+
+    for( auto&& a : created )
+    {
+      for( std::size_t i = 0; i <= D; i++ )
+      {
+        for( auto&& b : created )
+        {
+          if( a == b )
+            continue;
+
+          bool shared = true;
+
+          for( std::size_t j = 0; j <= D; j++ )
+            if( j != i && std::find( _cells[b].begin(), _cells[b].end(), _cells[a][j] ) == _cells[b].end() )
+              shared = false;
+
+          if( shared )
+            _neighbours[a][i] = b;
+        }
+      }
+    }
+
+    _last = created.front();
+
+    // Incremental insertion -------------------------------------------
+
+    for( auto&& index : unique )
+      if( std::find( initial.begin(), initial.end(), index ) == initial.end() )
+        this->insert( index );
+  }
+
+  /**
+    Sorts points along a Z-order curve in their bounding box. Points that
+    are close on the curve are usually close in space, so consecutive
+    insertions affect nearby cells.
+  */
+
+  void sortSpatially( std::vector<std::size_t>& indices ) const
+  {
+    if( indices.empty() )
+      return;
+
+    constexpr unsigned bits = 64 / D;
+
+    std::array<double, D> min;
+    std::array<double, D> max;
+
+    min.fill( std::numeric_limits<double>::max() );
+    max.fill( std::numeric_limits<double>::lowest() );
+
+    for( auto&& i : indices )
+    {
+      for( std::size_t l = 0; l < D; l++ )
+      {
+        min[l] = std::min( min[l], this->point(i)[l] );
+        max[l] = std::max( max[l], this->point(i)[l] );
+      }
+    }
+
+    std::vector< std::pair<std::uint64_t, std::size_t> > codes;
+    codes.reserve( indices.size() );
+
+    for( auto&& i : indices )
+    {
+      std::uint64_t code = 0;
+
+      for( std::size_t l = 0; l < D; l++ )
+      {
+        auto extent = max[l] - min[l];
+        auto scaled = extent > 0 ? ( this->point(i)[l] - min[l] ) / extent : 0.0;
+        auto value  = static_cast<std::uint64_t>( scaled * static_cast<double>( ( std::uint64_t(1) << bits ) - 1 ) );
+
+        for( unsigned b = 0; b < bits; b++ )
+          code |= ( ( value >> b ) & 1 ) << ( b * D + l );
+      }
+
+      codes.push_back( std::make_pair( code, i ) );
+    }
+
+    std::sort( codes.begin(), codes.end() );
+
+    for( std::size_t i = 0; i < codes.size(); i++ )
+      indices[i] = codes[i].second;
+  }
+
+  /** Inserts a new point into the triangulation */
+  void insert( std::size_t index )
+  {
+    auto p = this->point( index );
+    auto s = this->locate( p );
+
+    ++_stamp;
+
+    std::vector<std::size_t> cavity = { s };
+    std::vector<Facet> boundary;
+
+    _visited[s]     = _stamp;
+    _conflicting[s] = true;
+
+    // Collect all cells in conflict with the new point as well as the
+    // facets that bound them.
+    for( std::size_t k = 0; k < cavity.size(); k++ )
+    {
+      auto c = cavity[k];
+
+      for( std::size_t i = 0; i <= D; i++ )
+      {
+        auto neighbour = _neighbours[c][i];
+
+        if( _visited[neighbour] != _stamp )
+        {
+          _visited[neighbour]     = _stamp;
+          _conflicting[neighbour] = this->conflict( neighbour, p );
+
+          if( _conflicting[neighbour] )
+            cavity.push_back( neighbour );
+        }
+
+        if( !_conflicting[neighbour] )
+          boundary.push_back( std::make_pair( c, i ) );
+      }
+    }
+
+    // Connect the boundary of the cavity with the new point. Since the
+    // new point replaces the vertex opposite to each boundary facet, the
+    // new cells have the same orientation as the cells of the cavity.
+
+    std::vector<Ridge> ridges;
+    ridges.reserve( boundary.size() * D );
+
+    for( auto&& facet : boundary )
+    {
+      auto c    = facet.first;
+      auto i    = facet.second;
+      Cell cell = _cells[c];
+      cell[i]   = index;
+
+      auto neighbour = _neighbours[c][i];
+      auto created   = this->allocate( cell );
+
+      _neighbours[created][i] = neighbour;
+      *std::find( _neighbours[neighbour].begin(), _neighbours[neighbour].end(), c ) = created;
+
+      for( std::size_t j = 0; j <= D; j++ )
+      {
+        if( j == i )
+          continue;
+
+        Ridge ridge;
+        ridge.cell     = created;
+        ridge.position = j;
+
+        std::size_t l = 0;
+        for( std::size_t m = 0; m <= D; m++ )
+          if( m != i && m != j )
+            ridge.vertices[l++] = cell[m];
+
+        std::sort( ridge.vertices.begin(), ridge.vertices.end() );
+        ridges.push_back( ridge );
+      }
+
+      _last = created;
+    }
+
+    std::sort( ridges.begin(), ridges.end() );
+
+    // Every ridge of the boundary of the cavity is shared by exactly two
+    // boundary facets. Anything else indicates that round-off errors
+    // produced a cavity that is not star-shaped.
+    for( std::size_t k = 0; k < ridges.size(); k += 2 )
+    {
+      if( k+1 >= ridges.size() || ridges[k].vertices != ridges[k+1].vertices || ( k+2 < ridges.size() && ridges[k+2].vertices == ridges[k].vertices ) )
+        throw std::runtime_error( "Unable to insert point into Delaunay triangulation" );
+
+      _neighbours[ ridges[k].cell ][ ridges[k].position ]     = ridges[k+1].cell;
+      _neighbours[ ridges[k+1].cell ][ ridges[k+1].position ] = ridges[k].cell;
+    }
+
+    for( auto&& c : cavity )
+    {
+      _alive[c] = false;
+      _free.push_back( c );
+    }
+  }
+
+  /**
+    Locates a cell that is in conflict with a point by walking towards
+    the point, starting from the last cell that has been created. If the
+    walk fails to terminate, all cells are checked.
+  */
+
+  std::size_t locate( const double* p )
+  {
+    auto c = _last;
+
+    if( this->isInfinite( c ) )
+      c = _neighbours[c][ this->position( c, infinite ) ];
+
+    for( std::size_t steps = 0; steps < _cells.size(); steps++ )
+    {
+      if( this->isInfinite( c ) )
+        break;
+
+      // Choosing the first facet at random prevents the walk from
+      // cycling.
+      _random ^= _random << 13;
+      _random ^= _random >> 17;
+      _random ^= _random << 5;
+
+      auto offset = static_cast<std::size_t>( _random % ( D+1 ) );
+      bool moved  = false;
+
+      for( std::size_t j = 0; j <= D && !moved; j++ )
+      {
+        auto i = ( offset + j ) % ( D+1 );
+
+        if( this->orientation( _cells[c], i, p ) < 0 )
+        {
+          c     = _neighbours[c][i];
+          moved = true;
+        }
+      }
+
+      if( !moved )
+        break;
+    }
+
+    if( this->conflict( c, p ) )
+      return c;
+
+    for( std::size_t d = 0; d < _cells.size(); d++ )
+      if( _alive[d] && this->conflict( d, p ) )
+        return d;
+
+    throw std::runtime_error( "Unable to locate point in Delaunay triangulation" );
+  }
+
+  /** Checks whether a point is in conflict with a cell */
+  bool conflict( std::size_t c, const double* p ) const
+  {
+    auto&& cell = _cells[c];
+
+    if( !this->isInfinite( c ) )
+    {
+      std::array< std::array<long double, D+1>, D+1 > B;
+
+      for( std::size_t i = 0; i <= D; i++ )
+      {
+        auto q          = this->point( cell[i] );
+        long double sum = 0;
+
+        for( std::size_t l = 0; l < D; l++ )
+        {
+          B[i][l] = static_cast<long double>( q[l] ) - p[l];
+          sum    += B[i][l] * B[i][l];
+        }
+
+        B[i][D] = sum;
+      }
+
+      // The sign of the determinant depends on the dimension; it is
+      // positive in two dimensions and negative in three dimensions if
+      // the point is inside the circumsphere of a positively-oriented
+      // cell.
+      auto det = detail::determinant( B );
+      return D % 2 == 0 ? det > 0 : det < 0;
+    }
+
+    // Infinite cells are in conflict with all points beyond their finite
+    // facet. Points on the hyperplane of the facet are only in conflict
+    // if they are inside its circumsphere.
+    auto k = this->position( c, infinite );
+    auto o = this->orientation( cell, k, p );
+
+    if( o != 0 )
+      return o > 0;
+
+    std::vector<const double*> facet;
+    for( std::size_t j = 0; j <= D; j++ )
+      if( j != k )
+        facet.push_back( this->point( cell[j] ) );
+
+    std::vector<long double> centre;
+    auto squaredRadius = detail::circumsphere( facet, D, centre );
+
+    return detail::squaredDistance( p, centre ) < squaredRadius;
+  }
+
+  /**
+    Calculates the orientation of a cell whose vertex at the given
+    position is replaced by a point. Use a position larger than D to
+    calculate the orientation of the cell itself.
+  */
+
+  long double orientation( const Cell& cell, std::size_t position, const double* p ) const
+  {
+    Points points;
+
+    for( std::size_t i = 0; i <= D; i++ )
+      points[i] = i == position ? p : this->point( cell[i] );
+
+    std::array< std::array<long double, D>, D > A;
+
+    for( std::size_t i = 1; i <= D; i++ )
+      for( std::size_t l = 0; l < D; l++ )
+        A[i-1][l] = static_cast<long double>( points[i][l] ) - points[0][l];
+
+    return detail::determinant( A );
+  }
+
+  bool isInfinite( std::size_t c ) const
+  {
+    return std::find( _cells[c].begin(), _cells[c].end(), infinite ) != _cells[c].end();
+  }
+
+  std::size_t position( std::size_t c, std::size_t vertex ) const
+  {
+    return static_cast<std::size_t>( std::distance( _cells[c].begin(), std::find( _cells[c].begin(), _cells[c].end(), vertex ) ) );
+  }
+
+  /** Creates a new cell, re-using the storage of removed cells */
+  std::size_t allocate( const Cell& cell )
+  {
+    Cell neighbours;
+    neighbours.fill( infinite );
+
+    if( !_free.empty() )
+    {
+      auto c = _free.back();
+      _free.pop_back();
+
+      _cells[c]      = cell;
+      _neighbours[c] = neighbours;
+      _alive[c]      = true;
+
+      return c;
+    }
+
+    _cells.push_back( cell );
+    _neighbours.push_back( neighbours );
+    _alive.push_back( true );
+    _visited.push_back( 0 );
+    _conflicting.push_back( false );
+
+    return _cells.size() - 1;
+  }
+
+  /** Coordinates of all points */
+  std::vector<double> _points;
+
+  /** Pairs of duplicate points and their originals */
+  std::vector< std::pair<std::size_t, std::size_t> > _duplicates;
+
+  /** Vertices of all cells, including removed ones */
+  std::vector<Cell> _cells;
+
+  /** Neighbours of all cells; the i-th neighbour is opposite to the i-th vertex */
+  std::vector<Cell> _neighbours;
+
+  /** Indicates whether a cell is still part of the triangulation */
+  std::vector<bool> _alive;
+
+  /** Indices of removed cells whose storage may be re-used */
+  std::vector<std::size_t> _free;
+
+  /** Stamps and conflict flags for searching the cavity of a new point */
+  std::vector<std::size_t> _visited;
+  std::vector<bool> _conflicting;
+  std::size_t _stamp = 0;
+
+  /** Last cell that has been created; used as the start of a walk */
+  std::size_t _last = 0;
+
+  /** State of the random number generator for walks */
+  std::uint32_t _random = 2463534242;
+};
+
+template <std::size_t D> constexpr std::size_t DelaunayTriangulation<D>::infinite;
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
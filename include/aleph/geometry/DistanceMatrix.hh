@@ -0,0 +1,195 @@
+#ifndef ALEPH_GEOMETRY_DISTANCE_MATRIX_HH__
+#define ALEPH_GEOMETRY_DISTANCE_MATRIX_HH__
+
+#include <aleph/geometry/distances/Traits.hh>
+
+#include <aleph/math/SymmetricMatrix.hh>
+
+#include <aleph/utilities/MemoryMappedFile.hh>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <cmath>
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+namespace detail
+{
+
+/**
+  Calculates all pairwise distances of a container and stores them in the
+  upper triangular part of a matrix, using the storage layout of
+  math::SymmetricMatrix. Points are processed in blocks, so the points of
+  a block of columns remain in the cache while they are being compared to
+  the points of a block of rows. Blocks of rows are distributed among all
+  threads if OpenMP is available.
+
+  The distances are calculated with the distance functor, which uses the
+  vectorised kernels whenever possible. Hence, all distances coincide with
+  the ones calculated by the nearest neighbour wrappers.
+*/
+
+template <class Distance, class Container> void fillDistanceMatrix( const Container& container,
+                                                                    typename Distance::ResultType* data,
+                                                                    Distance dist )
+{
+  using ResultType = typename Distance::ResultType;
+
+  std::size_t n = container.size();
+  std::size_t d = container.dimension();
+
+  distances::Traits<Distance> traits;
+
+  // Chooses the block size such that a block of points fits into the
+  // cache of a core
+  std::size_t blockSize = std::max( std::size_t(8), std::size_t( 16384 ) / ( sizeof( typename Container::ElementType ) * std::max( d, std::size_t(1) ) ) );
+  std::size_t numBlocks = ( n + blockSize - 1 ) / blockSize;
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( numBlocks ); s++ )
+  {
+    auto i0 = static_cast<std::size_t>( s ) * blockSize;
+    auto i1 = std::min( n, i0 + blockSize );
+
+    for( std::size_t j0 = i0; j0 < n; j0 += blockSize )
+    {
+      auto j1 = std::min( n, j0 + blockSize );
+
+      for( std::size_t i = i0; i < i1; i++ )
+      {
+        // Points to the (virtual) first entry of the ith row, so that it
+        // can be indexed by the column
+        auto row = data + math::SymmetricMatrix<ResultType>::rowOffset( i, n );
+        auto p   = container.point( i );
+
+        for( std::size_t j = std::max( j0, i ); j < j1; j++ )
+        {
+          if( i == j )
+            row[j] = ResultType();
+          else
+          {
+            row[j] = traits.from( dist( p.begin(),
+                                        container.point( j ).begin(),
+                                        d ) );
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+/**
+  Calculates all pairwise distances of a container, e.g. a point cloud,
+  and stores them in a symmetric matrix. The matrix contains the actual
+  distances, i.e. the values returned by the distance functor have been
+  transformed using the corresponding traits class.
+
+  The calculation uses the vectorised distance kernels and runs in
+  parallel if OpenMP is available.
+
+  @param container Container whose distances are to be calculated
+  @param distance  Distance functor
+
+  @returns Symmetric matrix of all pairwise distances
+*/
+
+template <class Distance, class Container> math::SymmetricMatrix<typename Distance::ResultType> distanceMatrix( const Container& container,
+                                                                                                                Distance distance = Distance() )
+{
+  math::SymmetricMatrix<typename Distance::ResultType> M( container.size() );
+  detail::fillDistanceMatrix( container, M.data(), distance );
+
+  return M;
+}
+
+/**
+  Calculates all pairwise distances of a container and stores them in a
+  file, which is mapped into memory. The file is created or overwritten,
+  and it contains the upper triangular part of the matrix in row-major
+  order, using the native byte order of the machine. This makes it
+  possible to calculate distance matrices that are larger than the main
+  memory. Use loadDistanceMatrix() to map the file again.
+
+  @param container Container whose distances are to be calculated
+  @param filename  Output filename
+  @param distance  Distance functor
+
+  @returns Symmetric matrix of all pairwise distances, which refers to
+  the contents of the file
+
+  @throws std::runtime_error if the file cannot be created or mapped
+*/
+
+template <class Distance, class Container> math::SymmetricMatrix<typename Distance::ResultType> distanceMatrix( const Container& container,
+                                                                                                                const std::string& filename,
+                                                                                                                Distance distance = Distance() )
+{
+  using ResultType = typename Distance::ResultType;
+
+  std::size_t n = container.size();
+  auto file     = std::make_shared<utilities::MemoryMappedFile>( filename, n * ( n + 1 ) / 2 * sizeof( ResultType ) );
+  auto data     = reinterpret_cast<ResultType*>( file->data() );
+
+  detail::fillDistanceMatrix( container, data, distance );
+
+  return math::SymmetricMatrix<ResultType>( n, data, file );
+}
+
+/**
+  Loads a distance matrix that has been stored by distanceMatrix(). The
+  file is mapped into memory, so loading does not copy any data, and the
+  matrix keeps the mapping alive. Modifications of the matrix are never
+  written back to the file.
+
+  @param filename Input filename
+
+  @returns Symmetric matrix that refers to the contents of the file
+
+  @throws std::runtime_error if the file cannot be mapped or if its size
+  does not correspond to the upper triangular part of a matrix
+*/
+
+template <class T> math::SymmetricMatrix<T> loadDistanceMatrix( const std::string& filename )
+{
+  auto file = std::make_shared<utilities::MemoryMappedFile>( filename );
+
+  if( file->size() % sizeof(T) != 0 )
+    throw std::runtime_error( "Size of file '" + filename + "' does not match type of distance matrix" );
+
+  // Solves m = n(n+1)/2 for the number of rows; the result is verified
+  // afterwards because the square root is not necessarily exact.
+  auto m = file->size() / sizeof(T);
+  auto n = static_cast<std::size_t>( ( std::sqrt( 8.0 * static_cast<double>( m ) + 1.0 ) - 1.0 ) / 2.0 );
+
+  while( n * ( n + 1 ) / 2 < m )
+    ++n;
+
+  while( n > 0 && n * ( n + 1 ) / 2 > m )
+    --n;
+
+  if( n * ( n + 1 ) / 2 != m )
+    throw std::runtime_error( "Size of file '" + filename + "' does not correspond to a distance matrix" );
+
+  if( n == 0 )
+    return math::SymmetricMatrix<T>( 0 );
+
+  return math::SymmetricMatrix<T>( n, reinterpret_cast<T*>( file->data() ), file );
+}
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
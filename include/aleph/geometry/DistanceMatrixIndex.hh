@@ -0,0 +1,360 @@
+#ifndef ALEPH_GEOMETRY_DISTANCE_MATRIX_INDEX_HH__
+#define ALEPH_GEOMETRY_DISTANCE_MATRIX_INDEX_HH__
+
+#include <aleph/geometry/DistanceMatrix.hh>
+#include <aleph/geometry/NearestNeighbours.hh>
+
+#include <aleph/math/SymmetricMatrix.hh>
+
+#include <aleph/topology/io/Matrix.hh>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+/**
+  @class DistanceMatrixIndex
+  @brief Nearest neighbours for a matrix of pairwise distances
+
+  Answers nearest neighbour queries for data that are only available in
+  the form of pairwise distances, e.g. dissimilarities that cannot be
+  represented by coordinates. Hence, Vietoris--Rips complexes of such
+  data can be calculated with the same algorithms as for point clouds.
+
+  Upon construction, the neighbours of every point are sorted according
+  to their distance. A radius query then only requires a binary search
+  per point, while a query for the k nearest neighbours merely copies a
+  prefix of every list. The lists are sorted in parallel if OpenMP is
+  available.
+
+  The lists store 32-bit indices, so if they contain all points, they
+  require twice as much memory as a matrix of single-precision values.
+  If a maximum radius is specified, the lists only contain neighbours
+  whose distance is smaller than this radius, which typically reduces
+  their size considerably, e.g. when calculating a Vietoris--Rips
+  complex up to the same radius. Queries that exceed the lists, such as
+  radius queries with a larger radius, scan the rows of the matrix
+  instead, so their results remain exact. The matrix itself is never
+  copied, so it may remain mapped into memory, as provided by
+  loadDistanceMatrix().
+
+  The results are consistent with the ones of the other wrappers. Every
+  point is its own nearest neighbour, and a radius query only reports
+  points whose distance is strictly smaller than the radius.
+*/
+
+template <class T, class I = std::size_t>
+class DistanceMatrixIndex : public NearestNeighbours< DistanceMatrixIndex<T, I>, T, I >
+{
+public:
+  using IndexType   = I;
+  using ElementType = T;
+  using Matrix      = math::SymmetricMatrix<T, I>;
+
+  /**
+    Creates the index for a matrix of pairwise distances. The matrix is
+    moved into the index, so a matrix that has been mapped into memory
+    continues to use the file. The neighbour lists contain all points.
+
+    @param distances Matrix of pairwise distances
+
+    @throws std::runtime_error if the matrix has too many rows for 32-bit
+    indices
+  */
+
+  explicit DistanceMatrixIndex( Matrix distances )
+    : _distances( std::move( distances ) )
+    , _neighbours( _distances.numRows() )
+    , _maxRadius( ElementType() )
+    , _complete( true )
+  {
+    this->build();
+  }
+
+  /**
+    Creates the index for a matrix of pairwise distances, storing only
+    neighbours whose distance is smaller than a maximum radius.
+
+    @param distances Matrix of pairwise distances
+    @param maxRadius Maximum radius of the neighbour lists
+
+    @throws std::runtime_error if the matrix has too many rows for 32-bit
+    indices
+  */
+
+  DistanceMatrixIndex( Matrix distances, ElementType maxRadius )
+    : _distances( std::move( distances ) )
+    , _neighbours( _distances.numRows() )
+    , _maxRadius( maxRadius )
+    , _complete( false )
+  {
+    this->build();
+  }
+
+  /**
+    Creates the index for a matrix of pairwise distances that is stored
+    in a text file, using io::MatrixReader. The matrix may be stored as a
+    dense matrix or as a lower triangular matrix.
+
+    @param filename Input filename
+
+    @see io::MatrixReader
+  */
+
+  explicit DistanceMatrixIndex( const std::string& filename )
+    : DistanceMatrixIndex( read( filename ) )
+  {
+  }
+
+  void radiusSearch( ElementType radius,
+                     std::vector< std::vector<IndexType> >& indices,
+                     std::vector< std::vector<ElementType> >& distances ) const
+  {
+    indices.clear();
+    distances.clear();
+
+    indices.resize( this->size() );
+    distances.resize( this->size() );
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( this->size() ); s++ )
+    {
+      auto i = static_cast<IndexType>( s );
+
+      if( _complete || radius <= _maxRadius )
+      {
+        auto&& N = _neighbours[i];
+
+        // Finds the first neighbour whose distance is not smaller than the
+        // radius; all preceding neighbours are part of the result.
+        auto it = std::partition_point( N.begin(), N.end(),
+                                        [this, i, radius] ( Neighbour j )
+                                        {
+                                          return this->distance( i, j ) < radius;
+                                        } );
+
+        this->report( i, N.begin(), it, indices[i], distances[i] );
+      }
+      else
+      {
+        auto N = this->scanRadius( i, radius );
+        this->report( i, N.begin(), N.end(), indices[i], distances[i] );
+      }
+    }
+  }
+
+  void neighbourSearch( unsigned k,
+                        std::vector< std::vector<IndexType> >& indices,
+                        std::vector< std::vector<ElementType> >& distances ) const
+  {
+    indices.clear();
+    distances.clear();
+
+    indices.resize( this->size() );
+    distances.resize( this->size() );
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( this->size() ); s++ )
+    {
+      auto i   = static_cast<IndexType>( s );
+      auto&& N = _neighbours[i];
+      auto m   = std::min( this->size(), static_cast<std::size_t>( k ) );
+
+      // All points that are missing from a truncated list are at least as
+      // far away as the maximum radius, so a sufficiently long list always
+      // contains the nearest neighbours.
+      if( N.size() >= m )
+        this->report( i, N.begin(), N.begin() + static_cast<std::ptrdiff_t>( m ), indices[i], distances[i] );
+      else
+      {
+        auto M = this->scanNearest( i, m );
+        this->report( i, M.begin(), M.end(), indices[i], distances[i] );
+      }
+    }
+  }
+
+  std::size_t size() const noexcept
+  {
+    return static_cast<std::size_t>( _distances.numRows() );
+  }
+
+  /** @returns Matrix of pairwise distances */
+  const Matrix& distances() const noexcept
+  {
+    return _distances;
+  }
+
+private:
+
+  /** Type of the indices that are stored in the neighbour lists */
+  using Neighbour = std::uint32_t;
+
+  /** Reads a distance matrix from a text file */
+  static Matrix read( const std::string& filename )
+  {
+    Matrix M;
+
+    topology::io::MatrixReader reader;
+    reader( filename, M );
+
+    return M;
+  }
+
+  /**
+    @returns Distance between two points. The upper triangular part of the
+    matrix is accessed directly, which avoids the checks of the matrix.
+    The distance of a point to itself is always zero.
+  */
+
+  ElementType distance( IndexType i, IndexType j ) const noexcept
+  {
+    if( i == j )
+      return ElementType();
+    else if( i > j )
+      std::swap( i, j );
+
+    return _distances.data()[ _distances.rowOffset( i ) + j ];
+  }
+
+  /**
+    Compares two neighbours of a point by their distance. Ties are broken
+    by the index of a point, which ensures that every point precedes its
+    duplicates in its own list.
+  */
+
+  bool compare( IndexType i, IndexType j, IndexType k ) const noexcept
+  {
+    auto dj = this->distance( i, j );
+    auto dk = this->distance( i, k );
+
+    if( dj != dk )
+      return dj < dk;
+    else if( j == i || k == i )
+      return j == i && k != i;
+    else
+      return j < k;
+  }
+
+  /** @returns Sorted list of all neighbours of a point within a radius */
+  std::vector<Neighbour> scanRadius( IndexType i, ElementType radius ) const
+  {
+    std::vector<Neighbour> N;
+
+    for( std::size_t j = 0; j < this->size(); j++ )
+    {
+      if( this->distance( i, static_cast<IndexType>( j ) ) < radius )
+        N.push_back( static_cast<Neighbour>( j ) );
+    }
+
+    std::sort( N.begin(), N.end(),
+               [this, i] ( Neighbour j, Neighbour k )
+               {
+                 return this->compare( i, j, k );
+               } );
+
+    return N;
+  }
+
+  /** @returns Sorted list of the m nearest neighbours of a point */
+  std::vector<Neighbour> scanNearest( IndexType i, std::size_t m ) const
+  {
+    std::vector<Neighbour> N( this->size() );
+    std::iota( N.begin(), N.end(), Neighbour() );
+
+    std::partial_sort( N.begin(), N.begin() + static_cast<std::ptrdiff_t>( m ), N.end(),
+                       [this, i] ( Neighbour j, Neighbour k )
+                       {
+                         return this->compare( i, j, k );
+                       } );
+
+    N.resize( m );
+    return N;
+  }
+
+  /** Sorts the neighbours of every point according to their distance */
+  void build()
+  {
+    auto n = this->size();
+
+    if( n > static_cast<std::size_t>( std::numeric_limits<Neighbour>::max() ) )
+      throw std::runtime_error( "Distance matrix has too many rows for neighbour lists" );
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( n ); s++ )
+    {
+      auto i = static_cast<IndexType>( s );
+
+      if( _complete )
+      {
+        auto&& N = _neighbours[i];
+
+        N.resize( n );
+        std::iota( N.begin(), N.end(), Neighbour() );
+
+        std::sort( N.begin(), N.end(),
+                   [this, i] ( Neighbour j, Neighbour k )
+                   {
+                     return this->compare( i, j, k );
+                   } );
+      }
+      else
+      {
+        // Only the neighbours of the final list are collected, so memory
+        // is never allocated for all points.
+        auto N = this->scanRadius( i, _maxRadius );
+        N.shrink_to_fit();
+
+        _neighbours[i].swap( N );
+      }
+    }
+  }
+
+  /** Copies a range of neighbours, along with their distances, to the output */
+  template <class Iterator> void report( IndexType i,
+                                         Iterator begin, Iterator end,
+                                         std::vector<IndexType>& indices,
+                                         std::vector<ElementType>& distances ) const
+  {
+    indices.assign( begin, end );
+    distances.reserve( indices.size() );
+
+    for( auto&& j : indices )
+      distances.push_back( this->distance( i, j ) );
+  }
+
+  /** Matrix of pairwise distances */
+  Matrix _distances;
+
+  /** Neighbours of every point, sorted by their distance */
+  std::vector< std::vector<Neighbour> > _neighbours;
+
+  /** Maximum radius of the neighbour lists, unless they are complete */
+  ElementType _maxRadius;
+
+  /** Indicates whether the neighbour lists contain all points */
+  bool _complete;
+};
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
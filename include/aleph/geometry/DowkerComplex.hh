@@ -1,13 +1,13 @@
 #ifndef ALEPH_GEOMETRY_DOWKER_COMPLEX_HH__
 #define ALEPH_GEOMETRY_DOWKER_COMPLEX_HH__
 
-#include <aleph/math/Combinations.hh>
-
 #include <aleph/topology/filtrations/Data.hh>
 
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/utilities/ParallelSort.hh>
+
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graph_traits.hpp>
 
@@ -17,9 +17,12 @@
 #include <algorithm>
 #include <iterator>
 #include <limits>
-#include <unordered_map>
 #include <vector>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 namespace aleph
 {
 
@@ -64,6 +67,112 @@ template <class D, class V> void swap( Vertex<D, V>& first, Vertex<D, V>& second
   std::swap( first.w, second.w );
 }
 
+/**
+  Enumerates all subsets of the vertices that are admissible for a base
+  point, starting from a given position. The weight of every subset is
+  the maximum weight of its vertices.
+*/
+
+template <class Simplex, class Vertex> void enumerateDowkerSimplices( const std::vector<Vertex>& vertices,
+                                                                      std::size_t start,
+                                                                      std::size_t maxSize,
+                                                                      std::vector<typename Simplex::VertexType>& current,
+                                                                      typename Simplex::DataType weight,
+                                                                      std::vector<Simplex>& simplices )
+{
+  for( std::size_t i = start; i < vertices.size(); i++ )
+  {
+    current.push_back( vertices[i].p );
+
+    auto w = std::max( weight, vertices[i].w );
+    simplices.push_back( Simplex( current.begin(), current.end(), w ) );
+
+    if( current.size() < maxSize )
+      enumerateDowkerSimplices( vertices, i+1, maxSize, current, w, simplices );
+
+    current.pop_back();
+  }
+}
+
+/**
+  Creates all simplices of a Dowker complex from a mapping of base points
+  to the vertices that are admissible for them. Every simplex receives
+  the *smallest* weight at which it is observed by a base point.
+
+  Base points are processed in parallel, with every thread storing its
+  simplices in a separate buffer. Afterwards, all simplices are sorted
+  lexicographically and by weight, such that duplicates can be removed
+  by keeping the first occurrence of every simplex.
+
+  @param basePoints Admissible vertices for every base point
+  @param dimension  Maximum dimension for expansion. If set to zero, will
+                    expand the complex to its maximum dimension.
+*/
+
+template <class Simplex, class Vertex> std::vector<Simplex> makeDowkerSimplices( const std::vector< std::vector<Vertex> >& basePoints,
+                                                                                 unsigned dimension )
+{
+  using DataType   = typename Simplex::DataType;
+  using VertexType = typename Simplex::VertexType;
+
+  std::vector< std::vector<Simplex> > buffers;
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+#ifdef _OPENMP
+    #pragma omp single
+    buffers.resize( static_cast<std::size_t>( omp_get_num_threads() ) );
+
+    auto&& simplices = buffers[ static_cast<std::size_t>( omp_get_thread_num() ) ];
+#else
+    buffers.resize( 1 );
+
+    auto&& simplices = buffers.front();
+#endif
+
+    std::vector<VertexType> current;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic)
+#endif
+    for( std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>( basePoints.size() ); i++ )
+    {
+      auto&& vertices = basePoints[ static_cast<std::size_t>( i ) ];
+      auto maxSize    = dimension == 0 ? vertices.size() : std::size_t( dimension + 1 );
+
+      enumerateDowkerSimplices( vertices, 0, maxSize, current, std::numeric_limits<DataType>::lowest(), simplices );
+    }
+  }
+
+  std::vector<Simplex> simplices;
+
+  {
+    std::size_t size = 0;
+
+    for( auto&& buffer : buffers )
+      size += buffer.size();
+
+    simplices.reserve( size );
+
+    for( auto&& buffer : buffers )
+    {
+      std::move( buffer.begin(), buffer.end(), std::back_inserter( simplices ) );
+      buffer = std::vector<Simplex>();
+    }
+  }
+
+  aleph::utilities::parallelSort( simplices.begin(), simplices.end(), [] ( const Simplex& s, const Simplex& t )
+    {
+      return s < t || ( s == t && s.data() < t.data() );
+    }
+  );
+
+  simplices.erase( std::unique( simplices.begin(), simplices.end() ), simplices.end() );
+  return simplices;
+}
+
 } // namespace detail
 
 /**
@@ -156,108 +265,34 @@ std::pair<
   using Simplex           = topology::Simplex<D, V>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
-  using VertexType     = V;
-  VertexType maxVertex = VertexType();
-
-  for( auto&& pair : pairs )
-  {
-    maxVertex = std::max(maxVertex, VertexType(pair.p) );
-    maxVertex = std::max(maxVertex, VertexType(pair.q) );
-  }
-
-  using Vertex = Vertex<D, V>;
+  using VertexType = V;
+  using Vertex     = Vertex<D, V>;
 
   // Keep track of the mapping induced by fixing either the source
   // points or the sink points.
-  std::unordered_map< VertexType, std::vector<Vertex> > sourceBasePointMap;
-  std::unordered_map< VertexType, std::vector<Vertex> > sinkBasePointMap;
+  std::vector< std::vector<Vertex> > sourceBasePoints;
+  std::vector< std::vector<Vertex> > sinkBasePoints;
 
   for( auto&& pair : pairs )
   {
-    auto&& p = pair.p;
-    auto&& q = pair.q;
+    auto p = static_cast<std::size_t>( pair.p );
+    auto q = static_cast<std::size_t>( pair.q );
 
-    sourceBasePointMap[ VertexType(p) ].push_back( { VertexType(q), pair.w } );
-    sinkBasePointMap[ VertexType(q) ].push_back( { VertexType(p), pair.w } );
-  }
-
-  // Auxiliary weight calculation lambda function ----------------------
-  //
-  // This function calculates the *maximum* weight of a range of
-  // vertices. It is used to determine the weight of a simplex.
-
-  using Iterator = typename std::vector<Vertex>::const_iterator;
-  auto getWeight = [] ( Iterator begin, Iterator end )
-  {
-    using DataType  = D;
-    DataType weight = std::numeric_limits<DataType>::lowest();
-
-    for( auto it = begin; it != end; ++it )
-      weight = std::max( weight, it->w );
-
-    return weight;
-  };
-
-  auto makeSimplices = [&dimension, &getWeight] ( const std::unordered_map< VertexType, std::vector<Vertex> >& map )
-  {
-    std::vector<Simplex> simplices;
-    std::unordered_map<Simplex, D> simplex_to_weight;
-
-    for( auto&& pair : map )
+    if( std::max( p, q ) >= sourceBasePoints.size() )
     {
-      auto vertices            = pair.second;
-      std::size_t maxDimension = 0;
-
-      if( dimension == 0 )
-        maxDimension = vertices.size();
-      else
-        maxDimension = dimension + 1;
-
-      using DifferenceType = typename decltype(vertices)::difference_type;
-
-      for( std::size_t d = std::min( vertices.size(), maxDimension ); d >= 1; d-- )
-      {
-        math::for_each_combination( vertices.begin(), vertices.begin() + DifferenceType(d), vertices.end(),
-          [&simplex_to_weight, &getWeight] ( Iterator first, Iterator last )
-          {
-            std::vector<V> vertices_;
-            vertices_.reserve( typename std::vector<V>::size_type( std::distance( first, last ) ) );
-
-            for( auto it = first; it != last; ++it )
-              vertices_.push_back( it->p );
-
-            Simplex s( vertices_.begin(), vertices_.end() );
-
-            if( simplex_to_weight.find(s) == simplex_to_weight.end() )
-              simplex_to_weight[s] = getWeight(first, last);
-            else
-              simplex_to_weight[s] = std::min( simplex_to_weight[s], getWeight(first, last) );
-
-            return false;
-          }
-        );
-      }
+      sourceBasePoints.resize( std::max( p, q ) + 1 );
+      sinkBasePoints.resize( std::max( p, q ) + 1 );
     }
 
-    for( auto&& pair : simplex_to_weight )
-    {
-      auto s = pair.first;
-      s.setData( pair.second );
-
-      simplices.push_back( s );
-    }
-
-    return simplices;
-  };
-
-  auto sourceEdges = makeSimplices( sourceBasePointMap );
-  auto sinkEdges   = makeSimplices( sinkBasePointMap );
+    sourceBasePoints[p].push_back( { VertexType(q), static_cast<D>( pair.w ) } );
+    sinkBasePoints[q].push_back( { VertexType(p), static_cast<D>( pair.w ) } );
+  }
 
-  SimplicialComplex dowkerSourceComplex( sourceEdges.begin(), sourceEdges.end() );
-  SimplicialComplex dowkerSinkComplex  ( sinkEdges.begin()  , sinkEdges.end()   );
+  SimplicialComplex dowkerSourceComplex;
+  SimplicialComplex dowkerSinkComplex;
 
-  dowkerSourceComplex.sort( topology::filtrations::Data<Simplex>() );
-  dowkerSinkComplex.sort( topology::filtrations::Data<Simplex>() );
+  dowkerSourceComplex.bulkLoad( makeDowkerSimplices<Simplex>( sourceBasePoints, dimension ), topology::filtrations::Data<Simplex>() );
+  dowkerSinkComplex.bulkLoad( makeDowkerSimplices<Simplex>( sinkBasePoints, dimension ), topology::filtrations::Data<Simplex>() );
 
   return std::make_pair( dowkerSourceComplex, dowkerSinkComplex );
 }
@@ -294,111 +329,33 @@ template
   using Simplex           = topology::Simplex<DataType, VertexType>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
-  VertexType maxVertex = VertexType();
-
-  for( auto&& pair : pairs )
-  {
-    maxVertex = std::max(maxVertex, VertexType(pair.p) );
-    maxVertex = std::max(maxVertex, VertexType(pair.q) );
-  }
-
   using Vertex = Vertex<DataType, VertexType>;
 
   // Keep track of the mapping induced by fixing the source points. In
   // essence, this is a adjacency list representation of a matrix that
   // tracks the admissibility of vertices.
-  std::unordered_map< VertexType, std::vector<Vertex> > sourceBasePointMap;
+  std::vector< std::vector<Vertex> > sourceBasePoints;
 
   for( auto&& pair : pairs )
   {
-    auto&& p = pair.p;
-    auto&& q = pair.q;
-
-    sourceBasePointMap[ VertexType(p) ].push_back( { VertexType(q), pair.w } );
-  }
-
-  // Auxiliary weight calculation lambda function ----------------------
-  //
-  // This function calculates the *maximum* weight of a range of
-  // vertices. It is used to determine the weight of a simplex.
-
-  using Iterator = typename std::vector<Vertex>::const_iterator;
-  auto getWeight = [] ( Iterator begin, Iterator end )
-  {
-    DataType weight = std::numeric_limits<DataType>::lowest();
+    auto p = static_cast<std::size_t>( pair.p );
 
-    for( auto it = begin; it != end; ++it )
-      weight = std::max( weight, it->w );
+    if( p >= sourceBasePoints.size() )
+      sourceBasePoints.resize( p + 1 );
 
-    return weight;
-  };
+    sourceBasePoints[p].push_back( { VertexType( pair.q ), pair.w } );
+  }
 
   // Create all valid simplices ----------------------------------------
   //
   // All valid simplices with respect to the source point are created
   // by generating all combinations of admissible pairs, with respect
-  // to the given source point.
-  //
-  std::vector<Simplex> simplices;
-
-  {
-    // The same simplex may occur multiple times because it is
-    // 'observed' by multiple source points. We need to obtain
-    // the *earliest* weight at which the simplex occurs!
-    std::unordered_map<Simplex, DataType> simplex_to_weight;
-
-    for( auto&& pair : sourceBasePointMap )
-    {
-      auto vertices            = pair.second;
-      std::size_t maxDimension = 0;
-
-      if( dimension == 0 )
-        maxDimension = vertices.size();
-      else
-        maxDimension = dimension + 1;
-
-      using DifferenceType = typename decltype(vertices)::difference_type;
-
-      for( std::size_t d = std::min( vertices.size(), maxDimension ); d >= 1; d-- )
-      {
-        math::for_each_combination( vertices.begin(), vertices.begin() + DifferenceType(d), vertices.end(),
-          [&simplex_to_weight, &getWeight] ( Iterator first, Iterator last )
-          {
-            std::vector<VertexType> vertices_;
-            vertices_.reserve( typename std::vector<VertexType>::size_type( std::distance( first, last ) ) );
-
-            for( auto it = first; it != last; ++it )
-              vertices_.push_back( it->p );
-
-            Simplex s( vertices_.begin(), vertices_.end() );
-
-            // Ensures that we do not take the default weight, which is
-            // zero, as the weight of the simplex---there does not seem
-            // to be a way to solve this more efficiently...
-            if( simplex_to_weight.find(s) == simplex_to_weight.end() )
-              simplex_to_weight[s] = getWeight(first, last);
-            else
-              simplex_to_weight[s] = std::min( simplex_to_weight[s], getWeight(first, last) );
-
-            return false;
-          }
-        );
-      }
-    }
-
-    // Set the weights of all simplices prior to inserting them into the
-    // simplicial complex.
-    for( auto&& pair : simplex_to_weight )
-    {
-      auto s = pair.first;
-      s.setData( pair.second );
-
-      simplices.push_back( s );
-    }
-  }
+  // to the given source point. The same simplex may occur multiple
+  // times because it is 'observed' by multiple source points, so we
+  // need to obtain the *earliest* weight at which the simplex occurs.
 
-  SimplicialComplex K( simplices.begin(), simplices.end() );
-  K.sort( topology::filtrations::Data<Simplex>() );
+  SimplicialComplex K;
+  K.bulkLoad( makeDowkerSimplices<Simplex>( sourceBasePoints, dimension ), topology::filtrations::Data<Simplex>() );
 
   return K;
 }
@@ -34,7 +34,8 @@ public:
 #ifdef ALEPH_WITH_FLANN
     _matrix
       = flann::Matrix<ElementType>( container.data(),
-                                    container.size(), container.dimension() );
+                                    container.size(), container.dimension(),
+                                    container.stride() * sizeof( ElementType ) );
 
     flann::IndexParams indexParameters
       = flann::KDTreeSingleIndexParams();
@@ -96,14 +97,20 @@ public:
       return;
 
     distances.clear();
-    distances.resize( internalDistances.size(), std::vector<ElementType>( internalDistances.front().size() ) );
+    distances.resize( internalDistances.size() );
 
     {
       using size_type = typename std::vector< std::vector<ElementType> >::size_type;
 
+      // Every point has a different number of neighbours within the
+      // radius, so the size of every row has to be set individually.
       for( size_type row = 0; row < distances.size(); row++ )
+      {
+        distances[row].resize( internalDistances[row].size() );
+
         for( size_type col = 0; col < distances[row].size(); col++ )
           distances[row][col] = static_cast<ElementType>( internalDistances[row][col] );
+      }
     }
 
     for( auto&& D : distances )
@@ -111,7 +118,7 @@ public:
       std::transform( D.begin(), D.end(), D.begin(),
                       [this] ( ElementType x )
                       {
-                        return _traits.from( x );
+                        return static_cast<ElementType>( _traits.from( x ) );
                       } );
     }
   }
@@ -179,14 +186,20 @@ public:
       return;
 
     distances.clear();
-    distances.resize( internalDistances.size(), std::vector<ElementType>( internalDistances.front().size() ) );
+    distances.resize( internalDistances.size() );
 
     {
       using size_type = typename std::vector< std::vector<ElementType> >::size_type;
 
+      // Rows are sized individually because points may have fewer than k
+      // neighbours, e.g. if k exceeds the number of points.
       for( size_type row = 0; row < distances.size(); row++ )
+      {
+        distances[row].resize( internalDistances[row].size() );
+
         for( size_type col = 0; col < distances[row].size(); col++ )
           distances[row][col] = static_cast<ElementType>( internalDistances[row][col] );
+      }
     }
 
     for( auto&& D : distances )
@@ -194,7 +207,7 @@ public:
       std::transform( D.begin(), D.end(), D.begin(),
                       [this] ( ElementType x )
                       {
-                        return _traits.from( x );
+                        return static_cast<ElementType>( _traits.from( x ) );
                       } );
     }
   }
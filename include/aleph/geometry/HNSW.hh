@@ -0,0 +1,711 @@
+#ifndef ALEPH_GEOMETRY_HNSW_HH__
+#define ALEPH_GEOMETRY_HNSW_HH__
+
+#include <aleph/geometry/NearestNeighbours.hh>
+#include <aleph/geometry/distances/Traits.hh>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cmath>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+namespace detail
+{
+
+/**
+  Marks the nodes that have been visited during a graph search. Instead
+  of clearing all marks for every search, a new epoch is started, which
+  makes resetting the list a constant-time operation.
+*/
+
+class VisitedList
+{
+public:
+  explicit VisitedList( std::size_t n )
+    : _marks( n, 0 )
+    , _epoch( 0 )
+  {
+  }
+
+  /** Starts a new search, forgetting about all visited nodes */
+  void reset()
+  {
+    if( ++_epoch == 0 )
+    {
+      std::fill( _marks.begin(), _marks.end(), 0u );
+      _epoch = 1;
+    }
+  }
+
+  /**
+    Marks a node as visited.
+
+    @returns true if the node has not been visited before
+  */
+
+  bool visit( std::size_t i )
+  {
+    if( _marks[i] == _epoch )
+      return false;
+
+    _marks[i] = _epoch;
+    return true;
+  }
+
+private:
+  std::vector<unsigned> _marks;
+  unsigned _epoch;
+};
+
+} // namespace detail
+
+/**
+  @class HNSW
+  @brief Approximate nearest neighbours using a hierarchical navigable small world graph
+
+  This class implements the index described in the paper "Efficient and
+  robust approximate nearest neighbor search using Hierarchical Navigable
+  Small World graphs" by Malkov and Yashunin. Every point is assigned a
+  random level; the index contains a proximity graph for every level,
+  with the points of a level forming a subset of the points of all lower
+  levels. Queries descend greedily through the levels and perform a
+  beam search in the lowest level.
+
+  In contrast to kd-trees, the performance of the index does not degrade
+  with the dimension of the points, making it suitable for large sets of
+  high-dimensional points. The results are *approximate*, though, i.e. a
+  query may miss some of the actual neighbours. The recall is controlled
+  by the following parameters:
+
+  - `M`: Number of neighbours of every point in the upper levels, with
+    twice as many neighbours in the lowest level. Larger values increase
+    the recall at the expense of memory and construction time.
+
+  - `efConstruction`: Size of the beam during construction. Larger values
+    result in a graph of higher quality but increase construction time.
+
+  - `efSearch`: Size of the beam during queries. Larger values increase
+    the recall of queries but make them slower.
+
+  The graph is constructed in parallel and all queries are processed in
+  parallel if OpenMP is available. Since the interface only permits the
+  points of the index to be queried, the beam search of a query starts
+  directly at the query point instead of descending through the levels.
+  Distances are reported exactly, so a query never returns a point that
+  is too far away.
+*/
+
+template <class Container, class DistanceFunctor>
+class HNSW : public NearestNeighbours< HNSW<Container, DistanceFunctor>, std::size_t, typename Container::ElementType >
+{
+public:
+  using IndexType       = std::size_t;
+  using ElementType     = typename Container::ElementType;
+  using Traits          = aleph::geometry::distances::Traits<DistanceFunctor>;
+  using Distance        = DistanceFunctor;
+
+  /**
+    Builds the index for all points of a container. The points are copied
+    into a contiguous block of memory.
+
+    @param container      Container that stores the input data
+    @param M              Number of neighbours per point in the upper levels
+    @param efConstruction Size of the beam during construction
+    @param efSearch       Size of the beam during queries
+
+    @throws std::runtime_error if fewer than two neighbours are requested
+  */
+
+  explicit HNSW( const Container& container,
+                 unsigned M              = 16,
+                 unsigned efConstruction = 200,
+                 unsigned efSearch       = 64 )
+    : _dimension( static_cast<std::size_t>( container.dimension() ) )
+    , _size( static_cast<std::size_t>( container.size() ) )
+    , _M( M )
+    , _maxM0( 2 * M )
+    , _efConstruction( std::max( efConstruction, M ) )
+    , _efSearch( efSearch )
+  {
+    if( M < 2 )
+      throw std::runtime_error( "HNSW requires at least two neighbours per point" );
+
+    _points.reserve( _size * _dimension );
+
+    for( std::size_t i = 0; i < _size; i++ )
+    {
+      auto&& p = container.point( i );
+      _points.insert( _points.end(), p.begin(), p.begin() + static_cast<std::ptrdiff_t>( _dimension ) );
+    }
+
+    this->build();
+  }
+
+  void radiusSearch( ElementType radius,
+                     std::vector< std::vector<IndexType> >& indices,
+                     std::vector< std::vector<ElementType> >& distances ) const
+  {
+    indices.clear();
+    distances.clear();
+
+    indices.resize( _size );
+    distances.resize( _size );
+
+    if( _size == 0 )
+      return;
+
+    auto r = _traits.to( radius );
+
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      detail::VisitedList visited( _size );
+      std::vector<IndexType> buffer;
+
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 64)
+#endif
+      for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( _size ); s++ )
+      {
+        auto i = static_cast<std::size_t>( s );
+        auto q = this->point( i );
+        auto W = this->searchLevel( q, std::make_pair( this->distance( q, i ), i ), _efSearch, 0, visited, buffer );
+
+        // Starting from all points of the beam that satisfy the radius
+        // condition, the graph is traversed to collect all neighbours
+        // that satisfy the condition as well.
+
+        std::vector<Candidate> result;
+        std::vector<IndexType> queue;
+
+        visited.reset();
+
+        for( auto&& candidate : W )
+        {
+          visited.visit( candidate.second );
+
+          if( candidate.first < r )
+          {
+            result.push_back( candidate );
+            queue.push_back( candidate.second );
+          }
+        }
+
+        while( !queue.empty() )
+        {
+          auto j = queue.back();
+          queue.pop_back();
+
+          this->getNeighbours( j, 0, buffer );
+
+          for( auto&& l : buffer )
+          {
+            if( !visited.visit( l ) )
+              continue;
+
+            auto d = this->distance( q, l );
+            if( d < r )
+            {
+              result.push_back( std::make_pair( d, l ) );
+              queue.push_back( l );
+            }
+          }
+        }
+
+        std::sort( result.begin(), result.end() );
+        this->report( result, indices[i], distances[i] );
+      }
+    }
+  }
+
+  void neighbourSearch( unsigned k,
+                        std::vector< std::vector<IndexType> >& indices,
+                        std::vector< std::vector<ElementType> >& distances ) const
+  {
+    indices.clear();
+    distances.clear();
+
+    indices.resize( _size );
+    distances.resize( _size );
+
+    if( _size == 0 || k == 0 )
+      return;
+
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      detail::VisitedList visited( _size );
+      std::vector<IndexType> buffer;
+
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 64)
+#endif
+      for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( _size ); s++ )
+      {
+        auto i = static_cast<std::size_t>( s );
+        auto q = this->point( i );
+        auto W = this->searchLevel( q, std::make_pair( this->distance( q, i ), i ), std::max( _efSearch, k ), 0, visited, buffer );
+
+        if( W.size() > k )
+          W.resize( k );
+
+        this->report( W, indices[i], distances[i] );
+      }
+    }
+  }
+
+  std::size_t size() const noexcept
+  {
+    return _size;
+  }
+
+  /** @returns Size of the beam during queries */
+  unsigned efSearch() const noexcept
+  {
+    return _efSearch;
+  }
+
+  /** Changes the size of the beam during queries, e.g. to increase recall */
+  void setEfSearch( unsigned efSearch ) noexcept
+  {
+    _efSearch = efSearch;
+  }
+
+private:
+  using ResultType = typename DistanceFunctor::ResultType;
+
+  /** Pair of a distance and the index of a point */
+  using Candidate = std::pair<ResultType, IndexType>;
+
+  /** @returns Pointer to the coordinates of a point */
+  const ElementType* point( IndexType i ) const noexcept
+  {
+    return _points.data() + i * _dimension;
+  }
+
+  /** @returns Distance between a query point and a point of the index */
+  ResultType distance( const ElementType* q, IndexType j ) const
+  {
+    return _distance( q, this->point( j ), _dimension );
+  }
+
+  // Locking -----------------------------------------------------------
+  //
+  // During construction, every point is protected by a lock because its
+  // neighbours may be changed by other threads. After construction, the
+  // graph is read-only and no locks are required any more.
+
+  void lock( IndexType i ) const
+  {
+#ifdef _OPENMP
+    if( !_locks.empty() )
+      omp_set_lock( &_locks[i] );
+#else
+    (void) i;
+#endif
+  }
+
+  void unlock( IndexType i ) const
+  {
+#ifdef _OPENMP
+    if( !_locks.empty() )
+      omp_unset_lock( &_locks[i] );
+#else
+    (void) i;
+#endif
+  }
+
+  // Graph access ------------------------------------------------------
+
+  /** Copies the neighbours of a point in a level; the caller has to lock the point */
+  void readLinks( IndexType i, unsigned level, std::vector<IndexType>& neighbours ) const
+  {
+    if( level == 0 )
+    {
+      auto first = _links.begin() + static_cast<std::ptrdiff_t>( i * _maxM0 );
+      neighbours.assign( first, first + static_cast<std::ptrdiff_t>( _linkCounts[i] ) );
+    }
+    else
+      neighbours = _upperLinks[i][level-1];
+  }
+
+  /** Replaces the neighbours of a point in a level; the caller has to lock the point */
+  void writeLinks( IndexType i, unsigned level, const std::vector<IndexType>& neighbours )
+  {
+    if( level == 0 )
+    {
+      std::copy( neighbours.begin(), neighbours.end(), _links.begin() + static_cast<std::ptrdiff_t>( i * _maxM0 ) );
+      _linkCounts[i] = static_cast<unsigned>( neighbours.size() );
+    }
+    else
+      _upperLinks[i][level-1] = neighbours;
+  }
+
+  /** Copies the neighbours of a point in a level */
+  void getNeighbours( IndexType i, unsigned level, std::vector<IndexType>& neighbours ) const
+  {
+    this->lock( i );
+    this->readLinks( i, level, neighbours );
+    this->unlock( i );
+  }
+
+  // Search ------------------------------------------------------------
+
+  /**
+    Greedily moves towards the query point in all levels above the target
+    level, starting from the given candidate.
+  */
+
+  Candidate descend( const ElementType* q, Candidate current, unsigned level, unsigned target, std::vector<IndexType>& buffer ) const
+  {
+    for( unsigned l = level; l > target; l-- )
+    {
+      bool changed = true;
+
+      while( changed )
+      {
+        changed = false;
+
+        this->getNeighbours( current.second, l, buffer );
+
+        for( auto&& j : buffer )
+        {
+          auto d = this->distance( q, j );
+          if( d < current.first )
+          {
+            current = std::make_pair( d, j );
+            changed = true;
+          }
+        }
+      }
+    }
+
+    return current;
+  }
+
+  /**
+    Performs a beam search in a single level, starting from the given
+    candidate.
+
+    @returns At most ef points, sorted by their distance to the query
+  */
+
+  std::vector<Candidate> searchLevel( const ElementType* q,
+                                      const Candidate& entry,
+                                      unsigned ef,
+                                      unsigned level,
+                                      detail::VisitedList& visited,
+                                      std::vector<IndexType>& buffer ) const
+  {
+    visited.reset();
+    visited.visit( entry.second );
+
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > candidates;
+    std::priority_queue<Candidate> results;
+
+    candidates.push( entry );
+    results.push( entry );
+
+    while( !candidates.empty() )
+    {
+      auto candidate = candidates.top();
+
+      // All remaining candidates are farther away than the farthest
+      // result, so they cannot improve the results.
+      if( candidate.first > results.top().first )
+        break;
+
+      candidates.pop();
+
+      this->getNeighbours( candidate.second, level, buffer );
+
+      for( auto&& j : buffer )
+      {
+        if( !visited.visit( j ) )
+          continue;
+
+        auto d = this->distance( q, j );
+
+        if( results.size() < ef || d < results.top().first )
+        {
+          candidates.push( std::make_pair( d, j ) );
+          results.push( std::make_pair( d, j ) );
+
+          if( results.size() > ef )
+            results.pop();
+        }
+      }
+    }
+
+    std::vector<Candidate> result;
+    result.reserve( results.size() );
+
+    while( !results.empty() )
+    {
+      result.push_back( results.top() );
+      results.pop();
+    }
+
+    std::reverse( result.begin(), result.end() );
+    return result;
+  }
+
+  /**
+    Selects at most m neighbours from a set of candidates that is sorted
+    by distance. A candidate is only selected if it is closer to the
+    query point than to all previously-selected neighbours, which keeps
+    the graph navigable for clustered data.
+  */
+
+  std::vector<IndexType> selectNeighbours( const std::vector<Candidate>& candidates, unsigned m ) const
+  {
+    std::vector<IndexType> result;
+    result.reserve( m );
+
+    for( auto&& candidate : candidates )
+    {
+      if( result.size() >= m )
+        break;
+
+      auto p    = this->point( candidate.second );
+      bool good = std::none_of( result.begin(), result.end(), [this, &p, &candidate] ( IndexType j )
+        {
+          return this->distance( p, j ) < candidate.first;
+        }
+      );
+
+      if( good )
+        result.push_back( candidate.second );
+    }
+
+    return result;
+  }
+
+  // Construction ------------------------------------------------------
+
+  /** Adds a point to the neighbours of another point in a given level */
+  void connect( IndexType j, IndexType i, unsigned level, std::vector<IndexType>& buffer )
+  {
+    auto maxM = level == 0 ? _maxM0 : _M;
+
+    this->lock( j );
+    this->readLinks( j, level, buffer );
+
+    if( buffer.size() < maxM )
+      buffer.push_back( i );
+
+    // Shrink the neighbourhood by choosing among the old neighbours and
+    // the new point.
+    else
+    {
+      auto p = this->point( j );
+
+      std::vector<Candidate> candidates;
+      candidates.reserve( buffer.size() + 1 );
+
+      for( auto&& l : buffer )
+        candidates.push_back( std::make_pair( this->distance( p, l ), l ) );
+
+      candidates.push_back( std::make_pair( this->distance( p, i ), i ) );
+
+      std::sort( candidates.begin(), candidates.end() );
+      buffer = this->selectNeighbours( candidates, maxM );
+    }
+
+    this->writeLinks( j, level, buffer );
+    this->unlock( j );
+  }
+
+  /** Inserts a point into all levels up to its own level */
+  void insert( IndexType i, detail::VisitedList& visited, std::vector<IndexType>& buffer )
+  {
+    auto q     = this->point( i );
+    auto level = _levels[i];
+    auto entry = std::make_pair( this->distance( q, _entryPoint ), _entryPoint );
+
+    if( _maxLevel > level )
+      entry = this->descend( q, entry, _maxLevel, level, buffer );
+
+    for( unsigned l = std::min( level, _maxLevel ) + 1; l-- > 0; )
+    {
+      auto W = this->searchLevel( q, entry, _efConstruction, l, visited, buffer );
+
+      W.erase( std::remove_if( W.begin(), W.end(), [&i] ( const Candidate& c ) { return c.second == i; } ), W.end() );
+
+      if( W.empty() )
+        continue;
+
+      auto neighbours = this->selectNeighbours( W, _M );
+
+      this->lock( i );
+      this->writeLinks( i, l, neighbours );
+      this->unlock( i );
+
+      for( auto&& j : neighbours )
+        this->connect( j, i, l, buffer );
+
+      entry = W.front();
+    }
+  }
+
+  /**
+    Builds the graph. Every point is assigned a random level, following
+    an exponential distribution. The point with the largest level is the
+    entry point of all searches, and the remaining points are inserted
+    in parallel, in descending order of their levels.
+  */
+
+  void build()
+  {
+    if( _size == 0 )
+      return;
+
+    std::mt19937 rng( 42 );
+    std::uniform_real_distribution<double> distribution( 0.0, 1.0 );
+
+    auto mL = 1.0 / std::log( static_cast<double>( _M ) );
+
+    _levels.resize( _size );
+    _upperLinks.resize( _size );
+
+    for( std::size_t i = 0; i < _size; i++ )
+    {
+      _levels[i] = static_cast<unsigned>( std::floor( -std::log( 1.0 - distribution( rng ) ) * mL ) );
+      _upperLinks[i].resize( _levels[i] );
+    }
+
+    _links.resize( _size * _maxM0 );
+    _linkCounts.resize( _size );
+
+    std::vector<IndexType> order( _size );
+    std::iota( order.begin(), order.end(), IndexType(0) );
+    std::shuffle( order.begin(), order.end(), rng );
+
+    std::stable_sort( order.begin(), order.end(), [this] ( IndexType i, IndexType j )
+      {
+        return _levels[i] > _levels[j];
+      }
+    );
+
+    _entryPoint = order.front();
+    _maxLevel   = _levels[ _entryPoint ];
+
+#ifdef _OPENMP
+    _locks.resize( _size );
+
+    for( auto&& lock : _locks )
+      omp_init_lock( &lock );
+
+    #pragma omp parallel
+#endif
+    {
+      detail::VisitedList visited( _size );
+      std::vector<IndexType> buffer;
+
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 64)
+#endif
+      for( std::ptrdiff_t s = 1; s < static_cast<std::ptrdiff_t>( _size ); s++ )
+        this->insert( order[ static_cast<std::size_t>( s ) ], visited, buffer );
+    }
+
+#ifdef _OPENMP
+    for( auto&& lock : _locks )
+      omp_destroy_lock( &lock );
+
+    _locks.clear();
+#endif
+  }
+
+  /** Converts candidates into indices and distances */
+  void report( const std::vector<Candidate>& candidates,
+               std::vector<IndexType>& indices,
+               std::vector<ElementType>& distances ) const
+  {
+    indices.clear();
+    distances.clear();
+
+    indices.reserve( candidates.size() );
+    distances.reserve( candidates.size() );
+
+    for( auto&& candidate : candidates )
+    {
+      indices.push_back( candidate.second );
+      distances.push_back( static_cast<ElementType>( _traits.from( candidate.first ) ) );
+    }
+  }
+
+  /** Dimension of the points */
+  std::size_t _dimension;
+
+  /** Number of points */
+  std::size_t _size;
+
+  /** Number of neighbours per point in the upper levels */
+  unsigned _M;
+
+  /** Number of neighbours per point in the lowest level */
+  unsigned _maxM0;
+
+  /** Size of the beam during construction */
+  unsigned _efConstruction;
+
+  /** Size of the beam during queries */
+  unsigned _efSearch;
+
+  /** Coordinates of all points, stored contiguously */
+  std::vector<ElementType> _points;
+
+  /** Level of every point */
+  std::vector<unsigned> _levels;
+
+  /** Neighbours in the lowest level, using a fixed number of slots per point */
+  std::vector<IndexType> _links;
+
+  /** Number of neighbours in the lowest level */
+  std::vector<unsigned> _linkCounts;
+
+  /** Neighbours in all upper levels that a point belongs to */
+  std::vector< std::vector< std::vector<IndexType> > > _upperLinks;
+
+  /** Entry point of all searches, i.e. the point with the largest level */
+  IndexType _entryPoint = 0;
+
+  /** Level of the entry point */
+  unsigned _maxLevel = 0;
+
+#ifdef _OPENMP
+  /** Locks for every point, which are only used during construction */
+  mutable std::vector<omp_lock_t> _locks;
+#endif
+
+  /** Distance functor */
+  DistanceFunctor _distance;
+
+  /** Required for optional distance functor conversions */
+  Traits _traits;
+};
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
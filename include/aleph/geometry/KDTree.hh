@@ -0,0 +1,385 @@
+#ifndef ALEPH_GEOMETRY_KD_TREE_HH__
+#define ALEPH_GEOMETRY_KD_TREE_HH__
+
+#include <aleph/geometry/NearestNeighbours.hh>
+#include <aleph/geometry/distances/Traits.hh>
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+/**
+  @class KDTree
+  @brief Exact nearest neighbours using a kd-tree
+
+  Stores the points of a container in a kd-tree. Every inner node splits
+  its points at the median of the coordinate with the largest spread,
+  while leaves store small buckets of points, which are compared to the
+  query point with the vectorised distance kernels.
+
+  In contrast to the FLANN wrapper, this class does not require external
+  libraries and its results are always *exact*. Like FLANN, the distance
+  functor has to support the calculation of partial distances by means
+  of the `accum_dist()` function, which is used to prune subtrees whose
+  splitting plane is too far away from the query point.
+
+  Queries are processed in parallel if OpenMP is available. Their results
+  are sorted by distance, and they are consistent with the ones of the
+  other wrappers, i.e. the results of a point include the point itself,
+  and radius queries only report points whose distance is strictly
+  smaller than the radius. The performance of kd-trees degrades with the
+  dimension of the points, so they are most suitable for low-dimensional
+  data.
+*/
+
+template <class Container, class DistanceFunctor>
+class KDTree : public NearestNeighbours< KDTree<Container, DistanceFunctor>, typename Container::ElementType, std::size_t >
+{
+public:
+  using IndexType       = std::size_t;
+  using ElementType     = typename Container::ElementType;
+  using Traits          = aleph::geometry::distances::Traits<DistanceFunctor>;
+  using Distance        = DistanceFunctor;
+
+  /**
+    Builds the kd-tree for all points of a container. The points are
+    copied into a contiguous block of memory.
+
+    @param container Container that stores the input data
+    @param leafSize  Maximum number of points in a leaf
+  */
+
+  explicit KDTree( const Container& container, std::size_t leafSize = 16 )
+    : _dimension( static_cast<std::size_t>( container.dimension() ) )
+    , _size( static_cast<std::size_t>( container.size() ) )
+    , _leafSize( std::max( leafSize, std::size_t(1) ) )
+  {
+    _points.reserve( _size * _dimension );
+
+    for( std::size_t i = 0; i < _size; i++ )
+    {
+      auto&& p = container.point( i );
+      _points.insert( _points.end(), p.begin(), p.begin() + static_cast<std::ptrdiff_t>( _dimension ) );
+    }
+
+    _indices.resize( _size );
+    std::iota( _indices.begin(), _indices.end(), IndexType() );
+
+    if( _size > 0 )
+      this->build( 0, _size );
+  }
+
+  void radiusSearch( ElementType radius,
+                     std::vector< std::vector<IndexType> >& indices,
+                     std::vector< std::vector<ElementType> >& distances ) const
+  {
+    indices.clear();
+    distances.clear();
+
+    indices.resize( _size );
+    distances.resize( _size );
+
+    auto r = _traits.to( radius );
+
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      std::vector<Candidate> result;
+      std::vector<Entry> stack;
+
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 64)
+#endif
+      for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( _size ); s++ )
+      {
+        auto i = static_cast<std::size_t>( s );
+        auto q = this->point( i );
+
+        result.clear();
+        stack.assign( 1, Entry( ResultType(), 0 ) );
+
+        while( !stack.empty() )
+        {
+          auto entry = stack.back();
+          stack.pop_back();
+
+          if( !( entry.first < r ) )
+            continue;
+
+          auto&& node = _nodes[ entry.second ];
+
+          if( node.isLeaf() )
+          {
+            for( std::size_t k = node.begin; k < node.end; k++ )
+            {
+              auto j = _indices[k];
+              auto d = this->distance( q, j );
+
+              if( d < r )
+                result.push_back( std::make_pair( d, j ) );
+            }
+          }
+          else
+            this->descend( q, node, entry.first, stack );
+        }
+
+        std::sort( result.begin(), result.end() );
+        this->report( result, indices[i], distances[i] );
+      }
+    }
+  }
+
+  void neighbourSearch( unsigned k,
+                        std::vector< std::vector<IndexType> >& indices,
+                        std::vector< std::vector<ElementType> >& distances ) const
+  {
+    indices.clear();
+    distances.clear();
+
+    indices.resize( _size );
+    distances.resize( _size );
+
+    if( _size == 0 || k == 0 )
+      return;
+
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      std::vector<Entry> stack;
+
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 64)
+#endif
+      for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( _size ); s++ )
+      {
+        auto i = static_cast<std::size_t>( s );
+        auto q = this->point( i );
+
+        // Max-heap of the best candidates found so far; its top element
+        // bounds the distance of subtrees that remain to be visited.
+        std::priority_queue<Candidate> heap;
+
+        stack.assign( 1, Entry( ResultType(), 0 ) );
+
+        while( !stack.empty() )
+        {
+          auto entry = stack.back();
+          stack.pop_back();
+
+          if( heap.size() == k && !( entry.first < heap.top().first ) )
+            continue;
+
+          auto&& node = _nodes[ entry.second ];
+
+          if( node.isLeaf() )
+          {
+            for( std::size_t l = node.begin; l < node.end; l++ )
+            {
+              auto j         = _indices[l];
+              auto candidate = std::make_pair( this->distance( q, j ), j );
+
+              if( heap.size() < k )
+                heap.push( candidate );
+              else if( candidate < heap.top() )
+              {
+                heap.pop();
+                heap.push( candidate );
+              }
+            }
+          }
+          else
+            this->descend( q, node, entry.first, stack );
+        }
+
+        std::vector<Candidate> result;
+        result.reserve( heap.size() );
+
+        while( !heap.empty() )
+        {
+          result.push_back( heap.top() );
+          heap.pop();
+        }
+
+        std::reverse( result.begin(), result.end() );
+        this->report( result, indices[i], distances[i] );
+      }
+    }
+  }
+
+  std::size_t size() const noexcept
+  {
+    return _size;
+  }
+
+private:
+  using ResultType = typename DistanceFunctor::ResultType;
+  using Candidate  = std::pair<ResultType, IndexType>;
+
+  /** Lower bound of the distance to the points of a node, and its index */
+  using Entry      = std::pair<ResultType, std::size_t>;
+
+  /** Node of the tree; leaves do not have any children */
+  struct Node
+  {
+    std::size_t begin;
+    std::size_t end;
+    std::size_t left;
+    std::size_t right;
+    std::size_t axis;
+    ElementType split;
+
+    bool isLeaf() const noexcept
+    {
+      return left == 0 && right == 0;
+    }
+  };
+
+  /** @returns Pointer to the coordinates of the ith point */
+  const ElementType* point( IndexType i ) const noexcept
+  {
+    return _points.data() + i * _dimension;
+  }
+
+  ResultType distance( const ElementType* q, IndexType i ) const
+  {
+    return _distance( q, this->point( i ), _dimension );
+  }
+
+  /**
+    Builds the subtree for a range of points and returns the index of its
+    root. Since the root of the tree is stored at index 0, no other node
+    refers to it, so an index of 0 indicates a missing child.
+  */
+
+  std::size_t build( std::size_t begin, std::size_t end )
+  {
+    auto index = _nodes.size();
+    _nodes.push_back( Node{ begin, end, 0, 0, 0, ElementType() } );
+
+    if( end - begin <= _leafSize || _dimension == 0 )
+      return index;
+
+    // Determines the coordinate with the largest spread ---------------
+
+    std::size_t axis   = 0;
+    ElementType spread = ElementType();
+
+    for( std::size_t k = 0; k < _dimension; k++ )
+    {
+      auto minmax = std::minmax_element( _indices.begin() + static_cast<std::ptrdiff_t>( begin ),
+                                         _indices.begin() + static_cast<std::ptrdiff_t>( end ),
+                                         [this, k] ( IndexType i, IndexType j )
+                                         {
+                                           return this->point( i )[k] < this->point( j )[k];
+                                         } );
+
+      auto s = this->point( *minmax.second )[k] - this->point( *minmax.first )[k];
+
+      if( s > spread )
+      {
+        axis   = k;
+        spread = s;
+      }
+    }
+
+    // All points are identical, so they cannot be split any further
+    if( !( spread > ElementType() ) )
+      return index;
+
+    // Splits the points at the median ---------------------------------
+
+    auto middle = begin + ( end - begin ) / 2;
+
+    std::nth_element( _indices.begin() + static_cast<std::ptrdiff_t>( begin ),
+                      _indices.begin() + static_cast<std::ptrdiff_t>( middle ),
+                      _indices.begin() + static_cast<std::ptrdiff_t>( end ),
+                      [this, axis] ( IndexType i, IndexType j )
+                      {
+                        return this->point( i )[axis] < this->point( j )[axis];
+                      } );
+
+    auto split  = this->point( _indices[middle] )[axis];
+    auto left   = this->build( begin, middle );
+    auto right  = this->build( middle, end );
+
+    _nodes[index].left  = left;
+    _nodes[index].right = right;
+    _nodes[index].axis  = axis;
+    _nodes[index].split = split;
+
+    return index;
+  }
+
+  /**
+    Pushes the children of an inner node onto the stack of a query, such
+    that the child containing the query point is visited first. Points in
+    the other child are at least as far away as the splitting plane.
+  */
+
+  void descend( const ElementType* q, const Node& node, ResultType bound, std::vector<Entry>& stack ) const
+  {
+    auto x     = q[node.axis];
+    auto plane = _distance.accum_dist( x, node.split, static_cast<int>( node.axis ) );
+
+    auto near  = x < node.split ? node.left : node.right;
+    auto far   = x < node.split ? node.right : node.left;
+
+    stack.push_back( Entry( std::max( bound, ResultType( plane ) ), far ) );
+    stack.push_back( Entry( bound, near ) );
+  }
+
+  /** Stores the candidates of a query, converting their distances */
+  void report( const std::vector<Candidate>& candidates,
+               std::vector<IndexType>& indices,
+               std::vector<ElementType>& distances ) const
+  {
+    indices.reserve( candidates.size() );
+    distances.reserve( candidates.size() );
+
+    for( auto&& candidate : candidates )
+    {
+      indices.push_back( candidate.second );
+      distances.push_back( static_cast<ElementType>( _traits.from( candidate.first ) ) );
+    }
+  }
+
+  /** Dimension of all points */
+  std::size_t _dimension;
+
+  /** Number of points */
+  std::size_t _size;
+
+  /** Maximum number of points in a leaf */
+  std::size_t _leafSize;
+
+  /** Coordinates of all points in row-major order */
+  std::vector<ElementType> _points;
+
+  /** Indices of all points, ordered such that every node refers to a range */
+  std::vector<IndexType> _indices;
+
+  /** Nodes of the tree; the root is stored first */
+  std::vector<Node> _nodes;
+
+  /** Distance functor */
+  DistanceFunctor _distance;
+
+  /** Required for optional distance functor conversions */
+  Traits _traits;
+};
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
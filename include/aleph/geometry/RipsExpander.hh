@@ -114,9 +114,9 @@ public:
       {
         auto w = s.data();
 
-        for( auto itFace = s.begin_boundary(); itFace != s.end_boundary(); ++itFace )
+        for( std::size_t i = 0; i < s.boundarySize(); i++ )
         {
-          auto itFaceInS = S.find( *itFace );
+          auto itFaceInS = S.find( s.face( i ) );
           if( itFaceInS != S.end() )
             w = std::max( w, itFaceInS->data() );
         }
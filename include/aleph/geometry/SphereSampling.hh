@@ -19,7 +19,9 @@ namespace geometry
   points per area of the sphere is uniform. Only the angular values of
   the sampled points (\f$\theta\f$, \f$\phi\f$) will be returned.
 
-  @param n Number of samples to draw
+  @param n   Number of samples to draw
+  @param rng Random number generator; using a generator with a fixed
+             seed makes the samples reproducible
 
   @returns Vector of angle values, i.e. \f$\theta\f$ and \f$\phi\f$,
            which are sufficient to describe the sphere. Please use
@@ -27,12 +29,9 @@ namespace geometry
            from the resulting angles.
 */
 
-template <class T>
-std::vector< std::pair<T, T> > sphereSampling( unsigned n )
+template <class T, class Engine>
+std::vector< std::pair<T, T> > sphereSampling( unsigned n, Engine& rng )
 {
-  std::random_device rd;
-  std::mt19937 rng( rd() );
-
   std::vector< std::pair<T, T> > angles;
   angles.reserve( n );
 
@@ -52,6 +51,22 @@ std::vector< std::pair<T, T> > sphereSampling( unsigned n )
   return angles;
 }
 
+/**
+  Samples \f$n\f$ points from a sphere, using a random number generator
+  with a random seed.
+
+  @see sphereSampling( unsigned, Engine& )
+*/
+
+template <class T>
+std::vector< std::pair<T, T> > sphereSampling( unsigned n )
+{
+  std::random_device rd;
+  std::mt19937 rng( rd() );
+
+  return sphereSampling<T>( n, rng );
+}
+
 /**
   Converts a vector of angles into a point cloud that contains samples
   from a sphere of a given radius.
@@ -465,7 +465,7 @@ private:
   template <class Container> Vector getPosition( const Container& container, std::size_t i )
   {
     auto d   = container.dimension();
-    auto p   = container[i];
+    auto p   = container.point( i );
     Vector v = Vector::Zero(1, Index(d) );
 
     // copy (and transform!) the vector; there's an implicit type
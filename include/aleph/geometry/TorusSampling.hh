@@ -21,7 +21,9 @@ namespace geometry
 
   @param R Inner radius
   @param r Outer radius
-  @param n Number of samples to draw
+  @param n   Number of samples to draw
+  @param rng Random number generator; using a generator with a fixed
+             seed makes the samples reproducible
 
   @returns Vector of angle values, i.e. \f$\theta\f$ and \f$\psi\f$,
            which are sufficient to describe a torus. Please use
@@ -29,17 +31,12 @@ namespace geometry
            from the resulting angles.
 */
 
-template <class T>
+template <class T, class Engine>
 std::vector< std::pair<T, T> > torusRejectionSampling( T R,
                                                        T r,
-                                                       unsigned n )
+                                                       unsigned n,
+                                                       Engine& rng )
 {
-  std::random_device rd;
-
-  std::mt19937 rngPsi( rd() );
-  std::mt19937 rngX( rd() );
-  std::mt19937 rngY( rd() );
-
   // I do not store the values of theta directly, but instead report directly
   // those angles that are deemed to be "correct".
   std::vector< std::pair<T, T> > angles;
@@ -51,17 +48,35 @@ std::vector< std::pair<T, T> > torusRejectionSampling( T R,
 
   while( angles.size() < n )
   {
-    auto x = xDistribution( rngX );
-    auto y = yDistribution( rngY );
+    auto x = xDistribution( rng );
+    auto y = yDistribution( rng );
     auto f = static_cast<T>( 1.0 + (r/R) * std::cos( x ) ) / ( 2.0 * M_PI );
 
     if( y < f )
-      angles.push_back( std::make_pair( x, psiDistribution( rngPsi ) ) );
+      angles.push_back( std::make_pair( x, psiDistribution( rng ) ) );
   }
 
   return angles;
 }
 
+/**
+  Samples exactly \f$n\f$ points from a torus, using a random number
+  generator with a random seed.
+
+  @see torusRejectionSampling( T, T, unsigned, Engine& )
+*/
+
+template <class T>
+std::vector< std::pair<T, T> > torusRejectionSampling( T R,
+                                                       T r,
+                                                       unsigned n )
+{
+  std::random_device rd;
+  std::mt19937 rng( rd() );
+
+  return torusRejectionSampling( R, r, n, rng );
+}
+
 /**
   Converts a vector of angles into a point cloud that contains samples
   from a torus.
@@ -4,11 +4,15 @@
 #include <aleph/geometry/RipsExpander.hh>
 #include <aleph/geometry/RipsSkeleton.hh>
 
+#include <aleph/math/SymmetricMatrix.hh>
+
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
 #include <aleph/topology/filtrations/Data.hh>
 
+#include <vector>
+
 namespace aleph
 {
 
@@ -95,6 +99,58 @@ auto buildVietorisRipsComplex(
   return K;
 }
 
+/**
+  Convenience function for building a Vietoris--Rips complex from a matrix
+  of pairwise distances, as calculated by distanceMatrix(), for example.
+  The complex uses the same weights as the complex that is built from a
+  wrapper for nearest neighbours, i.e. 1-simplices are weighted by their
+  distance and higher-dimensional simplices by the maximum weight of
+  their faces. As for the wrappers, an edge is only added if its length
+  is strictly smaller than the threshold.
+*/
+
+template <class T, class I> auto buildVietorisRipsComplex(
+  const math::SymmetricMatrix<T, I>& distances,
+  T epsilon,
+  unsigned dimension ) -> topology::SimplicialComplex< topology::Simplex<T, I> >
+{
+  using Simplex           = topology::Simplex<T, I>;
+  using SimplicialComplex = topology::SimplicialComplex<Simplex>;
+
+  auto n    = distances.numRows();
+  auto data = distances.data();
+
+  std::vector<Simplex> simplices;
+  simplices.reserve( n );
+
+  for( I i = 0; i < n; i++ )
+    simplices.push_back( Simplex( i ) );
+
+  for( I i = 0; i < n; i++ )
+  {
+    // Traverses the upper triangular part of the ith row directly, which
+    // is stored contiguously
+    auto row = data + distances.rowOffset( i );
+
+    for( I j = i+1; j < n; j++ )
+    {
+      if( row[j] < epsilon )
+        simplices.push_back( Simplex( {i,j}, row[j] ) );
+    }
+  }
+
+  SimplicialComplex skeleton( simplices.begin(), simplices.end() );
+
+  geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+  auto K = ripsExpander( skeleton, dimension );
+  K      = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( topology::filtrations::Data<Simplex>() );
+
+  return K;
+}
+
 } // namespace geometry
 
 } // namespace aleph
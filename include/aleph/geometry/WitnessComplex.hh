@@ -7,14 +7,15 @@
 #include <numeric>
 #include <random>
 #include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <aleph/geometry/RipsExpander.hh>
 
 #include <aleph/geometry/distances/Traits.hh>
 
-#include <aleph/math/SymmetricMatrix.hh>
-
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
@@ -26,6 +27,187 @@ namespace aleph
 namespace geometry
 {
 
+namespace detail
+{
+
+/**
+  Enumerates all simplices that consist of the candidate landmarks of
+  a single witness and stores them in a map, along with the smallest
+  value for which they have been witnessed so far. The candidates are
+  required to be sorted by their distance to the witness, so the value
+  of each simplex is the distance of its last vertex.
+
+  @param candidates Landmarks and their distances to the witness
+  @param start      Index of the first candidate that may be added
+  @param maxSize    Maximum number of vertices of a simplex
+  @param vertices   Vertices of the current simplex
+  @param simplices  Map of all witnessed simplices
+*/
+
+template <class DataType, class VertexType, class Map>
+void enumerateWitnessedSimplices( const std::vector< std::pair<DataType, VertexType> >& candidates,
+                                  std::size_t start,
+                                  std::size_t maxSize,
+                                  std::vector<VertexType>& vertices,
+                                  Map& simplices )
+{
+  using Simplex = typename Map::key_type;
+
+  for( std::size_t i = start; i < candidates.size(); i++ )
+  {
+    vertices.push_back( candidates[i].second );
+
+    if( vertices.size() >= 2 )
+    {
+      auto value = candidates[i].first;
+      auto it    = simplices.find( Simplex( vertices.begin(), vertices.end() ) );
+
+      if( it == simplices.end() )
+        simplices.emplace( Simplex( vertices.begin(), vertices.end() ), value );
+      else
+        it->second = std::min( it->second, value );
+    }
+
+    if( vertices.size() < maxSize )
+      enumerateWitnessedSimplices( candidates, i + 1, maxSize, vertices, simplices );
+
+    vertices.pop_back();
+  }
+}
+
+/**
+  Calculates all simplices with at most \p maxSize vertices that are
+  witnessed by at least one point of the container. In the notation of
+  buildWitnessComplex(), a witness \f$i\f$ witnesses all simplices whose
+  landmarks satisfy \f$\mathrm{dist}_{a,i} \leq R + m_i\f$. It is hence
+  sufficient to select these landmarks for every witness, instead of
+  evaluating every simplex for every witness.
+
+  Witnesses are processed in parallel. Only a single row of distances is
+  stored per thread, so the memory requirements do not depend on the
+  number of witnesses.
+
+  @returns Unsorted simplices, including all landmarks as vertices
+*/
+
+template <
+  class Simplex,
+  class Distance,
+  class Container,
+  class IndexType
+> std::vector<Simplex> witnessedSimplices( const Container& container,
+                                           const std::vector<IndexType>& landmarkIndices,
+                                           std::size_t maxSize,
+                                           unsigned nu,
+                                           typename Distance::ResultType R )
+{
+  using DataType   = typename Simplex::DataType;
+  using VertexType = typename Simplex::VertexType;
+  using Traits     = aleph::geometry::distances::Traits<Distance>;
+  using Point      = typename std::decay<decltype( container.point( 0 ) )>::type;
+  using Coordinate = typename Point::value_type;
+  using Map        = std::unordered_map<Simplex, DataType>;
+
+  auto n = landmarkIndices.size();
+  auto N = container.size();
+  auto d = container.dimension();
+
+  if( nu > n )
+    throw std::out_of_range( "Parameter nu must not exceed number of landmarks" );
+
+  // Copy the coordinates of all landmarks into a single block of memory
+  // because they are traversed for every witness.
+  std::vector<Coordinate> landmarks;
+  landmarks.reserve( n * d );
+
+  for( auto&& index : landmarkIndices )
+  {
+    auto&& landmark = container.point( index );
+    landmarks.insert( landmarks.end(), landmark.begin(), landmark.begin() + static_cast<std::ptrdiff_t>( d ) );
+  }
+
+  Map simplices;
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    Distance dist;
+    Traits traits;
+
+    Map localSimplices;
+
+    std::vector<DataType> distances( n );
+    std::vector<DataType> buffer;
+    std::vector< std::pair<DataType, VertexType> > candidates;
+    std::vector<VertexType> vertices;
+
+    auto numWitnesses = static_cast<std::ptrdiff_t>( N );
+
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for( std::ptrdiff_t k = 0; k < numWitnesses; k++ )
+    {
+      auto&& point = container.point( static_cast<decltype(N)>( k ) );
+
+      for( std::size_t i = 0; i < n; i++ )
+        distances[i] = traits.from( dist( landmarks.begin() + static_cast<std::ptrdiff_t>( i * d ), point.begin(), d ) );
+
+      // Only the $\nu$th smallest distance is required, so a partial
+      // selection is sufficient.
+      auto threshold = R;
+
+      if( nu != 0 )
+      {
+        buffer = distances;
+
+        std::nth_element( buffer.begin(), buffer.begin() + nu - 1, buffer.end() );
+        threshold = R + buffer[nu - 1];
+      }
+
+      candidates.clear();
+
+      for( std::size_t i = 0; i < n; i++ )
+      {
+        if( distances[i] <= threshold )
+          candidates.emplace_back( distances[i], static_cast<VertexType>( i ) );
+      }
+
+      std::sort( candidates.begin(), candidates.end() );
+      enumerateWitnessedSimplices( candidates, 0, maxSize, vertices, localSimplices );
+    }
+
+#ifdef _OPENMP
+    #pragma omp critical
+#endif
+    {
+      for( auto&& pair : localSimplices )
+      {
+        auto it = simplices.find( pair.first );
+
+        if( it == simplices.end() )
+          simplices.insert( pair );
+        else
+          it->second = std::min( it->second, pair.second );
+      }
+    }
+  }
+
+  std::vector<Simplex> result;
+  result.reserve( n + simplices.size() );
+
+  for( std::size_t i = 0; i < n; i++ )
+    result.push_back( Simplex( static_cast<VertexType>(i) ) );
+
+  for( auto&& pair : simplices )
+    result.push_back( Simplex( pair.first, pair.second ) );
+
+  return result;
+}
+
+} // namespace detail
+
 /**
   Builds a witness complex from a given container. This requires a set
   of *landmarks*. Other configuration options influence how a new edge
@@ -106,7 +288,6 @@ template <
   using IndexType         = typename std::iterator_traits<InputIterator>::value_type;
   using VertexType        = IndexType;
   using DataType          = typename Distance::ResultType;
-  using Traits            = aleph::geometry::distances::Traits<Distance>;
   using Simplex           = topology::Simplex<DataType, VertexType>;
   using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
@@ -123,90 +304,70 @@ template <
   if( n == 0 || N == 0 )
     return {};
 
-  // Distance matrix between a set of $n$ landmarks (cols) and $N$ data
-  // points (rows). Note that I transposed the matrix because accessing
-  // the columns is faster that way (and will be required later on).
-  std::vector< std::vector<DataType> > D;
-  D.reserve( N );
+  // Only edges are created from the witnesses; all higher-dimensional
+  // simplices are obtained by expansion.
+  auto simplices = detail::witnessedSimplices<Simplex, Distance>( container, landmarkIndices, 2, nu, R );
 
-  Distance dist;
-  Traits traits;
-
-  for( std::size_t j = 0; j < N; j++ )
-  {
-    std::vector<DataType> distances;
-    distances.reserve( n );
-
-    auto&& point = container[j];
-
-    for( std::size_t i = 0; i < n; i++ )
-    {
-      auto&& landmark = container[ landmarkIndices.at(i) ];
-
-      distances.emplace_back( traits.from( dist( landmark.begin(), point.begin(), d ) ) );
-    }
-
-    D.push_back( distances );
-  }
-
-  // Get smallest entries of the distance matrix. This is required for
-  // deciding whether a specific edge is valid or not, with respect to
-  // the given parameters.
-
-  std::vector<DataType> smallest( N );
-
-  if( nu != 0 )
-  {
-    for( std::size_t col = 0; col < N; col++ )
-    {
-      std::vector<DataType> column = D[col];
-
-      std::nth_element( column.begin(), column.begin() + nu - 1, column.end() );
-      smallest[col] = column.at( nu - 1 );
-    }
-  }
-
-  // -------------------------------------------------------------------
-  //
-  // Records the appearance times of each potential edge in the witness
-  // complex and creates the valid edges.
+  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
 
-  std::vector<Simplex> simplices;
+  SimplicialComplex K = SimplicialComplex( simplices.begin(), simplices.end() );
+  SimplicialComplex L = ripsExpander( K, dimension == 0 ? static_cast<unsigned>( d + 1 ) : dimension );
+  L                   = ripsExpander.assignMaximumWeight( L );
 
-  aleph::math::SymmetricMatrix<DataType> M( n );
+  L.sort( aleph::topology::filtrations::Data<Simplex>() );
+  return L;
+}
 
-  for( std::size_t i = 0; i < n; i++ )
-  {
-    simplices.push_back( Simplex( static_cast<VertexType>(i) ) );
+/**
+  Builds a witness complex whose higher-dimensional simplices are also
+  created directly from the witnesses. Whereas buildWitnessComplex()
+  creates edges and expands them, this function only adds a simplex if
+  a *single* witness witnesses all of its vertices, i.e. if all of them
+  satisfy the edge criterion for this witness. The data of a simplex is
+  the smallest maximum distance of its vertices to such a witness.
+
+  The resulting complex is a subcomplex of the expanded witness complex
+  with the same edges and is typically much smaller. All parameters are
+  used in the same way as for buildWitnessComplex().
+
+  @see buildWitnessComplex()
+*/
 
-    for( std::size_t j = i+1; j < n; j++ )
-    {
-      auto min = std::numeric_limits<DataType>::max();
+template <
+  class Distance,
+  class Container,
+  class InputIterator
+> auto buildDirectWitnessComplex(
+  const Container& container,
+  InputIterator begin,
+  InputIterator end,
+  unsigned dimension = 0,
+  unsigned nu = 2,
+  typename Distance::ResultType R = typename Distance::ResultType(),
+  Distance /* distance */ = Distance() ) -> topology::SimplicialComplex< topology::Simplex<typename Distance::ResultType, typename std::iterator_traits<InputIterator>::value_type> >
+{
+  using IndexType         = typename std::iterator_traits<InputIterator>::value_type;
+  using VertexType        = IndexType;
+  using DataType          = typename Distance::ResultType;
+  using Simplex           = topology::Simplex<DataType, VertexType>;
+  using SimplicialComplex = topology::SimplicialComplex<Simplex>;
 
-      for( std::size_t k = 0; k < N; k++ )
-      {
-        if( std::max( D[k][i], D[k][j] ) <= R + smallest.at(k) )
-          min = std::min( min, std::max( D[k][i], D[k][j] ) );
-      }
+  std::vector<IndexType> landmarkIndices( begin, end );
 
-      if( min != std::numeric_limits<DataType>::max() )
-      {
-        auto u = static_cast<VertexType>(i);
-        auto v = static_cast<VertexType>(j);
+  auto n = landmarkIndices.size();
+  auto N = container.size();
+  auto d = container.dimension();
 
-        simplices.push_back( Simplex( {u,v}, min ) );
-      }
-    }
-  }
+  if( n == 0 || N == 0 )
+    return {};
 
-  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+  auto maxSize   = static_cast<std::size_t>( dimension == 0 ? d + 1 : dimension ) + 1;
+  auto simplices = detail::witnessedSimplices<Simplex, Distance>( container, landmarkIndices, maxSize, nu, R );
 
-  SimplicialComplex K = SimplicialComplex( simplices.begin(), simplices.end() );
-  SimplicialComplex L = ripsExpander( K, dimension == 0 ? static_cast<unsigned>( d + 1 ) : dimension );
-  L                   = ripsExpander.assignMaximumWeight( L );
+  SimplicialComplex K;
+  K.bulkLoad( std::move( simplices ), aleph::topology::filtrations::Data<Simplex>() );
 
-  L.sort( aleph::topology::filtrations::Data<Simplex>() );
-  return L;
+  return K;
 }
 
 /**
@@ -236,14 +397,29 @@ template <class T, class OutputIterator> void generateRandomLandmarks( T n, T k,
 
 /**
   Generates a set of landmarks for the witness complex, using the
-  max-min strategy. Given a distance measure, a new landmark will
-  be chosen so as to *maximize* the *minimum distance* to the set
-  of selected landmarks. An output iterator is used to report the
-  indices of the selected landmarks.
+  max-min strategy, starting from a given point. Given a distance
+  measure, a new landmark will be chosen so as to *maximize* the
+  *minimum distance* to the set of selected landmarks. Ties are
+  resolved in favour of the point with the smallest index, so the
+  result is deterministic.
+
+  Every point stores its distance to the nearest landmark, which is
+  updated whenever a new landmark is added. Hence, every additional
+  landmark requires a linear number of distance calculations. These
+  calculations run in parallel if OpenMP is available.
+
+  The sequence of landmarks forms a *greedy permutation* if all points
+  are selected. Its *insertion radii*, i.e. the distances of each new
+  landmark to its nearest predecessor, are reported as well. They may
+  be used to build sparse filtrations. The first landmark, which does
+  not have a predecessor, is assigned the maximum value of the type.
 
   @param container Container that stores the input data
   @param n         Number of landmarks to select
-  @param result    Output iterator for storing the results
+  @param first     Index of the first landmark
+  @param result    Output iterator for storing the indices of the
+                   landmarks
+  @param radii     Output iterator for storing the insertion radii
   @param distance  Distance measure. This parameter may be specified
                    to permit template type deduction.
 */
@@ -251,54 +427,133 @@ template <class T, class OutputIterator> void generateRandomLandmarks( T n, T k,
 template <
   class Distance,
   class Container,
-  class OutputIterator
-> void generateMaxMinLandmarks( const Container& container, std::size_t n, OutputIterator result, Distance distance = Distance() )
+  class OutputIterator,
+  class RadiusOutputIterator
+> void generateMaxMinLandmarks( const Container& container,
+                                std::size_t n,
+                                std::size_t first,
+                                OutputIterator result,
+                                RadiusOutputIterator radii,
+                                Distance distance = Distance() )
 {
-  if( n > container.size() )
-    throw std::out_of_range( "Number of landmarks is out of range" );
-
   using SizeType = decltype( container.size() );
+  using DataType = typename Distance::ResultType;
 
-  std::random_device rd;
-  std::mt19937 rng( rd() );
+  auto N = static_cast<std::size_t>( container.size() );
+  auto d = container.dimension();
+
+  if( n > N )
+    throw std::out_of_range( "Number of landmarks is out of range" );
 
-  std::uniform_int_distribution<SizeType> distribution( SizeType(0), container.size() - 1 );
+  if( n == 0 )
+    return;
 
-  std::vector<SizeType> indices;
-  indices.reserve( n );
+  if( first >= N )
+    throw std::out_of_range( "Index of first landmark is out of range" );
 
-  indices.emplace_back( distribution( rng ) );
+  aleph::geometry::distances::Traits<Distance> traits;
 
-  using DataType = typename Distance::ResultType;
-  auto N         = container.size();
-  auto d         = container.dimension();
+  // Distance of every point to its nearest landmark; this is measured
+  // in the units of the distance functor, not in the units of the
+  // traits, because only comparisons are required.
+  std::vector<DataType> nearest( N, std::numeric_limits<DataType>::max() );
+
+  auto index  = first;
+  auto radius = std::numeric_limits<DataType>::max();
 
-  while( indices.size() < n )
+  for( std::size_t k = 0; ; k++ )
   {
-    auto index = SizeType(0);
-    auto max   = std::numeric_limits<DataType>::lowest();
+    *result++ = static_cast<SizeType>( index );
+    *radii++  = radius;
 
-    for( SizeType i = 0; i < N; i++ )
+    if( k + 1 == n )
+      break;
+
+    auto&& landmark = container.point( static_cast<SizeType>( index ) );
+    std::vector<typename std::decay<decltype( *landmark.begin() )>::type> coordinates( landmark.begin(), landmark.end() );
+
+    auto bestIndex = N;
+    auto bestValue = std::numeric_limits<DataType>::lowest();
+
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
     {
-      auto min = std::numeric_limits<DataType>::max();
+      auto threadIndex = N;
+      auto threadValue = std::numeric_limits<DataType>::lowest();
 
-      for( auto&& landmarkIndex : indices )
+#ifdef _OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for( std::ptrdiff_t j = 0; j < static_cast<std::ptrdiff_t>( N ); j++ )
       {
-        auto dist = distance( container[i].begin(), container[landmarkIndex].begin(), d );
-        min       = std::min( min, dist );
+        auto i     = static_cast<std::size_t>( j );
+        auto&& p   = container.point( static_cast<SizeType>( i ) );
+        nearest[i] = std::min( nearest[i], distance( coordinates.begin(), p.begin(), d ) );
+
+        // Since every thread processes a contiguous block of indices in
+        // increasing order, the first maximum is the one with the smallest
+        // index.
+        if( nearest[i] > threadValue )
+        {
+          threadValue = nearest[i];
+          threadIndex = i;
+        }
       }
 
-      if( min > max )
+#ifdef _OPENMP
+      #pragma omp critical
+#endif
       {
-        max   = min;
-        index = i;
+        if( threadValue > bestValue || ( threadValue == bestValue && threadIndex < bestIndex ) )
+        {
+          bestValue = threadValue;
+          bestIndex = threadIndex;
+        }
       }
     }
 
-    indices.push_back( index );
+    index  = bestIndex;
+    radius = traits.from( bestValue );
   }
+}
+
+/**
+  Generates a set of landmarks for the witness complex, using the
+  max-min strategy. Given a distance measure, a new landmark will
+  be chosen so as to *maximize* the *minimum distance* to the set
+  of selected landmarks. An output iterator is used to report the
+  indices of the selected landmarks. The first landmark is chosen
+  at random.
+
+  @param container Container that stores the input data
+  @param n         Number of landmarks to select
+  @param result    Output iterator for storing the results
+  @param distance  Distance measure. This parameter may be specified
+                   to permit template type deduction.
+*/
+
+template <
+  class Distance,
+  class Container,
+  class OutputIterator
+> void generateMaxMinLandmarks( const Container& container, std::size_t n, OutputIterator result, Distance distance = Distance() )
+{
+  if( n > container.size() )
+    throw std::out_of_range( "Number of landmarks is out of range" );
+
+  if( n == 0 )
+    return;
+
+  std::random_device rd;
+  std::mt19937 rng( rd() );
+
+  std::uniform_int_distribution<std::size_t> distribution( 0, static_cast<std::size_t>( container.size() ) - 1 );
+
+  std::vector<typename Distance::ResultType> radii;
+  radii.reserve( n );
 
-  std::copy( indices.begin(), indices.end(), result );
+  generateMaxMinLandmarks( container, n, distribution( rng ), result, std::back_inserter( radii ), distance );
 }
 
 } // namespace geometry
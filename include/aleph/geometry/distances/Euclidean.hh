@@ -1,6 +1,7 @@
 #ifndef ALEPH_GEOMETRY_DISTANCES_EUCLIDEAN_HH__
 #define ALEPH_GEOMETRY_DISTANCES_EUCLIDEAN_HH__
 
+#include <aleph/geometry/distances/Kernels.hh>
 #include <aleph/geometry/distances/Traits.hh>
 
 #include <cmath>
@@ -8,6 +9,7 @@
 
 #include <iterator>
 #include <string>
+#include <type_traits>
 
 namespace aleph
 {
@@ -23,11 +25,16 @@ namespace distances
   order to handle arbitrary ranges. Its interface is somewhat general, but
   the \c accum_dist function is specifically meant to be used with FLANN.
 
+  The second template parameter specifies the type in which distances are
+  accumulated and reported. Using `Euclidean<float, double>` keeps the data
+  in single precision, which halves the required memory bandwidth, while
+  distances retain the precision of double values.
+
   @see FLANN project page (http://www.cs.ubc.ca/research/flann)
   @see FLANN repository   (https://github.com/mariusmuja/flann)
 */
 
-template <class T> class Euclidean
+template <class T, class R = T> class Euclidean
 {
 public:
 
@@ -37,7 +44,7 @@ public:
 
   // Required for FLANN usage
   using ElementType = T;
-  using ResultType  = T;
+  using ResultType  = R;
 
   /**
     Given two points (such as those used in a persistence diagram),
@@ -71,14 +78,123 @@ public:
     @param worstDistance If set to a value greater than zero, calculations will
     stop once the value has been reached. Else, the value of this variable is
     ignored. This variable is provided in order to remain compatible with the
-    interface of FLANN.
+    interface of FLANN. Contiguous ranges of floating point values are handled
+    by vectorised kernels, which always calculate the full distance.
   */
 
   template <typename Iterator1, typename Iterator2>
   ResultType operator()( Iterator1 a,
                          Iterator2 b,
                          std::size_t size,
-                         ElementType worstDistance = -1.0 ) const
+                         ResultType worstDistance = -1.0 ) const
+  {
+    using UseKernel = std::integral_constant<bool,
+                                                std::is_floating_point<ElementType>::value
+                                             && std::is_floating_point<ResultType>::value
+                                             && detail::IsContiguous<Iterator1, ElementType>::value
+                                             && detail::IsContiguous<Iterator2, ElementType>::value>;
+
+    return this->distance( a, b, size, worstDistance, UseKernel() );
+  }
+
+  /**
+    Calculates the distances between a query point and a set of points,
+    which are stored contiguously in row-major order.
+
+    @param q      Query point
+    @param points Points
+    @param n      Number of points
+    @param d      Dimension of the query point and all other points
+    @param result Output array, which must have space for n values
+  */
+
+  void oneToMany( const ElementType* q,
+                  const ElementType* points, std::size_t n,
+                  std::size_t d,
+                  ResultType* result ) const
+  {
+    detail::oneToMany( detail::kernels<ElementType, ResultType>().squaredEuclidean, q, points, n, d, result );
+  }
+
+  /**
+    Calculates all pairwise distances between two sets of points, which
+    are stored contiguously in row-major order. The result is stored in
+    row-major order as well, i.e. the distance between the ith point of
+    the first set and the jth point of the second set is stored at index
+    i*n + j. This function uses a formulation based on dot products, so
+    its results may differ slightly from the pairwise results.
+
+    @param A      First set of points
+    @param m      Number of points in the first set
+    @param B      Second set of points
+    @param n      Number of points in the second set
+    @param d      Dimension of all points
+    @param result Output array, which must have space for m*n values
+  */
+
+  void manyToMany( const ElementType* A, std::size_t m,
+                   const ElementType* B, std::size_t n,
+                   std::size_t d,
+                   ResultType* result ) const
+  {
+    detail::squaredEuclideanManyToMany( A, m, B, n, d, result );
+  }
+
+  /**
+    Partial distance calculation, used by FLANN for fast kd-tree calculations.
+    This function exploits that the Euclidean distance can be evaluated
+    component-wise.
+
+    @param a First component
+    @param b Second component
+
+    @returns Partial distance between those two components
+  */
+
+  template <typename U, typename V>
+  ResultType accum_dist( const U& a,
+                         const V& b,
+                         int __attribute__((unused)) ) const
+  {
+    return (a-b) * (a-b);
+  }
+
+  /** @returns Name of functor */
+  static std::string name()
+  {
+    return "Euclidean distance";
+  }
+
+private:
+
+  /**
+    Calculates the distance between two contiguous ranges of floating
+    point values with the fastest kernel that is supported by the current
+    processor. Since the kernels are vectorised, they do not stop early,
+    and the worst distance is ignored.
+  */
+
+  template <typename Iterator1, typename Iterator2>
+  ResultType distance( Iterator1 a,
+                       Iterator2 b,
+                       std::size_t size,
+                       ResultType /* worstDistance */,
+                       std::true_type ) const
+  {
+    if( size == 0 )
+      return ResultType();
+
+    auto&& K = detail::kernels<ElementType, ResultType>();
+    return K.squaredEuclidean( detail::pointer<ElementType>( a ), detail::pointer<ElementType>( b ), size );
+  }
+
+  /** Calculates the distance between two arbitrary ranges */
+  template <typename Iterator1, typename Iterator2>
+  ResultType distance( Iterator1 a,
+                       Iterator2 b,
+                       std::size_t size,
+                       ResultType worstDistance,
+                       std::false_type ) const
   {
     // Fix compiler warnings about unused parameters. This is provided to be
     // compatible with FLANN.
@@ -101,10 +217,10 @@ public:
 
     while( a < lastGroup )
     {
-      diff0 = ElementType( a[0] - b[0] );
-      diff1 = ElementType( a[1] - b[1] );
-      diff2 = ElementType( a[2] - b[2] );
-      diff3 = ElementType( a[3] - b[3] );
+      diff0 = ResultType( a[0] ) - ResultType( b[0] );
+      diff1 = ResultType( a[1] ) - ResultType( b[1] );
+      diff2 = ResultType( a[2] ) - ResultType( b[2] );
+      diff3 = ResultType( a[3] ) - ResultType( b[3] );
 
       result +=   diff0 * diff0
                 + diff1 * diff1
@@ -120,50 +236,25 @@ public:
 
     while( a < last )
     {
-      diff0  = ElementType( *a++ - *b++ );
+      diff0  = ResultType( *a++ ) - ResultType( *b++ );
       result = result + diff0 * diff0;
     }
 
     return result;
   }
-
-  /**
-    Partial distance calculation, used by FLANN for fast kd-tree calculations.
-    This function exploits that the Euclidean distance can be evaluated
-    component-wise.
-
-    @param a First component
-    @param b Second component
-
-    @returns Partial distance between those two components
-  */
-
-  template <typename U, typename V>
-  ResultType accum_dist( const U& a,
-                         const V& b,
-                         int __attribute__((unused)) ) const
-  {
-    return (a-b) * (a-b);
-  }
-
-  /** @returns Name of functor */
-  static std::string name()
-  {
-    return "Euclidean distance";
-  }
 };
 
-template <class T> struct Traits< Euclidean<T> >
+template <class T, class R> struct Traits< Euclidean<T, R> >
 {
-  using ResultType  = typename Euclidean<T>::ResultType;
-  using ElementType = typename Euclidean<T>::ElementType;
+  using ResultType  = typename Euclidean<T, R>::ResultType;
+  using ElementType = typename Euclidean<T, R>::ElementType;
 
-  ResultType from( ElementType x ) const noexcept
+  ResultType from( ResultType x ) const noexcept
   {
     return ResultType( std::sqrt( x ) );
   }
 
-  ResultType to( ElementType x ) const noexcept
+  ResultType to( ResultType x ) const noexcept
   {
     return ResultType( x*x );
   }
@@ -1,11 +1,14 @@
 #ifndef ALEPH_GEOMETRY_DISTANCES_HAMMING_HH__
 #define ALEPH_GEOMETRY_DISTANCES_HAMMING_HH__
 
+#include <aleph/geometry/distances/Kernels.hh>
+
 #include <cstddef>
 #include <cmath>
 
 #include <iterator>
 #include <string>
+#include <type_traits>
 
 namespace aleph
 {
@@ -48,7 +51,8 @@ public:
     @param worstDistance If set to a value greater than zero, calculations will
     stop once the value has been reached. Else, the value of this variable is
     ignored. This variable is provided in order to remain compatible with the
-    interface of FLANN.
+    interface of FLANN. Contiguous ranges of floating point values are handled
+    by vectorised kernels, which always calculate the full distance.
 
     @returns Hamming distance between the two input vectors.
   */
@@ -58,6 +62,112 @@ public:
                          Iterator2 b,
                          std::size_t size,
                          ElementType worstDistance = -1.0 ) const
+  {
+    using UseKernel = std::integral_constant<bool,
+                                                std::is_floating_point<ElementType>::value
+                                             && detail::IsContiguous<Iterator1, ElementType>::value
+                                             && detail::IsContiguous<Iterator2, ElementType>::value>;
+
+    return this->distance( a, b, size, worstDistance, UseKernel() );
+  }
+
+  /**
+    Calculates the distances between a query point and a set of points,
+    which are stored contiguously in row-major order.
+
+    @param q      Query point
+    @param points Points
+    @param n      Number of points
+    @param d      Dimension of the query point and all other points
+    @param result Output array, which must have space for n values
+  */
+
+  void oneToMany( const ElementType* q,
+                  const ElementType* points, std::size_t n,
+                  std::size_t d,
+                  ResultType* result ) const
+  {
+    detail::oneToMany( detail::kernels<ElementType>().hamming, q, points, n, d, result );
+  }
+
+  /**
+    Calculates all pairwise distances between two sets of points, which
+    are stored contiguously in row-major order. The result is stored in
+    row-major order as well, i.e. the distance between the ith point of
+    the first set and the jth point of the second set is stored at index
+    i*n + j.
+
+    @param A      First set of points
+    @param m      Number of points in the first set
+    @param B      Second set of points
+    @param n      Number of points in the second set
+    @param d      Dimension of all points
+    @param result Output array, which must have space for m*n values
+  */
+
+  void manyToMany( const ElementType* A, std::size_t m,
+                   const ElementType* B, std::size_t n,
+                   std::size_t d,
+                   ResultType* result ) const
+  {
+    detail::manyToMany( detail::kernels<ElementType>().hamming, A, m, B, n, d, result );
+  }
+
+  /**
+    Partial distance calculation, used by FLANN for fast kd-tree calculations.
+    This function exploits that the Hamming distance can be evaluated
+    component-wise.
+
+    @param a First component
+    @param b Second component
+
+    @returns Partial distance between those two components
+  */
+
+  template <typename U, typename V>
+  ResultType accum_dist( const U& a,
+                         const V& b,
+                         int __attribute__((unused)) ) const
+  {
+    return std::abs( a - b );
+  }
+
+  /** @returns Name of functor */
+  static std::string name()
+  {
+    return "Hamming distance";
+  }
+
+private:
+
+  /**
+    Calculates the distance between two contiguous ranges of floating
+    point values with the fastest kernel that is supported by the current
+    processor. Since the kernels are vectorised, they do not stop early,
+    and the worst distance is ignored.
+  */
+
+  template <typename Iterator1, typename Iterator2>
+  ResultType distance( Iterator1 a,
+                       Iterator2 b,
+                       std::size_t size,
+                       ElementType /* worstDistance */,
+                       std::true_type ) const
+  {
+    if( size == 0 )
+      return ResultType();
+
+    auto&& K = detail::kernels<ElementType>();
+    return K.hamming( detail::pointer<ElementType>( a ), detail::pointer<ElementType>( b ), size );
+  }
+
+  /** Calculates the distance between two arbitrary ranges */
+  template <typename Iterator1, typename Iterator2>
+  ResultType distance( Iterator1 a,
+                       Iterator2 b,
+                       std::size_t size,
+                       ElementType worstDistance,
+                       std::false_type ) const
   {
     // Fixes warnings about unused parameters. This parameter is
     // provided for compatibility reasons with FLANN only.
@@ -103,31 +213,6 @@ public:
 
     return result;
   }
-
-  /**
-    Partial distance calculation, used by FLANN for fast kd-tree calculations.
-    This function exploits that the Hamming distance can be evaluated
-    component-wise.
-
-    @param a First component
-    @param b Second component
-
-    @returns Partial distance between those two components
-  */
-
-  template <typename U, typename V>
-  ResultType accum_dist( const U& a,
-                         const V& b,
-                         int __attribute__((unused)) ) const
-  {
-    return std::abs( a - b );
-  }
-
-  /** @returns Name of functor */
-  static std::string name()
-  {
-    return "Hamming distance";
-  }
 };
 
 } // namespace distances
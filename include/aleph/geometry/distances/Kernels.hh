@@ -0,0 +1,1245 @@
+#ifndef ALEPH_GEOMETRY_DISTANCES_KERNELS_HH__
+#define ALEPH_GEOMETRY_DISTANCES_KERNELS_HH__
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+// The vectorised kernels are compiled for specific instruction sets by
+// using function attributes, so they do not require any compiler flags.
+// The instruction set is selected at runtime. The kernels are limited to
+// x86-64 because the Hamming kernels require 64-bit intrinsics, such as
+// _mm_popcnt_u64() and _mm256_extract_epi64(), that are unavailable for
+// 32-bit targets.
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && defined( __x86_64__ )
+  #define ALEPH_GEOMETRY_DISTANCES_X86_KERNELS
+  #include <immintrin.h>
+#endif
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+namespace distances
+{
+
+namespace detail
+{
+
+/** Instruction sets for which distance kernels are available */
+enum class InstructionSet
+{
+  Generic,
+  AVX2,
+  AVX512
+};
+
+/** @returns true if the current processor supports an instruction set */
+inline bool isSupported( InstructionSet instructionSet ) noexcept
+{
+#ifdef ALEPH_GEOMETRY_DISTANCES_X86_KERNELS
+  __builtin_cpu_init();
+
+  switch( instructionSet )
+  {
+  case InstructionSet::Generic:
+    return true;
+  case InstructionSet::AVX2:
+    return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) && __builtin_cpu_supports( "popcnt" );
+  case InstructionSet::AVX512:
+    return __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "popcnt" );
+  }
+
+  return false;
+#else
+  return instructionSet == InstructionSet::Generic;
+#endif
+}
+
+/** @returns Best instruction set that is supported by the current processor */
+inline InstructionSet bestInstructionSet() noexcept
+{
+  if( isSupported( InstructionSet::AVX512 ) )
+    return InstructionSet::AVX512;
+  else if( isSupported( InstructionSet::AVX2 ) )
+    return InstructionSet::AVX2;
+  else
+    return InstructionSet::Generic;
+}
+
+// Generic kernels -----------------------------------------------------
+//
+// These kernels use multiple accumulators, which shortens dependency
+// chains and permits the compiler to vectorise them. Values are
+// accumulated in type R, which may have a higher precision than the
+// type T of the input values.
+
+template <class T, class R = T> R squaredEuclideanGeneric( const T* a, const T* b, std::size_t n ) noexcept
+{
+  R s0 = R(), s1 = R(), s2 = R(), s3 = R();
+  std::size_t i = 0;
+
+  for( ; i + 4 <= n; i += 4 )
+  {
+    R d0 = R( a[i] )   - R( b[i] );
+    R d1 = R( a[i+1] ) - R( b[i+1] );
+    R d2 = R( a[i+2] ) - R( b[i+2] );
+    R d3 = R( a[i+3] ) - R( b[i+3] );
+
+    s0 += d0 * d0;
+    s1 += d1 * d1;
+    s2 += d2 * d2;
+    s3 += d3 * d3;
+  }
+
+  for( ; i < n; i++ )
+  {
+    R d = R( a[i] ) - R( b[i] );
+    s0 += d * d;
+  }
+
+  return ( s0 + s1 ) + ( s2 + s3 );
+}
+
+template <class T, class R = T> R manhattanGeneric( const T* a, const T* b, std::size_t n ) noexcept
+{
+  R s0 = R(), s1 = R(), s2 = R(), s3 = R();
+  std::size_t i = 0;
+
+  for( ; i + 4 <= n; i += 4 )
+  {
+    s0 += a[i]   > b[i]   ? R( a[i] )   - R( b[i] )   : R( b[i] )   - R( a[i] );
+    s1 += a[i+1] > b[i+1] ? R( a[i+1] ) - R( b[i+1] ) : R( b[i+1] ) - R( a[i+1] );
+    s2 += a[i+2] > b[i+2] ? R( a[i+2] ) - R( b[i+2] ) : R( b[i+2] ) - R( a[i+2] );
+    s3 += a[i+3] > b[i+3] ? R( a[i+3] ) - R( b[i+3] ) : R( b[i+3] ) - R( a[i+3] );
+  }
+
+  for( ; i < n; i++ )
+    s0 += a[i] > b[i] ? R( a[i] ) - R( b[i] ) : R( b[i] ) - R( a[i] );
+
+  return ( s0 + s1 ) + ( s2 + s3 );
+}
+
+template <class T, class R = T> R hammingGeneric( const T* a, const T* b, std::size_t n ) noexcept
+{
+  std::size_t count = 0;
+
+  for( std::size_t i = 0; i < n; i++ )
+    count += a[i] != b[i];
+
+  return static_cast<R>( count );
+}
+
+template <class T, class R = T> R dotGeneric( const T* a, const T* b, std::size_t n ) noexcept
+{
+  R s0 = R(), s1 = R(), s2 = R(), s3 = R();
+  std::size_t i = 0;
+
+  for( ; i + 4 <= n; i += 4 )
+  {
+    s0 += R( a[i] )   * R( b[i] );
+    s1 += R( a[i+1] ) * R( b[i+1] );
+    s2 += R( a[i+2] ) * R( b[i+2] );
+    s3 += R( a[i+3] ) * R( b[i+3] );
+  }
+
+  for( ; i < n; i++ )
+    s0 += R( a[i] ) * R( b[i] );
+
+  return ( s0 + s1 ) + ( s2 + s3 );
+}
+
+/** @returns Number of bits that are set in a word */
+inline unsigned popcount( std::uint64_t x ) noexcept
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+  return static_cast<unsigned>( __builtin_popcountll( x ) );
+#else
+  x = x - ( ( x >> 1 ) & 0x5555555555555555ull );
+  x = ( x & 0x3333333333333333ull ) + ( ( x >> 2 ) & 0x3333333333333333ull );
+  x = ( x + ( x >> 4 ) ) & 0x0F0F0F0F0F0F0F0Full;
+
+  return static_cast<unsigned>( ( x * 0x0101010101010101ull ) >> 56 );
+#endif
+}
+
+/**
+  Counts the number of different bits in two ranges of words, i.e. the
+  Hamming distance of two bit vectors that are stored in packed form.
+*/
+
+inline std::uint64_t hammingWordsGeneric( const std::uint64_t* a, const std::uint64_t* b, std::size_t n ) noexcept
+{
+  std::uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+  std::size_t i = 0;
+
+  for( ; i + 4 <= n; i += 4 )
+  {
+    c0 += popcount( a[i]   ^ b[i] );
+    c1 += popcount( a[i+1] ^ b[i+1] );
+    c2 += popcount( a[i+2] ^ b[i+2] );
+    c3 += popcount( a[i+3] ^ b[i+3] );
+  }
+
+  for( ; i < n; i++ )
+    c0 += popcount( a[i] ^ b[i] );
+
+  return ( c0 + c1 ) + ( c2 + c3 );
+}
+
+#ifdef ALEPH_GEOMETRY_DISTANCES_X86_KERNELS
+
+// AVX2 kernels --------------------------------------------------------
+
+#define ALEPH_AVX2 __attribute__(( target( "avx2,fma,popcnt" ) ))
+
+ALEPH_AVX2 inline float horizontalSum( __m256 x ) noexcept
+{
+  __m128 s = _mm_add_ps( _mm256_castps256_ps128( x ), _mm256_extractf128_ps( x, 1 ) );
+  s        = _mm_add_ps( s, _mm_movehl_ps( s, s ) );
+  s        = _mm_add_ss( s, _mm_shuffle_ps( s, s, 0x55 ) );
+
+  return _mm_cvtss_f32( s );
+}
+
+ALEPH_AVX2 inline double horizontalSum( __m256d x ) noexcept
+{
+  __m128d s = _mm_add_pd( _mm256_castpd256_pd128( x ), _mm256_extractf128_pd( x, 1 ) );
+  s         = _mm_add_sd( s, _mm_unpackhi_pd( s, s ) );
+
+  return _mm_cvtsd_f64( s );
+}
+
+ALEPH_AVX2 inline float squaredEuclideanAVX2( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m256 s0 = _mm256_setzero_ps();
+  __m256 s1 = _mm256_setzero_ps();
+
+  std::size_t i = 0;
+
+  for( ; i + 16 <= n; i += 16 )
+  {
+    __m256 d0 = _mm256_sub_ps( _mm256_loadu_ps( a+i ),   _mm256_loadu_ps( b+i ) );
+    __m256 d1 = _mm256_sub_ps( _mm256_loadu_ps( a+i+8 ), _mm256_loadu_ps( b+i+8 ) );
+
+    s0 = _mm256_fmadd_ps( d0, d0, s0 );
+    s1 = _mm256_fmadd_ps( d1, d1, s1 );
+  }
+
+  for( ; i + 8 <= n; i += 8 )
+  {
+    __m256 d = _mm256_sub_ps( _mm256_loadu_ps( a+i ), _mm256_loadu_ps( b+i ) );
+    s0       = _mm256_fmadd_ps( d, d, s0 );
+  }
+
+  float result = horizontalSum( _mm256_add_ps( s0, s1 ) );
+
+  for( ; i < n; i++ )
+    result += ( a[i] - b[i] ) * ( a[i] - b[i] );
+
+  return result;
+}
+
+ALEPH_AVX2 inline double squaredEuclideanAVX2( const double* a, const double* b, std::size_t n ) noexcept
+{
+  __m256d s0 = _mm256_setzero_pd();
+  __m256d s1 = _mm256_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 8 <= n; i += 8 )
+  {
+    __m256d d0 = _mm256_sub_pd( _mm256_loadu_pd( a+i ),   _mm256_loadu_pd( b+i ) );
+    __m256d d1 = _mm256_sub_pd( _mm256_loadu_pd( a+i+4 ), _mm256_loadu_pd( b+i+4 ) );
+
+    s0 = _mm256_fmadd_pd( d0, d0, s0 );
+    s1 = _mm256_fmadd_pd( d1, d1, s1 );
+  }
+
+  for( ; i + 4 <= n; i += 4 )
+  {
+    __m256d d = _mm256_sub_pd( _mm256_loadu_pd( a+i ), _mm256_loadu_pd( b+i ) );
+    s0        = _mm256_fmadd_pd( d, d, s0 );
+  }
+
+  double result = horizontalSum( _mm256_add_pd( s0, s1 ) );
+
+  for( ; i < n; i++ )
+    result += ( a[i] - b[i] ) * ( a[i] - b[i] );
+
+  return result;
+}
+
+ALEPH_AVX2 inline float manhattanAVX2( const float* a, const float* b, std::size_t n ) noexcept
+{
+  const __m256 signMask = _mm256_set1_ps( -0.0f );
+
+  __m256 s0 = _mm256_setzero_ps();
+  __m256 s1 = _mm256_setzero_ps();
+
+  std::size_t i = 0;
+
+  for( ; i + 16 <= n; i += 16 )
+  {
+    __m256 d0 = _mm256_sub_ps( _mm256_loadu_ps( a+i ),   _mm256_loadu_ps( b+i ) );
+    __m256 d1 = _mm256_sub_ps( _mm256_loadu_ps( a+i+8 ), _mm256_loadu_ps( b+i+8 ) );
+
+    s0 = _mm256_add_ps( s0, _mm256_andnot_ps( signMask, d0 ) );
+    s1 = _mm256_add_ps( s1, _mm256_andnot_ps( signMask, d1 ) );
+  }
+
+  for( ; i + 8 <= n; i += 8 )
+  {
+    __m256 d = _mm256_sub_ps( _mm256_loadu_ps( a+i ), _mm256_loadu_ps( b+i ) );
+    s0       = _mm256_add_ps( s0, _mm256_andnot_ps( signMask, d ) );
+  }
+
+  float result = horizontalSum( _mm256_add_ps( s0, s1 ) );
+
+  for( ; i < n; i++ )
+    result += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+
+  return result;
+}
+
+ALEPH_AVX2 inline double manhattanAVX2( const double* a, const double* b, std::size_t n ) noexcept
+{
+  const __m256d signMask = _mm256_set1_pd( -0.0 );
+
+  __m256d s0 = _mm256_setzero_pd();
+  __m256d s1 = _mm256_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 8 <= n; i += 8 )
+  {
+    __m256d d0 = _mm256_sub_pd( _mm256_loadu_pd( a+i ),   _mm256_loadu_pd( b+i ) );
+    __m256d d1 = _mm256_sub_pd( _mm256_loadu_pd( a+i+4 ), _mm256_loadu_pd( b+i+4 ) );
+
+    s0 = _mm256_add_pd( s0, _mm256_andnot_pd( signMask, d0 ) );
+    s1 = _mm256_add_pd( s1, _mm256_andnot_pd( signMask, d1 ) );
+  }
+
+  for( ; i + 4 <= n; i += 4 )
+  {
+    __m256d d = _mm256_sub_pd( _mm256_loadu_pd( a+i ), _mm256_loadu_pd( b+i ) );
+    s0        = _mm256_add_pd( s0, _mm256_andnot_pd( signMask, d ) );
+  }
+
+  double result = horizontalSum( _mm256_add_pd( s0, s1 ) );
+
+  for( ; i < n; i++ )
+    result += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+
+  return result;
+}
+
+ALEPH_AVX2 inline float hammingAVX2( const float* a, const float* b, std::size_t n ) noexcept
+{
+  std::size_t count = 0;
+  std::size_t i     = 0;
+
+  for( ; i + 8 <= n; i += 8 )
+  {
+    __m256 neq = _mm256_cmp_ps( _mm256_loadu_ps( a+i ), _mm256_loadu_ps( b+i ), _CMP_NEQ_UQ );
+    count     += static_cast<std::size_t>( __builtin_popcount( static_cast<unsigned>( _mm256_movemask_ps( neq ) ) ) );
+  }
+
+  for( ; i < n; i++ )
+    count += a[i] != b[i];
+
+  return static_cast<float>( count );
+}
+
+ALEPH_AVX2 inline double hammingAVX2( const double* a, const double* b, std::size_t n ) noexcept
+{
+  std::size_t count = 0;
+  std::size_t i     = 0;
+
+  for( ; i + 4 <= n; i += 4 )
+  {
+    __m256d neq = _mm256_cmp_pd( _mm256_loadu_pd( a+i ), _mm256_loadu_pd( b+i ), _CMP_NEQ_UQ );
+    count      += static_cast<std::size_t>( __builtin_popcount( static_cast<unsigned>( _mm256_movemask_pd( neq ) ) ) );
+  }
+
+  for( ; i < n; i++ )
+    count += a[i] != b[i];
+
+  return static_cast<double>( count );
+}
+
+ALEPH_AVX2 inline float dotAVX2( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m256 s0 = _mm256_setzero_ps();
+  __m256 s1 = _mm256_setzero_ps();
+
+  std::size_t i = 0;
+
+  for( ; i + 16 <= n; i += 16 )
+  {
+    s0 = _mm256_fmadd_ps( _mm256_loadu_ps( a+i ),   _mm256_loadu_ps( b+i ),   s0 );
+    s1 = _mm256_fmadd_ps( _mm256_loadu_ps( a+i+8 ), _mm256_loadu_ps( b+i+8 ), s1 );
+  }
+
+  for( ; i + 8 <= n; i += 8 )
+    s0 = _mm256_fmadd_ps( _mm256_loadu_ps( a+i ), _mm256_loadu_ps( b+i ), s0 );
+
+  float result = horizontalSum( _mm256_add_ps( s0, s1 ) );
+
+  for( ; i < n; i++ )
+    result += a[i] * b[i];
+
+  return result;
+}
+
+ALEPH_AVX2 inline double dotAVX2( const double* a, const double* b, std::size_t n ) noexcept
+{
+  __m256d s0 = _mm256_setzero_pd();
+  __m256d s1 = _mm256_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 8 <= n; i += 8 )
+  {
+    s0 = _mm256_fmadd_pd( _mm256_loadu_pd( a+i ),   _mm256_loadu_pd( b+i ),   s0 );
+    s1 = _mm256_fmadd_pd( _mm256_loadu_pd( a+i+4 ), _mm256_loadu_pd( b+i+4 ), s1 );
+  }
+
+  for( ; i + 4 <= n; i += 4 )
+    s0 = _mm256_fmadd_pd( _mm256_loadu_pd( a+i ), _mm256_loadu_pd( b+i ), s0 );
+
+  double result = horizontalSum( _mm256_add_pd( s0, s1 ) );
+
+  for( ; i < n; i++ )
+    result += a[i] * b[i];
+
+  return result;
+}
+
+/**
+  Counts different bits by looking up the number of bits of every nibble
+  in a table, following the algorithm by Mula et al. The bytes of every
+  block are summed up horizontally afterwards.
+*/
+
+ALEPH_AVX2 inline std::uint64_t hammingWordsAVX2( const std::uint64_t* a, const std::uint64_t* b, std::size_t n ) noexcept
+{
+  const __m256i table = _mm256_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+
+  const __m256i lowMask = _mm256_set1_epi8( 0x0F );
+
+  __m256i sum = _mm256_setzero_si256();
+
+  std::size_t i = 0;
+
+  for( ; i + 4 <= n; i += 4 )
+  {
+    __m256i x = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a+i ) ),
+                                  _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b+i ) ) );
+
+    __m256i lo = _mm256_shuffle_epi8( table, _mm256_and_si256( x, lowMask ) );
+    __m256i hi = _mm256_shuffle_epi8( table, _mm256_and_si256( _mm256_srli_epi16( x, 4 ), lowMask ) );
+
+    sum = _mm256_add_epi64( sum, _mm256_sad_epu8( _mm256_add_epi8( lo, hi ), _mm256_setzero_si256() ) );
+  }
+
+  std::uint64_t result = static_cast<std::uint64_t>( _mm256_extract_epi64( sum, 0 ) )
+                       + static_cast<std::uint64_t>( _mm256_extract_epi64( sum, 1 ) )
+                       + static_cast<std::uint64_t>( _mm256_extract_epi64( sum, 2 ) )
+                       + static_cast<std::uint64_t>( _mm256_extract_epi64( sum, 3 ) );
+
+  for( ; i < n; i++ )
+    result += static_cast<std::uint64_t>( _mm_popcnt_u64( a[i] ^ b[i] ) );
+
+  return result;
+}
+
+// Mixed-precision kernels convert single precision values to double
+// precision before accumulating them. This prevents a loss of precision
+// for high-dimensional vectors while reading only half of the memory.
+
+ALEPH_AVX2 inline double squaredEuclideanMixedAVX2( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m256d s0 = _mm256_setzero_pd();
+  __m256d s1 = _mm256_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 8 <= n; i += 8 )
+  {
+    __m256d d0 = _mm256_sub_pd( _mm256_cvtps_pd( _mm_loadu_ps( a+i ) ),   _mm256_cvtps_pd( _mm_loadu_ps( b+i ) ) );
+    __m256d d1 = _mm256_sub_pd( _mm256_cvtps_pd( _mm_loadu_ps( a+i+4 ) ), _mm256_cvtps_pd( _mm_loadu_ps( b+i+4 ) ) );
+
+    s0 = _mm256_fmadd_pd( d0, d0, s0 );
+    s1 = _mm256_fmadd_pd( d1, d1, s1 );
+  }
+
+  double result = horizontalSum( _mm256_add_pd( s0, s1 ) );
+
+  for( ; i < n; i++ )
+  {
+    double d = double( a[i] ) - double( b[i] );
+    result  += d * d;
+  }
+
+  return result;
+}
+
+ALEPH_AVX2 inline double manhattanMixedAVX2( const float* a, const float* b, std::size_t n ) noexcept
+{
+  const __m256d signMask = _mm256_set1_pd( -0.0 );
+
+  __m256d s0 = _mm256_setzero_pd();
+  __m256d s1 = _mm256_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 8 <= n; i += 8 )
+  {
+    __m256d d0 = _mm256_sub_pd( _mm256_cvtps_pd( _mm_loadu_ps( a+i ) ),   _mm256_cvtps_pd( _mm_loadu_ps( b+i ) ) );
+    __m256d d1 = _mm256_sub_pd( _mm256_cvtps_pd( _mm_loadu_ps( a+i+4 ) ), _mm256_cvtps_pd( _mm_loadu_ps( b+i+4 ) ) );
+
+    s0 = _mm256_add_pd( s0, _mm256_andnot_pd( signMask, d0 ) );
+    s1 = _mm256_add_pd( s1, _mm256_andnot_pd( signMask, d1 ) );
+  }
+
+  double result = horizontalSum( _mm256_add_pd( s0, s1 ) );
+
+  for( ; i < n; i++ )
+    result += a[i] > b[i] ? double( a[i] ) - double( b[i] ) : double( b[i] ) - double( a[i] );
+
+  return result;
+}
+
+ALEPH_AVX2 inline double dotMixedAVX2( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m256d s0 = _mm256_setzero_pd();
+  __m256d s1 = _mm256_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 8 <= n; i += 8 )
+  {
+    s0 = _mm256_fmadd_pd( _mm256_cvtps_pd( _mm_loadu_ps( a+i ) ),   _mm256_cvtps_pd( _mm_loadu_ps( b+i ) ),   s0 );
+    s1 = _mm256_fmadd_pd( _mm256_cvtps_pd( _mm_loadu_ps( a+i+4 ) ), _mm256_cvtps_pd( _mm_loadu_ps( b+i+4 ) ), s1 );
+  }
+
+  double result = horizontalSum( _mm256_add_pd( s0, s1 ) );
+
+  for( ; i < n; i++ )
+    result += double( a[i] ) * double( b[i] );
+
+  return result;
+}
+
+#undef ALEPH_AVX2
+
+// AVX-512 kernels -----------------------------------------------------
+//
+// The remaining elements of a vector are handled by masked loads, so
+// there is no scalar loop.
+
+#define ALEPH_AVX512 __attribute__(( target( "avx512f,popcnt" ) ))
+
+ALEPH_AVX512 inline __mmask16 tailMask16( std::size_t n ) noexcept
+{
+  return static_cast<__mmask16>( ( 1u << n ) - 1u );
+}
+
+ALEPH_AVX512 inline __mmask8 tailMask8( std::size_t n ) noexcept
+{
+  return static_cast<__mmask8>( ( 1u << n ) - 1u );
+}
+
+// The reduction intrinsics of some compilers trigger spurious warnings
+// about uninitialized variables, so the reductions are performed via a
+// buffer. This is only required once per distance calculation.
+
+ALEPH_AVX512 inline float horizontalSum( __m512 x ) noexcept
+{
+  alignas(64) float buffer[16];
+  _mm512_store_ps( buffer, x );
+
+  float result = 0.0f;
+  for( auto&& y : buffer )
+    result += y;
+
+  return result;
+}
+
+ALEPH_AVX512 inline double horizontalSum( __m512d x ) noexcept
+{
+  alignas(64) double buffer[8];
+  _mm512_store_pd( buffer, x );
+
+  double result = 0.0;
+  for( auto&& y : buffer )
+    result += y;
+
+  return result;
+}
+
+ALEPH_AVX512 inline float squaredEuclideanAVX512( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m512 s0 = _mm512_setzero_ps();
+  __m512 s1 = _mm512_setzero_ps();
+
+  std::size_t i = 0;
+
+  for( ; i + 32 <= n; i += 32 )
+  {
+    __m512 d0 = _mm512_sub_ps( _mm512_loadu_ps( a+i ),    _mm512_loadu_ps( b+i ) );
+    __m512 d1 = _mm512_sub_ps( _mm512_loadu_ps( a+i+16 ), _mm512_loadu_ps( b+i+16 ) );
+
+    s0 = _mm512_fmadd_ps( d0, d0, s0 );
+    s1 = _mm512_fmadd_ps( d1, d1, s1 );
+  }
+
+  for( ; i < n; i += 16 )
+  {
+    auto mask = n - i >= 16 ? static_cast<__mmask16>( 0xFFFF ) : tailMask16( n - i );
+    __m512 d  = _mm512_sub_ps( _mm512_maskz_loadu_ps( mask, a+i ), _mm512_maskz_loadu_ps( mask, b+i ) );
+    s0        = _mm512_fmadd_ps( d, d, s0 );
+  }
+
+  return horizontalSum( _mm512_add_ps( s0, s1 ) );
+}
+
+ALEPH_AVX512 inline double squaredEuclideanAVX512( const double* a, const double* b, std::size_t n ) noexcept
+{
+  __m512d s0 = _mm512_setzero_pd();
+  __m512d s1 = _mm512_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 16 <= n; i += 16 )
+  {
+    __m512d d0 = _mm512_sub_pd( _mm512_loadu_pd( a+i ),   _mm512_loadu_pd( b+i ) );
+    __m512d d1 = _mm512_sub_pd( _mm512_loadu_pd( a+i+8 ), _mm512_loadu_pd( b+i+8 ) );
+
+    s0 = _mm512_fmadd_pd( d0, d0, s0 );
+    s1 = _mm512_fmadd_pd( d1, d1, s1 );
+  }
+
+  for( ; i < n; i += 8 )
+  {
+    auto mask  = n - i >= 8 ? static_cast<__mmask8>( 0xFF ) : tailMask8( n - i );
+    __m512d d  = _mm512_sub_pd( _mm512_maskz_loadu_pd( mask, a+i ), _mm512_maskz_loadu_pd( mask, b+i ) );
+    s0         = _mm512_fmadd_pd( d, d, s0 );
+  }
+
+  return horizontalSum( _mm512_add_pd( s0, s1 ) );
+}
+
+ALEPH_AVX512 inline float manhattanAVX512( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m512 s0 = _mm512_setzero_ps();
+  __m512 s1 = _mm512_setzero_ps();
+
+  std::size_t i = 0;
+
+  for( ; i + 32 <= n; i += 32 )
+  {
+    s0 = _mm512_add_ps( s0, _mm512_abs_ps( _mm512_sub_ps( _mm512_loadu_ps( a+i ),    _mm512_loadu_ps( b+i ) ) ) );
+    s1 = _mm512_add_ps( s1, _mm512_abs_ps( _mm512_sub_ps( _mm512_loadu_ps( a+i+16 ), _mm512_loadu_ps( b+i+16 ) ) ) );
+  }
+
+  for( ; i < n; i += 16 )
+  {
+    auto mask = n - i >= 16 ? static_cast<__mmask16>( 0xFFFF ) : tailMask16( n - i );
+    s0        = _mm512_add_ps( s0, _mm512_abs_ps( _mm512_sub_ps( _mm512_maskz_loadu_ps( mask, a+i ), _mm512_maskz_loadu_ps( mask, b+i ) ) ) );
+  }
+
+  return horizontalSum( _mm512_add_ps( s0, s1 ) );
+}
+
+ALEPH_AVX512 inline double manhattanAVX512( const double* a, const double* b, std::size_t n ) noexcept
+{
+  __m512d s0 = _mm512_setzero_pd();
+  __m512d s1 = _mm512_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 16 <= n; i += 16 )
+  {
+    s0 = _mm512_add_pd( s0, _mm512_abs_pd( _mm512_sub_pd( _mm512_loadu_pd( a+i ),   _mm512_loadu_pd( b+i ) ) ) );
+    s1 = _mm512_add_pd( s1, _mm512_abs_pd( _mm512_sub_pd( _mm512_loadu_pd( a+i+8 ), _mm512_loadu_pd( b+i+8 ) ) ) );
+  }
+
+  for( ; i < n; i += 8 )
+  {
+    auto mask = n - i >= 8 ? static_cast<__mmask8>( 0xFF ) : tailMask8( n - i );
+    s0        = _mm512_add_pd( s0, _mm512_abs_pd( _mm512_sub_pd( _mm512_maskz_loadu_pd( mask, a+i ), _mm512_maskz_loadu_pd( mask, b+i ) ) ) );
+  }
+
+  return horizontalSum( _mm512_add_pd( s0, s1 ) );
+}
+
+ALEPH_AVX512 inline float hammingAVX512( const float* a, const float* b, std::size_t n ) noexcept
+{
+  std::size_t count = 0;
+
+  for( std::size_t i = 0; i < n; i += 16 )
+  {
+    auto mask = n - i >= 16 ? static_cast<__mmask16>( 0xFFFF ) : tailMask16( n - i );
+    auto neq  = _mm512_mask_cmp_ps_mask( mask, _mm512_maskz_loadu_ps( mask, a+i ), _mm512_maskz_loadu_ps( mask, b+i ), _CMP_NEQ_UQ );
+    count    += static_cast<std::size_t>( __builtin_popcount( static_cast<unsigned>( neq ) ) );
+  }
+
+  return static_cast<float>( count );
+}
+
+ALEPH_AVX512 inline double hammingAVX512( const double* a, const double* b, std::size_t n ) noexcept
+{
+  std::size_t count = 0;
+
+  for( std::size_t i = 0; i < n; i += 8 )
+  {
+    auto mask = n - i >= 8 ? static_cast<__mmask8>( 0xFF ) : tailMask8( n - i );
+    auto neq  = _mm512_mask_cmp_pd_mask( mask, _mm512_maskz_loadu_pd( mask, a+i ), _mm512_maskz_loadu_pd( mask, b+i ), _CMP_NEQ_UQ );
+    count    += static_cast<std::size_t>( __builtin_popcount( static_cast<unsigned>( neq ) ) );
+  }
+
+  return static_cast<double>( count );
+}
+
+ALEPH_AVX512 inline float dotAVX512( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m512 s0 = _mm512_setzero_ps();
+  __m512 s1 = _mm512_setzero_ps();
+
+  std::size_t i = 0;
+
+  for( ; i + 32 <= n; i += 32 )
+  {
+    s0 = _mm512_fmadd_ps( _mm512_loadu_ps( a+i ),    _mm512_loadu_ps( b+i ),    s0 );
+    s1 = _mm512_fmadd_ps( _mm512_loadu_ps( a+i+16 ), _mm512_loadu_ps( b+i+16 ), s1 );
+  }
+
+  for( ; i < n; i += 16 )
+  {
+    auto mask = n - i >= 16 ? static_cast<__mmask16>( 0xFFFF ) : tailMask16( n - i );
+    s0        = _mm512_fmadd_ps( _mm512_maskz_loadu_ps( mask, a+i ), _mm512_maskz_loadu_ps( mask, b+i ), s0 );
+  }
+
+  return horizontalSum( _mm512_add_ps( s0, s1 ) );
+}
+
+ALEPH_AVX512 inline double dotAVX512( const double* a, const double* b, std::size_t n ) noexcept
+{
+  __m512d s0 = _mm512_setzero_pd();
+  __m512d s1 = _mm512_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 16 <= n; i += 16 )
+  {
+    s0 = _mm512_fmadd_pd( _mm512_loadu_pd( a+i ),   _mm512_loadu_pd( b+i ),   s0 );
+    s1 = _mm512_fmadd_pd( _mm512_loadu_pd( a+i+8 ), _mm512_loadu_pd( b+i+8 ), s1 );
+  }
+
+  for( ; i < n; i += 8 )
+  {
+    auto mask = n - i >= 8 ? static_cast<__mmask8>( 0xFF ) : tailMask8( n - i );
+    s0        = _mm512_fmadd_pd( _mm512_maskz_loadu_pd( mask, a+i ), _mm512_maskz_loadu_pd( mask, b+i ), s0 );
+  }
+
+  return horizontalSum( _mm512_add_pd( s0, s1 ) );
+}
+
+// Converts eight single precision values to double precision. The masked
+// conversion is used because the unmasked one triggers the same spurious
+// warnings as the reduction intrinsics.
+ALEPH_AVX512 inline __m512d toDouble( __m256 x ) noexcept
+{
+  return _mm512_maskz_cvtps_pd( static_cast<__mmask8>( 0xFF ), x );
+}
+
+// Loads up to eight single precision values and converts them to double
+// precision. Missing values are set to zero.
+ALEPH_AVX512 inline __m512d loadMixed( const float* a, std::size_t n ) noexcept
+{
+  __m256i count = _mm256_set1_epi32( static_cast<int>( std::min( n, std::size_t( 8 ) ) ) );
+  __m256i mask  = _mm256_cmpgt_epi32( count, _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ) );
+
+  return toDouble( _mm256_maskload_ps( a, mask ) );
+}
+
+ALEPH_AVX512 inline double squaredEuclideanMixedAVX512( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m512d s0 = _mm512_setzero_pd();
+  __m512d s1 = _mm512_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 16 <= n; i += 16 )
+  {
+    __m512d d0 = _mm512_sub_pd( toDouble( _mm256_loadu_ps( a+i ) ),   toDouble( _mm256_loadu_ps( b+i ) ) );
+    __m512d d1 = _mm512_sub_pd( toDouble( _mm256_loadu_ps( a+i+8 ) ), toDouble( _mm256_loadu_ps( b+i+8 ) ) );
+
+    s0 = _mm512_fmadd_pd( d0, d0, s0 );
+    s1 = _mm512_fmadd_pd( d1, d1, s1 );
+  }
+
+  for( ; i < n; i += 8 )
+  {
+    __m512d d = _mm512_sub_pd( loadMixed( a+i, n-i ), loadMixed( b+i, n-i ) );
+    s0        = _mm512_fmadd_pd( d, d, s0 );
+  }
+
+  return horizontalSum( _mm512_add_pd( s0, s1 ) );
+}
+
+ALEPH_AVX512 inline double manhattanMixedAVX512( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m512d s0 = _mm512_setzero_pd();
+  __m512d s1 = _mm512_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 16 <= n; i += 16 )
+  {
+    __m512d d0 = _mm512_sub_pd( toDouble( _mm256_loadu_ps( a+i ) ),   toDouble( _mm256_loadu_ps( b+i ) ) );
+    __m512d d1 = _mm512_sub_pd( toDouble( _mm256_loadu_ps( a+i+8 ) ), toDouble( _mm256_loadu_ps( b+i+8 ) ) );
+
+    s0 = _mm512_add_pd( s0, _mm512_abs_pd( d0 ) );
+    s1 = _mm512_add_pd( s1, _mm512_abs_pd( d1 ) );
+  }
+
+  for( ; i < n; i += 8 )
+  {
+    __m512d d = _mm512_sub_pd( loadMixed( a+i, n-i ), loadMixed( b+i, n-i ) );
+    s0        = _mm512_add_pd( s0, _mm512_abs_pd( d ) );
+  }
+
+  return horizontalSum( _mm512_add_pd( s0, s1 ) );
+}
+
+ALEPH_AVX512 inline double dotMixedAVX512( const float* a, const float* b, std::size_t n ) noexcept
+{
+  __m512d s0 = _mm512_setzero_pd();
+  __m512d s1 = _mm512_setzero_pd();
+
+  std::size_t i = 0;
+
+  for( ; i + 16 <= n; i += 16 )
+  {
+    s0 = _mm512_fmadd_pd( toDouble( _mm256_loadu_ps( a+i ) ),   toDouble( _mm256_loadu_ps( b+i ) ),   s0 );
+    s1 = _mm512_fmadd_pd( toDouble( _mm256_loadu_ps( a+i+8 ) ), toDouble( _mm256_loadu_ps( b+i+8 ) ), s1 );
+  }
+
+  for( ; i < n; i += 8 )
+    s0 = _mm512_fmadd_pd( loadMixed( a+i, n-i ), loadMixed( b+i, n-i ), s0 );
+
+  return horizontalSum( _mm512_add_pd( s0, s1 ) );
+}
+
+#undef ALEPH_AVX512
+
+/** Counts different bits with the population count instruction of AVX-512 */
+__attribute__(( target( "avx512f,avx512vpopcntdq" ) ))
+inline std::uint64_t hammingWordsAVX512( const std::uint64_t* a, const std::uint64_t* b, std::size_t n ) noexcept
+{
+  __m512i sum = _mm512_setzero_si512();
+
+  for( std::size_t i = 0; i < n; i += 8 )
+  {
+    auto mask = n - i >= 8 ? static_cast<__mmask8>( 0xFF ) : static_cast<__mmask8>( ( 1u << ( n - i ) ) - 1u );
+    __m512i x = _mm512_xor_si512( _mm512_maskz_loadu_epi64( mask, a+i ), _mm512_maskz_loadu_epi64( mask, b+i ) );
+    sum       = _mm512_add_epi64( sum, _mm512_popcnt_epi64( x ) );
+  }
+
+  alignas(64) std::uint64_t buffer[8];
+  _mm512_store_si512( buffer, sum );
+
+  std::uint64_t result = 0;
+  for( auto&& c : buffer )
+    result += c;
+
+  return result;
+}
+
+#endif
+
+// Dispatch ------------------------------------------------------------
+
+/**
+  Stores the kernels for one instruction set. All kernels operate on two
+  contiguous ranges of the same length, whose values are of type T, and
+  accumulate their results in type R.
+*/
+
+template <class T, class R = T> struct Kernels
+{
+  using Function = R (*)( const T*, const T*, std::size_t );
+
+  Function squaredEuclidean;
+  Function manhattan;
+  Function hamming;
+  Function dot;
+};
+
+/** Tag for kernels that accumulate single precision values in double precision */
+struct MixedPrecision
+{
+};
+
+/** Keeps the generic kernels for types without vectorised kernels */
+
+template <class T, class R> Kernels<T, R> makeVectorisedKernels( InstructionSet, Kernels<T, R> kernels, void* ) noexcept
+{
+  return kernels;
+}
+
+/** Replaces the generic kernels by vectorised kernels for single and double precision */
+template <class T> Kernels<T> makeVectorisedKernels( InstructionSet instructionSet, Kernels<T> kernels, T* ) noexcept
+{
+#ifdef ALEPH_GEOMETRY_DISTANCES_X86_KERNELS
+  using Function = typename Kernels<T>::Function;
+
+  switch( instructionSet )
+  {
+  case InstructionSet::Generic:
+    break;
+  case InstructionSet::AVX2:
+    kernels.squaredEuclidean = static_cast<Function>( &squaredEuclideanAVX2 );
+    kernels.manhattan        = static_cast<Function>( &manhattanAVX2 );
+    kernels.hamming          = static_cast<Function>( &hammingAVX2 );
+    kernels.dot              = static_cast<Function>( &dotAVX2 );
+    break;
+  case InstructionSet::AVX512:
+    kernels.squaredEuclidean = static_cast<Function>( &squaredEuclideanAVX512 );
+    kernels.manhattan        = static_cast<Function>( &manhattanAVX512 );
+    kernels.hamming          = static_cast<Function>( &hammingAVX512 );
+    kernels.dot              = static_cast<Function>( &dotAVX512 );
+    break;
+  }
+#else
+  (void) instructionSet;
+#endif
+
+  return kernels;
+}
+
+/**
+  Replaces the generic kernels by vectorised kernels for single precision
+  values that are accumulated in double precision. The Hamming distance
+  does not accumulate any values, so it always uses the generic kernel.
+*/
+
+inline Kernels<float, double> makeVectorisedKernels( InstructionSet instructionSet, Kernels<float, double> kernels, MixedPrecision* ) noexcept
+{
+#ifdef ALEPH_GEOMETRY_DISTANCES_X86_KERNELS
+  switch( instructionSet )
+  {
+  case InstructionSet::Generic:
+    break;
+  case InstructionSet::AVX2:
+    kernels.squaredEuclidean = &squaredEuclideanMixedAVX2;
+    kernels.manhattan        = &manhattanMixedAVX2;
+    kernels.dot              = &dotMixedAVX2;
+    break;
+  case InstructionSet::AVX512:
+    kernels.squaredEuclidean = &squaredEuclideanMixedAVX512;
+    kernels.manhattan        = &manhattanMixedAVX512;
+    kernels.dot              = &dotMixedAVX512;
+    break;
+  }
+#else
+  (void) instructionSet;
+#endif
+
+  return kernels;
+}
+
+/**
+  Creates the kernels for a given instruction set. If the instruction set
+  is not supported by the current processor, the generic kernels will be
+  used instead.
+*/
+
+template <class T, class R = T> Kernels<T, R> makeKernels( InstructionSet instructionSet ) noexcept
+{
+  static_assert( std::is_floating_point<T>::value && std::is_floating_point<R>::value, "Distance kernels require a floating point type" );
+
+  Kernels<T, R> kernels = {
+    &squaredEuclideanGeneric<T, R>,
+    &manhattanGeneric<T, R>,
+    &hammingGeneric<T, R>,
+    &dotGeneric<T, R>
+  };
+
+  if( !isSupported( instructionSet ) )
+    return kernels;
+
+  // Only single and double precision, as well as single precision with
+  // double precision accumulation, are vectorised; other combinations
+  // of floating point types use the generic kernels.
+  using Type = typename std::conditional<
+    std::is_same<T, R>::value && ( std::is_same<T, float>::value || std::is_same<T, double>::value ),
+    T,
+    typename std::conditional<
+      std::is_same<T, float>::value && std::is_same<R, double>::value,
+      MixedPrecision,
+      void
+    >::type
+  >::type;
+
+  return makeVectorisedKernels( instructionSet, kernels, static_cast<Type*>( nullptr ) );
+}
+
+/**
+  @returns Kernels for the best instruction set of the current processor;
+  the instruction set is only determined once.
+*/
+
+template <class T, class R = T> const Kernels<T, R>& kernels() noexcept
+{
+  static const Kernels<T, R> result = makeKernels<T, R>( bestInstructionSet() );
+  return result;
+}
+
+/** Function type of kernels for bit vectors that are stored in packed form */
+using WordKernel = std::uint64_t (*)( const std::uint64_t*, const std::uint64_t*, std::size_t );
+
+/**
+  Creates the Hamming distance kernel for packed bit vectors for a given
+  instruction set. The AVX-512 kernel additionally requires the population
+  count extension; without it, the AVX2 kernel will be used.
+*/
+
+inline WordKernel makeHammingWordsKernel( InstructionSet instructionSet ) noexcept
+{
+  if( !isSupported( instructionSet ) )
+    return &hammingWordsGeneric;
+
+#ifdef ALEPH_GEOMETRY_DISTANCES_X86_KERNELS
+  switch( instructionSet )
+  {
+  case InstructionSet::Generic:
+    break;
+  case InstructionSet::AVX512:
+    if( __builtin_cpu_supports( "avx512vpopcntdq" ) )
+      return &hammingWordsAVX512;
+    else if( isSupported( InstructionSet::AVX2 ) )
+      return &hammingWordsAVX2;
+    break;
+  case InstructionSet::AVX2:
+    return &hammingWordsAVX2;
+  }
+#endif
+
+  return &hammingWordsGeneric;
+}
+
+/** @returns Hamming distance kernel for packed bit vectors of the current processor */
+inline WordKernel hammingWordsKernel() noexcept
+{
+  static const WordKernel result = makeHammingWordsKernel( bestInstructionSet() );
+  return result;
+}
+
+/**
+  Checks whether an iterator refers to contiguous storage of a type,
+  which permits the use of the distance kernels.
+*/
+
+template <class Iterator, class T> struct IsContiguous
+{
+  using Type = typename std::remove_cv<T>::type;
+
+  static constexpr bool value =    std::is_same<Iterator, Type*>::value
+                                || std::is_same<Iterator, const Type*>::value
+                                || std::is_same<Iterator, typename std::vector<Type>::iterator>::value
+                                || std::is_same<Iterator, typename std::vector<Type>::const_iterator>::value;
+};
+
+/** @returns Pointer to the element that an iterator refers to */
+template <class T, class Iterator> const T* pointer( Iterator it ) noexcept
+{
+  return &*it;
+}
+
+/**
+  Calculates the distances between a query point and a set of points,
+  which are stored contiguously in row-major order, using a kernel.
+*/
+
+template <class T, class R> void oneToMany( R (*kernel)( const T*, const T*, std::size_t ),
+                                            const T* q,
+                                            const T* points, std::size_t n,
+                                            std::size_t d,
+                                            R* result )
+{
+  for( std::size_t i = 0; i < n; i++ )
+    result[i] = kernel( q, points + i*d, d );
+}
+
+/**
+  Calculates all distances between two sets of points, which are stored
+  contiguously in row-major order, using a kernel. Rows of the result are
+  calculated in parallel if OpenMP is available.
+*/
+
+template <class T, class R> void manyToMany( R (*kernel)( const T*, const T*, std::size_t ),
+                                             const T* A, std::size_t m,
+                                             const T* B, std::size_t n,
+                                             std::size_t d,
+                                             R* result )
+{
+#ifdef _OPENMP
+  #pragma omp parallel for
+#endif
+  for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( m ); s++ )
+  {
+    auto i = static_cast<std::size_t>( s );
+
+    for( std::size_t j = 0; j < n; j++ )
+      result[i*n + j] = kernel( A + i*d, B + j*d, d );
+  }
+}
+
+/**
+  Calculates all squared Euclidean distances between two sets of points,
+  which are stored contiguously in row-major order. This function uses
+  the identity \f$\|x-y\|^2 = \|x\|^2 + \|y\|^2 - 2\langle x, y\rangle\f$,
+  so most of the work consists of the dot products of all pairs, which
+  are calculated like a matrix product:
+
+  - Blocks of points of B are packed into panels of `NR` points, which
+    store the coordinates of all points of a panel contiguously for every
+    dimension, converted to the result type.
+
+  - A micro-kernel calculates the dot products of `MR` points of A with
+    all points of a panel. Its `MR * NR` sums remain in registers for all
+    dimensions, so every coordinate that is loaded is used `MR` or `NR`
+    times. The innermost loop runs over the points of the panel, which
+    permits the compiler to vectorise it without reordering any sums.
+
+  Blocks of rows of the result are calculated in parallel if OpenMP is
+  available. In contrast to the direct calculation, the identity suffers
+  from cancellation errors for nearby points, so the results may differ
+  slightly from the kernels of individual pairs of points, and they are
+  clamped to zero. Accumulating single precision values in double
+  precision reduces these errors considerably.
+*/
+
+template <class T, class R> void squaredEuclideanManyToMany( const T* A, std::size_t m,
+                                                             const T* B, std::size_t n,
+                                                             std::size_t d,
+                                                             R* result )
+{
+  // Size of the micro-kernel; 4 x 8 sums fit into the vector registers of
+  // all supported instruction sets.
+  constexpr std::size_t MR = 4;
+  constexpr std::size_t NR = 8;
+
+  auto&& K = kernels<T, R>();
+
+  std::vector<R> normsA( m );
+  std::vector<R> normsB( n );
+
+  for( std::size_t i = 0; i < m; i++ )
+    normsA[i] = K.dot( A + i*d, A + i*d, d );
+
+  for( std::size_t j = 0; j < n; j++ )
+    normsB[j] = K.dot( B + j*d, B + j*d, d );
+
+  // Chooses the block size such that the packed panels of a block of
+  // points fit into the cache of a core
+  std::size_t blockSize = std::max( NR, std::size_t( 32768 ) / ( sizeof(R) * std::max( d, std::size_t(1) ) ) / NR * NR );
+  std::size_t numBlocks = ( m + blockSize - 1 ) / blockSize;
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    std::vector<R> panels( blockSize * d );
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic)
+#endif
+    for( std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t>( numBlocks ); s++ )
+    {
+      auto i0 = static_cast<std::size_t>( s ) * blockSize;
+      auto i1 = std::min( m, i0 + blockSize );
+
+      for( std::size_t j0 = 0; j0 < n; j0 += blockSize )
+      {
+        auto j1 = std::min( n, j0 + blockSize );
+
+        // Pack the block of B; missing points of the last panel are
+        // padded with zeroes.
+        for( std::size_t p = j0; p < j1; p += NR )
+        {
+          auto panel = panels.data() + ( p - j0 ) * d;
+
+          for( std::size_t k = 0; k < d; k++ )
+          {
+            for( std::size_t t = 0; t < NR; t++ )
+              panel[k*NR + t] = p + t < j1 ? static_cast<R>( B[(p+t)*d + k] ) : R();
+          }
+        }
+
+        for( std::size_t i = i0; i < i1; i += MR )
+        {
+          // Missing rows of the last micro-kernel repeat the first row;
+          // their results are discarded.
+          const T* rows[MR];
+
+          for( std::size_t r = 0; r < MR; r++ )
+            rows[r] = A + ( i + r < i1 ? i + r : i ) * d;
+
+          for( std::size_t p = j0; p < j1; p += NR )
+          {
+            auto panel = panels.data() + ( p - j0 ) * d;
+
+            R sums[MR][NR] = {};
+
+            for( std::size_t k = 0; k < d; k++ )
+            {
+              auto b = panel + k*NR;
+
+              for( std::size_t r = 0; r < MR; r++ )
+              {
+                auto a = static_cast<R>( rows[r][k] );
+
+                for( std::size_t t = 0; t < NR; t++ )
+                  sums[r][t] += a * b[t];
+              }
+            }
+
+            for( std::size_t r = 0; r < MR && i + r < i1; r++ )
+            {
+              for( std::size_t t = 0; t < NR && p + t < j1; t++ )
+              {
+                auto x                  = normsA[i+r] + normsB[p+t] - 2 * sums[r][t];
+                result[(i+r)*n + p + t] = std::max( x, R() );
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+} // namespace distances
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
@@ -1,11 +1,14 @@
 #ifndef ALEPH_GEOMETRY_DISTANCES_MANHATTAN_HH__
 #define ALEPH_GEOMETRY_DISTANCES_MANHATTAN_HH__
 
+#include <aleph/geometry/distances/Kernels.hh>
+
 #include <cstddef>
 #include <cmath>
 
 #include <iterator>
 #include <string>
+#include <type_traits>
 
 namespace aleph
 {
@@ -21,11 +24,15 @@ namespace distances
   to handle arbitrary ranges. Its interface is general, but the \c accum_dist
   function is specifically meant to be used with FLANN.
 
+  The second template parameter specifies the type in which distances are
+  accumulated and reported, which may have a higher precision than the
+  type of the data.
+
   @see FLANN project page (http://www.cs.ubc.ca/research/flann)
   @see FLANN repository   (https://github.com/mariusmuja/flann)
 */
 
-template <class T> class Manhattan
+template <class T, class R = T> class Manhattan
 {
 public:
 
@@ -35,7 +42,7 @@ public:
 
   // Required for FLANN usage
   using ElementType = T;
-  using ResultType  = T;
+  using ResultType  = R;
 
   /**
     Given two ranges of double values, which are assumed to represent two
@@ -48,7 +55,8 @@ public:
     @param worstDistance If set to a value greater than zero, calculations will
     stop once the value has been reached. Else, the value of this variable is
     ignored. This variable is provided in order to remain compatible with the
-    interface of FLANN.
+    interface of FLANN. Contiguous ranges of floating point values are handled
+    by vectorised kernels, which always calculate the full distance.
 
     @returns Manhattan distance between the two input vectors.
   */
@@ -57,18 +65,125 @@ public:
   ResultType operator()( Iterator1 a,
                          Iterator2 b,
                          std::size_t size,
-                         ElementType worstDistance = -1.0 ) const
+                         ResultType worstDistance = -1.0 ) const
+  {
+    using UseKernel = std::integral_constant<bool,
+                                                std::is_floating_point<ElementType>::value
+                                             && std::is_floating_point<ResultType>::value
+                                             && detail::IsContiguous<Iterator1, ElementType>::value
+                                             && detail::IsContiguous<Iterator2, ElementType>::value>;
+
+    return this->distance( a, b, size, worstDistance, UseKernel() );
+  }
+
+  /**
+    Calculates the distances between a query point and a set of points,
+    which are stored contiguously in row-major order.
+
+    @param q      Query point
+    @param points Points
+    @param n      Number of points
+    @param d      Dimension of the query point and all other points
+    @param result Output array, which must have space for n values
+  */
+
+  void oneToMany( const ElementType* q,
+                  const ElementType* points, std::size_t n,
+                  std::size_t d,
+                  ResultType* result ) const
+  {
+    detail::oneToMany( detail::kernels<ElementType, ResultType>().manhattan, q, points, n, d, result );
+  }
+
+  /**
+    Calculates all pairwise distances between two sets of points, which
+    are stored contiguously in row-major order. The result is stored in
+    row-major order as well, i.e. the distance between the ith point of
+    the first set and the jth point of the second set is stored at index
+    i*n + j.
+
+    @param A      First set of points
+    @param m      Number of points in the first set
+    @param B      Second set of points
+    @param n      Number of points in the second set
+    @param d      Dimension of all points
+    @param result Output array, which must have space for m*n values
+  */
+
+  void manyToMany( const ElementType* A, std::size_t m,
+                   const ElementType* B, std::size_t n,
+                   std::size_t d,
+                   ResultType* result ) const
+  {
+    detail::manyToMany( detail::kernels<ElementType, ResultType>().manhattan, A, m, B, n, d, result );
+  }
+
+  /**
+    Partial distance calculation, used by FLANN for fast kd-tree calculations.
+    This function exploits that the Manhattan distance can be evaluated
+    component-wise.
+
+    @param a First component
+    @param b Second component
+
+    @returns Partial distance between those two components
+  */
+
+  template <typename U, typename V>
+  ResultType accum_dist( const U& a,
+                         const V& b,
+                         int __attribute__((unused)) ) const
+  {
+    return std::abs( a - b );
+  }
+
+  /** @returns Name of functor */
+  static std::string name()
+  {
+    return "Manhattan distance";
+  }
+
+private:
+
+  /**
+    Calculates the distance between two contiguous ranges of floating
+    point values with the fastest kernel that is supported by the current
+    processor. Since the kernels are vectorised, they do not stop early,
+    and the worst distance is ignored.
+  */
+
+  template <typename Iterator1, typename Iterator2>
+  ResultType distance( Iterator1 a,
+                       Iterator2 b,
+                       std::size_t size,
+                       ResultType /* worstDistance */,
+                       std::true_type ) const
+  {
+    if( size == 0 )
+      return ResultType();
+
+    auto&& K = detail::kernels<ElementType, ResultType>();
+    return K.manhattan( detail::pointer<ElementType>( a ), detail::pointer<ElementType>( b ), size );
+  }
+
+  /** Calculates the distance between two arbitrary ranges */
+  template <typename Iterator1, typename Iterator2>
+  ResultType distance( Iterator1 a,
+                       Iterator2 b,
+                       std::size_t size,
+                       ResultType worstDistance,
+                       std::false_type ) const
   {
     // Fixes warnings about unused parameters. This parameter is
     // provided for compatibility reasons with FLANN only.
     (void) worstDistance;
 
-    ElementType result = 0.0;
+    ResultType result = 0.0;
 
-    ElementType diff0  = 0.0;
-    ElementType diff1  = 0.0;
-    ElementType diff2  = 0.0;
-    ElementType diff3  = 0.0;
+    ResultType diff0  = 0.0;
+    ResultType diff1  = 0.0;
+    ResultType diff2  = 0.0;
+    ResultType diff3  = 0.0;
 
     using DifferenceType1
       = typename std::iterator_traits<Iterator1>::difference_type;
@@ -78,10 +193,10 @@ public:
 
     while( a < lastGroup )
     {
-      diff0 = std::abs( ElementType( a[0] - b[0] ) );
-      diff1 = std::abs( ElementType( a[1] - b[1] ) );
-      diff2 = std::abs( ElementType( a[2] - b[2] ) );
-      diff3 = std::abs( ElementType( a[3] - b[3] ) );
+      diff0 = std::abs( ResultType( a[0] ) - ResultType( b[0] ) );
+      diff1 = std::abs( ResultType( a[1] ) - ResultType( b[1] ) );
+      diff2 = std::abs( ResultType( a[2] ) - ResultType( b[2] ) );
+      diff3 = std::abs( ResultType( a[3] ) - ResultType( b[3] ) );
 
       result +=   diff0
                 + diff1
@@ -97,37 +212,12 @@ public:
 
     while( a < last )
     {
-      diff0  = std::abs( ElementType( *a++ - *b++ ) );
+      diff0  = std::abs( ResultType( *a++ ) - ResultType( *b++ ) );
       result = result + diff0;
     }
 
     return result;
   }
-
-  /**
-    Partial distance calculation, used by FLANN for fast kd-tree calculations.
-    This function exploits that the Manhattan distance can be evaluated
-    component-wise.
-
-    @param a First component
-    @param b Second component
-
-    @returns Partial distance between those two components
-  */
-
-  template <typename U, typename V>
-  ResultType accum_dist( const U& a,
-                         const V& b,
-                         int __attribute__((unused)) ) const
-  {
-    return std::abs( a - b );
-  }
-
-  /** @returns Name of functor */
-  static std::string name()
-  {
-    return "Manhattan distance";
-  }
 };
 
 } // namespace distances
@@ -0,0 +1,151 @@
+#ifndef ALEPH_GEOMETRY_DISTANCES_PACKED_HAMMING_HH__
+#define ALEPH_GEOMETRY_DISTANCES_PACKED_HAMMING_HH__
+
+#include <aleph/geometry/distances/Kernels.hh>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <iterator>
+#include <string>
+#include <type_traits>
+
+namespace aleph
+{
+
+namespace geometry
+{
+
+namespace distances
+{
+
+/**
+  Hamming distance functor for binary vectors that are stored in packed
+  form, i.e. every element of a range is a word that stores one bit per
+  coordinate. The distance is calculated by counting the bits of the XOR
+  of two words, using the population count instructions of the current
+  processor. Unused bits of a word must be zero.
+
+  In contrast to the other distance functors, the size of a range refers
+  to the number of *words*, not to the number of coordinates. This is
+  consistent with aleph::containers::BitPointCloud, whose dimension is the
+  number of words per point.
+
+  @see aleph::containers::BitPointCloud
+*/
+
+template <class T = std::uint64_t> class PackedHamming
+{
+public:
+
+  static_assert( std::is_integral<T>::value && std::is_unsigned<T>::value, "Packed bit vectors require an unsigned integral type" );
+
+  // Flag telling FLANN that this functor can be used for calculating distances
+  // within kd trees.
+  using is_kdtree_distance = bool;
+
+  // Required for FLANN usage
+  using ElementType = T;
+  using ResultType  = T;
+
+  /**
+    Given two ranges of words, which are assumed to represent two binary
+    vectors, calculates the number of bits in which they differ.
+
+    @param a             Iterator describing first vector
+    @param b             Iterator describing second vector
+    @param size          Number of words of vectors a and b
+
+    @param worstDistance If set to a value greater than zero, calculations will
+    stop once the value has been reached. Else, the value of this variable is
+    ignored. This variable is provided in order to remain compatible with the
+    interface of FLANN. Contiguous ranges of 64-bit words always use the full
+    distance calculation.
+
+    @returns Hamming distance between the two input vectors.
+  */
+
+  template <typename Iterator1, typename Iterator2>
+  ResultType operator()( Iterator1 a,
+                         Iterator2 b,
+                         std::size_t size,
+                         ElementType worstDistance = 0 ) const
+  {
+    using UseKernel = std::integral_constant<bool,
+                                                std::is_same<ElementType, std::uint64_t>::value
+                                             && detail::IsContiguous<Iterator1, ElementType>::value
+                                             && detail::IsContiguous<Iterator2, ElementType>::value>;
+
+    return this->distance( a, b, size, worstDistance, UseKernel() );
+  }
+
+  /**
+    Partial distance calculation, used by FLANN for fast kd-tree calculations.
+    This function exploits that the Hamming distance can be evaluated
+    word-wise.
+
+    @param a First word
+    @param b Second word
+
+    @returns Number of different bits in both words
+  */
+
+  template <typename U, typename V>
+  ResultType accum_dist( const U& a,
+                         const V& b,
+                         int __attribute__((unused)) ) const
+  {
+    return static_cast<ResultType>( detail::popcount( static_cast<std::uint64_t>( a ^ b ) ) );
+  }
+
+  /** @returns Name of functor */
+  static std::string name()
+  {
+    return "Packed Hamming distance";
+  }
+
+private:
+
+  /** Uses the fastest kernel for contiguous ranges of 64-bit words */
+  template <typename Iterator1, typename Iterator2>
+  ResultType distance( Iterator1 a,
+                       Iterator2 b,
+                       std::size_t size,
+                       ElementType /* worstDistance */,
+                       std::true_type ) const
+  {
+    if( size == 0 )
+      return ResultType();
+
+    return detail::hammingWordsKernel()( detail::pointer<ElementType>( a ), detail::pointer<ElementType>( b ), size );
+  }
+
+  /** Calculates the distance between two arbitrary ranges of words */
+  template <typename Iterator1, typename Iterator2>
+  ResultType distance( Iterator1 a,
+                       Iterator2 b,
+                       std::size_t size,
+                       ElementType worstDistance,
+                       std::false_type ) const
+  {
+    ResultType result = ResultType();
+
+    for( std::size_t i = 0; i < size; i++, ++a, ++b )
+    {
+      result = static_cast<ResultType>( result + this->accum_dist( *a, *b, 0 ) );
+
+      if( worstDistance > 0 && result > worstDistance )
+        return result;
+    }
+
+    return result;
+  }
+};
+
+} // namespace distances
+
+} // namespace geometry
+
+} // namespace aleph
+
+#endif
@@ -25,14 +25,14 @@ template <class T> struct Traits
   using ResultType  = typename T::ResultType;
   using ElementType = typename T::ElementType;
 
-  ResultType from( ElementType x ) const noexcept
+  ResultType from( ResultType x ) const noexcept
   {
-    return ResultType( x );
+    return x;
   }
 
-  ResultType to( ElementType x ) const noexcept
+  ResultType to( ResultType x ) const noexcept
   {
-    return ResultType( x );
+    return x;
   }
 };
 
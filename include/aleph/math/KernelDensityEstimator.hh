@@ -1,6 +1,8 @@
 #ifndef ALEPH_MATH_KERNEL_DENSITY_ESTIMATOR_HH__
 #define ALEPH_MATH_KERNEL_DENSITY_ESTIMATOR_HH__
 
+#include <aleph/math/KahanSummation.hh>
+
 #include <functional>
 #include <iterator>
 #include <numeric>
@@ -184,11 +186,14 @@ public:
     static_assert( std::is_same<typename std::iterator_traits<InputIterator>::value_type, DataType>::value,
                    "Input iterator value type and data type must match" );
 
-    double value = 0.0;
+    // The contributions of individual points may be very small, so they
+    // are accumulated with compensation, regardless of the precision of
+    // the data.
+    KahanSummation<double> value = 0.0;
 
     for( InputIterator it = begin; it != end; ++it )
     {
-      double norm_   = norm( difference( *it, x ) );
+      double norm_   = static_cast<double>( norm( difference( *it, x ) ) );
       double kernel_ = kernel( norm_ / _bandwidth );
 
       value += kernel_;
@@ -2,6 +2,7 @@
 #define ALEPH_MATH_SYMMETRIC_MATRIX_HH__
 
 #include <algorithm>
+#include <memory>
 #include <ostream>
 #include <stdexcept>
 
@@ -25,7 +26,10 @@ namespace math
       M(i,j)
       M(j,i)
 
-  Other than that, this class aims to have a small footprint.
+  Other than that, this class aims to have a small footprint. The upper
+  triangular part of the matrix, including the diagonal, is stored in
+  row-major order. The storage may also be provided externally, e.g. by
+  a file that has been mapped into memory.
 
   @tparam T Data type stored in matrix, e.g. `double`
   @tparam I Index type for accessing the matrix. You may change this for
@@ -47,8 +51,28 @@ public:
     : _numRows( n )
     , _size( n * ( n + 1 ) / 2 )
     , _data( new T[ _size ] )
+    , _storage( _data, std::default_delete<T[]>() )
+  {
+    std::fill( _data, _data + _size, T() );
+  }
+
+  /**
+    Creates a symmetric matrix that uses external storage. The storage
+    must have space for \f$n(n+1)/2\f$ values, which are interpreted as
+    the upper triangular part of the matrix in row-major order. The data
+    are neither copied nor initialized.
+
+    @param n       Number of rows (and columns)
+    @param data    Pointer to the upper triangular part of the matrix
+    @param storage Owner of the storage; the matrix keeps it alive
+  */
+
+  SymmetricMatrix( I n, T* data, std::shared_ptr<void> storage )
+    : _numRows( n )
+    , _size( n * ( n + 1 ) / 2 )
+    , _data( data )
+    , _storage( std::move( storage ) )
   {
-    std::fill( _data, _data + _size, I(0) );
   }
 
   /**
@@ -66,18 +90,23 @@ public:
     std::copy( other._data, other._data + other._size, _data );
   }
 
-  /** Destroys the symmetric matrix */
-  ~SymmetricMatrix()
+  /**
+    Moves a symmetric matrix. In contrast to copying it, this does not
+    allocate any memory, and external storage remains in use.
+  */
+
+  SymmetricMatrix( SymmetricMatrix&& other ) noexcept
   {
-    delete[] _data;
+    this->swap( other );
   }
 
   /** Swaps two matrices */
-  void swap( SymmetricMatrix& other )
+  void swap( SymmetricMatrix& other ) noexcept
   {
     std::swap( _numRows, other._numRows );
     std::swap( _size   , other._size    );
     std::swap( _data   , other._data    );
+    std::swap( _storage, other._storage );
   }
 
   /**
@@ -110,7 +139,7 @@ public:
     if( row > column )
       std::swap( row, column );
 
-    auto index = row * _numRows - row * ( row + 1 ) / 2 + column;
+    auto index = this->rowOffset( row ) + column;
 
     if( index >= _size )
       throw std::out_of_range( "Index is out of range" );
@@ -123,6 +152,48 @@ public:
     return const_cast<T&>( static_cast<const SymmetricMatrix&>( *this )( row, column ) );
   }
 
+  /**
+    Calculates the offset of a row in the storage of the upper triangular
+    part of a matrix with n rows. The offset refers to the (virtual) first
+    column of the row, so the entry in column \f$j \geq i\f$ of row
+    \f$i\f$ is stored at index `rowOffset(i,n) + j`. In contrast to
+    indexing a pointer with the individual terms, the offset is always in
+    the range of the storage.
+
+    @param row Row whose offset is to be calculated
+    @param n   Number of rows (and columns)
+
+    @returns Offset of the row, i.e. \f$i \cdot n - i(i+1)/2\f$
+  */
+
+  static I rowOffset( I row, I n ) noexcept
+  {
+    return row * n - row * ( row + 1 ) / 2;
+  }
+
+  /** @overload rowOffset( I, I ) */
+  I rowOffset( I row ) const noexcept
+  {
+    return rowOffset( row, _numRows );
+  }
+
+  /**
+    Returns pointer to the upper triangular part of the matrix, which is
+    stored in row-major order. Row i starts at index `rowOffset(i) + i`,
+    i.e. its first entry is the diagonal element.
+  */
+
+  T* data() noexcept
+  {
+    return _data;
+  }
+
+  /** @overload data() */
+  const T* data() const noexcept
+  {
+    return _data;
+  }
+
   /** Returns number of rows */
   I numRows() const noexcept
   {
@@ -152,6 +223,9 @@ private:
   /** 1D data storage (for efficiency reasons) */
   T* _data = nullptr;
 
+  /** Owner of the data storage, which may be external */
+  std::shared_ptr<void> _storage;
+
 };
 
 } // namespace math
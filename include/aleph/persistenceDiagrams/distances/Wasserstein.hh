@@ -2,6 +2,7 @@
 #define ALEPH_PERSISTENCE_DIAGRAMS_DISTANCES_WASSERSTEIN_HH__
 
 #include <aleph/geometry/distances/Infinity.hh>
+#include <aleph/math/KahanSummation.hh>
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 
 #include <aleph/persistenceDiagrams/distances/detail/Munkres.hh>
@@ -121,19 +122,22 @@ template <
 
   detail::Munkres<DataType> solver( costs );
 
-  auto M              = solver();
-  DataType totalCosts = DataType();
+  auto M = solver();
+
+  // Costs are accumulated in double precision with compensation, since
+  // there may be many small costs for single precision diagrams.
+  aleph::math::KahanSummation<double> totalCosts = 0.0;
 
   for( row = IndexType(); row < M.n(); row++ )
   {
     for( col = IndexType(); col < M.n(); col++ )
     {
       if( M( row, col ) == IndexType() )
-        totalCosts += costs( row, col );
+        totalCosts += static_cast<double>( costs( row, col ) );
     }
   }
 
-  return std::pow( totalCosts, 1 / power );
+  return static_cast<DataType>( std::pow( static_cast<double>( totalCosts ), 1.0 / static_cast<double>( power ) ) );
 }
 
 } // namespace distances
@@ -6,15 +6,19 @@
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 #include <aleph/persistenceDiagrams/Calculation.hh>
 
+#include <aleph/persistentHomology/Instrumentation.hh>
 #include <aleph/persistentHomology/PersistencePairing.hh>
+#include <aleph/persistentHomology/RepresentativeCycles.hh>
 
 #include <aleph/topology/Conversions.hh>
+#include <aleph/topology/FilteredView.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
 #include <algorithm>
 #include <limits>
 #include <tuple>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace aleph
@@ -29,6 +33,12 @@ namespace aleph
 
   @param M                          Boundary matrix to reduce
 
+  @param instrumentation            Instrumentation policy for collecting statistics
+                                    about the reduction, e.g. the number of column
+                                    additions or the wall time of every phase. See
+                                    persistentHomology::instrumentation::Statistics
+                                    for more details.
+
   @param includeAllUnpairedCreators Flag indicating whether all unpaired creators should
                                     be included (regardless of their dimension). If set,
                                     this increases the size of the resulting pairing, as
@@ -51,12 +61,17 @@ namespace aleph
   @tparam Representation     The representation of the boundary matrix, i.e. how
                              columns are stored. This parameter is automatically
                              determined from the input data.
+
+  @tparam Instrumentation    Instrumentation policy; this parameter is automatically
+                             determined from the input data.
 */
 
 template <
   class ReductionAlgorithm = aleph::defaults::ReductionAlgorithm,
-  class Representation = aleph::defaults::Representation
+  class Representation = aleph::defaults::Representation,
+  class Instrumentation
 > PersistencePairing<typename Representation::Index> calculatePersistencePairing( const topology::BoundaryMatrix<Representation>& M,
+                                                                                  Instrumentation& instrumentation,
                                                                                   bool includeAllUnpairedCreators    = false,
                                                                                   typename Representation::Index max = std::numeric_limits<typename Representation::Index>::max() )
 {
@@ -65,10 +80,18 @@ template <
   using Index              = typename Representation::Index;
   using PersistencePairing = PersistencePairing<Index>;
 
+  instrumentation.beginPhase( "copy" );
+
   BoundaryMatrix<Representation> B = M;
 
+  instrumentation.endPhase();
+  instrumentation.beginPhase( "reduction" );
+
   ReductionAlgorithm reductionAlgorithm;
-  reductionAlgorithm( B );
+  reductionAlgorithm( B, instrumentation );
+
+  instrumentation.endPhase();
+  instrumentation.beginPhase( "pairing" );
 
   PersistencePairing pairing;           // resulting pairing
   std::unordered_set<Index> creators;   // keeps track of (potential) creators
@@ -142,9 +165,82 @@ template <
   }
 
   std::sort( pairing.begin(), pairing.end() );
+
+  instrumentation.endPhase();
   return pairing;
 }
 
+/**
+  Given a boundary matrix, reduces it and reads off the resulting
+  persistence pairing. This is the uninstrumented variant of the
+  function above; please refer to its documentation for a detailed
+  description of all parameters.
+*/
+
+template <
+  class ReductionAlgorithm = aleph::defaults::ReductionAlgorithm,
+  class Representation = aleph::defaults::Representation
+> PersistencePairing<typename Representation::Index> calculatePersistencePairing( const topology::BoundaryMatrix<Representation>& M,
+                                                                                  bool includeAllUnpairedCreators    = false,
+                                                                                  typename Representation::Index max = std::numeric_limits<typename Representation::Index>::max() )
+{
+  persistentHomology::instrumentation::NoInstrumentation instrumentation;
+
+  return calculatePersistencePairing<ReductionAlgorithm>( M,
+                                                          instrumentation,
+                                                          includeAllUnpairedCreators,
+                                                          max );
+}
+
+/**
+  Given a boundary matrix, reduces it and reads off the resulting
+  persistence pairing as well as representative cycles for all pairs
+  whose persistence, i.e. the difference between the indices of their
+  destroyer and creator, is at least as large as a given threshold.
+  Cycles of essential features are always considered significant, but
+  they are only stored if requested, because this requires tracking
+  additional columns during the reduction.
+
+  Only the cycles of significant pairs are stored. Please refer to
+  persistentHomology::RepresentativeCycleTracking for more details
+  about the memory requirements.
+
+  @param M                          Boundary matrix to reduce; it must not be dualized
+  @param threshold                  Minimum persistence of pairs whose cycles are stored
+  @param includeEssential           Flag indicating whether cycles of essential features
+                                    should be stored
+  @param includeAllUnpairedCreators Flag indicating whether all unpaired creators should
+                                    be included; see calculatePersistencePairing()
+
+  @returns Persistence pairing and representative cycles, indexed by
+  the creator of each pair
+
+  @tparam ReductionAlgorithm Algorithm for reducing the boundary matrix
+  @tparam Representation     Representation of the boundary matrix
+*/
+
+template <
+  class ReductionAlgorithm = aleph::defaults::ReductionAlgorithm,
+  class Representation = aleph::defaults::Representation
+> std::pair<
+    PersistencePairing<typename Representation::Index>,
+    persistentHomology::RepresentativeCycles<typename Representation::Index>
+  > calculateRepresentativeCycles( const topology::BoundaryMatrix<Representation>& M,
+                                   typename Representation::Index threshold = typename Representation::Index(0),
+                                   bool includeEssential                    = false,
+                                   bool includeAllUnpairedCreators          = false )
+{
+  using Index = typename Representation::Index;
+
+  persistentHomology::RepresentativeCycleTracking<Index> tracking( threshold, includeEssential );
+
+  auto pairing = calculatePersistencePairing<ReductionAlgorithm>( M,
+                                                                  tracking,
+                                                                  includeAllUnpairedCreators );
+
+  return std::make_pair( pairing, tracking.cycles( pairing ) );
+}
+
 /**
   Calculates a set of persistence diagrams from a simplicial complex in
   filtration order, while permitting some additional parameters. Notice
@@ -178,6 +274,28 @@ template <
   return makePersistenceDiagrams( pairing, K );
 }
 
+/**
+  @overload calculatePersistenceDiagrams()
+
+  Calculates a set of persistence diagrams from a filtered view of
+  a simplicial complex, without copying any of its simplices.
+*/
+
+template <
+  class ReductionAlgorithm = defaults::ReductionAlgorithm,
+  class Representation     = defaults::Representation,
+  class SimplicialComplex,
+  class Predicate
+> std::vector< PersistenceDiagram<typename SimplicialComplex::ValueType::DataType> > calculatePersistenceDiagrams( const topology::FilteredView<SimplicialComplex, Predicate>& K, bool dualize = true, bool includeAllUnpairedCreators = false )
+{
+  using namespace topology;
+
+  auto boundaryMatrix = makeBoundaryMatrix<Representation>( K );
+  auto pairing        = calculatePersistencePairing<ReductionAlgorithm>( dualize ? boundaryMatrix.dualize() : boundaryMatrix, includeAllUnpairedCreators );
+
+  return makePersistenceDiagrams( pairing, K );
+}
+
 /**
   Calculates a persistence diagram from a boundary matrix and a set of
   function values. This function is meant to permit quick calculations
@@ -0,0 +1,261 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_INSTRUMENTATION_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_INSTRUMENTATION_HH__
+
+#include <aleph/utilities/Timer.hh>
+
+#include <algorithm>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace persistentHomology
+{
+
+namespace instrumentation
+{
+
+/**
+  @class NoInstrumentation
+  @brief Default instrumentation policy that does not record anything
+
+  All reduction algorithms call into an instrumentation policy when they
+  start, and whenever they add, clear, or finish reducing a column. This
+  class provides empty versions of all these hooks, so that the compiler
+  is able to remove them entirely. It is used by default.
+*/
+
+class NoInstrumentation
+{
+public:
+  template <class Matrix> void initialize( const Matrix& /* M */ ) noexcept
+  {
+  }
+
+  void beginPhase( const char* /* name */ ) noexcept
+  {
+  }
+
+  void endPhase() noexcept
+  {
+  }
+
+  template <class Matrix, class Index> void addition( const Matrix& /* M */, Index /* source */, Index /* target */ ) noexcept
+  {
+  }
+
+  template <class Matrix, class Index> void clear( const Matrix& /* M */, Index /* j */ ) noexcept
+  {
+  }
+
+  template <class Matrix, class Index> void reduced( const Matrix& /* M */, Index /* j */ ) noexcept
+  {
+  }
+};
+
+/**
+  @class Statistics
+  @brief Instrumentation policy for collecting statistics about a reduction
+
+  This policy keeps track of the number of columns, column additions,
+  cleared columns, and the fill-in of the reduced matrix, grouped by
+  the dimension of the simplex corresponding to each column. Moreover,
+  wall times of all phases reported by the algorithms are measured.
+
+  Statistics accumulate over multiple reductions; to start over, just
+  use a new instance.
+
+  Note that the fill-in is measured by querying the size of a column
+  from the boundary matrix, which requires a copy of the column. This
+  policy should thus only be used for diagnostic purposes.
+*/
+
+class Statistics
+{
+public:
+
+  /** Counters for all columns of a single dimension */
+  struct DimensionStatistics
+  {
+    std::size_t columns         = 0; ///< Number of columns
+    std::size_t additions       = 0; ///< Number of column additions (with this column as the target)
+    std::size_t cleared         = 0; ///< Number of columns that have been cleared
+    std::size_t maxColumnSize   = 0; ///< Maximum number of non-zero entries of a reduced column
+    std::size_t totalColumnSize = 0; ///< Total number of non-zero entries of all reduced columns
+  };
+
+  /** Wall time of a single phase of the calculation, measured in milliseconds */
+  using Phase = std::pair<std::string, double>;
+
+  // Hooks -------------------------------------------------------------
+
+  template <class Matrix> void initialize( const Matrix& M )
+  {
+    // Querying the maximum dimension of a matrix requires traversing
+    // all columns, so the value is cached for the following hooks.
+    _maxDimension = static_cast<std::size_t>( M.getDimension() );
+
+    using Index = decltype( M.getNumColumns() );
+
+    for( Index j = Index(0); j < M.getNumColumns(); j++ )
+      _dimensions[ this->dimension( M, j ) ].columns += 1;
+  }
+
+  void beginPhase( const char* name )
+  {
+    _currentPhases.push_back( name );
+    _timers.push_back( utilities::Timer() );
+  }
+
+  void endPhase()
+  {
+    if( _timers.empty() )
+      return;
+
+    _phases.push_back( std::make_pair( _currentPhases.back(), _timers.back().elapsed_ms() ) );
+
+    _currentPhases.pop_back();
+    _timers.pop_back();
+  }
+
+  template <class Matrix, class Index> void addition( const Matrix& M, Index /* source */, Index target )
+  {
+    _dimensions[ this->dimension( M, target ) ].additions += 1;
+  }
+
+  template <class Matrix, class Index> void clear( const Matrix& M, Index j )
+  {
+    _dimensions[ this->dimension( M, j ) ].cleared += 1;
+  }
+
+  template <class Matrix, class Index> void reduced( const Matrix& M, Index j )
+  {
+    auto&& statistics = _dimensions[ this->dimension( M, j ) ];
+    auto size         = M.getColumn( j ).size();
+
+    statistics.maxColumnSize    = std::max( statistics.maxColumnSize, size );
+    statistics.totalColumnSize += size;
+  }
+
+  // Queries -----------------------------------------------------------
+
+  /** @returns Statistics for all dimensions that have been encountered */
+  const std::map<std::size_t, DimensionStatistics>& dimensions() const noexcept
+  {
+    return _dimensions;
+  }
+
+  /** @returns Wall times of all phases, in the order in which they finished */
+  const std::vector<Phase>& phases() const noexcept
+  {
+    return _phases;
+  }
+
+  /** @returns Statistics accumulated over all dimensions */
+  DimensionStatistics total() const
+  {
+    DimensionStatistics result;
+
+    for( auto&& pair : _dimensions )
+    {
+      auto&& s = pair.second;
+
+      result.columns         += s.columns;
+      result.additions       += s.additions;
+      result.cleared         += s.cleared;
+      result.maxColumnSize    = std::max( result.maxColumnSize, s.maxColumnSize );
+      result.totalColumnSize += s.totalColumnSize;
+    }
+
+    return result;
+  }
+
+private:
+
+  /**
+    Determines the dimension of the simplex that corresponds to a given
+    column. For dualized matrices, the stored dimension is transformed
+    back so that statistics always refer to the original complex.
+  */
+
+  template <class Matrix, class Index> std::size_t dimension( const Matrix& M, Index j ) const
+  {
+    auto d = static_cast<std::size_t>( M.getDimension( j ) );
+    return M.isDualized() ? _maxDimension - d : d;
+  }
+
+  std::size_t _maxDimension = 0;
+
+  std::map<std::size_t, DimensionStatistics> _dimensions;
+  std::vector<Phase> _phases;
+
+  std::vector<std::string> _currentPhases;
+  std::vector<utilities::Timer> _timers;
+};
+
+/**
+  Writes statistics of a reduction to an output stream, using the JSON
+  format. Dimensions are stored as an array of objects, and phases are
+  stored in the order in which they finished.
+*/
+
+inline void writeJSON( std::ostream& o, const Statistics& statistics )
+{
+  std::string level = "  ";
+
+  auto writeDimensionStatistics = [&o] ( const Statistics::DimensionStatistics& s )
+  {
+    o << "\"columns\": "         << s.columns         << ", "
+      << "\"additions\": "       << s.additions       << ", "
+      << "\"cleared\": "         << s.cleared         << ", "
+      << "\"maxColumnSize\": "   << s.maxColumnSize   << ", "
+      << "\"totalColumnSize\": " << s.totalColumnSize;
+  };
+
+  o << "{\n";
+
+  o << level << "\"total\": { ";
+  writeDimensionStatistics( statistics.total() );
+  o << " },\n";
+
+  o << level << "\"dimensions\": [\n";
+
+  for( auto it = statistics.dimensions().begin(); it != statistics.dimensions().end(); ++it )
+  {
+    if( it != statistics.dimensions().begin() )
+      o << ",\n";
+
+    o << level << level << "{ \"dimension\": " << it->first << ", ";
+    writeDimensionStatistics( it->second );
+    o << " }";
+  }
+
+  o << "\n"
+    << level << "],\n";
+
+  o << level << "\"phases\": [\n";
+
+  for( auto it = statistics.phases().begin(); it != statistics.phases().end(); ++it )
+  {
+    if( it != statistics.phases().begin() )
+      o << ",\n";
+
+    o << level << level << "{ \"name\": \"" << it->first << "\", \"time_ms\": " << it->second << " }";
+  }
+
+  o << "\n"
+    << level << "]\n"
+    << "}";
+}
+
+} // namespace instrumentation
+
+} // namespace persistentHomology
+
+} // namespace aleph
+
+#endif
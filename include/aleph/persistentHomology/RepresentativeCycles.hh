@@ -0,0 +1,291 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_REPRESENTATIVE_CYCLES_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_REPRESENTATIVE_CYCLES_HH__
+
+#include <aleph/persistentHomology/Instrumentation.hh>
+#include <aleph/persistentHomology/PersistencePairing.hh>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace persistentHomology
+{
+
+/**
+  @class RepresentativeCycles
+  @brief Sparse container for representative cycles of a persistence pairing
+
+  Every representative cycle is stored as a sorted list of simplex
+  indices and identified by the index of the creator of its pair. Only
+  the cycles of features that have been deemed to be significant need
+  to be stored; all other pairs simply do not have a cycle.
+*/
+
+template <class Index> class RepresentativeCycles
+{
+public:
+  using Cycle         = std::vector<Index>;
+  using ContainerType = std::map<Index, Cycle>;
+  using ConstIterator = typename ContainerType::const_iterator;
+
+  ConstIterator begin() const { return _cycles.begin(); }
+  ConstIterator end()   const { return _cycles.end();   }
+
+  /** Stores the cycle of a given creator, replacing any previous cycle */
+  template <class InputIterator> void add( Index creator, InputIterator begin, InputIterator end )
+  {
+    Cycle cycle( begin, end );
+    std::sort( cycle.begin(), cycle.end() );
+
+    _cycles[creator] = std::move( cycle );
+  }
+
+  /** @returns true if a cycle has been stored for the given creator */
+  bool contains( Index creator ) const
+  {
+    return _cycles.find( creator ) != _cycles.end();
+  }
+
+  /**
+    @returns Cycle of the given creator. An empty cycle is returned if
+    no cycle has been stored for the creator.
+  */
+
+  Cycle get( Index creator ) const
+  {
+    auto it = _cycles.find( creator );
+    if( it != _cycles.end() )
+      return it->second;
+    else
+      return {};
+  }
+
+  std::size_t size() const noexcept
+  {
+    return _cycles.size();
+  }
+
+  bool empty() const noexcept
+  {
+    return _cycles.empty();
+  }
+
+private:
+  ContainerType _cycles;
+};
+
+/**
+  @class RepresentativeCycleTracking
+  @brief Policy for extracting representative cycles during a reduction
+
+  This policy uses the hooks that every reduction algorithm provides for
+  instrumentation purposes. It stores representative cycles only for
+  pairs whose persistence, measured in terms of the indices in the
+  filtration, is at least as large as a user-defined threshold.
+
+  For a pair that is destroyed by column \f$j\f$, the reduced column
+  \f$R_j\f$ is a cycle that is born at the creator of the pair. Hence,
+  such cycles are a by-product of the reduction and do not require any
+  additional bookkeeping: the reduced column is merely copied for all
+  significant pairs.
+
+  Only cycles of *essential* features, i.e. features that are never
+  destroyed, require the matrix \f$V\f$ of the decomposition \f$R =
+  DV\f$. Since this matrix may become dense, it is only tracked if
+  essential cycles are requested explicitly. Even then, it is tracked
+  sparsely: only columns that have been modified during the reduction
+  are stored, and the column of a creator is discarded as soon as its
+  pair is known, because it cannot describe an essential feature.
+
+  The policy requires a boundary matrix that has not been dualized,
+  because the reduction of a dualized matrix yields cocycles instead.
+*/
+
+template <class Index> class RepresentativeCycleTracking : public instrumentation::NoInstrumentation
+{
+public:
+
+  /**
+    Creates a new policy for tracking representative cycles.
+
+    @param threshold        Minimum persistence, i.e. the difference of
+                            the indices of destroyer and creator, of all
+                            pairs whose cycles should be stored.
+
+    @param includeEssential Flag indicating whether cycles of essential
+                            features should be stored as well. This
+                            requires tracking the matrix V, which may
+                            use a lot of memory.
+  */
+
+  explicit RepresentativeCycleTracking( Index threshold = Index(0), bool includeEssential = false )
+    : _threshold( threshold )
+    , _includeEssential( includeEssential )
+  {
+  }
+
+  // Hooks -------------------------------------------------------------
+
+  template <class Matrix> void initialize( const Matrix& M )
+  {
+    if( M.isDualized() )
+      throw std::runtime_error( "Representative cycles require a boundary matrix that has not been dualized" );
+  }
+
+  template <class Matrix> void addition( const Matrix& /* M */, Index source, Index target )
+  {
+    if( !_includeEssential )
+      return;
+
+    // Inserting the target first ensures that the reference to the source
+    // remains valid; unmodified columns only contain their own index.
+    auto it = _V.find( target );
+    if( it == _V.end() )
+      it = _V.emplace( target, Cycle( 1, target ) ).first;
+
+    auto&& t = it->second;
+
+    auto jt = _V.find( source );
+    if( jt != _V.end() )
+      symmetricDifference( t, jt->second );
+    else
+      symmetricDifference( t, Cycle( 1, source ) );
+  }
+
+  template <class Matrix> void clear( const Matrix& /* M */, Index j )
+  {
+    // Cleared columns are never used in any addition, and their pairs
+    // are known already, so they do not require a column of V.
+    _V.erase( j );
+  }
+
+  template <class Matrix> void reduced( const Matrix& M, Index j )
+  {
+    Index i;
+    bool valid;
+
+    std::tie( i, valid ) = M.getMaximumIndex( j );
+
+    if( !valid )
+      return;
+
+    // The creator of the pair is not essential, so its column of V will
+    // never be required.
+    if( _includeEssential )
+      _V.erase( i );
+
+    if( j - i < _threshold )
+      return;
+
+    auto column = M.getColumn( j );
+    _cycles.add( i, column.begin(), column.end() );
+  }
+
+  // Queries -----------------------------------------------------------
+
+  /**
+    Collects all representative cycles of significant pairs. Since the
+    policy itself cannot know which creators remain unpaired, this has
+    to be decided by the pairing that results from the reduction.
+
+    @param pairing Persistence pairing of the reduced matrix
+  */
+
+  RepresentativeCycles<Index> cycles( const PersistencePairing<Index>& pairing ) const
+  {
+    auto result = _cycles;
+
+    if( !_includeEssential )
+      return result;
+
+    for( auto&& pair : pairing )
+    {
+      if( pair.second != std::numeric_limits<Index>::max() )
+        continue;
+
+      auto column = this->column( pair.first );
+      result.add( pair.first, column.begin(), column.end() );
+    }
+
+    return result;
+  }
+
+private:
+  using Cycle = typename RepresentativeCycles<Index>::Cycle;
+
+  /** @returns Column of V; unmodified columns are not stored */
+  Cycle column( Index j ) const
+  {
+    auto it = _V.find( j );
+    if( it != _V.end() )
+      return it->second;
+    else
+      return { j };
+  }
+
+  /**
+    Replaces a sorted column by its symmetric difference with another
+    sorted column, i.e. their sum over \f$\mathbb{Z}_2\f$. The columns
+    are merged backwards into the free space at the end of the target,
+    so no additional column is allocated.
+  */
+
+  static void symmetricDifference( Cycle& target, const Cycle& source )
+  {
+    auto m = target.size();
+    auto n = source.size();
+
+    target.resize( m + n );
+
+    // Positions are offset by one so that they remain unsigned
+    auto a = m;
+    auto b = n;
+    auto w = m + n;
+
+    while( a > 0 && b > 0 )
+    {
+      if( target[a-1] == source[b-1] )
+      {
+        --a;
+        --b;
+      }
+      else if( target[a-1] > source[b-1] )
+        target[--w] = target[--a];
+      else
+        target[--w] = source[--b];
+    }
+
+    // Remaining entries of the target are already in place, so only the
+    // source has to be copied.
+    while( b > 0 )
+      target[--w] = source[--b];
+
+    if( a != w )
+      std::move( target.begin() + static_cast<std::ptrdiff_t>( w ), target.end(), target.begin() + static_cast<std::ptrdiff_t>( a ) );
+
+    target.resize( a + ( m + n - w ) );
+  }
+
+  Index _threshold;
+  bool _includeEssential;
+
+  /** Columns of V that have been modified during the reduction */
+  std::unordered_map<Index, Cycle> _V;
+
+  /** Cycles of all significant pairs */
+  RepresentativeCycles<Index> _cycles;
+};
+
+} // namespace persistentHomology
+
+} // namespace aleph
+
+#endif
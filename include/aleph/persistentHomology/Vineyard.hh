@@ -0,0 +1,473 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_VINEYARD_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_VINEYARD_HH__
+
+#include <aleph/config/Defaults.hh>
+
+#include <aleph/persistentHomology/PersistencePairing.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+
+#include <aleph/utilities/EmptyFunctor.hh>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+/**
+  @class Vineyard
+  @brief Maintains a persistence pairing under changes of the filtration order
+
+  This class implements the vineyard algorithm by Cohen-Steiner et al.
+  for updating a persistence pairing when the order of the filtration
+  changes. It keeps a decomposition \f$R = DV\f$ of the boundary matrix
+  \f$D\f$, where \f$R\f$ is reduced and \f$V\f$ is upper triangular. A
+  transposition of two adjacent simplices only requires a constant
+  number of column operations on this decomposition. This makes it
+  possible to follow time-varying data, e.g. a function on a complex
+  that is sampled at several time steps, without having to reduce a
+  new boundary matrix for every time step.
+
+  Internally, every simplex is identified by the index of its column
+  in the *original* boundary matrix. These identifiers remain stable
+  under all transpositions; they are used by all functions that need
+  to refer to a simplex, whereas positions refer to the current order
+  of the filtration.
+
+  @tparam Representation Representation of the boundary matrix that is
+                         used to initialize the vineyard. All columns
+                         are copied, so the representation only needs
+                         to support column queries.
+*/
+
+template <class Representation = defaults::Representation> class Vineyard
+{
+public:
+  using Index  = typename Representation::Index;
+  using Matrix = topology::BoundaryMatrix<Representation>;
+
+  /**
+    Creates a new vineyard from a boundary matrix in filtration order
+    and calculates its initial decomposition. The matrix must not have
+    been dualized.
+  */
+
+  explicit Vineyard( const Matrix& M )
+  {
+    if( M.isDualized() )
+      throw std::runtime_error( "Vineyard updates require a boundary matrix that has not been dualized" );
+
+    auto n = static_cast<std::size_t>( M.getNumColumns() );
+
+    _D.resize( n );
+    _V.resize( n );
+    _dimensions.resize( n );
+    _order.resize( n );
+    _positions.resize( n );
+    _lows.resize( n, none() );
+    _pivots.resize( n, none() );
+
+    for( std::size_t j = 0; j < n; j++ )
+    {
+      _D[j]          = M.getColumn( static_cast<Index>( j ) );
+      _V[j]          = { static_cast<Index>( j ) };
+      _dimensions[j] = M.getDimension( static_cast<Index>( j ) );
+      _order[j]      = static_cast<Index>( j );
+      _positions[j]  = static_cast<Index>( j );
+
+      // Identifiers and positions coincide at the beginning, so the
+      // columns are already sorted correctly.
+      std::sort( _D[j].begin(), _D[j].end() );
+    }
+
+    _R = _D;
+
+    this->reduce();
+  }
+
+  /** @returns Number of simplices in the filtration */
+  Index size() const noexcept
+  {
+    return static_cast<Index>( _order.size() );
+  }
+
+  /**
+    @returns Current filtration order, i.e. the identifiers of all
+    simplices, sorted by their position in the filtration
+  */
+
+  const std::vector<Index>& order() const noexcept
+  {
+    return _order;
+  }
+
+  /** @returns Current position of a simplex in the filtration */
+  Index position( Index simplex ) const
+  {
+    return _positions.at( static_cast<std::size_t>( simplex ) );
+  }
+
+  /**
+    Exchanges the simplices at positions \p i and \p i + 1 of the
+    current filtration and updates the decomposition. The simplex at
+    position \p i must not be a face of the simplex at position \p i
+    + 1, as this would result in an invalid filtration.
+
+    @param i Position of the first simplex to exchange
+
+    @returns true if the transposition changed the pairing, i.e. if
+    the two simplices exchanged their partners in the pairing. Else,
+    the partners of all simplices remain the same and only their
+    positions change.
+  */
+
+  bool transpose( Index i )
+  {
+    if( static_cast<std::size_t>( i ) + 1 >= _order.size() )
+      throw std::out_of_range( "Position of transposition is out of bounds" );
+
+    auto a = _order[ static_cast<std::size_t>( i ) ];
+    auto b = _order[ static_cast<std::size_t>( i ) + 1 ];
+
+    if( contains( _D[b], a ) )
+      throw std::runtime_error( "Unable to exchange a simplex with one of its cofaces" );
+
+    // Only these columns may change their lowest one: the two columns
+    // that are exchanged, as well as the two columns that are paired
+    // with the corresponding rows.
+    auto k = _pivots[a];
+    auto l = _pivots[b];
+
+    std::vector<Index> affected = { a, b };
+
+    if( k != none() )
+      affected.push_back( k );
+
+    if( l != none() )
+      affected.push_back( l );
+
+    std::vector<Index> previousLows;
+    previousLows.reserve( affected.size() );
+
+    for( auto&& c : affected )
+    {
+      previousLows.push_back( _lows[c] );
+
+      if( _lows[c] != none() )
+        _pivots[ _lows[c] ] = none();
+    }
+
+    bool positiveA = _R[a].empty();
+    bool positiveB = _R[b].empty();
+
+    // The entry in row i of column i + 1 of V would violate the upper
+    // triangular structure of V after the transposition. All cases
+    // below remove it, followed by additional column operations that
+    // restore the reduced structure of R if required.
+    bool upper = contains( _V[b], a );
+
+    // Both simplices are positive: the entry in V may be removed
+    // without affecting R. If the rows are paired with columns that
+    // both contain the rows, the pairing might switch.
+    if( positiveA && positiveB )
+    {
+      if( upper )
+        this->add( a, b );
+
+      bool paired = k != none() && l != none() && contains( _R[l], a );
+
+      this->swap( i );
+
+      if( paired )
+      {
+        if( _positions[k] < _positions[l] )
+          this->add( k, l );
+        else
+          this->add( l, k );
+      }
+    }
+
+    // Both simplices are negative: if the lowest one of the first
+    // column is higher up, the addition needs to be undone after the
+    // transposition, resulting in a switch.
+    else if( !positiveA && !positiveB )
+    {
+      if( upper )
+      {
+        bool keep = _positions[ _lows[a] ] < _positions[ _lows[b] ];
+
+        this->add( a, b );
+        this->swap( i );
+
+        if( !keep )
+          this->add( b, a );
+      }
+      else
+        this->swap( i );
+    }
+
+    // The first simplex is negative, the second one is positive: both
+    // simplices exchange their roles.
+    else if( !positiveA && positiveB )
+    {
+      if( upper )
+      {
+        this->add( a, b );
+        this->swap( i );
+        this->add( b, a );
+      }
+      else
+        this->swap( i );
+    }
+
+    // The first simplex is positive, the second one is negative: the
+    // entry in V may be removed without affecting R.
+    else
+    {
+      if( upper )
+        this->add( a, b );
+
+      this->swap( i );
+    }
+
+    bool switched = false;
+
+    for( std::size_t index = 0; index < affected.size(); index++ )
+    {
+      auto c = affected[index];
+
+      _lows[c] = this->low( c );
+
+      if( _lows[c] != none() )
+        _pivots[ _lows[c] ] = c;
+
+      switched = switched || _lows[c] != previousLows[index];
+    }
+
+    return switched;
+  }
+
+  /**
+    Updates the filtration to a new order by performing a sequence of
+    transpositions. The number of transpositions is the number of
+    pairs of simplices whose order differs between both filtrations,
+    so the update is fast for small changes. Each transposition is
+    reported to a functor, which is called with the identifiers of
+    the two simplices, in their order *prior* to the transposition,
+    and a flag that indicates whether the pairing changed.
+
+    @param order   Identifiers of all simplices in their new order. This
+                   must be a valid filtration order, i.e. every simplex
+                   has to appear after all of its faces.
+
+    @param functor Functor for reporting transpositions
+  */
+
+  template <class Functor> void update( const std::vector<Index>& order, Functor&& functor )
+  {
+    if( order.size() != _order.size() )
+      throw std::runtime_error( "Number of simplices does not match" );
+
+    auto n = order.size();
+
+    std::vector<Index> ranks( n, none() );
+
+    for( std::size_t p = 0; p < n; p++ )
+    {
+      auto&& simplex = order[p];
+
+      if( static_cast<std::size_t>( simplex ) >= n || ranks[simplex] != none() )
+        throw std::runtime_error( "Order is not a permutation of all simplices" );
+
+      ranks[simplex] = static_cast<Index>( p );
+    }
+
+    // Insertion sort with respect to the new ranks. This only ever
+    // exchanges adjacent simplices whose order is inverted, and both
+    // filtrations agree on the order of faces and cofaces.
+    for( std::size_t p = 1; p < n; p++ )
+    {
+      for( std::size_t q = p; q > 0 && ranks[ _order[q-1] ] > ranks[ _order[q] ]; q-- )
+      {
+        auto sigma    = _order[q-1];
+        auto tau      = _order[q];
+        auto switched = this->transpose( static_cast<Index>( q-1 ) );
+
+        functor( sigma, tau, switched );
+      }
+    }
+  }
+
+  /** @overload update() */
+  void update( const std::vector<Index>& order )
+  {
+    this->update( order, utilities::EmptyFunctor() );
+  }
+
+  /**
+    Reads off the persistence pairing of the current filtration. All
+    indices refer to *positions* in the current filtration, so the
+    pairing is equivalent to the one that is calculated for the
+    permuted boundary matrix.
+
+    @param includeAllUnpairedCreators Flag indicating whether unpaired
+                                      creators of the highest dimension
+                                      should be included; please refer
+                                      to calculatePersistencePairing()
+                                      for more details.
+  */
+
+  PersistencePairing<Index> pairing( bool includeAllUnpairedCreators = false ) const
+  {
+    PersistencePairing<Index> pairing;
+
+    Index maxDimension = _dimensions.empty() ? Index(0) : *std::max_element( _dimensions.begin(), _dimensions.end() );
+
+    for( std::size_t p = 0; p < _order.size(); p++ )
+    {
+      auto&& simplex = _order[p];
+
+      if( _lows[simplex] != none() )
+        pairing.add( _positions[ _lows[simplex] ], static_cast<Index>( p ) );
+      else if( _pivots[simplex] == none() && ( _dimensions[simplex] != maxDimension || includeAllUnpairedCreators ) )
+        pairing.add( static_cast<Index>( p ) );
+    }
+
+    std::sort( pairing.begin(), pairing.end() );
+    return pairing;
+  }
+
+  /** @returns Boundary matrix of the current filtration */
+  Matrix boundaryMatrix() const
+  {
+    Matrix M;
+    M.setNumColumns( this->size() );
+
+    std::vector<Index> column;
+
+    for( std::size_t p = 0; p < _order.size(); p++ )
+    {
+      auto&& simplex = _order[p];
+
+      column.clear();
+
+      for( auto&& face : _D[simplex] )
+        column.push_back( _positions[face] );
+
+      M.setColumn( static_cast<Index>( p ), column.begin(), column.end() );
+      M.setDimension( static_cast<Index>( p ), _dimensions[simplex] );
+    }
+
+    return M;
+  }
+
+private:
+
+  /** @returns Sentinel value for columns without a lowest one */
+  static constexpr Index none() noexcept
+  {
+    return std::numeric_limits<Index>::max();
+  }
+
+  /** Checks whether a column, sorted by identifiers, contains a value */
+  static bool contains( const std::vector<Index>& column, Index value )
+  {
+    return std::binary_search( column.begin(), column.end(), value );
+  }
+
+  /** Calculates the lowest one of a column with respect to the current order */
+  Index low( Index column ) const
+  {
+    Index result = none();
+
+    for( auto&& row : _R[column] )
+    {
+      if( result == none() || _positions[row] > _positions[result] )
+        result = row;
+    }
+
+    return result;
+  }
+
+  /**
+    Adds the source column to the target column in both R and V. As
+    all columns are sorted by identifiers, whose order never changes,
+    this only requires merging both columns.
+  */
+
+  void add( Index source, Index target )
+  {
+    auto symmetricDifference = [this] ( const std::vector<Index>& s, std::vector<Index>& t )
+    {
+      _buffer.clear();
+
+      std::set_symmetric_difference( s.begin(), s.end(),
+                                     t.begin(), t.end(),
+                                     std::back_inserter( _buffer ) );
+
+      t.swap( _buffer );
+    };
+
+    symmetricDifference( _R[source], _R[target] );
+    symmetricDifference( _V[source], _V[target] );
+  }
+
+  /** Exchanges the simplices at positions i and i + 1 */
+  void swap( Index i )
+  {
+    auto p = static_cast<std::size_t>( i );
+
+    std::swap( _order[p], _order[p+1] );
+
+    _positions[ _order[p]   ] = static_cast<Index>( p );
+    _positions[ _order[p+1] ] = static_cast<Index>( p+1 );
+  }
+
+  /** Calculates the initial decomposition using the standard algorithm */
+  void reduce()
+  {
+    for( std::size_t j = 0; j < _R.size(); j++ )
+    {
+      auto column = static_cast<Index>( j );
+      auto l      = this->low( column );
+
+      while( l != none() && _pivots[l] != none() )
+      {
+        this->add( _pivots[l], column );
+        l = this->low( column );
+      }
+
+      _lows[j] = l;
+
+      if( l != none() )
+        _pivots[l] = column;
+    }
+  }
+
+  /** Boundary matrix; columns are indexed and sorted by identifiers */
+  std::vector< std::vector<Index> > _D;
+
+  /** Reduced boundary matrix; columns are indexed and sorted by identifiers */
+  std::vector< std::vector<Index> > _R;
+
+  /** Upper triangular matrix with R = DV; columns are indexed and sorted by identifiers */
+  std::vector< std::vector<Index> > _V;
+
+  std::vector<Index> _dimensions; ///< Dimension of every simplex
+  std::vector<Index> _order;      ///< Identifiers of simplices in filtration order
+  std::vector<Index> _positions;  ///< Position of every simplex in the filtration
+  std::vector<Index> _lows;       ///< Lowest one of every column of R
+  std::vector<Index> _pivots;     ///< Column whose lowest one is in a given row
+
+  /** Scratch buffer for column additions; re-used to avoid allocations */
+  std::vector<Index> _buffer;
+};
+
+} // namespace aleph
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_STANDARD_HH__
 #define ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_STANDARD_HH__
 
+#include <aleph/persistentHomology/Instrumentation.hh>
+
 #include <aleph/topology/BoundaryMatrix.hh>
 
 #include <tuple>
@@ -18,10 +20,15 @@ namespace algorithms
 class Standard
 {
 public:
-  template <class Representation> void operator()( topology::BoundaryMatrix<Representation>& M )
+  template <
+    class Representation,
+    class Instrumentation = instrumentation::NoInstrumentation
+  > void operator()( topology::BoundaryMatrix<Representation>& M, Instrumentation&& instrumentation = Instrumentation() )
   {
     using Index = typename Representation::Index;
 
+    instrumentation.initialize( M );
+
     auto numColumns = M.getNumColumns();
 
     std::vector< std::pair<Index, bool> > lut( static_cast<std::size_t>( numColumns ),
@@ -36,11 +43,15 @@ public:
       while( valid && lut[ static_cast<std::size_t>(i) ].second )
       {
         M.addColumns( lut[ static_cast<std::size_t>(i) ].first, j );
+        instrumentation.addition( M, lut[ static_cast<std::size_t>(i) ].first, j );
+
         std::tie( i, valid ) = M.getMaximumIndex( j );
       }
 
       if( valid )
         lut[ static_cast<std::size_t>(i) ] = std::make_pair( j, true );
+
+      instrumentation.reduced( M, j );
     }
   }
 };
@@ -48,10 +59,15 @@ public:
 class StandardRectangular
 {
 public:
-  template <class Representation> void operator()( topology::BoundaryMatrix<Representation>& M )
+  template <
+    class Representation,
+    class Instrumentation = instrumentation::NoInstrumentation
+  > void operator()( topology::BoundaryMatrix<Representation>& M, Instrumentation&& instrumentation = Instrumentation() )
   {
     using Index = typename Representation::Index;
 
+    instrumentation.initialize( M );
+
     auto numColumns = M.getNumColumns();
 
     std::vector< std::pair<Index, bool> > lut( static_cast<std::size_t>( numColumns ),
@@ -70,11 +86,15 @@ public:
       while( valid && lut[ static_cast<std::size_t>(i) ].second )
       {
         M.addColumns( lut[ static_cast<std::size_t>(i) ].first, j );
+        instrumentation.addition( M, lut[ static_cast<std::size_t>(i) ].first, j );
+
         std::tie( i, valid ) = M.getMaximumIndex( j );
       }
 
       if( valid )
         lut[ static_cast<std::size_t>(i) ] = std::make_pair( j, true );
+
+      instrumentation.reduced( M, j );
     }
   }
 };
@@ -1,6 +1,8 @@
 #ifndef ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_TWIST_HH__
 #define ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_TWIST_HH__
 
+#include <aleph/persistentHomology/Instrumentation.hh>
+
 #include <aleph/topology/BoundaryMatrix.hh>
 
 #include <tuple>
@@ -18,10 +20,15 @@ namespace algorithms
 class Twist
 {
 public:
-  template <class Representation> void operator()( topology::BoundaryMatrix<Representation>& M )
+  template <
+    class Representation,
+    class Instrumentation = instrumentation::NoInstrumentation
+  > void operator()( topology::BoundaryMatrix<Representation>& M, Instrumentation&& instrumentation = Instrumentation() )
   {
     using Index = typename Representation::Index;
 
+    instrumentation.initialize( M );
+
     auto dimension  = M.getDimension();
     auto numColumns = M.getNumColumns();
 
@@ -41,6 +48,8 @@ public:
           while( valid && lut[ std::size_t(i) ].second )
           {
             M.addColumns( lut[ std::size_t(i) ].first, j );
+            instrumentation.addition( M, lut[ std::size_t(i) ].first, j );
+
             std::tie( i, valid ) = M.getMaximumIndex( j );
           }
 
@@ -48,7 +57,11 @@ public:
           {
             lut[ std::size_t(i) ] = std::make_pair( j, true );
             M.clearColumn( i );
+
+            instrumentation.clear( M, i );
           }
+
+          instrumentation.reduced( M, j );
         }
       }
     }
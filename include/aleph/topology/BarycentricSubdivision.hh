@@ -155,9 +155,9 @@ public:
         // the current simplex.
         std::vector<Simplex> subdividedBoundary;
 
-        for( auto itBoundary = s.begin_boundary(); itBoundary != s.end_boundary(); ++itBoundary )
+        for( std::size_t i = 0; i < s.boundarySize(); i++ )
         {
-          auto pos = K.find( *itBoundary );
+          auto pos = K.find( s.face( i ) );
 
           if( pos == K.end() )
             throw std::runtime_error( "Unable to find boundary simplex" );
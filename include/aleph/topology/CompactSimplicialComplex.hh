@@ -0,0 +1,711 @@
+#ifndef ALEPH_TOPOLOGY_COMPACT_SIMPLICIAL_COMPLEX_HH__
+#define ALEPH_TOPOLOGY_COMPACT_SIMPLICIAL_COMPLEX_HH__
+
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/utilities/ParallelSort.hh>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+/**
+  @class CompactSimplicialComplex
+  @brief Immutable simplicial complex with a compact memory layout
+
+  This class stores a filtered simplicial complex using a number of flat
+  arrays instead of individual simplices. It is meant for pipelines that
+  only traverse a complex in filtration order and look up faces, e.g. the
+  calculation of persistent homology, but never modify the complex after
+  it has been built.
+
+  The vertices of all simplices are stored in a single contiguous array.
+  This array is partitioned by dimension, such that all simplices of the
+  same dimension are adjacent and have the same number of vertices. In
+  each partition, simplices are sorted lexicographically, which permits
+  finding faces by a binary search. The weights of all simplices, as well
+  as the mapping from and to the filtration order, are stored in arrays
+  that run parallel to the vertex array.
+
+  In contrast to a SimplicialComplex, this does not require any memory
+  allocations per simplex or any nodes of an index structure. Depending
+  on the dimension of the complex and the types used, this results in a
+  memory footprint that is between three and five times smaller.
+
+  The arrays are immutable and shared between copies of the complex. They
+  may also refer to external storage, e.g. a file that has been mapped
+  into memory by io::BinaryReader, in which case loading a complex does
+  not copy any simplices.
+
+  Since the complex does not store simplices, its iterators yield views
+  of simplices instead. These views provide the same interface as simple
+  simplices for traversing vertices and faces, so the complex can be used
+  with makeBoundaryMatrix() and makePersistenceDiagrams().
+
+  @tparam Simplex Simplex type of the original simplicial complex
+  @tparam Weight  Type used for storing weights; this may differ from the
+                  data type of the simplex, e.g. in order to store weights
+                  with single precision.
+  @tparam Index   Type used for indexing simplices; this limits the number
+                  of simplices that may be stored.
+*/
+
+template <
+  class Simplex,
+  class Weight = typename Simplex::DataType,
+  class Index  = std::uint32_t
+> class CompactSimplicialComplex
+{
+public:
+  using simplex_type = Simplex;
+  using VertexType   = typename Simplex::VertexType;
+
+  class simplex_view;
+  class face_view;
+  class const_iterator;
+
+  // STL-like typedefs -------------------------------------------------
+
+  using value_type = simplex_view;
+  using ValueType  = value_type;
+  using iterator   = const_iterator;
+
+  // Constructors ------------------------------------------------------
+
+  /** Creates an empty simplicial complex */
+  CompactSimplicialComplex()
+    : _vertices( nullptr )
+    , _weights( nullptr )
+    , _order( nullptr )
+    , _positions( nullptr )
+    , _vertexOffsets( 1, 0 )
+    , _slotOffsets( 1, 0 )
+  {
+  }
+
+  /**
+    Creates a compact simplicial complex that refers to external storage,
+    which has to use the memory layout described above: the simplices of
+    every dimension occupy consecutive slots, sorted lexicographically,
+    and all arrays but the slot offsets are only referenced. The arrays
+    are neither copied nor checked.
+
+    @param slotOffsets Offsets of all dimensions in terms of slots; the
+                       first offset is zero and the last one is the total
+                       number of simplices
+    @param vertices    Vertices of all simplices, partitioned by dimension
+    @param weights     Weights of all simplices, indexed by slot
+    @param order       Maps indices in the filtration order to slots
+    @param positions   Maps slots to indices in the filtration order
+    @param storage     Owner of the arrays; it is kept alive for as long
+                       as any copy of the complex exists
+
+    @throws std::runtime_error if the slot offsets are invalid
+  */
+
+  CompactSimplicialComplex( std::vector<std::size_t> slotOffsets,
+                            const VertexType* vertices,
+                            const Weight* weights,
+                            const Index* order,
+                            const Index* positions,
+                            std::shared_ptr<const void> storage )
+    : _vertices( vertices )
+    , _weights( weights )
+    , _order( order )
+    , _positions( positions )
+    , _vertexOffsets( 1, 0 )
+    , _slotOffsets( std::move( slotOffsets ) )
+    , _storage( std::move( storage ) )
+  {
+    if( _slotOffsets.empty() || _slotOffsets.front() != 0 || !std::is_sorted( _slotOffsets.begin(), _slotOffsets.end() ) )
+      throw std::runtime_error( "Invalid slot offsets for compact simplicial complex" );
+
+    // An empty complex does not have any partitions
+    if( _slotOffsets.back() == 0 )
+      _slotOffsets.resize( 1 );
+
+    for( std::size_t d = 0; d + 1 < _slotOffsets.size(); d++ )
+      _vertexOffsets.push_back( _vertexOffsets.back() + ( _slotOffsets[d+1] - _slotOffsets[d] ) * ( d + 1 ) );
+  }
+
+  /**
+    Creates a compact simplicial complex from a simplicial complex. The
+    order of the simplices in the original complex is preserved, so the
+    filtration does not have to be applied again.
+
+    @param K Simplicial complex to convert
+
+    @throws std::runtime_error if the complex contains too many simplices
+    for the chosen index type
+  */
+
+  explicit CompactSimplicialComplex( const SimplicialComplex<Simplex>& K )
+    : CompactSimplicialComplex()
+  {
+    if( K.size() > static_cast<std::size_t>( std::numeric_limits<Index>::max() ) )
+      throw std::runtime_error( "Simplicial complex is too large for index type" );
+
+    if( K.empty() )
+      return;
+
+    auto D       = K.dimension();
+    auto storage = std::make_shared<Storage>();
+
+    // Assign simplices to partitions according to their dimension. This
+    // does not change their relative order.
+    std::vector< std::vector<Index> > partitions( D + 1 );
+
+    for( std::size_t i = 0; i < K.size(); i++ )
+      partitions.at( K.at(i).dimension() ).push_back( static_cast<Index>( i ) );
+
+    _vertexOffsets.reserve( D + 2 );
+    _slotOffsets.reserve( D + 2 );
+
+    for( std::size_t d = 0; d <= D; d++ )
+    {
+      auto n = partitions[d].size();
+
+      _vertexOffsets.push_back( _vertexOffsets.back() + n * ( d + 1 ) );
+      _slotOffsets.push_back( _slotOffsets.back() + n );
+    }
+
+    storage->vertices.resize( _vertexOffsets.back() );
+    storage->weights.resize( K.size() );
+    storage->order.resize( K.size() );
+    storage->positions.resize( K.size() );
+
+    for( std::size_t d = 0; d <= D; d++ )
+    {
+      auto&& partition = partitions[d];
+
+      aleph::utilities::parallelSort( partition.begin(), partition.end(),
+        [&K] ( Index i, Index j )
+        {
+          return K.at(i) < K.at(j);
+        }
+      );
+
+      for( std::size_t k = 0; k < partition.size(); k++ )
+      {
+        auto&& simplex = K.at( partition[k] );
+        auto slot      = _slotOffsets[d] + k;
+
+        std::copy( simplex.begin(), simplex.end(),
+                   storage->vertices.begin() + static_cast<std::ptrdiff_t>( _vertexOffsets[d] + k * ( d + 1 ) ) );
+
+        storage->weights[slot]         = static_cast<Weight>( simplex.data() );
+        storage->order[ partition[k] ] = static_cast<Index>( slot );
+        storage->positions[slot]       = partition[k];
+      }
+    }
+
+    _vertices  = storage->vertices.data();
+    _weights   = storage->weights.data();
+    _order     = storage->order.data();
+    _positions = storage->positions.data();
+    _storage   = storage;
+  }
+
+  // Simplex access ----------------------------------------------------
+
+  const_iterator begin() const
+  {
+    return const_iterator( this, 0 );
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator( this, this->size() );
+  }
+
+  /**
+    @returns View of the simplex at the given position of the filtration
+    @throws std::out_of_range if the index is out of range
+  */
+
+  simplex_view at( std::size_t index ) const
+  {
+    if( index >= this->size() )
+      throw std::out_of_range( "Simplex index is out of range" );
+
+    return this->view( _order[index] );
+  }
+
+  /** @overload at() */
+  simplex_view operator[]( std::size_t index ) const
+  {
+    return this->view( _order[index] );
+  }
+
+  // Queries -----------------------------------------------------------
+
+  /**
+    Checks whether a simplex is contained in the simplicial complex. The
+    simplex may be represented by any type that permits iterating over
+    its vertices in the order used by the Simplex class, e.g. a simplex,
+    a simplex view, or a face view.
+  */
+
+  template <class T> bool contains( const T& simplex ) const
+  {
+    return this->slot( simplex ) != none();
+  }
+
+  /**
+    @returns Index of a simplex in the filtration order
+    @throws std::runtime_error if the simplex does not exist
+  */
+
+  template <class T> std::size_t index( const T& simplex ) const
+  {
+    auto s = this->slot( simplex );
+
+    if( s != none() )
+      return static_cast<std::size_t>( _positions[s] );
+    else
+      throw std::runtime_error( "Queried simplex does not exist" );
+  }
+
+  /** @returns Number of simplices in the simplicial complex */
+  std::size_t size() const
+  {
+    return _slotOffsets.back();
+  }
+
+  /** @returns Number of simplices of a given dimension */
+  std::size_t size( std::size_t dimension ) const
+  {
+    if( dimension + 1 >= _slotOffsets.size() )
+      return 0;
+
+    return _slotOffsets[dimension+1] - _slotOffsets[dimension];
+  }
+
+  /** @returns true if the simplicial complex is empty */
+  bool empty() const
+  {
+    return this->size() == 0;
+  }
+
+  /**
+    @returns Dimension of the simplicial complex, i.e. the maximum
+    dimension of its simplices
+
+    @throws std::runtime_error if the simplicial complex is empty
+  */
+
+  std::size_t dimension() const
+  {
+    if( !this->empty() )
+      return _slotOffsets.size() - 2;
+    else
+      throw std::runtime_error( "Unable to query dimensionality of empty simplicial complex" );
+  }
+
+  /** Converts the compact simplicial complex back into a simplicial complex */
+  SimplicialComplex<Simplex> toSimplicialComplex() const
+  {
+    using SimplexData = typename Simplex::DataType;
+
+    std::vector<Simplex> simplices;
+    simplices.reserve( this->size() );
+
+    for( auto&& s : *this )
+      simplices.push_back( Simplex( s.begin(), s.end(), static_cast<SimplexData>( s.data() ) ) );
+
+    return SimplicialComplex<Simplex>( simplices.begin(), simplices.end() );
+  }
+
+  // Raw storage -------------------------------------------------------
+  //
+  // These functions expose the arrays of the complex, which is required
+  // for storing it in a binary format. The layout is described above.
+
+  /** @returns Offsets of all dimensions in terms of slots */
+  const std::vector<std::size_t>& slotOffsets() const noexcept
+  {
+    return _slotOffsets;
+  }
+
+  /** @returns Vertices of all simplices, partitioned by dimension */
+  const VertexType* vertexData() const noexcept
+  {
+    return _vertices;
+  }
+
+  /** @returns Weights of all simplices, indexed by slot */
+  const Weight* weightData() const noexcept
+  {
+    return _weights;
+  }
+
+  /** @returns Map from indices in the filtration order to slots */
+  const Index* orderData() const noexcept
+  {
+    return _order;
+  }
+
+  /** @returns Map from slots to indices in the filtration order */
+  const Index* positionData() const noexcept
+  {
+    return _positions;
+  }
+
+private:
+
+  /** Arrays of a complex that has been created from a simplicial complex */
+  struct Storage
+  {
+    std::vector<VertexType> vertices;
+    std::vector<Weight>     weights;
+    std::vector<Index>      order;
+    std::vector<Index>      positions;
+  };
+
+  /** Sentinel value for a slot that does not exist */
+  static constexpr std::size_t none()
+  {
+    return std::numeric_limits<std::size_t>::max();
+  }
+
+  /** @returns Dimension of a given slot */
+  std::size_t dimension( std::size_t slot ) const
+  {
+    auto it = std::upper_bound( _slotOffsets.begin(), _slotOffsets.end(), slot );
+    return static_cast<std::size_t>( std::distance( _slotOffsets.begin(), it ) ) - 1;
+  }
+
+  /** @returns Pointer to first vertex of a given slot */
+  const VertexType* vertices( std::size_t slot, std::size_t dimension ) const
+  {
+    return _vertices + _vertexOffsets[dimension] + ( slot - _slotOffsets[dimension] ) * ( dimension + 1 );
+  }
+
+  simplex_view view( std::size_t slot ) const
+  {
+    auto d = this->dimension( slot );
+    return simplex_view( this->vertices( slot, d ), d + 1, _weights[slot] );
+  }
+
+  /**
+    Finds the slot of a given simplex by searching the partition of the
+    corresponding dimension. Every simplex of the partition is described
+    by the same number of vertices, so the search needs no indirection.
+
+    @returns Slot of the simplex or none() if it does not exist
+  */
+
+  template <class T> std::size_t slot( const T& simplex ) const
+  {
+    auto k = static_cast<std::size_t>( std::distance( simplex.begin(), simplex.end() ) );
+
+    if( k == 0 || k >= _slotOffsets.size() )
+      return none();
+
+    auto d     = k - 1;
+    auto first = _slotOffsets[d];
+    auto last  = _slotOffsets[d+1];
+
+    while( first < last )
+    {
+      auto middle   = first + ( last - first ) / 2;
+      auto vertices = this->vertices( middle, d );
+
+      if( std::lexicographical_compare( vertices, vertices + k, simplex.begin(), simplex.end() ) )
+        first = middle + 1;
+      else
+        last = middle;
+    }
+
+    if( first < _slotOffsets[d+1] )
+    {
+      auto vertices = this->vertices( first, d );
+
+      if( std::equal( vertices, vertices + k, simplex.begin() ) )
+        return first;
+    }
+
+    return none();
+  }
+
+  /** Vertices of all simplices, partitioned by dimension */
+  const VertexType* _vertices;
+
+  /** Weights of all simplices, indexed by slot */
+  const Weight* _weights;
+
+  /** Maps indices in the filtration order to slots */
+  const Index* _order;
+
+  /** Maps slots to indices in the filtration order */
+  const Index* _positions;
+
+  /** Offsets of the partitions in the vertex array */
+  std::vector<std::size_t> _vertexOffsets;
+
+  /** Offsets of the partitions in terms of slots */
+  std::vector<std::size_t> _slotOffsets;
+
+  /** Owner of the arrays, which are shared between all copies */
+  std::shared_ptr<const void> _storage;
+};
+
+// ---------------------------------------------------------------------
+
+/**
+  @class simplex_view
+  @brief Lightweight view of a simplex stored in a compact complex
+
+  The view provides the parts of the interface of a simplex that are
+  required for traversing the complex, i.e. access to its vertices, its
+  weight, and its faces. It remains valid for as long as the complex
+  it belongs to.
+*/
+
+template <class Simplex, class Weight, class Index>
+class CompactSimplicialComplex<Simplex, Weight, Index>::simplex_view
+{
+public:
+  using DataType       = Weight;
+  using VertexType     = typename Simplex::VertexType;
+  using const_iterator = const VertexType*;
+
+  simplex_view( const VertexType* vertices, std::size_t size, Weight data )
+    : _vertices( vertices )
+    , _size( size )
+    , _data( data )
+  {
+  }
+
+  const_iterator begin() const { return _vertices;         }
+  const_iterator end()   const { return _vertices + _size; }
+
+  std::size_t size()      const { return _size;     }
+  std::size_t dimension() const { return _size - 1; }
+  bool empty()            const { return _size == 0; }
+
+  Weight data() const { return _data; }
+
+  VertexType operator[]( std::size_t index ) const
+  {
+    return _vertices[index];
+  }
+
+  /** @returns Number of faces in the boundary of the simplex */
+  std::size_t boundarySize() const
+  {
+    return _size > 1 ? _size : 0;
+  }
+
+  /**
+    @returns View of the face that is obtained by omitting the vertex with
+    the given index. Faces are enumerated in the same order as for simple
+    simplices.
+
+    @throws std::out_of_range if the index is out of range
+  */
+
+  face_view face( std::size_t i ) const
+  {
+    if( i >= _size )
+      throw std::out_of_range( "Face index is out of range" );
+
+    return face_view( _vertices, _size, i );
+  }
+
+  /** Checks whether the view and a given simplex have the same vertices */
+  bool operator==( const Simplex& simplex ) const
+  {
+    return _size == simplex.size() && std::equal( this->begin(), this->end(), simplex.begin() );
+  }
+
+  /** @overload operator==() */
+  bool operator!=( const Simplex& simplex ) const
+  {
+    return !this->operator==( simplex );
+  }
+
+private:
+  const VertexType* _vertices;
+  std::size_t _size;
+  Weight _data;
+};
+
+// ---------------------------------------------------------------------
+
+/**
+  @class face_view
+  @brief Lightweight view of a face of a simplex stored in a compact complex
+
+  This is the analogue of Simplex::face_view for compact complexes: the
+  face is described by the vertices of its simplex and the index of the
+  omitted vertex.
+*/
+
+template <class Simplex, class Weight, class Index>
+class CompactSimplicialComplex<Simplex, Weight, Index>::face_view
+{
+public:
+
+  /** Random-access iterator over all vertices of the face */
+  class const_iterator
+    : public boost::iterator_facade<const_iterator,
+                                    const VertexType,
+                                    boost::random_access_traversal_tag>
+  {
+  public:
+    const_iterator()
+      : _vertices( nullptr )
+      , _omitted( 0 )
+      , _position( 0 )
+    {
+    }
+
+    const_iterator( const VertexType* vertices, std::size_t omitted, std::size_t position )
+      : _vertices( vertices )
+      , _omitted( omitted )
+      , _position( position )
+    {
+    }
+
+  private:
+    friend class boost::iterator_core_access;
+
+    const VertexType& dereference() const
+    {
+      return _vertices[ _position < _omitted ? _position : _position + 1 ];
+    }
+
+    bool equal( const const_iterator& other ) const
+    {
+      return _vertices == other._vertices && _position == other._position;
+    }
+
+    void increment()                    { ++_position; }
+    void decrement()                    { --_position; }
+    void advance( std::ptrdiff_t n )    { _position = static_cast<std::size_t>( static_cast<std::ptrdiff_t>( _position ) + n ); }
+
+    std::ptrdiff_t distance_to( const const_iterator& other ) const
+    {
+      return static_cast<std::ptrdiff_t>( other._position ) - static_cast<std::ptrdiff_t>( _position );
+    }
+
+    const VertexType* _vertices;
+    std::size_t _omitted;
+    std::size_t _position;
+  };
+
+  face_view( const VertexType* vertices, std::size_t size, std::size_t omitted )
+    : _vertices( vertices )
+    , _size( size )
+    , _omitted( omitted )
+  {
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator( _vertices, _omitted, 0 );
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator( _vertices, _omitted, this->size() );
+  }
+
+  /** @returns Number of vertices of the face */
+  std::size_t size() const
+  {
+    return _size - 1;
+  }
+
+  /** @returns Index of the omitted vertex in the original simplex */
+  std::size_t omitted() const
+  {
+    return _omitted;
+  }
+
+  VertexType operator[]( std::size_t index ) const
+  {
+    return _vertices[ index < _omitted ? index : index + 1 ];
+  }
+
+private:
+  const VertexType* _vertices;
+  std::size_t _size;
+  std::size_t _omitted;
+};
+
+// ---------------------------------------------------------------------
+
+/**
+  @class const_iterator
+  @brief Iterator over all simplices of a compact complex in filtration order
+
+  Since the complex does not store any simplices, dereferencing the
+  iterator yields a simplex view by value.
+*/
+
+template <class Simplex, class Weight, class Index>
+class CompactSimplicialComplex<Simplex, Weight, Index>::const_iterator
+  : public boost::iterator_facade<const_iterator,
+                                  simplex_view,
+                                  boost::random_access_traversal_tag,
+                                  simplex_view>
+{
+public:
+  const_iterator()
+    : _complex( nullptr )
+    , _position( 0 )
+  {
+  }
+
+  const_iterator( const CompactSimplicialComplex* complex, std::size_t position )
+    : _complex( complex )
+    , _position( position )
+  {
+  }
+
+private:
+  friend class boost::iterator_core_access;
+
+  simplex_view dereference() const
+  {
+    return ( *_complex )[ _position ];
+  }
+
+  bool equal( const const_iterator& other ) const
+  {
+    return _complex == other._complex && _position == other._position;
+  }
+
+  void increment()                    { ++_position; }
+  void decrement()                    { --_position; }
+  void advance( std::ptrdiff_t n )    { _position = static_cast<std::size_t>( static_cast<std::ptrdiff_t>( _position ) + n ); }
+
+  std::ptrdiff_t distance_to( const const_iterator& other ) const
+  {
+    return static_cast<std::ptrdiff_t>( other._position ) - static_cast<std::ptrdiff_t>( _position );
+  }
+
+  const CompactSimplicialComplex* _complex;
+  std::size_t _position;
+};
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
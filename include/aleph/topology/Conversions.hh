@@ -6,7 +6,7 @@
 #include <aleph/topology/BoundaryMatrix.hh>
 
 #include <algorithm>
-#include <unordered_map>
+#include <vector>
 
 namespace aleph
 {
@@ -30,25 +30,16 @@ template <
   class SimplicialComplex
 > BoundaryMatrix<Representation> makeBoundaryMatrix( const SimplicialComplex& K, std::size_t max = 0 )
 {
-  using Simplex = typename SimplicialComplex::ValueType;
-  using Index   = typename BoundaryMatrix<Representation>::Index;
+  using Index = typename BoundaryMatrix<Representation>::Index;
 
   BoundaryMatrix<Representation> M;
   M.setNumColumns( static_cast<Index>( K.size() ) );
 
-  // Prepare index map -------------------------------------------------
-  //
-  // The idea is to map simplices to their index within the filtration
-  // in order to speed up the conversion process.
+  // Faces are looked up directly in the simplicial complex, using views
+  // of the boundary of every simplex. This neither requires copying all
+  // simplices into an additional index map, nor creating faces.
 
-  std::unordered_map<Simplex, Index> simplex_to_index;
-
-  {
-    Index i = Index(0);
-
-    for( auto&& simplex : K )
-      simplex_to_index[simplex] = i++;
-  }
+  std::vector<Index> column;
 
   Index j = Index(0);
 
@@ -56,15 +47,10 @@ template <
   {
     if( !max || j < max )
     {
-      std::vector<Index> column;
-      column.reserve( itSimplex->size() );
-
-      for( auto&& itBoundary = itSimplex->begin_boundary();
-           itBoundary != itSimplex->end_boundary();
-           ++itBoundary )
-      {
-        column.push_back( simplex_to_index[ *itBoundary ] );
-      }
+      column.clear();
+
+      for( std::size_t i = 0; i < itSimplex->boundarySize(); i++ )
+        column.push_back( static_cast<Index>( K.index( itSimplex->face( i ) ) ) );
 
       M.setColumn( j, column.begin(), column.end() );
     }
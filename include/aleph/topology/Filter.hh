@@ -1,6 +1,8 @@
 #ifndef ALEPH_TOPOLOGY_FILTER_HH__
 #define ALEPH_TOPOLOGY_FILTER_HH__
 
+#include <aleph/topology/FilteredView.hh>
+
 namespace aleph
 {
 
@@ -26,6 +28,10 @@ namespace topology
     return true;
   }
   \endcode
+
+  If the filtered complex is only required for reading, e.g. in order
+  to calculate its persistent homology, Filter::view() should be used
+  instead because it does not copy any simplices.
 */
 
 class Filter
@@ -43,6 +49,19 @@ public:
 
     return L;
   }
+
+  /**
+    Creates a lightweight view of all simplices that satisfy the given
+    functor. The view refers to the original simplicial complex, which
+    must thus outlive it.
+
+    @see FilteredView
+  */
+
+  template <class SimplicialComplex, class Functor> FilteredView<SimplicialComplex, Functor> view( const SimplicialComplex& K, Functor f ) const
+  {
+    return FilteredView<SimplicialComplex, Functor>( K, f );
+  }
 };
 
 } // namespace topology
@@ -0,0 +1,204 @@
+#ifndef ALEPH_TOPOLOGY_FILTERED_VIEW_HH__
+#define ALEPH_TOPOLOGY_FILTERED_VIEW_HH__
+
+#include <boost/iterator/permutation_iterator.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+/**
+  @class FilteredView
+  @brief Read-only view of the simplices of a complex that satisfy a predicate
+
+  The view stores a reference to a simplicial complex and the positions
+  of all simplices that satisfy a given predicate. Iterating over the
+  view yields these simplices in the filtration order of the complex.
+  Indices, however, refer to positions *within* the view, so the view
+  may be used in place of a simplicial complex for creating a boundary
+  matrix or for calculating persistence diagrams.
+
+  In contrast to the Filter and Skeleton functors, a view does not copy
+  any simplices. This makes it cheap to create many views of the same
+  complex, e.g. when sweeping over a parameter. The complex must remain
+  valid and unchanged for as long as the view is being used.
+
+  The predicate has to satisfy the interface described in Filter. It
+  should only retain sets of simplices that are closed under taking
+  faces; otherwise, creating a boundary matrix is impossible.
+*/
+
+template <class SimplicialComplex, class Predicate> class FilteredView
+{
+public:
+  using ValueType  = typename SimplicialComplex::ValueType;
+  using value_type = ValueType;
+
+  using Positions      = std::vector<std::size_t>;
+  using const_iterator = boost::permutation_iterator<typename SimplicialComplex::const_iterator,
+                                                     typename Positions::const_iterator>;
+  using iterator       = const_iterator;
+
+  /**
+    Creates a new view by evaluating the predicate for every simplex of
+    the complex once.
+
+    @param K         Simplicial complex
+    @param predicate Predicate that decides whether a simplex is retained
+  */
+
+  FilteredView( const SimplicialComplex& K, Predicate predicate )
+    : _K( K )
+    , _predicate( predicate )
+  {
+    std::size_t i = 0;
+
+    for( auto&& simplex : K )
+    {
+      if( _predicate( simplex ) )
+        _positions.push_back( i );
+
+      ++i;
+    }
+  }
+
+  const_iterator begin() const { return const_iterator( _K.begin(), _positions.begin() ); }
+  const_iterator end()   const { return const_iterator( _K.begin(), _positions.end()   ); }
+
+  /**
+    @returns Simplex at the given position of the view
+    @throws std::out_of_range if the index is out of range
+  */
+
+  const ValueType& at( std::size_t index ) const
+  {
+    return _K.at( _positions.at( index ) );
+  }
+
+  /** @returns Number of simplices in the view */
+  std::size_t size() const
+  {
+    return _positions.size();
+  }
+
+  /** @returns true if the view does not contain any simplices */
+  bool empty() const
+  {
+    return _positions.empty();
+  }
+
+  /**
+    @returns Dimension of the view, i.e. the maximum dimension of its
+    simplices
+
+    @throws std::runtime_error if the view is empty
+  */
+
+  std::size_t dimension() const
+  {
+    if( this->empty() )
+      throw std::runtime_error( "Unable to query dimensionality of empty simplicial complex" );
+
+    std::size_t dimension = 0;
+
+    for( auto&& simplex : *this )
+      dimension = std::max( dimension, static_cast<std::size_t>( simplex.dimension() ) );
+
+    return dimension;
+  }
+
+  /**
+    Searches for a simplex in the view. The simplex may be given by any
+    type that permits queries of the underlying complex, e.g. a simplex
+    or a face view.
+
+    @returns Iterator to the simplex, or end() if the simplex either
+    does not exist or does not belong to the view
+  */
+
+  template <class T> const_iterator find( const T& simplex ) const
+  {
+    auto it = this->position( simplex );
+    return const_iterator( _K.begin(), it );
+  }
+
+  /** @returns true if the simplex belongs to the view */
+  template <class T> bool contains( const T& simplex ) const
+  {
+    return this->position( simplex ) != _positions.end();
+  }
+
+  /**
+    @returns Index of the simplex within the view
+    @throws std::runtime_error if the simplex does not belong to the view
+  */
+
+  template <class T> std::size_t index( const T& simplex ) const
+  {
+    auto it = this->position( simplex );
+
+    if( it != _positions.end() )
+      return static_cast<std::size_t>( std::distance( _positions.begin(), it ) );
+    else
+      throw std::runtime_error( "Queried simplex does not exist" );
+  }
+
+  /** @returns Underlying simplicial complex */
+  const SimplicialComplex& base() const noexcept
+  {
+    return _K;
+  }
+
+private:
+
+  /**
+    @returns Iterator to the position of the simplex in the underlying
+    complex, or the end of the positions if the simplex does not belong
+    to the view
+  */
+
+  template <class T> typename Positions::const_iterator position( const T& simplex ) const
+  {
+    auto itSimplex = _K.find( simplex );
+
+    if( itSimplex == _K.end() )
+      return _positions.end();
+
+    auto i  = static_cast<std::size_t>( std::distance( _K.begin(), itSimplex ) );
+    auto it = std::lower_bound( _positions.begin(), _positions.end(), i );
+
+    if( it != _positions.end() && *it == i )
+      return it;
+    else
+      return _positions.end();
+  }
+
+  const SimplicialComplex& _K;
+  Predicate _predicate;
+
+  /** Positions of all retained simplices in the underlying complex */
+  Positions _positions;
+};
+
+/**
+  Convenience function for creating a filtered view while deducing the
+  types of its arguments.
+*/
+
+template <class SimplicialComplex, class Predicate> FilteredView<SimplicialComplex, Predicate> makeFilteredView( const SimplicialComplex& K, Predicate predicate )
+{
+  return FilteredView<SimplicialComplex, Predicate>( K, predicate );
+}
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
@@ -49,17 +49,18 @@ auto generateErdosRenyiGraph( unsigned n, double p ) -> SimplicialComplex< Simpl
   probability of p. In contrast to Erdős--Rényi graphs, here a
   weight is assigned according to a number of Bernoulli trials
   with success probability p.
+
+  The random number generator is specified by the client, so using a
+  generator with a fixed seed makes the graph reproducible.
 */
 
-auto generateWeightedRandomGraph( unsigned n, double p ) -> SimplicialComplex< Simplex<unsigned, unsigned> >
+template <class Engine> auto generateWeightedRandomGraph( unsigned n, double p, Engine& mt ) -> SimplicialComplex< Simplex<unsigned, unsigned> >
 {
   using S = Simplex<unsigned, unsigned>;
   using K = SimplicialComplex<S>;
 
   std::vector<S> simplices;
 
-  std::random_device rd;
-  std::mt19937 mt( rd() );
   std::uniform_real_distribution<> distribution( 0.0, 1.0 );
 
   for( unsigned i = 0; i < n; i++ )
@@ -84,7 +85,20 @@ auto generateWeightedRandomGraph( unsigned n, double p ) -> SimplicialComplex< S
   std::sort( simplices.begin(), simplices.end(), aleph::topology::filtrations::Data<S>() );
 
   return K( simplices.begin(), simplices.end() );
+}
+
+/**
+  Generates a weighted random graph with n vertices and a link
+  probability of p, using a random number generator with a random
+  seed.
+*/
+
+auto generateWeightedRandomGraph( unsigned n, double p ) -> SimplicialComplex< Simplex<unsigned, unsigned> >
+{
+  std::random_device rd;
+  std::mt19937 mt( rd() );
 
+  return generateWeightedRandomGraph( n, p, mt );
 }
 
 } // namespace topology
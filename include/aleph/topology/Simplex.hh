@@ -4,6 +4,7 @@
 #include <boost/functional/hash.hpp>
 
 #include <boost/iterator/iterator_adaptor.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 #include <boost/iterator/filter_iterator.hpp>
 
 #include <algorithm>
@@ -60,6 +61,7 @@ public:
   // I cannot describe the class inline because boost::iterator_adaptor expects
   // a _complete_ class.
   class boundary_iterator;
+  class face_view;
 
   // Constructors ------------------------------------------------------
 
@@ -201,6 +203,65 @@ public:
     return boundary_iterator( _vertices.end(), _vertices);
   }
 
+  /**
+    @returns Number of faces in the boundary of the simplex, i.e. the
+    number of faces that are enumerated by the boundary iterator
+  */
+
+  std::size_t boundarySize() const
+  {
+    return _vertices.size() > 1 ? _vertices.size() : 0;
+  }
+
+  /**
+    Returns a view of a face of the simplex. The face consists of all
+    vertices of the simplex except for the one with the given index.
+    In contrast to the boundary iterator, the view does not allocate
+    any memory, so it is well-suited for face lookups, e.g. by means
+    of SimplicialComplex::find() or SimplicialComplex::index().
+
+    The view refers to the vertices of the simplex, so it must not be
+    used after the simplex has been destroyed.
+
+    @param i Index of the vertex to omit; faces are enumerated in the
+             same order as by the boundary iterator.
+
+    @throws std::out_of_range if the index is out of range.
+  */
+
+  face_view face( std::size_t i ) const
+  {
+    if( i >= _vertices.size() )
+      throw std::out_of_range( "Face index is out of range" );
+
+    return face_view( _vertices, i );
+  }
+
+  /**
+    Stores the vertices of a face of the simplex in a caller-supplied
+    buffer. When the buffer is re-used for all faces, this requires at
+    most one allocation.
+
+    @param i        Index of the vertex to omit
+    @param vertices Buffer for storing the vertices of the face
+
+    @throws std::out_of_range if the index is out of range.
+  */
+
+  void face( std::size_t i, vertex_container_type& vertices ) const
+  {
+    if( i >= _vertices.size() )
+      throw std::out_of_range( "Face index is out of range" );
+
+    vertices.clear();
+
+    for( std::size_t j = 0; j < _vertices.size(); j++ )
+    {
+      if( j != i )
+        vertices.push_back( _vertices[j] );
+    }
+  }
+
   // Data --------------------------------------------------------------
 
   /**
@@ -446,6 +507,146 @@ private:
 
 // ---------------------------------------------------------------------
 
+/**
+  @class face_view
+  @brief Lightweight view of a face of a given simplex
+
+  A face view represents the face of a simplex that is obtained by
+  omitting a single vertex. It only stores a reference to the vertices
+  of the simplex and the index of the omitted vertex, so it may be
+  created without allocating any memory. Its vertices are sorted in
+  the same order as the vertices of a simplex.
+*/
+
+template <
+    class DataType,
+    class VertexType
+>
+class Simplex<DataType, VertexType>::face_view
+{
+public:
+
+  /** Random-access iterator over all vertices of the face */
+  class const_iterator
+    : public boost::iterator_facade<const_iterator,
+                                    const VertexType,
+                                    boost::random_access_traversal_tag>
+  {
+  public:
+    const_iterator()
+      : _vertices( nullptr )
+      , _omitted( 0 )
+      , _position( 0 )
+    {
+    }
+
+    const_iterator( const vertex_container_type* vertices, std::size_t omitted, std::size_t position )
+      : _vertices( vertices )
+      , _omitted( omitted )
+      , _position( position )
+    {
+    }
+
+  private:
+    friend class boost::iterator_core_access;
+
+    const VertexType& dereference() const
+    {
+      return ( *_vertices )[ _position < _omitted ? _position : _position + 1 ];
+    }
+
+    bool equal( const const_iterator& other ) const
+    {
+      return _vertices == other._vertices && _position == other._position;
+    }
+
+    void increment()                    { ++_position; }
+    void decrement()                    { --_position; }
+    void advance( std::ptrdiff_t n )    { _position = static_cast<std::size_t>( static_cast<std::ptrdiff_t>( _position ) + n ); }
+
+    std::ptrdiff_t distance_to( const const_iterator& other ) const
+    {
+      return static_cast<std::ptrdiff_t>( other._position ) - static_cast<std::ptrdiff_t>( _position );
+    }
+
+    const vertex_container_type* _vertices;
+    std::size_t _omitted;
+    std::size_t _position;
+  };
+
+  face_view( const vertex_container_type& vertices, std::size_t omitted )
+    : _vertices( &vertices )
+    , _omitted( omitted )
+  {
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator( _vertices, _omitted, 0 );
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator( _vertices, _omitted, this->size() );
+  }
+
+  /** @returns Number of vertices of the face */
+  std::size_t size() const
+  {
+    return _vertices->size() - 1;
+  }
+
+  /** @returns true if the face is empty, i.e. it belongs to a 0-simplex */
+  bool empty() const
+  {
+    return this->size() == 0;
+  }
+
+  /**
+    @returns Dimension of the face
+
+    @throws std::runtime_error if the face is empty
+  */
+
+  std::size_t dimension() const
+  {
+    if( this->empty() )
+      throw std::runtime_error( "Querying dimension of empty simplex" );
+    else
+      return this->size() - 1;
+  }
+
+  /** @returns Index of the omitted vertex in the original simplex */
+  std::size_t omitted() const
+  {
+    return _omitted;
+  }
+
+  /** @returns Vertex of the face, specified by an index */
+  VertexType operator[]( std::size_t index ) const
+  {
+    return _vertices->at( index < _omitted ? index : index + 1 );
+  }
+
+  /** Checks whether the face and a given simplex have the same vertices */
+  bool operator==( const Simplex<DataType, VertexType>& simplex ) const
+  {
+    return this->size() == simplex.size() && std::equal( this->begin(), this->end(), simplex.begin() );
+  }
+
+  /** @overload operator==() */
+  bool operator!=( const Simplex<DataType, VertexType>& simplex ) const
+  {
+    return !this->operator==( simplex );
+  }
+
+private:
+  const vertex_container_type* _vertices;
+  std::size_t _omitted;
+};
+
+// ---------------------------------------------------------------------
+
 /**
   Outputs a simplex to an ostream. This is used for debugging purposes.
 
@@ -1,6 +1,8 @@
 #ifndef ALEPH_TOPOLOGY_SIMPLICIAL_COMPLEX_HH__
 #define ALEPH_TOPOLOGY_SIMPLICIAL_COMPLEX_HH__
 
+#include <aleph/utilities/ParallelSort.hh>
+
 #include <boost/multi_index_container.hpp>
 
 #include <boost/multi_index/indexed_by.hpp>
@@ -53,6 +55,8 @@ public:
   using const_dimension_iterator       = typename simplex_container_t::template index<dimension_t>::type::const_iterator;
   using dimension_iterator             = typename simplex_container_t::template index<dimension_t>::type::iterator;
 
+  using face_view = typename Simplex::face_view;
+
   // STL-like typedefs -------------------------------------------------
 
   // This simplifies writing algorithms that do not have any internal knowledge
@@ -375,6 +379,54 @@ public:
       throw std::runtime_error( "Queried simplex does not exist" );
   }
 
+  // Face queries ------------------------------------------------------
+  //
+  // The following functions accept a view of a face of some simplex and
+  // look up the corresponding simplex without creating it, i.e. without
+  // allocating any memory. Apart from that, they behave exactly like the
+  // functions for simplex queries.
+
+  /** @overload contains() */
+  bool contains( const face_view& face ) const
+  {
+    return _simplices.template get<lexicographical_t>().find( face, lexicographical_comparison() ) != _simplices.template get<lexicographical_t>().end();
+  }
+
+  /** @overload find() */
+  const_iterator find( const face_view& face ) const
+  {
+    auto&& it
+      = _simplices.template get<lexicographical_t>().find( face, lexicographical_comparison() );
+
+    if( it != this->end_lexicographical() )
+      return _simplices.template project<index_t>( it );
+    else
+      return this->end();
+  }
+
+  /** @overload find() */
+  iterator find( const face_view& face )
+  {
+    auto&& it
+      = _simplices.template get<lexicographical_t>().find( face, lexicographical_comparison() );
+
+    if( it != this->end_lexicographical() )
+      return _simplices.template project<index_t>( it );
+    else
+      return this->end();
+  }
+
+  /** @overload index() */
+  std::size_t index( const face_view& face ) const
+  {
+    auto&& itSimplex = this->find( face );
+
+    if( itSimplex != this->end() )
+      return static_cast<std::size_t>( std::distance( this->begin(), itSimplex ) );
+    else
+      throw std::runtime_error( "Queried simplex does not exist" );
+  }
+
   /** @returns Number of simplices stored in simplicial complex */
   std::size_t size() const
   {
@@ -450,7 +502,19 @@ public:
 
   template <class Comparison> void sort( Comparison&& comparison )
   {
-    _simplices.sort( std::ref( comparison ) );
+    // Sorting an external view in parallel and rearranging the container
+    // afterwards is faster than sorting the container itself, which has
+    // to use a sequential merge sort of its nodes.
+    std::vector< std::reference_wrapper<const Simplex> > view( _simplices.begin(), _simplices.end() );
+
+    aleph::utilities::parallelSort( view.begin(), view.end(),
+      [&comparison] ( const Simplex& s, const Simplex& t )
+      {
+        return comparison( s, t );
+      }
+    );
+
+    _simplices.rearrange( view.begin() );
   }
 
   /** Sorts simplices according to their builtin comparison function */
@@ -459,6 +523,45 @@ public:
     _simplices.sort();
   }
 
+  /**
+    Replaces the contents of the simplicial complex by a set of simplices
+    and applies a filtration to them. This is the preferred way of creating
+    large simplicial complexes: instead of updating all indices of the
+    container for every simplex, the simplices are sorted in parallel,
+    first lexicographically and then according to the filtration, so that
+    every index only needs to be built once.
+
+    Duplicate simplices are only stored once. The relative order of all
+    simplices that are equivalent with respect to the filtration remains
+    lexicographical.
+
+    @param simplices  Unsorted simplices
+    @param comparison Simplex comparison object (or function) that describes
+                      the filtration
+
+    @see SimplicialComplex::sort()
+  */
+
+  template <class Comparison> void bulkLoad( std::vector<Simplex> simplices, Comparison&& comparison )
+  {
+    aleph::utilities::parallelSort( simplices.begin(), simplices.end(), std::less<Simplex>() );
+
+    _simplices.clear();
+
+    // Since the simplices are sorted, every insertion into the
+    // lexicographical index happens at its end, which only takes
+    // amortized constant time.
+    auto&& index = _simplices.template get<lexicographical_t>();
+
+    for( auto&& simplex : simplices )
+      index.insert( index.end(), std::move( simplex ) );
+
+    simplices.clear();
+    simplices.shrink_to_fit();
+
+    this->sort( comparison );
+  }
+
   // -------------------------------------------------------------------
 
   /**
@@ -548,11 +651,9 @@ public:
         = useMaximum ? std::numeric_limits<DataType>::lowest()
                      : std::numeric_limits<DataType>::max();
 
-      for( auto itBoundary = itSimplex->begin_boundary();
-           itBoundary != itSimplex->end_boundary();
-           ++itBoundary )
+      for( std::size_t i = 0; i < itSimplex->boundarySize(); i++ )
       {
-        const_iterator itPos = this->find( *itBoundary );
+        const_iterator itPos = this->find( itSimplex->face( i ) );
         if( itPos != this->end() )
         {
           weight = useMaximum ? std::max( weight, itPos->data() )
@@ -687,20 +788,17 @@ private:
 
   void checkAndRestoreValidity( const Simplex& simplex )
   {
-    for( auto itFace = simplex.begin_boundary();
-         itFace != simplex.end_boundary();
-         ++itFace )
+    for( std::size_t i = 0; i < simplex.boundarySize(); i++ )
     {
-      const_lexicographical_iterator itStoredFace
-          = _simplices.template get<lexicographical_t>().find( *itFace );
+      auto face = simplex.face( i );
 
-      if( itStoredFace == _simplices.template get<lexicographical_t>().end() )
+      if( !this->contains( face ) )
       {
         // The new simplex shall contain the same vertices as the "face
         // simplex", but the data from its parent simplex. This ensures that
         // the data of a coface is always greater than or equal to the data of
         // its faces (assuming that the data type is comparable).
-        _simplices.push_back( Simplex( *itFace,
+        _simplices.push_back( Simplex( face.begin(), face.end(),
                                        simplex.data() ) );
       }
     }
@@ -716,22 +814,30 @@ private:
 
   bool checkValidity( const Simplex& simplex )
   {
-    for( auto itFace = simplex.begin_boundary();
-         itFace != simplex.end_boundary();
-         ++itFace )
+    for( std::size_t i = 0; i < simplex.boundarySize(); i++ )
     {
       // Check whether an unknown face has been found. If so, the simplex is
       // invalid.
-      const_lexicographical_iterator itStoredFace
-          = _simplices.template get<lexicographical_t>().find( *itFace );
-
-      if( itStoredFace == _simplices.template get<lexicographical_t>().end() )
+      if( !this->contains( simplex.face( i ) ) )
         return false;
     }
 
     return true;
   }
 
+  /**
+    Lexicographical comparison of vertex ranges. This permits queries of
+    the lexicographical index with face views instead of simplices.
+  */
+
+  struct lexicographical_comparison
+  {
+    template <class S, class T> bool operator()( const S& s, const T& t ) const
+    {
+      return std::lexicographical_compare( s.begin(), s.end(), t.begin(), t.end() );
+    }
+  };
+
   /**
     Simplex container. boost::multi_index is used to provide different "views"
     to the simplicial data set. The first view uses the current sorting order
@@ -1,6 +1,10 @@
 #ifndef ALEPH_TOPOLOGY_SKELETON_HH__
 #define ALEPH_TOPOLOGY_SKELETON_HH__
 
+#include <aleph/topology/FilteredView.hh>
+
+#include <cstddef>
+
 namespace aleph
 {
 
@@ -44,6 +48,38 @@ public:
 
     return L;
   }
+
+  /** Predicate for retaining all simplices up to a given dimension */
+  class DimensionPredicate
+  {
+  public:
+    explicit DimensionPredicate( std::size_t k )
+      : _k( k )
+    {
+    }
+
+    template <class Simplex> bool operator()( const Simplex& s ) const
+    {
+      return s.dimension() <= _k;
+    }
+
+  private:
+    std::size_t _k;
+  };
+
+  /**
+    Creates a lightweight view of the \f$k\f$-skeleton of a simplicial
+    complex. In contrast to the function operator, this does not copy
+    any simplices. The view refers to the original simplicial complex,
+    which must thus outlive it.
+
+    @see FilteredView
+  */
+
+  template <class SimplicialComplex> FilteredView<SimplicialComplex, DimensionPredicate> view( std::size_t k, const SimplicialComplex& K ) const
+  {
+    return FilteredView<SimplicialComplex, DimensionPredicate>( K, DimensionPredicate( k ) );
+  }
 };
 
 } // namespace topology
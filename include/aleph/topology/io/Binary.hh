@@ -0,0 +1,464 @@
+#ifndef ALEPH_TOPOLOGY_IO_BINARY_HH__
+#define ALEPH_TOPOLOGY_IO_BINARY_HH__
+
+#include <aleph/topology/CompactSimplicialComplex.hh>
+
+#include <aleph/utilities/MemoryMappedFile.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+namespace io
+{
+
+/*
+  Binary format for filtered simplicial complexes
+  -----------------------------------------------
+
+  All values are stored in the byte order of the machine that wrote the
+  file; a byte order mark in the header permits detecting mismatches. A
+  file consists of the following sections, each of which starts at an
+  offset that is a multiple of 8:
+
+  1. Header (see below)
+  2. Slot offsets of all dimensions (uint64, `dimensions + 1` entries)
+  3. Slots of all simplices in filtration order (`simplices` indices)
+  4. Filtration indices of all slots (`simplices` indices)
+  5. Vertices of all simplices (`vertices` entries)
+  6. Weights of all slots (`simplices` entries)
+  7. Labels (optional); every label consists of its length (uint64) and
+     its characters, without any padding
+
+  Vertices and weights are partitioned by dimension: all simplices of
+  the same dimension occupy consecutive *slots*, and the slot offsets
+  describe where each dimension starts. Inside every partition, the
+  simplices are sorted lexicographically, while the two index sections
+  map between slots and the filtration order. This is the memory layout
+  of CompactSimplicialComplex, so such a complex can use the contents of
+  a mapped file directly. Indices are stored with 32 bits if possible,
+  and with 64 bits otherwise.
+*/
+
+namespace detail
+{
+
+struct BinaryHeader
+{
+  char          magic[8];
+  std::uint32_t byteOrder;
+  std::uint32_t version;
+  std::uint32_t vertexSize;
+  std::uint32_t dataSize;
+  std::uint32_t dataIsFloatingPoint;
+  std::uint32_t indexSize;
+  std::uint32_t flags;
+  std::uint32_t reserved;
+  std::uint64_t simplices;
+  std::uint64_t dimensions;
+  std::uint64_t vertices;
+  std::uint64_t labels;
+};
+
+static_assert( sizeof( BinaryHeader ) == 72, "Binary header must not contain any padding" );
+
+constexpr const char*   binaryMagic     = "ALEPHSC";
+constexpr std::uint32_t binaryByteOrder = 0x01020304;
+constexpr std::uint32_t binaryVersion   = 2;
+constexpr std::uint32_t binaryHasLabels = 0x1;
+
+/** Rounds an offset up to the next multiple of 8 */
+inline std::uint64_t pad( std::uint64_t offset )
+{
+  return ( offset + 7 ) & ~std::uint64_t( 7 );
+}
+
+/** Copies an array of indices of one type into an array of another type */
+template <class Source, class Target> void convertIndices( const char* data, std::size_t n, std::vector<Target>& result )
+{
+  result.resize( n );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    Source index = Source();
+    std::memcpy( &index, data + i * sizeof( Source ), sizeof( Source ) );
+
+    result[i] = static_cast<Target>( index );
+  }
+}
+
+} // namespace detail
+
+/**
+  @class BinaryReader
+  @brief Reads simplicial complexes in Aleph's binary format
+
+  The binary format stores a filtered simplicial complex, i.e. its
+  simplices, their weights, and their order, as well as optional labels
+  for its vertices. It is meant for caching simplicial complexes that are
+  expensive to create, such as expanded Vietoris--Rips complexes.
+
+  The file is mapped into memory. A CompactSimplicialComplex refers to
+  the mapped contents directly, so loading it does not require any
+  parsing or copying, and only the pages that are accessed are read. A
+  SimplicialComplex, by contrast, needs to be created from the simplices
+  in the file.
+
+  The vertex type and the data type of the simplicial complex need to
+  match the types that were used for writing the file.
+
+  @see BinaryWriter
+*/
+
+class BinaryReader
+{
+public:
+
+  /**
+    Checks whether a file is stored in the binary format by inspecting
+    its first bytes. The extension of the file does not matter.
+  */
+
+  static bool isBinary( const std::string& filename )
+  {
+    std::ifstream in( filename, std::ios::binary );
+    if( !in )
+      return false;
+
+    char magic[8] = {};
+    in.read( magic, sizeof( magic ) );
+
+    return in && std::memcmp( magic, detail::binaryMagic, sizeof( magic ) ) == 0;
+  }
+
+  /**
+    Reads a simplicial complex. The simplices are created in filtration
+    order from a compact simplicial complex that refers to the file.
+  */
+
+  template <class SimplicialComplex> void operator()( const std::string& filename, SimplicialComplex& K )
+  {
+    using Simplex    = typename SimplicialComplex::ValueType;
+    using DataType   = typename Simplex::DataType;
+
+    CompactSimplicialComplex<Simplex, DataType, std::uint64_t> C;
+    this->operator()( filename, C );
+
+    std::vector<Simplex> simplices;
+    simplices.reserve( C.size() );
+
+    for( auto&& s : C )
+      simplices.push_back( Simplex( s.begin(), s.end(), s.data() ) );
+
+    K = SimplicialComplex( simplices.begin(), simplices.end() );
+  }
+
+  /**
+    Reads a compact simplicial complex, which refers to the contents of
+    the mapped file and keeps the mapping alive. If the file uses indices
+    of a different size than the complex, only the indices are copied.
+
+    @throws std::runtime_error if the file cannot be read, if it is not
+    valid, or if its vertex or data type differs from the complex
+  */
+
+  template <class Simplex, class Weight, class Index> void operator()( const std::string& filename, CompactSimplicialComplex<Simplex, Weight, Index>& K )
+  {
+    using VertexType = typename Simplex::VertexType;
+
+    _labels.clear();
+
+    auto file = std::make_shared<utilities::MemoryMappedFile>( filename );
+    auto data = static_cast<const char*>( file->data() );
+    auto size = static_cast<std::uint64_t>( file->size() );
+
+    detail::BinaryHeader header;
+
+    if( size < sizeof( header ) )
+      throw std::runtime_error( "Binary file is truncated" );
+
+    std::memcpy( &header, data, sizeof( header ) );
+
+    if( std::memcmp( header.magic, detail::binaryMagic, sizeof( header.magic ) ) != 0 )
+      throw std::runtime_error( "File is not stored in binary format" );
+
+    if( header.byteOrder != detail::binaryByteOrder )
+      throw std::runtime_error( "Binary file uses a different byte order" );
+
+    if( header.version != detail::binaryVersion )
+      throw std::runtime_error( "Unsupported version of binary format" );
+
+    if(    header.vertexSize          != sizeof( VertexType )
+        || header.dataSize            != sizeof( Weight )
+        || header.dataIsFloatingPoint != static_cast<std::uint32_t>( std::is_floating_point<Weight>::value ) )
+      throw std::runtime_error( "Binary file uses different vertex or data types" );
+
+    if( header.indexSize != sizeof( std::uint32_t ) && header.indexSize != sizeof( std::uint64_t ) )
+      throw std::runtime_error( "Binary file uses an unsupported index type" );
+
+    auto n = header.simplices;
+    auto D = header.dimensions;
+
+    // Checking the sizes of all sections before accessing them makes it
+    // possible to detect truncated files.
+    if(    D > size
+        || n > size
+        || header.vertices > size )
+      throw std::runtime_error( "Binary file is truncated" );
+
+    if( n > static_cast<std::uint64_t>( std::numeric_limits<Index>::max() ) )
+      throw std::runtime_error( "Binary file contains too many simplices for index type" );
+
+    auto offsetsOffset   = std::uint64_t( sizeof( header ) );
+    auto orderOffset     = detail::pad( offsetsOffset   + ( D + 1 ) * sizeof( std::uint64_t ) );
+    auto positionsOffset = detail::pad( orderOffset     + n * header.indexSize );
+    auto verticesOffset  = detail::pad( positionsOffset + n * header.indexSize );
+    auto weightsOffset   = detail::pad( verticesOffset  + header.vertices * sizeof( VertexType ) );
+    auto labelsOffset    = detail::pad( weightsOffset   + n * sizeof( Weight ) );
+
+    if( labelsOffset > size )
+      throw std::runtime_error( "Binary file is truncated" );
+
+    std::vector<std::uint64_t> offsets( D + 1 );
+    std::memcpy( offsets.data(), data + offsetsOffset, offsets.size() * sizeof( std::uint64_t ) );
+
+    if( offsets.front() != 0 || offsets.back() != n || !std::is_sorted( offsets.begin(), offsets.end() ) )
+      throw std::runtime_error( "Binary file contains invalid dimension offsets" );
+
+    std::uint64_t numVertices = 0;
+
+    for( std::uint64_t d = 0; d < D; d++ )
+      numVertices += ( offsets[d+1] - offsets[d] ) * ( d + 1 );
+
+    if( numVertices != header.vertices )
+      throw std::runtime_error( "Binary file contains invalid dimension offsets" );
+
+    // Indices are only copied if their size differs from the index type
+    // of the complex; otherwise, the complex refers to the mapped file.
+
+    struct Storage
+    {
+      std::shared_ptr<utilities::MemoryMappedFile> file;
+
+      std::vector<Index> order;
+      std::vector<Index> positions;
+    };
+
+    auto storage  = std::make_shared<Storage>();
+    storage->file = file;
+
+    const Index* order     = nullptr;
+    const Index* positions = nullptr;
+
+    if( header.indexSize == sizeof( Index ) )
+    {
+      order     = reinterpret_cast<const Index*>( data + orderOffset );
+      positions = reinterpret_cast<const Index*>( data + positionsOffset );
+    }
+    else
+    {
+      auto N = static_cast<std::size_t>( n );
+
+      if( header.indexSize == sizeof( std::uint32_t ) )
+      {
+        detail::convertIndices<std::uint32_t>( data + orderOffset,     N, storage->order );
+        detail::convertIndices<std::uint32_t>( data + positionsOffset, N, storage->positions );
+      }
+      else
+      {
+        detail::convertIndices<std::uint64_t>( data + orderOffset,     N, storage->order );
+        detail::convertIndices<std::uint64_t>( data + positionsOffset, N, storage->positions );
+      }
+
+      order     = storage->order.data();
+      positions = storage->positions.data();
+    }
+
+    // Both index maps need to be inverses of each other; this ensures that
+    // all accesses of the complex remain within the mapped file.
+    for( std::uint64_t i = 0; i < n; i++ )
+    {
+      auto slot = static_cast<std::uint64_t>( order[i] );
+
+      if( slot >= n || static_cast<std::uint64_t>( positions[slot] ) != i )
+        throw std::runtime_error( "Binary file contains invalid simplex order" );
+    }
+
+    if( header.flags & detail::binaryHasLabels )
+    {
+      auto offset = labelsOffset;
+
+      for( std::uint64_t i = 0; i < header.labels; i++ )
+      {
+        std::uint64_t length = 0;
+
+        if( offset + sizeof( length ) > size )
+          throw std::runtime_error( "Binary file is truncated" );
+
+        std::memcpy( &length, data + offset, sizeof( length ) );
+        offset += sizeof( length );
+
+        if( length > size - offset )
+          throw std::runtime_error( "Binary file is truncated" );
+
+        _labels.push_back( std::string( data + offset, data + offset + length ) );
+        offset += length;
+      }
+    }
+
+    K = CompactSimplicialComplex<Simplex, Weight, Index>(
+      std::vector<std::size_t>( offsets.begin(), offsets.end() ),
+      reinterpret_cast<const VertexType*>( data + verticesOffset ),
+      reinterpret_cast<const Weight*>( data + weightsOffset ),
+      order,
+      positions,
+      storage
+    );
+  }
+
+  /** @returns Labels of the vertices, if they have been stored */
+  std::vector<std::string> labels() const noexcept
+  {
+    return _labels;
+  }
+
+private:
+  std::vector<std::string> _labels;
+};
+
+/**
+  @class BinaryWriter
+  @brief Writes simplicial complexes in Aleph's binary format
+
+  The writer stores the simplices of a simplicial complex, together with
+  their weights, their current order, and optional labels. Simplicial
+  complexes are converted into the layout of a compact simplicial
+  complex first, while compact simplicial complexes are written as-is.
+
+  @see BinaryReader
+*/
+
+class BinaryWriter
+{
+public:
+
+  template <class SimplicialComplex> void operator()( const std::string& filename, const SimplicialComplex& K )
+  {
+    std::ofstream out( filename, std::ios::binary );
+    if( !out )
+      throw std::runtime_error( "Unable to open output file" );
+
+    this->operator()( out, K );
+  }
+
+  template <class SimplicialComplex> void operator()( std::ostream& out, const SimplicialComplex& K )
+  {
+    using Simplex  = typename SimplicialComplex::ValueType;
+    using DataType = typename Simplex::DataType;
+
+    // Smaller indices result in smaller files, and they can be used by
+    // compact simplicial complexes with the default index type.
+    if( K.size() <= static_cast<std::size_t>( std::numeric_limits<std::uint32_t>::max() ) )
+      this->operator()( out, CompactSimplicialComplex<Simplex, DataType, std::uint32_t>( K ) );
+    else
+      this->operator()( out, CompactSimplicialComplex<Simplex, DataType, std::uint64_t>( K ) );
+  }
+
+  template <class Simplex, class Weight, class Index> void operator()( std::ostream& out, const CompactSimplicialComplex<Simplex, Weight, Index>& K )
+  {
+    using VertexType = typename Simplex::VertexType;
+
+    auto&& slotOffsets = K.slotOffsets();
+
+    auto n = static_cast<std::uint64_t>( K.size() );
+    auto D = static_cast<std::uint64_t>( slotOffsets.size() - 1 );
+
+    std::vector<std::uint64_t> offsets( slotOffsets.begin(), slotOffsets.end() );
+    std::uint64_t numVertices = 0;
+
+    for( std::uint64_t d = 0; d < D; d++ )
+      numVertices += ( offsets[d+1] - offsets[d] ) * ( d + 1 );
+
+    detail::BinaryHeader header;
+
+    std::memset( &header, 0, sizeof( header ) );
+    std::memcpy( header.magic, detail::binaryMagic, sizeof( header.magic ) );
+
+    header.byteOrder           = detail::binaryByteOrder;
+    header.version             = detail::binaryVersion;
+    header.vertexSize          = static_cast<std::uint32_t>( sizeof( VertexType ) );
+    header.dataSize            = static_cast<std::uint32_t>( sizeof( Weight ) );
+    header.dataIsFloatingPoint = static_cast<std::uint32_t>( std::is_floating_point<Weight>::value );
+    header.indexSize           = static_cast<std::uint32_t>( sizeof( Index ) );
+    header.flags               = _labels.empty() ? 0 : detail::binaryHasLabels;
+    header.simplices           = n;
+    header.dimensions          = D;
+    header.vertices            = numVertices;
+    header.labels              = static_cast<std::uint64_t>( _labels.size() );
+
+    std::uint64_t offset = 0;
+
+    this->write( out, &header, sizeof( header ), offset );
+    this->write( out, offsets.data(),    offsets.size() * sizeof( std::uint64_t ), offset );
+    this->write( out, K.orderData(),     n * sizeof( Index ),                       offset );
+    this->write( out, K.positionData(),  n * sizeof( Index ),                       offset );
+    this->write( out, K.vertexData(),    numVertices * sizeof( VertexType ),        offset );
+    this->write( out, K.weightData(),    n * sizeof( Weight ),                      offset );
+
+    for( auto&& label : _labels )
+    {
+      auto length = static_cast<std::uint64_t>( label.size() );
+
+      out.write( reinterpret_cast<const char*>( &length ), sizeof( length ) );
+      out.write( label.data(), static_cast<std::streamsize>( label.size() ) );
+    }
+
+    if( !out )
+      throw std::runtime_error( "Unable to write output file" );
+  }
+
+  /** Sets labels for the vertices; they are stored with the next complex */
+  template <class InputIterator> void setLabels( InputIterator begin, InputIterator end )
+  {
+    _labels.assign( begin, end );
+  }
+
+private:
+
+  /** Writes a section and pads it to the next multiple of 8 */
+  static void write( std::ostream& out, const void* data, std::size_t size, std::uint64_t& offset )
+  {
+    out.write( static_cast<const char*>( data ), static_cast<std::streamsize>( size ) );
+    offset += size;
+
+    auto padding = detail::pad( offset ) - offset;
+
+    for( std::uint64_t i = 0; i < padding; i++ )
+      out.put( '\0' );
+
+    offset += padding;
+  }
+
+  std::vector<std::string> _labels;
+};
+
+} // namespace io
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
@@ -4,9 +4,12 @@
 #include <algorithm>
 #include <istream>
 #include <fstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include <aleph/math/SymmetricMatrix.hh>
+
 #include <aleph/utilities/String.hh>
 
 namespace aleph
@@ -50,6 +53,14 @@ class MatrixReader
 {
 public:
 
+  /** Formats of distance matrices */
+  enum class DistanceMatrixFormat
+  {
+    Detect,         //< Detects the format from the number of values per line
+    Dense,          //< Every line contains one row of the matrix
+    LowerTriangular //< Every line contains the distances to all preceding points
+  };
+
   /**
     Reads a simplicial complex from a file, using the default maximum
     functor for weight assignment. If you want to change the functor,
@@ -249,6 +260,116 @@ public:
     K = SimplicialComplex( simplices.begin(), simplices.end() );
   }
 
+  /**
+    Reads a matrix of pairwise distances from a file. The matrix may be
+    stored in one of two formats:
+
+    - As a *dense* matrix, i.e. every line contains one row of the matrix.
+      The matrix must be square and symmetric.
+
+    - As a *lower triangular* matrix without its diagonal, i.e. the ith
+      line contains the distances of the (i+1)th point to all preceding
+      points. Hence, the first line contains a single value, the second
+      line contains two values, and so on.
+
+    Values may be separated by spaces or commas. Empty lines and lines
+    starting with `#` are ignored.
+
+    By default, the format is detected from the number of values in every
+    line. This is unique except for a file with a single value, which may
+    either be a dense matrix of one point or a lower triangular matrix of
+    two points. Since the former is trivial, the latter is assumed. Use
+    setDistanceMatrixFormat() to specify the format explicitly.
+
+    @param filename Input filename
+    @param M        Matrix of pairwise distances
+
+    @throws std::runtime_error if the file cannot be read, if one of its
+    values is not a number, or if its format is not supported
+  */
+
+  template <class T, class I> void operator()( const std::string& filename, math::SymmetricMatrix<T, I>& M )
+  {
+    std::ifstream in( filename );
+    if( !in )
+      throw std::runtime_error( "Unable to read input file" );
+
+    this->operator()( in, M );
+  }
+
+  /** @overload operator()( const std::string&, math::SymmetricMatrix<T, I>& ) */
+  template <class T, class I> void operator()( std::istream& in, math::SymmetricMatrix<T, I>& M )
+  {
+    std::vector< std::vector<T> > rows;
+    std::string line;
+
+    while( std::getline( in, line ) )
+    {
+      line = aleph::utilities::trim( line );
+
+      if( line.empty() || line.front() == '#' )
+        continue;
+
+      rows.push_back( parseRow<T>( line ) );
+    }
+
+    auto m     = rows.size();
+    bool dense = _distanceMatrixFormat == DistanceMatrixFormat::Dense;
+
+    if( _distanceMatrixFormat == DistanceMatrixFormat::Detect )
+    {
+      dense = m != 1 && std::all_of( rows.begin(), rows.end(),
+                                     [&m] ( const std::vector<T>& row )
+                                     {
+                                       return row.size() == m;
+                                     } );
+    }
+
+    if( dense )
+    {
+      math::SymmetricMatrix<T, I> D( static_cast<I>( m ) );
+
+      for( std::size_t i = 0; i < m; i++ )
+      {
+        if( rows[i].size() != m )
+          throw std::runtime_error( "Format error: dense matrix must be square" );
+      }
+
+      for( std::size_t i = 0; i < m; i++ )
+      {
+        for( std::size_t j = i; j < m; j++ )
+        {
+          if( rows[i][j] != rows[j][i] )
+            throw std::runtime_error( "Format error: distance matrix must be symmetric" );
+
+          D( static_cast<I>( i ), static_cast<I>( j ) ) = rows[i][j];
+        }
+      }
+
+      _height = m;
+      _width  = m;
+
+      M.swap( D );
+      return;
+    }
+
+    math::SymmetricMatrix<T, I> D( static_cast<I>( m + 1 ) );
+
+    for( std::size_t i = 0; i < m; i++ )
+    {
+      if( rows[i].size() != i + 1 )
+        throw std::runtime_error( "Format error: matrix must be dense or lower triangular" );
+
+      for( std::size_t j = 0; j <= i; j++ )
+        D( static_cast<I>( i + 1 ), static_cast<I>( j ) ) = rows[i][j];
+    }
+
+    _height = m + 1;
+    _width  = m + 1;
+
+    M.swap( D );
+  }
+
   /** @returns Height of matrix that was read last */
   std::size_t height() const noexcept { return _height; }
 
@@ -265,11 +386,65 @@ public:
     _addTriangles = value;
   }
 
+  /** Sets the format of distance matrices that are read subsequently */
+  void setDistanceMatrixFormat( DistanceMatrixFormat format ) noexcept
+  {
+    _distanceMatrixFormat = format;
+  }
+
+  /** @returns Current format of distance matrices */
+  DistanceMatrixFormat distanceMatrixFormat() const noexcept
+  {
+    return _distanceMatrixFormat;
+  }
+
 private:
+
+  /**
+    Parses a row of a distance matrix. In contrast to the more lenient
+    parsers of the other formats, every value has to be a valid number,
+    because a corrupt value would silently change the distances.
+  */
+
+  template <class T> static std::vector<T> parseRow( const std::string& line )
+  {
+    std::vector<T> row;
+
+    auto begin = line.begin();
+    auto end   = line.end();
+
+    while( begin != end )
+    {
+      if( aleph::utilities::isNumberSeparator( *begin ) )
+      {
+        ++begin;
+        continue;
+      }
+
+      auto first = begin;
+
+      while( begin != end && !aleph::utilities::isNumberSeparator( *begin ) )
+        ++begin;
+
+      std::string token( first, begin );
+      char* next = nullptr;
+      auto x     = aleph::utilities::toNumber<T>( token.c_str(), &next );
+
+      if( next != token.c_str() + token.size() )
+        throw std::runtime_error( "Format error: unable to convert '" + token + "' to a number" );
+
+      row.push_back( x );
+    }
+
+    return row;
+  }
+
   std::size_t _height = 0;
   std::size_t _width  = 0;
 
   bool _addTriangles  = true;
+
+  DistanceMatrixFormat _distanceMatrixFormat = DistanceMatrixFormat::Detect;
 };
 
 } // namespace io
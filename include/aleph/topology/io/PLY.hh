@@ -1,6 +1,8 @@
 #ifndef ALEPH_TOPOLOGY_IO_PLY_HH__
 #define ALEPH_TOPOLOGY_IO_PLY_HH__
 
+#include <aleph/containers/PointCloud.hh>
+
 #include <aleph/utilities/String.hh>
 
 #include <aleph/topology/Simplex.hh>
@@ -8,7 +10,10 @@
 
 #include <aleph/topology/filtrations/Data.hh>
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 
 #include <fstream>
 #include <limits>
@@ -84,9 +89,19 @@ union PLYValue
   unsigned char  uc;
 };
 
+/* @returns true if the machine stores values in little endian order */
+inline bool isLittleEndian()
+{
+  std::uint16_t value = 1;
+  unsigned char byte  = 0;
+
+  std::memcpy( &byte, &value, 1 );
+  return byte == 1;
+}
+
 /*
   Reads a single value from a binary input stream, reversing the storage
-  order if necessary.
+  order if it differs from the one of the machine.
 */
 
 template <class T> void readValue( std::ifstream& stream,
@@ -94,22 +109,54 @@ template <class T> void readValue( std::ifstream& stream,
                                    bool littleEndian,
                                    T* target )
 {
-  if( !littleEndian || bytes == 1 )
-    stream.read( reinterpret_cast<char*>( target ), static_cast<std::streamsize>( bytes ) );
-  else
-  {
-    char* buffer         = new char[bytes];
-    char* reversedBuffer = new char[bytes];
+  std::vector<char> buffer( bytes );
+  stream.read( buffer.data(), static_cast<std::streamsize>( bytes ) );
+
+  if( !stream )
+    throw std::runtime_error( "Unable to read binary value" );
 
-    stream.read( buffer, static_cast<std::streamsize>( bytes ) );
+  if( littleEndian != isLittleEndian() )
+    std::reverse( buffer.begin(), buffer.end() );
+
+  std::memcpy( target, buffer.data(), std::min( bytes, sizeof(T) ) );
+}
 
-    for( std::size_t i = 0; i < bytes; i++ )
-      reversedBuffer[i] = buffer[ bytes - 1 - i ];
+/*
+  Reads a single value of the given PLY data type from a binary input
+  stream and converts it to double.
+*/
 
-    std::copy( reversedBuffer, reversedBuffer + bytes, target );
+inline double readValue( std::ifstream& stream,
+                         const std::string& type,
+                         bool littleEndian )
+{
+  PLYValue pv;
+  auto bytes = TypeSizeMap.at( type );
 
-    delete[] reversedBuffer;
-    delete[] buffer;
+  if( type == "double" )
+  {
+    readValue( stream, bytes, littleEndian, &pv.d );
+    return pv.d;
+  }
+  else if( type == "float" )
+  {
+    readValue( stream, bytes, littleEndian, &pv.f );
+    return static_cast<double>( pv.f );
+  }
+  else if( bytes == 4 )
+  {
+    readValue( stream, bytes, littleEndian, &pv.u );
+    return TypeSignednessMap.at( type ) ? static_cast<double>( static_cast<std::int32_t>( pv.u ) ) : static_cast<double>( pv.u );
+  }
+  else if( bytes == 2 )
+  {
+    readValue( stream, bytes, littleEndian, &pv.us );
+    return TypeSignednessMap.at( type ) ? static_cast<double>( static_cast<std::int16_t>( pv.us ) ) : static_cast<double>( pv.us );
+  }
+  else
+  {
+    readValue( stream, bytes, littleEndian, &pv.uc );
+    return TypeSignednessMap.at( type ) ? static_cast<double>( static_cast<std::int8_t>( pv.uc ) ) : static_cast<double>( pv.uc );
   }
 }
 
@@ -134,6 +181,8 @@ public:
   struct PropertyDescriptor
   {
     std::string name;     // Property name (or list name)
+    std::string element;  // Name of the element the property belongs to
+    std::string type;     // Data type; only used for scalar properties
     unsigned index;       // Offset of attribute for ASCII data
     unsigned bytesOffset; // Offset of attribute for binary data
     unsigned bytes;       // Number of bytes
@@ -155,6 +204,8 @@ public:
 
   template <class SimplicialComplex> void operator()( std::ifstream& in, SimplicialComplex& K )
   {
+    _coordinates.clear();
+
     // Header ------------------------------------------------------------
     //
     // The header needs to consist of the word "ply", followed by a "format"
@@ -216,6 +267,8 @@ public:
     bool readingVertexProperties = false;
     bool readingFaceProperties   = false;
 
+    std::string currentElement;
+
     // Parse the rest of the header, taking care to skip any comment lines.
     do
     {
@@ -243,7 +296,8 @@ public:
         if( !converter )
           throw std::runtime_error( "Element conversion error: Expecting number of elements" );
 
-        name = utilities::trim( name );
+        name           = utilities::trim( name );
+        currentElement = name;
 
         if( name == "vertex" )
         {
@@ -272,8 +326,9 @@ public:
         dataType = utilities::trim( dataType );
         name     = utilities::trim( name );
 
-        PropertyDescriptor descriptor;
-        descriptor.index = propertyIndex;
+        PropertyDescriptor descriptor = PropertyDescriptor();
+        descriptor.index              = propertyIndex;
+        descriptor.element            = currentElement;
 
         // List of properties require a special handling. The syntax is
         // "property list SIZE_TYPE ENTRY_TYPE NAME", e.g. "property
@@ -299,6 +354,7 @@ public:
           descriptor.bytes       = detail::TypeSizeMap.at( dataType );
           descriptor.bytesOffset = propertyOffset;
           descriptor.name        = name;
+          descriptor.type        = dataType;
         }
 
         if( !converter )
@@ -359,6 +415,30 @@ public:
     _property = property;
   }
 
+  /**
+    @returns Coordinates of all vertices that have been read by the last
+    run of the reader. This permits using the mesh as a point cloud, e.g.
+    for calculating its alpha complex. The coordinates are available for
+    ASCII and binary files alike.
+  */
+
+  template <class T> containers::PointCloud<T> pointCloud() const
+  {
+    containers::PointCloud<T> pc( _coordinates.size(), 3 );
+
+    for( std::size_t i = 0; i < _coordinates.size(); i++ )
+    {
+      std::vector<T> p;
+
+      for( auto&& x : _coordinates[i] )
+        p.push_back( static_cast<T>( x ) );
+
+      pc.set( i, p.begin(), p.end() );
+    }
+
+    return pc;
+  }
+
 private:
 
   template <class Simplex> std::vector<Simplex> parseBinary( std::ifstream& in,
@@ -383,36 +463,25 @@ private:
 
     for( std::size_t vertexIndex = 0; vertexIndex < numVertices; vertexIndex++ )
     {
-      std::vector<double> coordinates;
+      std::vector<double> coordinates( 3 );
 
       for( auto&& descriptor : properties )
       {
         // Only faces may have lists for now...
-        if( descriptor.bytesListSize + descriptor.bytesListEntry != 0 )
+        if( descriptor.element != "vertex" || descriptor.bytesListSize + descriptor.bytesListEntry != 0 )
           continue;
 
-        detail::PLYValue pv;
+        auto value = detail::readValue( in, descriptor.type, littleEndian );
 
-        switch( descriptor.bytes )
-        {
-          case 8:
-            detail::readValue( in, descriptor.bytes, littleEndian, &pv.d );
-            break;
-          case 4:
-            detail::readValue( in, descriptor.bytes, littleEndian, &pv.f );
-            break;
-          case 2:
-            detail::readValue( in, descriptor.bytes, littleEndian, &pv.s );
-            break;
-          case 1:
-            detail::readValue( in, descriptor.bytes, littleEndian, &pv.c );
-            break;
-        }
-
-        // FIXME: Not sure whether this is legal...
-        if( descriptor.name == "x" || descriptor.name == "y" || descriptor.name == "z" )
-          coordinates.push_back( pv.d );
+        if( descriptor.name == "x" )
+          coordinates[0] = value;
+        else if( descriptor.name == "y" )
+          coordinates[1] = value;
+        else if( descriptor.name == "z" )
+          coordinates[2] = value;
       }
+
+      _coordinates.push_back( coordinates );
     }
 
     for( std::size_t faceIndex = 0; faceIndex < numVertices; faceIndex++ )
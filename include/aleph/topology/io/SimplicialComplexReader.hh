@@ -8,6 +8,10 @@
 #include <stdexcept>
 #include <vector>
 
+#include <aleph/topology/CompactSimplicialComplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/io/Binary.hh>
 #include <aleph/topology/io/EdgeLists.hh>
 #include <aleph/topology/io/GML.hh>
 #include <aleph/topology/io/HDF5.hh>
@@ -94,6 +98,18 @@ public:
     if( !in )
       throw std::runtime_error( "Unable to read input file" );
 
+    // Files in binary format are detected by their contents, regardless
+    // of their extension. Since they already contain weights, there is
+    // no need to use the functor.
+    if( BinaryReader::isBinary( filename ) )
+    {
+      BinaryReader reader;
+      reader( filename, K );
+
+      _labels = reader.labels();
+      return;
+    }
+
     auto extension = aleph::utilities::extension( filename );
 
     // The GML parser works more or less on its own and does not make
@@ -161,6 +177,52 @@ public:
     }
   }
 
+  /**
+    Reads a compact simplicial complex from a file. Files in binary
+    format are mapped into memory and used by the complex directly.
+    Since compact simplicial complexes are immutable, any other file is
+    read into a regular simplicial complex first, which is subsequently
+    converted.
+
+    @see SimplicialComplexReader::operator()( const std::string&, SimplicialComplex& )
+  */
+
+  template <class Simplex, class Weight, class Index> void operator()( const std::string& filename, CompactSimplicialComplex<Simplex, Weight, Index>& K )
+  {
+    if( BinaryReader::isBinary( filename ) )
+    {
+      BinaryReader reader;
+      reader( filename, K );
+
+      _labels = reader.labels();
+      return;
+    }
+
+    SimplicialComplex<Simplex> L;
+    this->operator()( filename, L );
+
+    K = CompactSimplicialComplex<Simplex, Weight, Index>( L );
+  }
+
+  /**
+    @overload operator()( const std::string&, CompactSimplicialComplex<Simplex, Weight, Index>& )
+    @see SimplicialComplexReader::operator()( const std::string&, SimplicialComplex&, Functor )
+  */
+
+  template <class Simplex, class Weight, class Index, class Functor> void operator()( const std::string& filename, CompactSimplicialComplex<Simplex, Weight, Index>& K, Functor functor )
+  {
+    if( BinaryReader::isBinary( filename ) )
+    {
+      this->operator()( filename, K );
+      return;
+    }
+
+    SimplicialComplex<Simplex> L;
+    this->operator()( filename, L, functor );
+
+    K = CompactSimplicialComplex<Simplex, Weight, Index>( L );
+  }
+
   /**
     Sets the attribute that is used to extract data values from input
     files. For PLY files, for example, this means using an  attribute
@@ -0,0 +1,390 @@
+#ifndef ALEPH_TOPOLOGY_REPRESENTATIONS_COMPRESSED_HH__
+#define ALEPH_TOPOLOGY_REPRESENTATIONS_COMPRESSED_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+namespace representations
+{
+
+/**
+  @class Compressed
+  @brief Memory-efficient column representation for large boundary matrices
+
+  This representation stores all columns of a boundary matrix in
+  a single contiguous arena of bytes. Each column is kept sorted in
+  *descending* order, with the first entry being stored verbatim and
+  all subsequent entries being stored as differences to their
+  predecessor. Every value is written as a variable-length integer
+  (LEB128), so that small deltas only require a single byte.
+
+  Since the first value of every column is its maximum index, pivot
+  lookups only need to decode a single integer. Column additions are
+  performed by decoding both columns on the fly and encoding their
+  symmetric difference into a scratch buffer, which is subsequently
+  written back to the arena. Columns that outgrow their slot in the
+  arena are moved to its end; the arena is compacted once too much
+  space has been wasted.
+
+  The representation is a drop-in replacement for the other ones in
+  this namespace, but it trades some speed for a memory footprint of
+  about one or two bytes per non-zero entry.
+*/
+
+template <class IndexType = unsigned> class Compressed
+{
+public:
+  using Index = IndexType;
+
+  void setNumColumns( Index numColumns )
+  {
+    _slots.resize( static_cast<std::size_t>( numColumns ) );
+    _dimensions.resize( static_cast<std::size_t>( numColumns ) );
+  }
+
+  Index getNumColumns() const
+  {
+    return static_cast<Index>( _slots.size() );
+  }
+
+  std::pair<Index, bool> getMaximumIndex( Index column ) const
+  {
+    auto&& slot = _slots.at( static_cast<std::size_t>( column ) );
+
+    if( slot.size == 0 )
+      return std::make_pair( Index(0), false );
+    else
+    {
+      const unsigned char* position = _arena.data() + slot.offset;
+      return std::make_pair( static_cast<Index>( decode( position ) ), true );
+    }
+  }
+
+  void addColumns( Index source, Index target )
+  {
+    auto&& sourceSlot = _slots.at( static_cast<std::size_t>( source ) );
+    auto&& targetSlot = _slots.at( static_cast<std::size_t>( target ) );
+
+    _buffer.clear();
+    _buffer.reserve( std::size_t( sourceSlot.size ) + std::size_t( targetSlot.size ) );
+
+    ColumnDecoder s( _arena.data() + sourceSlot.offset, sourceSlot.size );
+    ColumnDecoder t( _arena.data() + targetSlot.offset, targetSlot.size );
+
+    // Both columns are stored in descending order, so the symmetric
+    // difference can be calculated by a simple merge that discards
+    // all entries occurring in both columns.
+
+    ColumnEncoder encoder( _buffer );
+
+    while( s.valid() && t.valid() )
+    {
+      if( s.value() > t.value() )
+      {
+        encoder.push_back( s.value() );
+        s.next();
+      }
+      else if( t.value() > s.value() )
+      {
+        encoder.push_back( t.value() );
+        t.next();
+      }
+      else
+      {
+        s.next();
+        t.next();
+      }
+    }
+
+    for( ; s.valid(); s.next() )
+      encoder.push_back( s.value() );
+
+    for( ; t.valid(); t.next() )
+      encoder.push_back( t.value() );
+
+    this->store( static_cast<std::size_t>( target ) );
+  }
+
+  template <class InputIterator> void setColumn( Index column,
+                                                 InputIterator begin, InputIterator end )
+  {
+    std::vector<Index> values( begin, end );
+
+    // Ensures proper sorting order. Else, the reduction algorithm will
+    // not be able to reduce the matrix. Note that the sorting order is
+    // reversed in this representation, with the pivot coming first.
+    std::sort( values.begin(), values.end(), std::greater<Index>() );
+
+    _buffer.clear();
+
+    ColumnEncoder encoder( _buffer );
+
+    for( auto&& value : values )
+      encoder.push_back( static_cast<Value>( value ) );
+
+    this->store( static_cast<std::size_t>( column ) );
+
+    // Upon initialization, the column must by necessity have the dimension
+    // that is indicated by the amount of indices in its boundary. The case
+    // of 0-simplices needs special handling.
+    _dimensions.at( static_cast<std::size_t>( column ) )
+        = begin == end ? 0
+                       : static_cast<Index>( std::distance( begin, end ) - 1 );
+  }
+
+  std::vector<Index> getColumn( Index column ) const
+  {
+    auto&& slot = _slots.at( static_cast<std::size_t>( column ) );
+
+    std::vector<Index> result;
+
+    for( ColumnDecoder decoder( _arena.data() + slot.offset, slot.size ); decoder.valid(); decoder.next() )
+      result.push_back( static_cast<Index>( decoder.value() ) );
+
+    std::reverse( result.begin(), result.end() );
+    return result;
+  }
+
+  void clearColumn( Index column )
+  {
+    // The slot remains reserved for this column, so the column may be
+    // filled again later on without requiring additional memory.
+    _slots.at( static_cast<std::size_t>( column ) ).size = 0;
+  }
+
+  void setDimension( Index column, Index dimension )
+  {
+    _dimensions.at( static_cast<std::size_t>( column ) ) = dimension;
+  }
+
+  Index getDimension( Index column ) const
+  {
+    return _dimensions.at( static_cast<std::size_t>( column ) );
+  }
+
+  Index getDimension() const
+  {
+    if( _dimensions.empty() )
+      return Index(0);
+    else
+      return *std::max_element( _dimensions.begin(), _dimensions.end() );
+  }
+
+  /** @returns Number of bytes used by the arena, including unused slots */
+  std::size_t arenaSize() const
+  {
+    return _arena.size();
+  }
+
+  bool operator==( const Compressed& other ) const
+  {
+    if( _slots.size() != other._slots.size() || _dimensions != other._dimensions )
+      return false;
+
+    // The layout of the arena depends on the order of all previous
+    // operations, so only the contents of every column are compared.
+    for( std::size_t j = 0; j < _slots.size(); j++ )
+    {
+      auto&& s = _slots[j];
+      auto&& t = other._slots[j];
+
+      if( s.size != t.size )
+        return false;
+      else if( s.size != 0 && std::memcmp( _arena.data() + s.offset, other._arena.data() + t.offset, s.size ) != 0 )
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+
+  /** Unsigned type used for encoding values and deltas */
+  using Value = std::uint64_t;
+
+  /** Describes the position of a single column in the arena */
+  struct Slot
+  {
+    std::size_t   offset   = 0;
+    std::uint32_t size     = 0;
+    std::uint32_t capacity = 0;
+  };
+
+  /** Decodes a single variable-length integer and advances the position */
+  static Value decode( const unsigned char*& position )
+  {
+    Value value    = 0;
+    unsigned shift = 0;
+
+    while( *position & 0x80 )
+    {
+      value |= Value( *position++ & 0x7F ) << shift;
+      shift += 7;
+    }
+
+    value |= Value( *position++ ) << shift;
+    return value;
+  }
+
+  /** Encodes a single variable-length integer */
+  static void encode( Value value, std::vector<unsigned char>& out )
+  {
+    while( value >= 0x80 )
+    {
+      out.push_back( static_cast<unsigned char>( ( value & 0x7F ) | 0x80 ) );
+      value >>= 7;
+    }
+
+    out.push_back( static_cast<unsigned char>( value ) );
+  }
+
+  /** Sequential reader for a delta-encoded column */
+  class ColumnDecoder
+  {
+  public:
+    ColumnDecoder( const unsigned char* begin, std::uint32_t size )
+      : _position( begin )
+      , _end( begin + size )
+    {
+      if( _position != _end )
+      {
+        _value = decode( _position );
+        _valid = true;
+      }
+    }
+
+    bool valid() const noexcept { return _valid; }
+    Value value() const noexcept { return _value; }
+
+    void next()
+    {
+      if( _position != _end )
+        _value -= decode( _position );
+      else
+        _valid = false;
+    }
+
+  private:
+    const unsigned char* _position;
+    const unsigned char* _end;
+
+    Value _value = 0;
+    bool  _valid = false;
+  };
+
+  /** Sequential writer for a delta-encoded column */
+  class ColumnEncoder
+  {
+  public:
+    explicit ColumnEncoder( std::vector<unsigned char>& out )
+      : _out( out )
+    {
+    }
+
+    void push_back( Value value )
+    {
+      if( _first )
+      {
+        encode( value, _out );
+        _first = false;
+      }
+      else
+        encode( _previous - value, _out );
+
+      _previous = value;
+    }
+
+  private:
+    std::vector<unsigned char>& _out;
+
+    Value _previous = 0;
+    bool  _first    = true;
+  };
+
+  /**
+    Stores the contents of the scratch buffer in the slot of the given
+    column. If the slot is too small, the column is moved to the end of
+    the arena, and the arena is compacted if necessary.
+  */
+
+  void store( std::size_t column )
+  {
+    auto&& slot = _slots.at( column );
+    auto size   = static_cast<std::uint32_t>( _buffer.size() );
+
+    if( size > slot.capacity )
+    {
+      _wasted += slot.capacity;
+
+      // Leave some room for growth, as columns that have been extended
+      // once are likely to be extended again during the reduction.
+      slot.offset   = _arena.size();
+      slot.capacity = size + size / 4;
+
+      _arena.resize( _arena.size() + slot.capacity );
+    }
+
+    std::copy( _buffer.begin(), _buffer.end(), _arena.begin() + static_cast<std::ptrdiff_t>( slot.offset ) );
+    slot.size = size;
+
+    if( _wasted > _arena.size() / 2 && _wasted > minimumWaste )
+      this->compact();
+  }
+
+  /** Removes all unused space from the arena */
+  void compact()
+  {
+    std::vector<unsigned char> arena;
+    arena.reserve( _arena.size() - _wasted );
+
+    for( auto&& slot : _slots )
+    {
+      auto offset = arena.size();
+
+      arena.insert( arena.end(),
+                    _arena.begin() + static_cast<std::ptrdiff_t>( slot.offset ),
+                    _arena.begin() + static_cast<std::ptrdiff_t>( slot.offset + slot.capacity ) );
+
+      slot.offset = offset;
+    }
+
+    _arena.swap( arena );
+    _wasted = 0;
+  }
+
+  /** Amount of wasted bytes that is tolerated without compaction */
+  static constexpr std::size_t minimumWaste = std::size_t(1) << 20;
+
+  std::vector<unsigned char> _arena;
+  std::vector<Slot> _slots;
+  std::vector<Index> _dimensions;
+
+  /** Number of bytes in the arena that do not belong to any column */
+  std::size_t _wasted = 0;
+
+  /** Scratch buffer for encoding new columns; re-used to avoid allocations */
+  std::vector<unsigned char> _buffer;
+};
+
+template <class IndexType> constexpr std::size_t Compressed<IndexType>::minimumWaste;
+
+} // namespace representations
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef ALEPH_UTILITIES_MEMORY_MAPPED_FILE_HH__
+#define ALEPH_UTILITIES_MEMORY_MAPPED_FILE_HH__
+
+// Memory mapping is only available for POSIX systems. Other systems read
+// the complete file into memory instead, which is slower but results in
+// the same interface.
+#if defined(__unix__) || defined(__unix) || ( defined(__APPLE__) && defined(__MACH__) )
+  #define ALEPH_UTILITIES_MEMORY_MAPPING_AVAILABLE
+#endif
+
+#ifdef ALEPH_UTILITIES_MEMORY_MAPPING_AVAILABLE
+  #include <fcntl.h>
+  #include <unistd.h>
+
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+/**
+  @class MemoryMappedFile
+  @brief Maps the contents of a file into memory
+
+  Maps a file into memory so that its contents can be accessed without
+  reading or copying them. The mapping is *private*, i.e. modifications
+  of the mapped memory are permitted but never written back to the file.
+  Pages of the file are only read upon the first access, which makes it
+  possible to work with files that are larger than the main memory.
+*/
+
+class MemoryMappedFile
+{
+public:
+
+  /**
+    Maps a file into memory.
+
+    @param filename Name of the file to map
+
+    @throws std::runtime_error if the file cannot be opened or mapped
+  */
+
+  explicit MemoryMappedFile( const std::string& filename )
+    : _data( nullptr )
+    , _size( 0 )
+    , _mapped( false )
+  {
+#ifdef ALEPH_UTILITIES_MEMORY_MAPPING_AVAILABLE
+    int fd = ::open( filename.c_str(), O_RDONLY );
+
+    if( fd < 0 )
+      throw std::runtime_error( "Unable to open file '" + filename + "'" );
+
+    struct stat info;
+
+    if( ::fstat( fd, &info ) != 0 )
+    {
+      ::close( fd );
+      throw std::runtime_error( "Unable to determine size of file '" + filename + "'" );
+    }
+
+    _size = static_cast<std::size_t>( info.st_size );
+
+    // Empty files cannot be mapped, but they do not require any memory
+    // either.
+    if( _size > 0 )
+    {
+      void* data = ::mmap( nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+
+      if( data == MAP_FAILED )
+      {
+        ::close( fd );
+        throw std::runtime_error( "Unable to map file '" + filename + "'" );
+      }
+
+      _data   = static_cast<char*>( data );
+      _mapped = true;
+    }
+
+    // The mapping remains valid after closing the file descriptor
+    ::close( fd );
+#else
+    std::ifstream in( filename, std::ios::binary | std::ios::ate );
+
+    if( !in )
+      throw std::runtime_error( "Unable to open file '" + filename + "'" );
+
+    _size = static_cast<std::size_t>( in.tellg() );
+    _buffer.resize( _size );
+
+    in.seekg( 0 );
+    in.read( _buffer.data(), static_cast<std::streamsize>( _size ) );
+
+    _data = _size > 0 ? _buffer.data() : nullptr;
+#endif
+  }
+
+  /**
+    Creates a file of a given size, or truncates an existing one, and maps
+    it into memory. In contrast to the other constructor, the mapping is
+    *shared*, i.e. modifications of the mapped memory are written back to
+    the file. This makes it possible to create data structures that are
+    larger than the main memory.
+
+    @param filename Name of the file to create
+    @param size     Size of the file in bytes
+
+    @throws std::runtime_error if the file cannot be created or mapped
+  */
+
+  MemoryMappedFile( const std::string& filename, std::size_t size )
+    : _data( nullptr )
+    , _size( size )
+    , _mapped( false )
+  {
+#ifdef ALEPH_UTILITIES_MEMORY_MAPPING_AVAILABLE
+    int fd = ::open( filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+
+    if( fd < 0 )
+      throw std::runtime_error( "Unable to create file '" + filename + "'" );
+
+    if( ::ftruncate( fd, static_cast<off_t>( _size ) ) != 0 )
+    {
+      ::close( fd );
+      throw std::runtime_error( "Unable to resize file '" + filename + "'" );
+    }
+
+    if( _size > 0 )
+    {
+      void* data = ::mmap( nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+
+      if( data == MAP_FAILED )
+      {
+        ::close( fd );
+        throw std::runtime_error( "Unable to map file '" + filename + "'" );
+      }
+
+      _data   = static_cast<char*>( data );
+      _mapped = true;
+    }
+
+    ::close( fd );
+#else
+    std::ofstream out( filename, std::ios::binary );
+
+    if( !out )
+      throw std::runtime_error( "Unable to create file '" + filename + "'" );
+
+    _buffer.resize( _size );
+    _data     = _size > 0 ? _buffer.data() : nullptr;
+    _filename = filename;
+#endif
+  }
+
+  ~MemoryMappedFile()
+  {
+#ifdef ALEPH_UTILITIES_MEMORY_MAPPING_AVAILABLE
+    if( _mapped )
+      ::munmap( _data, _size );
+#else
+    // Without memory mapping, modifications of a file created by this
+    // class have to be written explicitly.
+    if( !_filename.empty() )
+    {
+      std::ofstream out( _filename, std::ios::binary );
+      out.write( _buffer.data(), static_cast<std::streamsize>( _size ) );
+    }
+#endif
+  }
+
+  MemoryMappedFile( const MemoryMappedFile& )            = delete;
+  MemoryMappedFile& operator=( const MemoryMappedFile& ) = delete;
+
+  /** @returns Pointer to the contents of the file */
+  char* data() const noexcept
+  {
+    return _data;
+  }
+
+  /** @returns Size of the file in bytes */
+  std::size_t size() const noexcept
+  {
+    return _size;
+  }
+
+  /**
+    @returns true if the file has been mapped into memory, or false if it
+    has been read because memory mapping is not available
+  */
+
+  bool mapped() const noexcept
+  {
+    return _mapped;
+  }
+
+private:
+  char* _data;
+  std::size_t _size;
+  bool _mapped;
+
+  // Only used if memory mapping is not available
+  std::vector<char> _buffer;
+  std::string _filename;
+};
+
+} // namespace utilities
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef ALEPH_UTILITIES_PARALLEL_SORT_HH__
+#define ALEPH_UTILITIES_PARALLEL_SORT_HH__
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+/**
+  Sorts a range in parallel while preserving the relative order of all
+  equivalent elements, i.e. the sort is *stable*. The range is split
+  into one chunk per thread, all chunks are sorted independently, and
+  the sorted chunks are merged pairwise afterwards. Without OpenMP, or
+  for small ranges, this falls back to std::stable_sort().
+
+  The comparison functor is shared among all threads and must thus be
+  safe to call concurrently. This is the case for all filtrations that
+  are provided by Aleph.
+
+  @param begin      Iterator to begin of range
+  @param end        Iterator to end of range
+  @param comparison Comparison functor
+*/
+
+template <class RandomAccessIterator, class Comparison> void parallelSort( RandomAccessIterator begin,
+                                                                           RandomAccessIterator end,
+                                                                           Comparison&& comparison )
+{
+  using DifferenceType = typename std::iterator_traits<RandomAccessIterator>::difference_type;
+
+  // Ranges smaller than this do not profit from being sorted in parallel
+  // because the threads spend more time on merging than on sorting.
+  DifferenceType minimumSize = 1 << 14;
+
+  auto n = std::distance( begin, end );
+
+#ifdef _OPENMP
+  auto numChunks = static_cast<DifferenceType>( omp_get_max_threads() );
+#else
+  auto numChunks = DifferenceType(1);
+#endif
+
+  if( numChunks <= 1 || n < minimumSize )
+  {
+    std::stable_sort( begin, end, std::ref( comparison ) );
+    return;
+  }
+
+  std::vector<DifferenceType> boundaries;
+  boundaries.reserve( static_cast<std::size_t>( numChunks + 1 ) );
+
+  for( DifferenceType i = 0; i <= numChunks; i++ )
+    boundaries.push_back( n * i / numChunks );
+
+#ifdef _OPENMP
+  #pragma omp parallel for
+#endif
+  for( DifferenceType i = 0; i < numChunks; i++ )
+  {
+    std::stable_sort( begin + boundaries[ static_cast<std::size_t>( i )   ],
+                      begin + boundaries[ static_cast<std::size_t>( i+1 ) ],
+                      std::ref( comparison ) );
+  }
+
+  // Merge neighbouring chunks until only a single one remains. Since
+  // std::inplace_merge() is stable, so is the whole sort.
+  for( DifferenceType width = 1; width < numChunks; width *= 2 )
+  {
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for( DifferenceType i = 0; i < numChunks; i += 2 * width )
+    {
+      auto middle = std::min( i + width,     numChunks );
+      auto last   = std::min( i + 2 * width, numChunks );
+
+      if( middle < last )
+      {
+        std::inplace_merge( begin + boundaries[ static_cast<std::size_t>( i )      ],
+                            begin + boundaries[ static_cast<std::size_t>( middle ) ],
+                            begin + boundaries[ static_cast<std::size_t>( last )   ],
+                            std::ref( comparison ) );
+      }
+    }
+  }
+}
+
+} // namespace utilities
+
+} // namespace aleph
+
+#endif
@@ -16,6 +16,9 @@
 #include <vector>
 
 #include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 
 namespace aleph
 {
@@ -186,6 +189,106 @@ template <class T, class S> T convert( const S& sequence )
   return convert<T>( sequence, success );
 }
 
+/**
+  Converts a terminated string to a number by using the conversion
+  functions of the C library. In contrast to streams, these functions
+  do not require any memory allocations, and they already handle special
+  values such as infinity.
+
+  @param string Terminated string
+  @param end    Set to the first character that is not part of the number
+
+  @returns Result of the conversion
+*/
+
+template <class T> T toNumber( const char* string, char** end )
+{
+  return static_cast<T>( std::strtod( string, end ) );
+}
+
+/** @overload toNumber() */
+template <> inline float toNumber<float>( const char* string, char** end )
+{
+  return std::strtof( string, end );
+}
+
+/** @overload toNumber() */
+template <> inline long double toNumber<long double>( const char* string, char** end )
+{
+  return std::strtold( string, end );
+}
+
+/** Checks whether a character separates two numbers in a sequence of numbers */
+inline bool isNumberSeparator( char c ) noexcept
+{
+  return c == ':' || c == ';' || c == ',' || std::isspace( static_cast<unsigned char>( c ) );
+}
+
+/**
+  Parses a sequence of numbers that are separated by commas, colons,
+  semicolons, or whitespace characters. The sequence does not need to
+  be terminated, which permits parsing the contents of memory-mapped
+  files directly. Invalid numbers are set to zero, which is consistent
+  with convert().
+
+  @param begin  Pointer to the first character of the sequence
+  @param end    Pointer after the last character of the sequence
+  @param result Output pointer for the numbers; if this is a null
+  pointer, the numbers are only counted
+
+  @returns Number of numbers in the sequence
+*/
+
+template <class T> std::size_t parseNumbers( const char* begin, const char* end, T* result )
+{
+  std::size_t count = 0;
+
+  while( begin != end )
+  {
+    if( isNumberSeparator( *begin ) )
+    {
+      ++begin;
+      continue;
+    }
+
+    auto token = begin;
+
+    while( begin != end && !isNumberSeparator( *begin ) )
+      ++begin;
+
+    if( result )
+    {
+      // The token is copied into a terminated buffer because the C
+      // library functions would otherwise read beyond its end.
+      auto length = static_cast<std::size_t>( begin - token );
+
+      std::string buffer;
+      char local[64];
+      char* first = local;
+
+      if( length < sizeof(local) )
+      {
+        std::memcpy( local, token, length );
+        local[length] = '\0';
+      }
+      else
+      {
+        buffer.assign( token, length );
+        first = &buffer[0];
+      }
+
+      char* next = nullptr;
+      auto x     = toNumber<T>( first, &next );
+
+      *result++ = next == first ? T() : x;
+    }
+
+    ++count;
+  }
+
+  return count;
+}
+
 } // namespace utilities
 
 } // namespace aleph
@@ -133,8 +133,25 @@ int main( int argc, char** argv )
 
   ct.print( std::cerr );
 
+  std::vector<double> rootDistances;
+  std::vector<double> edgeDistances;
+
   for( auto&& p : points )
-    ct.checkDistance( p );
+  {
+    ct.pathDistances( p, rootDistances, edgeDistances );
+
+    std::cerr << "Point = " << p << "\n";
+
+    std::cerr << "  root distances:\n";
+    for( auto&& d : rootDistances )
+      std::cerr << d << " ";
+    std::cerr << "\n";
+
+    std::cerr << "  edge distances:\n";
+    for( auto&& d : edgeDistances )
+      std::cerr << d << " ";
+    std::cerr << "\n";
+  }
 
   //for( auto&& p : points )
   //{
@@ -3,6 +3,7 @@
 #include <aleph/config/FLANN.hh>
 
 #include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/DistanceMatrix.hh>
 #include <aleph/geometry/FLANN.hh>
 
 #include <aleph/geometry/distances/Euclidean.hh>
@@ -30,23 +31,19 @@ template <class Distance> std::vector<DataType> pairwiseDistances( const PointCl
   std::vector<DataType> distances;
   distances.reserve( pointCloud.size() * ( pointCloud.size() - 1 ) / 2 );
 
-  auto d       = pointCloud.dimension();
-  auto n       = pointCloud.size();
-  using Traits = aleph::geometry::distances::Traits<Distance>;
+  // The distance matrix already contains the actual distances, i.e. the
+  // traits of the distance functor have been applied.
+  auto n = pointCloud.size();
+  auto M = aleph::geometry::distanceMatrix( pointCloud, distance );
 
-  Traits traits;
   for( decltype(n) i = 0; i < n; i++ )
   {
     for( decltype(n) j = i+1; j < n; j++ )
     {
-      auto dist = distance( pointCloud[i].begin(),
-                            pointCloud[j].begin(),
-                            d );
-
       // I want to be sure that I get the *square* of the distance, but
       // I cannot take this transformation within the distance functor,
       // such as the Manhattan distance, for granted.
-      dist      = traits.from( dist );
+      auto dist = M(i,j);
       dist     *= dist;
 
       distances.emplace_back( dist );
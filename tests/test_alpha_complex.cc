@@ -0,0 +1,349 @@
+#include <tests/Base.hh>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/AlphaComplex.hh>
+#include <aleph/geometry/CechComplex.hh>
+#include <aleph/geometry/DelaunayTriangulation.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+
+#include <aleph/topology/io/PLY.hh>
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cmath>
+#include <cstring>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+
+template <class T> PointCloud<T> randomPointCloud( std::size_t n, std::size_t d, unsigned seed )
+{
+  std::mt19937 rng( seed );
+  std::uniform_real_distribution<T> distribution( T(0), T(1) );
+
+  PointCloud<T> pc( n, d );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    std::vector<T> p( d );
+    std::generate( p.begin(), p.end(), [&] () { return distribution( rng ); } );
+
+    pc.set( i, p.begin(), p.end() );
+  }
+
+  return pc;
+}
+
+/** @returns Euler characteristic of a simplicial complex */
+template <class SimplicialComplex> long eulerCharacteristic( const SimplicialComplex& K )
+{
+  long chi = 0;
+
+  for( auto&& s : K )
+    chi += s.dimension() % 2 == 0 ? 1 : -1;
+
+  return chi;
+}
+
+/** Checks that the circumsphere of every cell is empty */
+template <std::size_t D> void checkDelaunayProperty( const DelaunayTriangulation<D>& T )
+{
+  for( auto&& cell : T.cells() )
+  {
+    std::vector<const double*> points;
+    for( auto&& v : cell )
+      points.push_back( T.point( v ) );
+
+    std::vector<long double> centre;
+    auto r = detail::circumsphere( points, D, centre );
+
+    for( std::size_t i = 0; i < T.size(); i++ )
+      ALEPH_ASSERT_THROW( detail::squaredDistance( T.point(i), centre ) >= r * ( 1 - 1e-9 ) );
+  }
+}
+
+/** Checks that the persistence diagrams of two complexes coincide in the given dimensions */
+template <class SimplicialComplex> void checkDiagrams( const SimplicialComplex& K, const SimplicialComplex& L, std::size_t dimension )
+{
+  using DataType = typename SimplicialComplex::ValueType::DataType;
+
+  auto D1 = calculatePersistenceDiagrams( K );
+  auto D2 = calculatePersistenceDiagrams( L );
+
+  for( std::size_t d = 0; d <= dimension; d++ )
+  {
+    std::vector< std::pair<DataType, DataType> > P1;
+    std::vector< std::pair<DataType, DataType> > P2;
+
+    if( d < D1.size() )
+    {
+      D1[d].removeDiagonal();
+
+      for( auto&& p : D1[d] )
+        P1.push_back( std::make_pair( p.x(), p.y() ) );
+    }
+
+    if( d < D2.size() )
+    {
+      D2[d].removeDiagonal();
+
+      for( auto&& p : D2[d] )
+        P2.push_back( std::make_pair( p.x(), p.y() ) );
+    }
+
+    // Round-off errors may result in tiny features
+    auto isSmall = [] ( const std::pair<DataType, DataType>& p )
+    {
+      return std::abs( p.second - p.first ) < DataType( 1e-4 );
+    };
+
+    P1.erase( std::remove_if( P1.begin(), P1.end(), isSmall ), P1.end() );
+    P2.erase( std::remove_if( P2.begin(), P2.end(), isSmall ), P2.end() );
+
+    std::sort( P1.begin(), P1.end() );
+    std::sort( P2.begin(), P2.end() );
+
+    ALEPH_ASSERT_EQUAL( P1.size(), P2.size() );
+
+    for( std::size_t i = 0; i < P1.size(); i++ )
+    {
+      ALEPH_ASSERT_THROW( std::abs( P1[i].first - P2[i].first ) < DataType( 1e-4 ) );
+      ALEPH_ASSERT_THROW( P1[i].second == P2[i].second || std::abs( P1[i].second - P2[i].second ) < DataType( 1e-4 ) );
+    }
+  }
+}
+
+template <class T> void testCech()
+{
+  ALEPH_TEST_BEGIN( "Alpha complex: comparison with Čech complex" );
+
+  {
+    auto pc = randomPointCloud<T>( 40, 2, 23 );
+    auto K  = buildAlphaComplex( pc );
+    auto L  = buildCechComplex( pc, T(2), 2 );
+
+    ALEPH_ASSERT_THROW( K.size() < L.size() );
+    ALEPH_ASSERT_EQUAL( eulerCharacteristic( K ), 1 );
+
+    checkDiagrams( K, L, 1 );
+  }
+
+  {
+    auto pc = randomPointCloud<T>( 25, 3, 42 );
+    auto K  = buildAlphaComplex( pc );
+    auto L  = buildCechComplex( pc, T(2), 3 );
+
+    ALEPH_ASSERT_THROW( K.size() < L.size() );
+    ALEPH_ASSERT_EQUAL( eulerCharacteristic( K ), 1 );
+
+    checkDiagrams( K, L, 2 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <std::size_t D> void testDelaunay()
+{
+  ALEPH_TEST_BEGIN( "Delaunay triangulation" );
+
+  auto pc = randomPointCloud<double>( 2000, D, 7 );
+
+  DelaunayTriangulation<D> T( pc );
+
+  ALEPH_ASSERT_EQUAL( T.size(), pc.size() );
+  ALEPH_ASSERT_THROW( T.duplicates().empty() );
+
+  checkDelaunayProperty( T );
+
+  auto K = buildAlphaComplex( pc );
+
+  ALEPH_ASSERT_EQUAL( eulerCharacteristic( K ), 1 );
+  ALEPH_ASSERT_EQUAL( K.dimension(), D );
+
+  // Faces have to precede their cofaces
+  for( std::size_t i = 0; i < K.size(); i++ )
+  {
+    auto&& s = K.at(i);
+    for( std::size_t j = 0; j < s.boundarySize(); j++ )
+      ALEPH_ASSERT_THROW( K.index( s.face(j) ) < i );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testDegenerateInputs()
+{
+  ALEPH_TEST_BEGIN( "Alpha complex: degenerate inputs" );
+
+  // Grids contain many co-circular points, so their triangulation is not
+  // unique. Every triangulation has the same number of triangles, though.
+  {
+    PointCloud<double> pc( 25, 2 );
+
+    for( std::size_t i = 0; i < 5; i++ )
+      for( std::size_t j = 0; j < 5; j++ )
+        pc.set( 5*i+j, { double(i), double(j) } );
+
+    DelaunayTriangulation<2> T( pc );
+
+    ALEPH_ASSERT_EQUAL( T.cells().size(), 32 );
+
+    auto K  = buildAlphaComplex( pc );
+    auto D  = calculatePersistenceDiagrams( K );
+
+    ALEPH_ASSERT_EQUAL( eulerCharacteristic( K ), 1 );
+    ALEPH_ASSERT_EQUAL( D.front().betti(), 1 );
+  }
+
+  // Copies of points must not create additional connected components
+  {
+    auto pc = randomPointCloud<double>( 20, 3, 11 );
+    auto qc = pc + pc;
+
+    DelaunayTriangulation<3> T( qc );
+
+    ALEPH_ASSERT_EQUAL( T.duplicates().size(), 20 );
+
+    auto K = buildAlphaComplex( qc );
+    auto D = calculatePersistenceDiagrams( K );
+
+    ALEPH_ASSERT_EQUAL( eulerCharacteristic( K ), 1 );
+    ALEPH_ASSERT_EQUAL( D.front().betti(), 1 );
+  }
+
+  {
+    PointCloud<double> pc( 10, 2 );
+
+    for( std::size_t i = 0; i < pc.size(); i++ )
+      pc.set( i, { double(i), double(2*i) } );
+
+    ALEPH_EXPECT_EXCEPTION( buildAlphaComplex( pc ), std::runtime_error );
+    ALEPH_EXPECT_EXCEPTION( buildAlphaComplex( randomPointCloud<double>( 10, 4, 1 ) ), std::runtime_error );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testPLY()
+{
+  ALEPH_TEST_BEGIN( "Alpha complex: PLY files" );
+
+  std::string filename = "/tmp/Tetrahedron.ply";
+
+  {
+    std::ofstream out( filename );
+
+    out << "ply\n"
+        << "format ascii 1.0\n"
+        << "element vertex 5\n"
+        << "property float x\n"
+        << "property float y\n"
+        << "property float z\n"
+        << "element face 4\n"
+        << "property list uchar int vertex_indices\n"
+        << "end_header\n"
+        << "0 0 0\n"
+        << "1 0 0\n"
+        << "0 1 0\n"
+        << "0 0 1\n"
+        << "0.2 0.2 0.2\n"
+        << "3 0 1 2\n"
+        << "3 0 1 3\n"
+        << "3 0 2 3\n"
+        << "3 1 2 3\n";
+  }
+
+  using Simplex           = topology::Simplex<double, unsigned>;
+  using SimplicialComplex = topology::SimplicialComplex<Simplex>;
+
+  SimplicialComplex M;
+
+  topology::io::PLYReader reader;
+  reader( filename, M );
+
+  auto pc = reader.pointCloud<double>();
+
+  ALEPH_ASSERT_EQUAL( pc.size(), 5 );
+  ALEPH_ASSERT_EQUAL( pc.dimension(), 3 );
+
+  auto K = buildAlphaComplex( pc );
+
+  // The interior point splits the tetrahedron into four tetrahedra
+  auto tetrahedra = std::count_if( K.begin(), K.end(), [] ( const typename decltype(K)::ValueType& s ) { return s.dimension() == 3; } );
+
+  ALEPH_ASSERT_EQUAL( tetrahedra, 4 );
+  ALEPH_ASSERT_EQUAL( eulerCharacteristic( K ), 1 );
+
+  // Binary files replace the vertices of the previous run; the values
+  // are stored in big endian order, regardless of the machine.
+  {
+    std::ofstream out( filename, std::ios::binary );
+
+    out << "ply\n"
+        << "format binary_big_endian 1.0\n"
+        << "element vertex 2\n"
+        << "property float x\n"
+        << "property float y\n"
+        << "property uchar intensity\n"
+        << "property double z\n"
+        << "element face 1\n"
+        << "property list uchar int vertex_indices\n"
+        << "end_header\n";
+
+    auto write = [&out] ( const void* value, std::size_t bytes )
+    {
+      std::vector<char> buffer( bytes );
+      std::memcpy( buffer.data(), value, bytes );
+
+      if( topology::io::detail::isLittleEndian() )
+        std::reverse( buffer.begin(), buffer.end() );
+
+      out.write( buffer.data(), static_cast<std::streamsize>( bytes ) );
+    };
+
+    for( unsigned i = 0; i < 2; i++ )
+    {
+      float x                 = 1.5f + float(i);
+      float y                 = -2.0f;
+      unsigned char intensity = 255;
+      double z                = 0.25 * double(i);
+
+      write( &x, sizeof(x) );
+      write( &y, sizeof(y) );
+      write( &intensity, sizeof(intensity) );
+      write( &z, sizeof(z) );
+    }
+  }
+
+  reader( filename, M );
+  pc = reader.pointCloud<double>();
+
+  ALEPH_ASSERT_EQUAL( pc.size(), 2 );
+  auto p = pc.point( 0 );
+  auto q = pc.point( 1 );
+
+  ALEPH_ASSERT_THROW( std::vector<double>( p.begin(), p.end() ) == std::vector<double>( { 1.5, -2.0, 0.0  } ) );
+  ALEPH_ASSERT_THROW( std::vector<double>( q.begin(), q.end() ) == std::vector<double>( { 2.5, -2.0, 0.25 } ) );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testCech<double>();
+  testCech<float> ();
+
+  testDelaunay<2>();
+  testDelaunay<3>();
+
+  testDegenerateInputs();
+  testPLY();
+}
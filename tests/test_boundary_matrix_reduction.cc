@@ -1,15 +1,18 @@
 #include <tests/Base.hh>
 
 #include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/Instrumentation.hh>
 #include <aleph/persistentHomology/algorithms/Standard.hh>
 #include <aleph/persistentHomology/algorithms/Twist.hh>
 
 #include <aleph/topology/BoundaryMatrix.hh>
 
+#include <aleph/topology/representations/Compressed.hh>
 #include <aleph/topology/representations/Set.hh>
 #include <aleph/topology/representations/Vector.hh>
 
 #include <algorithm>
+#include <sstream>
 #include <vector>
 
 template <class T> void testNonSquare()
@@ -242,14 +245,74 @@ template <class T> void setupBoundaryMatrix()
 
   ALEPH_TEST_BEGIN( "Boundary matrix setup & loading" );
 
-  using Set    = Set<T>;
-  using Vector = Vector<T>;
+  using Compressed = Compressed<T>;
+  using Set        = Set<T>;
+  using Vector     = Vector<T>;
 
   auto m1 = BoundaryMatrix<Set>::load( CMAKE_SOURCE_DIR + std::string( "/tests/input/Triangle.txt" ) );
   auto m2 = BoundaryMatrix<Vector>::load( CMAKE_SOURCE_DIR + std::string( "/tests/input/Triangle.txt" ) );
+  auto m3 = BoundaryMatrix<Compressed>::load( CMAKE_SOURCE_DIR + std::string( "/tests/input/Triangle.txt" ) );
 
   reduceBoundaryMatrix( m1 );
   reduceBoundaryMatrix( m2 );
+  reduceBoundaryMatrix( m3 );
+
+  for( T j = 0; j < m2.getNumColumns(); j++ )
+    ALEPH_ASSERT_THROW( m2.getColumn(j) == m3.getColumn(j) );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testInstrumentation()
+{
+  ALEPH_TEST_BEGIN( "Boundary matrix reduction instrumentation" );
+
+  using namespace aleph;
+  using namespace topology;
+  using namespace representations;
+
+  using namespace persistentHomology::algorithms;
+  using namespace persistentHomology::instrumentation;
+
+  using Matrix = BoundaryMatrix< Vector<T> >;
+
+  auto M = Matrix::load( CMAKE_SOURCE_DIR + std::string( "/tests/input/Triangle.txt" ) );
+
+  Statistics standardStatistics;
+  Statistics twistStatistics;
+  Statistics dualStatistics;
+
+  auto pairing1 = calculatePersistencePairing<Standard>( M, standardStatistics );
+  auto pairing2 = calculatePersistencePairing<Twist>( M, twistStatistics );
+  auto pairing3 = calculatePersistencePairing<Twist>( M.dualize(), dualStatistics );
+
+  ALEPH_ASSERT_THROW( pairing1 == calculatePersistencePairing<Standard>( M ) );
+  ALEPH_ASSERT_THROW( pairing1 == pairing2 );
+  ALEPH_ASSERT_THROW( pairing1 == pairing3 );
+
+  for( auto&& statistics : { standardStatistics, twistStatistics, dualStatistics } )
+  {
+    ALEPH_ASSERT_EQUAL( statistics.dimensions().size(), 3 );
+    ALEPH_ASSERT_EQUAL( statistics.dimensions().at(0).columns, 3 );
+    ALEPH_ASSERT_EQUAL( statistics.dimensions().at(1).columns, 3 );
+    ALEPH_ASSERT_EQUAL( statistics.dimensions().at(2).columns, 1 );
+    ALEPH_ASSERT_EQUAL( statistics.total().columns, 7 );
+    ALEPH_ASSERT_EQUAL( statistics.phases().size(), 3 );
+  }
+
+  // The standard algorithm has to reduce the last edge to zero, whereas
+  // the twist algorithm clears it because it is paired with the triangle.
+  // Moreover, the two vertices paired with edges are cleared.
+  ALEPH_ASSERT_EQUAL( standardStatistics.total().cleared, 0 );
+  ALEPH_ASSERT_EQUAL( twistStatistics.total().cleared, 3 );
+  ALEPH_ASSERT_EQUAL( twistStatistics.dimensions().at(0).cleared, 2 );
+  ALEPH_ASSERT_EQUAL( twistStatistics.dimensions().at(1).cleared, 1 );
+  ALEPH_ASSERT_THROW( standardStatistics.total().additions > twistStatistics.total().additions );
+
+  std::ostringstream stream;
+  writeJSON( stream, twistStatistics );
+
+  ALEPH_ASSERT_THROW( stream.str().find( "\"reduction\"" ) != std::string::npos );
 
   ALEPH_TEST_END();
 }
@@ -265,4 +328,7 @@ int main()
   testNonSquare<long>         ();
   testNonSquare<unsigned int> ();
   testNonSquare<unsigned long>();
+
+  testInstrumentation<unsigned>();
+  testInstrumentation<long>    ();
 }
@@ -4,6 +4,8 @@
 
 #include <aleph/geometry/CechComplex.hh>
 
+#include <aleph/math/Combinations.hh>
+
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
@@ -11,11 +13,18 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
+#include <numeric>
+#include <random>
 #include <set>
 #include <vector>
 
 #include <cmath>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 using namespace aleph::containers;
 using namespace aleph::geometry;
 using namespace aleph::topology;
@@ -41,8 +50,118 @@ template <class T> void triangle()
   ALEPH_TEST_END();
 }
 
+/**
+  Calculates all simplices of the Čech complex by checking every subset
+  of the point cloud. This is only feasible for very small inputs.
+*/
+
+template <class T> std::map<std::vector<std::size_t>, T> cechSimplices( const PointCloud<T>& pc, T r )
+{
+  std::vector<std::size_t> vertices( pc.size() );
+  std::iota( vertices.begin(), vertices.end(), std::size_t(0) );
+
+  std::map<std::vector<std::size_t>, T> simplices;
+
+  using DifferenceType = typename decltype(vertices)::difference_type;
+  using Iterator       = typename decltype(vertices)::const_iterator;
+
+  for( std::size_t k = 2; k <= pc.size(); k++ )
+  {
+    math::for_each_combination( vertices.begin(), vertices.begin() + DifferenceType(k), vertices.end(),
+      [&pc, &simplices, &r] ( Iterator first, Iterator last )
+      {
+        std::vector< std::vector<T> > points;
+        for( Iterator it = first; it != last; ++it )
+          points.push_back( pc[ *it ] );
+
+        using PointIterator      = typename decltype(points)::const_iterator;
+        using CoordinateIterator = typename std::vector<T>::const_iterator;
+        using Miniball           = Miniball::Miniball< Miniball::CoordAccessor<PointIterator, CoordinateIterator> >;
+
+        Miniball mb( static_cast<int>( pc.dimension() ), points.begin(), points.end() );
+        if( mb.squared_radius() <= r * r )
+          simplices[ std::vector<std::size_t>( first, last ) ] = T( 2 * std::sqrt( mb.squared_radius() ) );
+
+        return false;
+      }
+    );
+  }
+
+  return simplices;
+}
+
+template <class T> void randomPointClouds()
+{
+  ALEPH_TEST_BEGIN( "Random point clouds" );
+
+  std::mt19937 rng( 42 );
+  std::uniform_real_distribution<T> distribution( T(0), T(1) );
+
+  for( std::size_t d : { 2, 3 } )
+  {
+    PointCloud<T> pc( 14, d );
+
+    for( std::size_t i = 0; i < pc.size(); i++ )
+    {
+      std::vector<T> p( d );
+      std::generate( p.begin(), p.end(), [&] () { return distribution( rng ); } );
+
+      pc.set( i, p.begin(), p.end() );
+    }
+
+    for( auto r : { T(0.2), T(0.35), T(0.5) } )
+    {
+      auto expected = cechSimplices( pc, r );
+
+      for( int numThreads : { 1, 3 } )
+      {
+#ifdef _OPENMP
+        omp_set_num_threads( numThreads );
+#else
+        (void) numThreads;
+#endif
+
+        auto K = buildCechComplex( pc, r );
+
+        ALEPH_ASSERT_EQUAL( K.size(), expected.size() + pc.size() );
+
+        for( auto&& s : K )
+        {
+          if( s.dimension() == 0 )
+            continue;
+
+          std::vector<std::size_t> vertices( s.begin(), s.end() );
+          std::sort( vertices.begin(), vertices.end() );
+
+          ALEPH_ASSERT_THROW( expected.find( vertices ) != expected.end() );
+          ALEPH_ASSERT_THROW( std::abs( expected[vertices] - s.data() ) < T(1e-4) );
+        }
+
+        // Faces have to precede their cofaces
+        for( std::size_t i = 0; i < K.size(); i++ )
+        {
+          auto&& s = K.at(i);
+          for( std::size_t j = 0; j < s.boundarySize(); j++ )
+            ALEPH_ASSERT_THROW( K.index( s.face(j) ) < i );
+        }
+
+        // Limiting the dimension yields a skeleton of the complex
+        auto L = buildCechComplex( pc, r, 1 );
+
+        ALEPH_ASSERT_EQUAL( L.size(),
+                            static_cast<std::size_t>( std::count_if( K.begin(), K.end(), [] ( const typename decltype(K)::ValueType& s ) { return s.dimension() <= 1; } ) ) );
+      }
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
 int main()
 {
   triangle<double>();
   triangle<float> ();
+
+  randomPointClouds<double>();
+  randomPointClouds<float> ();
 }
@@ -0,0 +1,195 @@
+#include <tests/Base.hh>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <aleph/persistenceDiagrams/Calculation.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+
+#include <aleph/topology/CompactSimplicialComplex.hh>
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/io/SimplicialComplexReader.hh>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cmath>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+using namespace distances;
+
+/** Checks that a compact complex and a simplicial complex coincide */
+template <class CompactSimplicialComplex, class SimplicialComplex> void checkEquality( const CompactSimplicialComplex& C, const SimplicialComplex& K )
+{
+  ALEPH_ASSERT_EQUAL( C.size(), K.size() );
+  ALEPH_ASSERT_EQUAL( C.dimension(), K.dimension() );
+
+  std::size_t i = 0;
+
+  for( auto&& s : C )
+  {
+    auto&& t = K.at(i);
+
+    ALEPH_ASSERT_THROW( s == t );
+    ALEPH_ASSERT_EQUAL( s.dimension(), t.dimension() );
+    ALEPH_ASSERT_EQUAL( s.boundarySize(), t.boundarySize() );
+    ALEPH_ASSERT_THROW( std::abs( s.data() - t.data() ) < 1e-6 );
+    ALEPH_ASSERT_EQUAL( C.index( s ), i );
+    ALEPH_ASSERT_EQUAL( C.index( t ), i );
+
+    ++i;
+  }
+}
+
+template <class T> void testRips()
+{
+  ALEPH_TEST_BEGIN( "Compact simplicial complex from Rips complex" );
+
+  using PointCloud        = PointCloud<T>;
+  using Distance          = Euclidean<T>;
+  using Wrapper           = BruteForce<PointCloud, Distance>;
+  using RipsSkeleton      = RipsSkeleton<Wrapper>;
+  using SimplicialComplex = typename RipsSkeleton::SimplicialComplex;
+  using Simplex           = typename SimplicialComplex::ValueType;
+
+  auto pointCloud = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/S1.txt" ) );
+
+  Wrapper wrapper( pointCloud );
+  RipsSkeleton ripsSkeleton;
+  RipsExpander<SimplicialComplex> ripsExpander;
+
+  auto K = ripsSkeleton( wrapper, T(1.2) );
+  K      = ripsExpander( K, 2 );
+  K      = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( filtrations::Data<Simplex>() );
+
+  CompactSimplicialComplex<Simplex> C( K );
+  CompactSimplicialComplex<Simplex, float> F( K );
+
+  checkEquality( C, K );
+  checkEquality( F, K );
+
+  ALEPH_ASSERT_EQUAL( C.size(0) + C.size(1) + C.size(2), C.size() );
+  ALEPH_ASSERT_EQUAL( C.size(3), 0 );
+  ALEPH_ASSERT_THROW( C.toSimplicialComplex() == K );
+
+  // Boundary matrices are built by face queries, so they have to be the
+  // same for both representations.
+
+  auto M = makeBoundaryMatrix( K );
+
+  ALEPH_ASSERT_THROW( makeBoundaryMatrix( C ) == M );
+  ALEPH_ASSERT_THROW( makeBoundaryMatrix( F ) == M );
+
+  auto pairing = calculatePersistencePairing( M.dualize() );
+  auto D1      = makePersistenceDiagrams( pairing, K );
+  auto D2      = makePersistenceDiagrams( pairing, C );
+  auto D3      = makePersistenceDiagrams( pairing, F );
+
+  ALEPH_ASSERT_EQUAL( D1.size(), D2.size() );
+  ALEPH_ASSERT_EQUAL( D1.size(), D3.size() );
+
+  for( std::size_t i = 0; i < D1.size(); i++ )
+  {
+    ALEPH_ASSERT_THROW( D1[i] == D2[i] );
+    ALEPH_ASSERT_EQUAL( D1[i].size(), D3[i].size() );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class Data, class Vertex> void testQueries()
+{
+  ALEPH_TEST_BEGIN( "Compact simplicial complex queries" );
+
+  using Simplex                  = Simplex<Data, Vertex>;
+  using SimplicialComplex        = SimplicialComplex<Simplex>;
+  using CompactSimplicialComplex = CompactSimplicialComplex<Simplex>;
+
+  SimplicialComplex K = {
+    {0}, {1}, {2}, {3}, {0,1}, {0,2}, {1,2}, {0,1,2}, {2,3}
+  };
+
+  CompactSimplicialComplex C( K );
+
+  checkEquality( C, K );
+
+  ALEPH_ASSERT_THROW( C.contains( Simplex( {1,2} ) ) );
+  ALEPH_ASSERT_THROW( C.contains( Simplex( {1,3} ) ) == false );
+  ALEPH_ASSERT_THROW( C.contains( Simplex( {0,1,3} ) ) == false );
+  ALEPH_ASSERT_THROW( C.contains( Simplex( {0,1,2,3} ) ) == false );
+
+  ALEPH_EXPECT_EXCEPTION( C.index( Simplex( {1,3} ) ), std::runtime_error );
+  ALEPH_EXPECT_EXCEPTION( C.at( K.size() ), std::out_of_range );
+
+  for( auto&& s : C )
+  {
+    for( std::size_t i = 0; i < s.boundarySize(); i++ )
+    {
+      auto face = s.face( i );
+
+      ALEPH_ASSERT_THROW( C.contains( face ) );
+      ALEPH_ASSERT_EQUAL( C.index( face ), K.index( K.at( C.index( s ) ).face( i ) ) );
+    }
+  }
+
+  CompactSimplicialComplex E;
+
+  ALEPH_ASSERT_THROW( E.empty() );
+  ALEPH_ASSERT_EQUAL( E.size(), 0 );
+  ALEPH_ASSERT_THROW( E.begin() == E.end() );
+  ALEPH_ASSERT_THROW( E.contains( Simplex( {0} ) ) == false );
+  ALEPH_EXPECT_EXCEPTION( E.dimension(), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+void testReader()
+{
+  ALEPH_TEST_BEGIN( "Compact simplicial complex reader" );
+
+  using Simplex                  = Simplex<double, unsigned>;
+  using SimplicialComplex        = SimplicialComplex<Simplex>;
+  using CompactSimplicialComplex = CompactSimplicialComplex<Simplex, float>;
+
+  auto filename = CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple.net" );
+
+  SimplicialComplex K;
+  CompactSimplicialComplex C;
+
+  io::SimplicialComplexReader reader;
+  reader( filename, K );
+  reader( filename, C );
+
+  checkEquality( C, K );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testRips<float> ();
+  testRips<double>();
+
+  testQueries<double, unsigned>();
+  testQueries<float,  short   >();
+
+  testReader();
+}
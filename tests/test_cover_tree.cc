@@ -1,16 +1,30 @@
 #include <tests/Base.hh>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <numeric>
+#include <random>
 #include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include <cmath>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
 #include <aleph/geometry/CoverTree.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+#include <aleph/geometry/distances/Manhattan.hh>
 
 #include <aleph/topology/UnionFind.hh>
 
@@ -39,8 +53,6 @@ template <class T> void testSimple()
   ct.insert( 11 );
   ct.insert( 12 );
 
-  ct.print( std::cerr );
-
   ALEPH_ASSERT_THROW( ct.checkLevelInvariant() );
   ALEPH_ASSERT_THROW( ct.checkCoveringInvariant() );
   ALEPH_ASSERT_THROW( ct.checkSeparatingInvariant() );
@@ -59,17 +71,6 @@ template <class T> void testSimplePermutations()
     CoverTree<T,
               SimpleMetric<T> > ct;
 
-    // Debug output ----------------------------------------------------
-
-    std::cerr << "Permutation: ";
-
-    for( auto&& x : data )
-      std::cerr << x << " ";
-
-    std::cerr << "\n";
-
-    // Check validity of tree ------------------------------------------
-
     for( auto&& x : data )
       ct.insert( x );
 
@@ -232,8 +233,6 @@ template <class T> void test2D()
   // certain points are being covered.
 
   std::map<Point, unsigned > covered;
-  std::multimap<Point, long> levels;
-  std::multimap<Point, T   > distances;
 
   for( auto&& pair : nodesByLevel )
   {
@@ -245,61 +244,12 @@ template <class T> void test2D()
       // TODO: fix radius/level calculation; is this an implementation
       // detail of the tree?
       if( contains( centre, p, T( std::pow( T(2), level ) ) ) )
-      {
         covered[p] += 1;
-        levels.insert( std::make_pair( p, level ) );
-        distances.insert( std::make_pair( p, distance( centre, p ) ) );
-      }
     }
   }
 
-  std::cerr << "# Cover counter\n";
-
-  for( auto&& pair : covered )
-    std::cerr << pair.first << ": " << pair.second << "\n";
-
-  std::cerr << "# Levels counter\n";
-
-  for( auto&& p : points )
-  {
-    std::cerr << p << ": ";
-
-    auto range = levels.equal_range( p );
-    for( auto it = range.first; it != range.second; ++it )
-     std::cerr << it->second << " ";
-
-    std::cerr << "\n";
-  }
-
-  std::cerr << "# Distances counter\n";
-
-  for( auto&& p : points )
-  {
-    std::cerr << p << ": ";
-
-    auto range = distances.equal_range( p );
-    for( auto it = range.first; it != range.second; ++it )
-     std::cerr << it->second << " ";
-
-    std::cerr << "\n";
-  }
-
-  std::cerr << "# Basic cover distance density\n";
-
-  for( auto&& p : points )
-  {
-    std::cerr << p << ": ";
-
-    auto range      = distances.equal_range( p );
-    double distance = 0.0;
-
-    for( auto it = range.first; it != range.second; ++it )
-      distance += it->second;
-
-    distance /= static_cast<T>( std::distance( range.first, range.second ) );
-
-    std::cerr << distance << "\n";
-  }
+  // Every point is at least covered by its own node
+  ALEPH_ASSERT_EQUAL( covered.size(), points.size() );
 
   // DEBUG: output of cover radii --------------------------------------
 
@@ -350,10 +300,6 @@ template <class T> void test2D()
           << edge.second << "\n\n";
     }
 
-    std::cerr << "# Cover tree\n";
-
-    ct.print( std::cerr );
-
     std::set< std::pair<Point, Point> > filteredEdges;
 
     auto&& nodesToLevel = ct.nodesToLevel();
@@ -368,9 +314,6 @@ template <class T> void test2D()
       auto d_lower = std::pow( T(2), lower );
       auto d_upper = std::pow( T(2), upper );
 
-      std::cerr << edge.first << " -- " << edge.second << ":\n"
-                << "  " << upper << "," << lower << "," << std::abs( upper - lower ) << "\n";
-
       if( d <= d_lower && d <= d_upper )
         filteredEdges.insert( edge );
       else
@@ -440,8 +383,6 @@ template <class T> void test2D()
       auto&& level  = pair.first;
       auto&& centre = pair.second;
 
-      std::cerr << "Parent: " << centre << "\n";
-
       for( auto&& p : points )
       {
         // TODO: fix radius/level calculation; is this an implementation
@@ -455,9 +396,6 @@ template <class T> void test2D()
           if( uf.find( point_to_index[centre] ) == uf.find( point_to_index[p] ) )
             continue;
 
-          std::cerr << " -> " << p << "\n";
-          std::cerr << point_to_index[centre] << " -- " << point_to_index[p] << "\n";
-
           // Get connected component that corresponds to the child;
           // check for *shortest* distance
 
@@ -469,16 +407,10 @@ template <class T> void test2D()
           for( auto&& i : component )
             component_.push_back( points.at(i) );
 
-          std::cerr << " -> [" << component.size() << "]\n";
-
           auto q = linkage( centre, component_ );
-          if( p != q )
-            std::cerr << " -> This is different!\n";
 
           uf.merge( point_to_index[p], point_to_index[centre] );
 
-          std::cerr << point_to_index[centre] << " -- " << point_to_index[q] << "\n";
-
           if( centre < q )
             edges.insert( std::make_pair( centre, q ) );
           else
@@ -500,6 +432,236 @@ template <class T> void test2D()
   ALEPH_TEST_END();
 }
 
+template <class T> void testQueries()
+{
+  ALEPH_TEST_BEGIN( "Queries" );
+
+  using Point     = Point<T>;
+  using Metric    = EuclideanMetric<T>;
+  using CoverTree = CoverTree<Point, Metric>;
+
+  std::mt19937 rng( 42 );
+  std::uniform_real_distribution<T> distribution( T(0), T(10) );
+
+  std::vector<Point> points( 300 );
+
+  for( auto&& p : points )
+  {
+    p.x = distribution( rng );
+    p.y = distribution( rng );
+  }
+
+  {
+    CoverTree ct;
+    ct.insert( points.begin(), points.end() );
+
+    std::vector<Point> neighbours;
+    std::vector<T> distances;
+
+    ALEPH_EXPECT_EXCEPTION( ct.neighbourSearch( points.front(), 1, neighbours, distances ), std::runtime_error );
+  }
+
+  CoverTree ct( points.begin(), points.end() );
+
+  ALEPH_ASSERT_THROW( ct.isValid() );
+  ALEPH_ASSERT_EQUAL( ct.nodes().size(), points.size() );
+
+  std::vector<Point> queries( points.begin(), points.begin() + 50 );
+
+  for( std::size_t i = 0; i < 50; i++ )
+    queries.push_back( { distribution( rng ), distribution( rng ) } );
+
+  for( int numThreads : { 1, 3 } )
+  {
+#ifdef _OPENMP
+    omp_set_num_threads( numThreads );
+#else
+    (void) numThreads;
+#endif
+
+    std::vector< std::vector<Point> > neighbours;
+    std::vector< std::vector<T> > neighbourDistances;
+
+    ct.neighbourSearch( queries, 7, neighbours, neighbourDistances );
+
+    std::vector< std::vector<Point> > pointsInRadius;
+    std::vector< std::vector<T> > radiusDistances;
+
+    ct.radiusSearch( queries, T(1.5), pointsInRadius, radiusDistances );
+
+    ALEPH_ASSERT_EQUAL( neighbours.size(), queries.size() );
+    ALEPH_ASSERT_EQUAL( pointsInRadius.size(), queries.size() );
+
+    for( std::size_t i = 0; i < queries.size(); i++ )
+    {
+      std::vector<T> expected;
+      std::vector<Point> expectedPoints;
+
+      for( auto&& p : points )
+      {
+        auto d = distance( queries[i], p );
+
+        expected.push_back( d );
+
+        if( d < T(1.5) )
+          expectedPoints.push_back( p );
+      }
+
+      std::sort( expected.begin(), expected.end() );
+      expected.resize( 7 );
+
+      ALEPH_ASSERT_THROW( neighbourDistances[i] == expected );
+
+      for( std::size_t j = 0; j < neighbours[i].size(); j++ )
+        ALEPH_ASSERT_EQUAL( distance( queries[i], neighbours[i][j] ), neighbourDistances[i][j] );
+
+      ALEPH_ASSERT_THROW( std::is_sorted( radiusDistances[i].begin(), radiusDistances[i].end() ) );
+
+      std::sort( expectedPoints.begin(), expectedPoints.end() );
+      std::sort( pointsInRadius[i].begin(), pointsInRadius[i].end() );
+
+      ALEPH_ASSERT_THROW( pointsInRadius[i] == expectedPoints );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testBatch()
+{
+  ALEPH_TEST_BEGIN( "Batch construction" );
+
+  using Point     = Point<T>;
+  using Metric    = EuclideanMetric<T>;
+  using CoverTree = CoverTree<Point, Metric>;
+
+  std::mt19937 rng( 42 );
+  std::uniform_real_distribution<T> distribution( T(0), T(10) );
+
+  std::vector<Point> points( 200 );
+
+  for( auto&& p : points )
+  {
+    p.x = distribution( rng );
+    p.y = distribution( rng );
+  }
+
+  // Duplicates result in chains of nodes whose distance is zero
+  points.insert( points.end(), points.begin(), points.begin() + 20 );
+  points.insert( points.end(), 5, points.front() );
+
+  CoverTree batch( points.begin(), points.end() );
+  CoverTree sequential;
+
+  for( auto&& p : points )
+    sequential.insert( p );
+
+  sequential.build();
+
+  ALEPH_ASSERT_THROW( batch.isValid() );
+  ALEPH_ASSERT_THROW( sequential.isValid() );
+  ALEPH_ASSERT_EQUAL( batch.nodes().size(), points.size() );
+  ALEPH_ASSERT_EQUAL( sequential.nodes().size(), points.size() );
+
+  // The distance bound of every node must not be smaller than the
+  // distance to any point in its subtree.
+  for( auto&& ct : { &batch, &sequential } )
+  {
+    auto&& nodes = ct->nodes();
+
+    for( std::size_t i = 0; i < nodes.size(); i++ )
+    {
+      for( std::size_t j = i+1; j < nodes[i].end; j++ )
+        ALEPH_ASSERT_THROW( distance( nodes[i].point, nodes[j].point ) <= nodes[i].maxDistance );
+    }
+  }
+
+  std::vector< std::vector<Point> > neighbours1, neighbours2;
+  std::vector< std::vector<T> > distances1, distances2;
+
+  batch.neighbourSearch( points, 10, neighbours1, distances1 );
+  sequential.neighbourSearch( points, 10, neighbours2, distances2 );
+
+  ALEPH_ASSERT_THROW( distances1 == distances2 );
+
+  batch.radiusSearch( points, T(1), neighbours1, distances1 );
+  sequential.radiusSearch( points, T(1), neighbours2, distances2 );
+
+  ALEPH_ASSERT_THROW( distances1 == distances2 );
+
+  ALEPH_TEST_END();
+}
+
+template <class T, class Distance> void testIndex()
+{
+  ALEPH_TEST_BEGIN( "Cover tree index" );
+
+  using PointCloud = aleph::containers::PointCloud<T>;
+
+  std::mt19937 rng( 23 );
+  std::uniform_real_distribution<T> distribution( T(0), T(1) );
+
+  PointCloud pc( 400, 4 );
+
+  for( std::size_t i = 0; i < pc.size(); i++ )
+  {
+    std::vector<T> p( pc.dimension() );
+    std::generate( p.begin(), p.end(), [&] () { return distribution( rng ); } );
+
+    pc.set( i, p.begin(), p.end() );
+  }
+
+  CoverTreeIndex<PointCloud, Distance> index( pc );
+  BruteForce<PointCloud, Distance> bruteForce( pc );
+
+  ALEPH_ASSERT_EQUAL( index.size(), pc.size() );
+
+  for( int numThreads : { 1, 3 } )
+  {
+#ifdef _OPENMP
+    omp_set_num_threads( numThreads );
+#else
+    (void) numThreads;
+#endif
+
+    std::vector< std::vector<std::size_t> > indices1, indices2;
+    std::vector< std::vector<T> > distances1, distances2;
+
+    index.radiusSearch( T(0.5), indices1, distances1 );
+    bruteForce.radiusSearch( T(0.5), indices2, distances2 );
+
+    ALEPH_ASSERT_EQUAL( indices1.size(), indices2.size() );
+
+    for( std::size_t i = 0; i < indices1.size(); i++ )
+    {
+      std::sort( indices1[i].begin(), indices1[i].end() );
+      ALEPH_ASSERT_THROW( indices1[i] == indices2[i] );
+    }
+
+    index.neighbourSearch( 5, indices1, distances1 );
+    bruteForce.neighbourSearch( 5, indices2, distances2 );
+
+    for( std::size_t i = 0; i < indices1.size(); i++ )
+    {
+      ALEPH_ASSERT_THROW( distances1[i] == distances2[i] );
+      ALEPH_ASSERT_EQUAL( indices1[i].front(), i );
+    }
+
+    // The index can be used to calculate a Vietoris--Rips skeleton for
+    // an arbitrary metric.
+    auto K = RipsSkeleton< CoverTreeIndex<PointCloud, Distance> >()( index, T(0.4) );
+    auto L = RipsSkeleton< BruteForce<PointCloud, Distance> >()( bruteForce, T(0.4) );
+
+    K.sort();
+    L.sort();
+
+    ALEPH_ASSERT_EQUAL( K.size(), L.size() );
+    ALEPH_ASSERT_THROW( K == L );
+  }
+
+  ALEPH_TEST_END();
+}
+
 int main( int, char** )
 {
   //testSimple<double>();
@@ -510,4 +672,14 @@ int main( int, char** )
 
   test2D<double>();
   test2D<float> ();
+
+  testQueries<double>();
+  testQueries<float> ();
+
+  testBatch<double>();
+  testBatch<float> ();
+
+  testIndex<double, aleph::geometry::distances::Euclidean<double> >();
+  testIndex<float,  aleph::geometry::distances::Euclidean<float> > ();
+  testIndex<double, aleph::geometry::distances::Manhattan<double> >();
 }
@@ -1,6 +1,11 @@
+#include <aleph/config/FLANN.hh>
+
 #include <aleph/containers/PointCloud.hh>
 #include <aleph/containers/DataDescriptors.hh>
 
+#include <aleph/geometry/FLANN.hh>
+#include <aleph/geometry/KDTree.hh>
+
 #include <aleph/geometry/distances/Euclidean.hh>
 #include <aleph/geometry/distances/Manhattan.hh>
 
@@ -8,8 +13,10 @@
 
 #include <tests/Base.hh>
 
+#include <algorithm>
 #include <iostream>
 #include <iterator>
+#include <random>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -137,6 +144,153 @@ template <class D> void distanceToMeasureTest()
   ALEPH_TEST_END();
 }
 
+template <class D, class Wrapper> void nearestNeighbourTest()
+{
+  ALEPH_TEST_BEGIN( "Density estimation with nearest neighbours" );
+
+  using PointCloud = PointCloud<double>;
+
+  auto pc = load<double>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_comma_separated.txt" ) );
+
+  for( unsigned k : { 1, 5, 10 } )
+  {
+    auto e1 = estimateDensityDistanceToMeasure<D>( pc, k );
+    auto e2 = estimateDensityDistanceToMeasure<D, PointCloud, Wrapper>( pc, k );
+
+    ALEPH_ASSERT_EQUAL( e1.size(), pc.size() );
+    ALEPH_ASSERT_THROW( aleph::utilities::allclose( e1.begin(), e1.end(), e2.begin(), e2.end() ) );
+  }
+
+  // The truncated Gaussian estimator always uses the Euclidean distance,
+  // so the test is not repeated for other distances.
+  if( std::is_same<D, aleph::geometry::distances::Euclidean<double> >::value )
+  {
+    // The coordinates of the data set have a single decimal place, so many
+    // distances are equal to these bandwidths, or to the distance between
+    // the first two points. Points at the bandwidth have to be used by all
+    // wrappers.
+    auto p = pc.point( 0 );
+    auto q = pc.point( 1 );
+
+    double h0 = 0.0;
+
+    for( std::size_t k = 0; k < pc.dimension(); k++ )
+      h0 += ( p[k] - q[k] ) * ( p[k] - q[k] );
+
+    for( double h : { 0.1, 0.15, 0.2, 0.25, 0.5, 1.0, 1.05, std::sqrt( h0 ) } )
+    {
+      auto g1 = estimateDensityTruncatedGaussian( pc, h );
+      auto g2 = estimateDensityTruncatedGaussian<PointCloud, Wrapper>( pc, h );
+
+      ALEPH_ASSERT_EQUAL( g1.size(), pc.size() );
+      ALEPH_ASSERT_THROW( g1 == g2 );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class D> void lensDataDepthTest()
+{
+  ALEPH_TEST_BEGIN( "Lens data depth test" );
+
+  auto pc = load<double>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_comma_separated.txt" ) );
+  auto n  = pc.size();
+
+  D dist;
+  aleph::geometry::distances::Traits<D> traits;
+
+  auto distance = [&] ( std::size_t i, std::size_t j )
+  {
+    return traits.from( dist( pc.point( i ).begin(), pc.point( j ).begin(), pc.dimension() ) );
+  };
+
+  std::vector<unsigned> reference( n );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    for( std::size_t j = i+1; j < n; j++ )
+    {
+      for( std::size_t k = 0; k < n; k++ )
+      {
+        if( k != i && k != j && std::max( distance( i, k ), distance( j, k ) ) <= distance( i, j ) )
+          ++reference[k];
+      }
+    }
+  }
+
+  auto depth = estimateLensDataDepth<D>( pc );
+
+  ALEPH_ASSERT_THROW( depth == reference );
+
+  // Sampling all pairs results in the exact calculation
+  auto exact = estimateLensDataDepth<D>( pc, n * n );
+
+  ALEPH_ASSERT_THROW( exact == reference );
+
+  // The approximation is unbiased, so the total depth has to be close to
+  // the exact one, while the depth of individual points is subject to
+  // random fluctuations.
+  auto approximation = estimateLensDataDepth<D>( pc, n * ( n - 1 ) / 4 );
+
+  ALEPH_ASSERT_EQUAL( approximation.size(), n );
+
+  double total              = 0.0;
+  double totalApproximation = 0.0;
+
+  for( std::size_t k = 0; k < n; k++ )
+  {
+    total              += reference[k];
+    totalApproximation += approximation[k];
+  }
+
+  ALEPH_ASSERT_THROW( std::abs( total - totalApproximation ) / total < 0.05 );
+
+  ALEPH_TEST_END();
+}
+
+void highDimensionalTruncatedGaussianTest()
+{
+  ALEPH_TEST_BEGIN( "Truncated Gaussian density estimation in single precision" );
+
+  using PointCloud = PointCloud<float>;
+  using Wrapper    = KDTree<PointCloud, distances::Euclidean<float> >;
+
+  std::size_t n = 100;
+  std::size_t d = 256;
+
+  std::mt19937 rng( 42 );
+  std::uniform_real_distribution<float> distribution( -1.f, 1.f );
+
+  PointCloud pc( n, d );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    std::vector<float> p( d );
+
+    for( auto&& x : p )
+      x = distribution( rng );
+
+    pc.set( i, p.begin(), p.end() );
+  }
+
+  // The wrapper accumulates distances in single precision, whereas the
+  // direct calculation uses double precision. Bandwidths that are equal
+  // to distances of the data set must not result in missing points.
+  distances::Euclidean<float, double> distance;
+
+  for( std::size_t j = 1; j < n; j++ )
+  {
+    auto h  = std::sqrt( distance( pc.point( 0 ).begin(), pc.point( j ).begin(), d ) );
+    auto g1 = estimateDensityTruncatedGaussian( pc, h );
+    auto g2 = estimateDensityTruncatedGaussian<PointCloud, Wrapper>( pc, h );
+
+    ALEPH_ASSERT_THROW( g1 == g2 );
+  }
+
+  ALEPH_TEST_END();
+}
+
 int main()
 {
   using T  = double;
@@ -146,12 +300,23 @@ int main()
   std::cerr << "-- Euclidean distance\n";
 
   truncatedGaussianTest();
+  highDimensionalTruncatedGaussianTest();
 
   eccentricityTest<ED>();
   distanceToMeasureTest<ED>();
+  nearestNeighbourTest<ED, KDTree<PointCloud<T>, ED> >();
+#ifdef ALEPH_WITH_FLANN
+  nearestNeighbourTest<ED, FLANN<PointCloud<T>, ED> >();
+#endif
+  lensDataDepthTest<ED>();
 
   std::cerr << "-- Manhattan distance\n";
 
   eccentricityTest<MD>();
   distanceToMeasureTest<MD>();
+  nearestNeighbourTest<MD, KDTree<PointCloud<T>, MD> >();
+#ifdef ALEPH_WITH_FLANN
+  nearestNeighbourTest<MD, FLANN<PointCloud<T>, MD> >();
+#endif
+  lensDataDepthTest<MD>();
 }
@@ -0,0 +1,416 @@
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/DistanceMatrix.hh>
+#include <aleph/geometry/DistanceMatrixIndex.hh>
+#include <aleph/geometry/VietorisRipsComplex.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+#include <aleph/geometry/distances/Manhattan.hh>
+#include <aleph/geometry/distances/Traits.hh>
+
+#include <tests/Base.hh>
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <cstdio>
+
+using namespace aleph::containers;
+using namespace aleph::geometry;
+using namespace aleph;
+
+template <class T> PointCloud<T> makeRandomPointCloud( std::size_t n, std::size_t d )
+{
+  PointCloud<T> pointCloud( n, d );
+
+  std::mt19937 rng( 42 );
+  std::normal_distribution<T> distribution;
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    std::vector<T> p( d );
+
+    for( auto&& x : p )
+      x = distribution( rng );
+
+    pointCloud.set( i, p.begin(), p.end() );
+  }
+
+  return pointCloud;
+}
+
+template <class Distance, class Matrix, class Container> void checkDistances( const Matrix& M, const Container& container )
+{
+  Distance dist;
+  distances::Traits<Distance> traits;
+
+  auto n = container.size();
+  auto d = container.dimension();
+
+  ALEPH_ASSERT_EQUAL( M.numRows(), n );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    ALEPH_ASSERT_EQUAL( M(i,i), 0 );
+
+    for( std::size_t j = i+1; j < n; j++ )
+    {
+      auto x = traits.from( dist( container.point( i ).begin(),
+                                  container.point( j ).begin(),
+                                  d ) );
+
+      ALEPH_ASSERT_EQUAL( M(i,j), x );
+      ALEPH_ASSERT_EQUAL( M(j,i), x );
+
+      // Entries of the upper triangular part are stored contiguously
+      ALEPH_ASSERT_EQUAL( M.data()[ M.rowOffset( i ) + j ], x );
+    }
+  }
+}
+
+template <class T> void test()
+{
+  ALEPH_TEST_BEGIN( "Distance matrix" );
+
+  // The number of points is not a multiple of the block size, so that
+  // partial blocks are covered as well.
+  for( auto d : { 1, 4, 37 } )
+  {
+    auto pointCloud = makeRandomPointCloud<T>( 523, std::size_t( d ) );
+
+    auto M = distanceMatrix<distances::Euclidean<T> >( pointCloud );
+    auto N = distanceMatrix<distances::Manhattan<T> >( pointCloud );
+
+    checkDistances<distances::Euclidean<T> >( M, pointCloud );
+    checkDistances<distances::Manhattan<T> >( N, pointCloud );
+  }
+
+  {
+    PointCloud<T> pointCloud;
+
+    auto M = distanceMatrix<distances::Euclidean<T> >( pointCloud );
+    ALEPH_ASSERT_EQUAL( M.numRows(), 0 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testMapped()
+{
+  ALEPH_TEST_BEGIN( "Memory-mapped distance matrix" );
+
+  using Distance = distances::Euclidean<T>;
+
+  auto pointCloud = makeRandomPointCloud<T>( 300, 5 );
+  auto filename   = std::string( "/tmp/test_distance_matrix_" ) + std::to_string( sizeof(T) ) + ".bin";
+
+  {
+    auto M = distanceMatrix<Distance>( pointCloud, filename );
+    checkDistances<Distance>( M, pointCloud );
+
+    // Copies must not refer to the mapped file anymore
+    auto N = M;
+    N(0,1) = T(-1);
+
+    ALEPH_ASSERT_THROW( M(0,1) > 0 );
+  }
+
+  {
+    auto M = loadDistanceMatrix<T>( filename );
+    checkDistances<Distance>( M, pointCloud );
+  }
+
+  {
+    std::ofstream out( filename, std::ios::binary | std::ios::app );
+    T x = T();
+
+    out.write( reinterpret_cast<const char*>( &x ), sizeof(T) );
+  }
+
+  ALEPH_EXPECT_EXCEPTION( loadDistanceMatrix<T>( filename ), std::runtime_error );
+
+  std::remove( filename.c_str() );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testVietorisRipsComplex()
+{
+  ALEPH_TEST_BEGIN( "Vietoris--Rips complex from distance matrix" );
+
+  using Distance = distances::Euclidean<T>;
+  using Wrapper  = BruteForce<PointCloud<T>, Distance>;
+
+  auto pointCloud = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+  Wrapper wrapper( pointCloud );
+
+  auto M = distanceMatrix<Distance>( pointCloud );
+  auto K = buildVietorisRipsComplex( wrapper, T( 0.5 ), 2 );
+  auto L = buildVietorisRipsComplex( M, T( 0.5 ), 2 );
+
+  ALEPH_ASSERT_THROW( K.empty() == false );
+  ALEPH_ASSERT_EQUAL( K.size(), L.size() );
+
+  for( auto&& s : K )
+  {
+    auto it = L.find( s );
+
+    ALEPH_ASSERT_THROW( it != L.end() );
+    ALEPH_ASSERT_EQUAL( it->data(), s.data() );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testIndex()
+{
+  ALEPH_TEST_BEGIN( "Nearest neighbours from distance matrix" );
+
+  using Distance = distances::Euclidean<T>;
+  using Wrapper  = BruteForce<PointCloud<T>, Distance>;
+  using Index    = DistanceMatrixIndex<T>;
+
+  auto pointCloud = makeRandomPointCloud<T>( 200, 3 );
+  auto filename   = std::string( "/tmp/test_distance_matrix_index_" ) + std::to_string( sizeof(T) ) + ".bin";
+
+  distanceMatrix<Distance>( pointCloud, filename );
+
+  Wrapper wrapper( pointCloud );
+  Index index( loadDistanceMatrix<T>( filename ) );
+
+  ALEPH_ASSERT_EQUAL( index.size(), pointCloud.size() );
+
+  std::vector< std::vector<std::size_t> > I1, I2;
+  std::vector< std::vector<T> > D1, D2;
+
+  wrapper.radiusSearch( T( 1.5 ), I1, D1 );
+  index.radiusSearch( T( 1.5 ), I2, D2 );
+
+  ALEPH_ASSERT_EQUAL( I1.size(), I2.size() );
+
+  for( std::size_t i = 0; i < I1.size(); i++ )
+  {
+    ALEPH_ASSERT_EQUAL( I1[i].size(), I2[i].size() );
+    ALEPH_ASSERT_THROW( std::is_sorted( D2[i].begin(), D2[i].end() ) );
+
+    // The brute-force wrapper does not sort its results
+    std::sort( I1[i].begin(), I1[i].end() );
+    std::sort( D1[i].begin(), D1[i].end() );
+
+    auto indices = I2[i];
+    std::sort( indices.begin(), indices.end() );
+
+    ALEPH_ASSERT_THROW( I1[i] == indices );
+    ALEPH_ASSERT_THROW( D1[i] == D2[i] );
+  }
+
+  wrapper.neighbourSearch( 5, I1, D1 );
+  index.neighbourSearch( 5, I2, D2 );
+
+  for( std::size_t i = 0; i < I1.size(); i++ )
+  {
+    ALEPH_ASSERT_EQUAL( I2[i].size(), 5 );
+    ALEPH_ASSERT_EQUAL( I2[i].front(), i );
+    ALEPH_ASSERT_THROW( D1[i] == D2[i] );
+  }
+
+  // Truncated neighbour lists must not change any results, even if the
+  // queries exceed the lists.
+  {
+    Index truncated( loadDistanceMatrix<T>( filename ), T( 1.0 ) );
+
+    std::vector< std::vector<std::size_t> > I3;
+    std::vector< std::vector<T> > D3;
+
+    for( auto radius : { T( 0.5 ), T( 1.0 ), T( 1.5 ) } )
+    {
+      index.radiusSearch( radius, I2, D2 );
+      truncated.radiusSearch( radius, I3, D3 );
+
+      ALEPH_ASSERT_THROW( I2 == I3 );
+      ALEPH_ASSERT_THROW( D2 == D3 );
+    }
+
+    for( auto k : { 1u, 5u, 50u, 500u } )
+    {
+      index.neighbourSearch( k, I2, D2 );
+      truncated.neighbourSearch( k, I3, D3 );
+
+      ALEPH_ASSERT_THROW( I2 == I3 );
+      ALEPH_ASSERT_THROW( D2 == D3 );
+    }
+  }
+
+  auto K = buildVietorisRipsComplex( wrapper, T( 1.0 ), 2 );
+  auto L = buildVietorisRipsComplex( index, T( 1.0 ), 2 );
+
+  ALEPH_ASSERT_THROW( K.empty() == false );
+  ALEPH_ASSERT_EQUAL( K.size(), L.size() );
+
+  for( auto&& s : K )
+  {
+    auto it = L.find( s );
+
+    ALEPH_ASSERT_THROW( it != L.end() );
+    ALEPH_ASSERT_EQUAL( it->data(), s.data() );
+  }
+
+  std::remove( filename.c_str() );
+
+  ALEPH_TEST_END();
+}
+
+void testMatrixReader()
+{
+  ALEPH_TEST_BEGIN( "Reading distance matrices" );
+
+  using Index = DistanceMatrixIndex<double>;
+
+  std::string dense = "0 1 2\n"
+                      "1 0 3\n"
+                      "2 3 0\n";
+
+  std::string lower = "# Lower triangular matrix\n"
+                      "1\n"
+                      "\n"
+                      "2,3\n";
+
+  std::string asymmetric = "0 1\n"
+                           "2 0\n";
+
+  std::string invalid = "1\n"
+                        "2 3 4\n";
+
+  // Values that are not numbers must not be replaced by zero
+  std::string corrupt = "1\n"
+                        "foo,3\n";
+
+  std::string trailing = "0 1.5x\n"
+                         "1.5 0\n";
+
+  aleph::topology::io::MatrixReader reader;
+
+  for( auto&& text : { dense, lower } )
+  {
+    std::istringstream in( text );
+    aleph::math::SymmetricMatrix<double> M;
+
+    reader( in, M );
+
+    ALEPH_ASSERT_EQUAL( M.numRows(), 3 );
+    ALEPH_ASSERT_EQUAL( M(0,0), 0.0 );
+    ALEPH_ASSERT_EQUAL( M(0,1), 1.0 );
+    ALEPH_ASSERT_EQUAL( M(2,0), 2.0 );
+    ALEPH_ASSERT_EQUAL( M(1,2), 3.0 );
+
+    Index index( std::move( M ) );
+
+    std::vector< std::vector<std::size_t> > indices;
+    std::vector< std::vector<double> > distances;
+
+    index.radiusSearch( 2.5, indices, distances );
+
+    ALEPH_ASSERT_THROW( indices[0] == std::vector<std::size_t>( { 0, 1, 2 } ) );
+    ALEPH_ASSERT_THROW( indices[1] == std::vector<std::size_t>( { 1, 0 } ) );
+    ALEPH_ASSERT_THROW( indices[2] == std::vector<std::size_t>( { 2, 0 } ) );
+    ALEPH_ASSERT_THROW( distances[2] == std::vector<double>( { 0.0, 2.0 } ) );
+  }
+
+  for( auto&& text : { asymmetric, invalid, corrupt, trailing } )
+  {
+    std::istringstream in( text );
+    aleph::math::SymmetricMatrix<double> M;
+
+    ALEPH_EXPECT_EXCEPTION( reader( in, M ), std::runtime_error );
+  }
+
+  // A single value is ambiguous; by default, it is interpreted as a lower
+  // triangular matrix of two points.
+  {
+    std::istringstream in( "5\n" );
+    aleph::math::SymmetricMatrix<double> M;
+
+    reader( in, M );
+
+    ALEPH_ASSERT_EQUAL( M.numRows(), 2 );
+    ALEPH_ASSERT_EQUAL( M(0,1), 5.0 );
+  }
+
+  {
+    using Format = aleph::topology::io::MatrixReader::DistanceMatrixFormat;
+
+    aleph::topology::io::MatrixReader reader;
+    reader.setDistanceMatrixFormat( Format::Dense );
+
+    {
+      std::istringstream in( "0\n" );
+      aleph::math::SymmetricMatrix<double> M;
+
+      reader( in, M );
+      ALEPH_ASSERT_EQUAL( M.numRows(), 1 );
+    }
+
+    {
+      std::istringstream in( lower );
+      aleph::math::SymmetricMatrix<double> M;
+
+      ALEPH_EXPECT_EXCEPTION( reader( in, M ), std::runtime_error );
+    }
+
+    reader.setDistanceMatrixFormat( Format::LowerTriangular );
+
+    {
+      std::istringstream in( "0\n" );
+      aleph::math::SymmetricMatrix<double> M;
+
+      reader( in, M );
+      ALEPH_ASSERT_EQUAL( M.numRows(), 2 );
+    }
+
+    {
+      std::istringstream in( dense );
+      aleph::math::SymmetricMatrix<double> M;
+
+      ALEPH_EXPECT_EXCEPTION( reader( in, M ), std::runtime_error );
+    }
+  }
+
+  {
+    auto filename = std::string( "/tmp/test_distance_matrix.txt" );
+
+    {
+      std::ofstream out( filename );
+      out << lower;
+    }
+
+    Index index( filename );
+    ALEPH_ASSERT_EQUAL( index.size(), 3 );
+    ALEPH_ASSERT_EQUAL( index.distances()(1,2), 3.0 );
+
+    std::remove( filename.c_str() );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  test<float> ();
+  test<double>();
+
+  testMapped<float> ();
+  testMapped<double>();
+
+  testVietorisRipsComplex<float> ();
+  testVietorisRipsComplex<double>();
+
+  testIndex<float> ();
+  testIndex<double>();
+
+  testMatrixReader();
+}
@@ -2,10 +2,18 @@
 
 #include <aleph/geometry/distances/Euclidean.hh>
 #include <aleph/geometry/distances/Hamming.hh>
+#include <aleph/geometry/distances/Kernels.hh>
 #include <aleph/geometry/distances/Manhattan.hh>
+#include <aleph/geometry/distances/PackedHamming.hh>
 
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <random>
 #include <vector>
 
+#include <cmath>
+
 using namespace aleph;
 using namespace geometry;
 using namespace distances;
@@ -64,6 +72,261 @@ template <class T> void testManhattanDistance()
   ALEPH_TEST_END();
 }
 
+template <class T> std::vector<T> randomVector( std::size_t n, std::mt19937& rng )
+{
+  std::uniform_real_distribution<T> distribution( T(-5), T(5) );
+  std::vector<T> result( n );
+
+  // Coordinates are rounded in order to create some equal coordinates
+  // for the Hamming distance.
+  for( auto&& x : result )
+    x = std::round( distribution( rng ) );
+
+  return result;
+}
+
+template <class T> bool isClose( T x, T y )
+{
+  return std::abs( x - y ) <= T(1e-4) * std::max( T(1), std::abs( y ) );
+}
+
+template <class T> void testKernels()
+{
+  ALEPH_TEST_BEGIN( "Distance kernels" );
+
+  using namespace aleph::geometry::distances::detail;
+
+  std::mt19937 rng( 42 );
+
+  auto generic = makeKernels<T>( InstructionSet::Generic );
+
+  for( auto instructionSet : { InstructionSet::Generic, InstructionSet::AVX2, InstructionSet::AVX512 } )
+  {
+    // Kernels for unsupported instruction sets fall back to the generic
+    // kernels, so they can always be tested.
+    auto kernels = makeKernels<T>( instructionSet );
+
+    // Lengths are chosen such that every kernel has to handle partial
+    // vectors.
+    for( std::size_t n = 0; n < 68; n++ )
+    {
+      auto x = randomVector<T>( n, rng );
+      auto y = randomVector<T>( n, rng );
+
+      ALEPH_ASSERT_THROW( isClose( kernels.squaredEuclidean( x.data(), y.data(), n ), generic.squaredEuclidean( x.data(), y.data(), n ) ) );
+      ALEPH_ASSERT_THROW( isClose( kernels.manhattan( x.data(), y.data(), n ),        generic.manhattan( x.data(), y.data(), n ) ) );
+      ALEPH_ASSERT_THROW( isClose( kernels.dot( x.data(), y.data(), n ),              generic.dot( x.data(), y.data(), n ) ) );
+
+      ALEPH_ASSERT_EQUAL( kernels.hamming( x.data(), y.data(), n ), generic.hamming( x.data(), y.data(), n ) );
+      ALEPH_ASSERT_EQUAL( kernels.hamming( x.data(), x.data(), n ), T(0) );
+    }
+  }
+
+  // Contiguous ranges use the same kernels, regardless of whether they
+  // are specified by iterators or by pointers.
+  {
+    auto x = randomVector<T>( 37, rng );
+    auto y = randomVector<T>( 37, rng );
+
+    const T* p = x.data();
+    const T* q = y.data();
+
+    ALEPH_ASSERT_EQUAL( Euclidean<T>()( x.begin(), y.begin(), x.size() ), Euclidean<T>()( p, q, x.size() ) );
+    ALEPH_ASSERT_EQUAL( Manhattan<T>()( x.cbegin(), y.cbegin(), x.size() ), Manhattan<T>()( p, q, x.size() ) );
+    ALEPH_ASSERT_EQUAL( Hamming<T>()( x.begin(), y.begin(), x.size() ), Hamming<T>()( p, q, x.size() ) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T, class Distance> void testBatchedDistances()
+{
+  ALEPH_TEST_BEGIN( "Batched distances: " + Distance::name() );
+
+  std::mt19937 rng( 23 );
+
+  Distance distance;
+
+  // The second combination of sizes requires several blocks of points
+  // for higher dimensions, none of which are multiples of the tile size
+  for( auto&& size : { std::make_pair( 37, 53 ), std::make_pair( 301, 139 ) } )
+  for( std::size_t d : { 1, 3, 17, 64 } )
+  {
+    auto m = static_cast<std::size_t>( size.first );
+    auto n = static_cast<std::size_t>( size.second );
+
+    auto A = randomVector<T>( m*d, rng );
+    auto B = randomVector<T>( n*d, rng );
+
+    using ResultType = typename Distance::ResultType;
+
+    std::vector<ResultType> oneToMany( n );
+    std::vector<ResultType> manyToMany( m*n );
+
+    distance.manyToMany( A.data(), m, B.data(), n, d, manyToMany.data() );
+
+    for( std::size_t i = 0; i < m; i++ )
+    {
+      distance.oneToMany( A.data() + i*d, B.data(), n, d, oneToMany.data() );
+
+      for( std::size_t j = 0; j < n; j++ )
+      {
+        auto expected = distance( A.data() + i*d, B.data() + j*d, d );
+
+        ALEPH_ASSERT_EQUAL( oneToMany[j], expected );
+        ALEPH_ASSERT_THROW( isClose( manyToMany[i*n + j], expected ) );
+      }
+    }
+
+    // Distances between copies of a point must not become negative
+    manyToMany.resize( m*m );
+    distance.manyToMany( A.data(), m, A.data(), m, d, manyToMany.data() );
+
+    ALEPH_ASSERT_THROW( std::all_of( manyToMany.begin(), manyToMany.end(), [] ( ResultType x ) { return x >= ResultType(0); } ) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testMixedPrecision()
+{
+  ALEPH_TEST_BEGIN( "Mixed-precision distances" );
+
+  using namespace aleph::geometry::distances::detail;
+
+  std::mt19937 rng( 17 );
+  std::uniform_real_distribution<float> distribution( -1.0f, 1.0f );
+
+  auto reference = makeKernels<double>( InstructionSet::Generic );
+
+  for( auto instructionSet : { InstructionSet::Generic, InstructionSet::AVX2, InstructionSet::AVX512 } )
+  {
+    auto kernels = makeKernels<float, double>( instructionSet );
+
+    // Single precision values are converted to double precision without
+    // any loss, so the results must only differ in the order in which
+    // the values are accumulated.
+    for( std::size_t n = 0; n < 68; n++ )
+    {
+      std::vector<float> x( n );
+      std::vector<float> y( n );
+
+      std::generate( x.begin(), x.end(), [&] () { return distribution( rng ); } );
+      std::generate( y.begin(), y.end(), [&] () { return distribution( rng ); } );
+
+      std::vector<double> u( x.begin(), x.end() );
+      std::vector<double> v( y.begin(), y.end() );
+
+      ALEPH_ASSERT_THROW( std::abs( kernels.squaredEuclidean( x.data(), y.data(), n ) - reference.squaredEuclidean( u.data(), v.data(), n ) ) < 1e-12 );
+      ALEPH_ASSERT_THROW( std::abs( kernels.manhattan( x.data(), y.data(), n )        - reference.manhattan( u.data(), v.data(), n ) )        < 1e-12 );
+      ALEPH_ASSERT_THROW( std::abs( kernels.dot( x.data(), y.data(), n )              - reference.dot( u.data(), v.data(), n ) )              < 1e-12 );
+    }
+  }
+
+  // Accumulating many small values in single precision loses precision,
+  // whereas the mixed-precision functor is as precise as the functor for
+  // double precision values.
+  {
+    std::size_t n = 1 << 20;
+
+    std::vector<float> x( n, 0.0f );
+    std::vector<float> y( n, 0.1f );
+
+    std::vector<double> u( x.begin(), x.end() );
+    std::vector<double> v( y.begin(), y.end() );
+
+    auto expected = Euclidean<double>()( u.data(), v.data(), n );
+    auto mixed    = Euclidean<float, double>()( x.data(), y.data(), n );
+    auto single   = Euclidean<float>()( x.data(), y.data(), n );
+
+    ALEPH_ASSERT_THROW( std::abs( mixed - expected ) <= 1e-9 * expected );
+    ALEPH_ASSERT_THROW( std::abs( mixed - expected ) <= std::abs( double( single ) - expected ) );
+  }
+
+  // Ranges that are not contiguous are accumulated in double precision
+  // as well.
+  {
+    std::vector<float> x( 37 );
+    std::vector<float> y( 37 );
+
+    std::generate( x.begin(), x.end(), [&] () { return distribution( rng ); } );
+    std::generate( y.begin(), y.end(), [&] () { return distribution( rng ); } );
+
+    std::deque<float> d1( x.begin(), x.end() );
+    std::deque<float> d2( y.begin(), y.end() );
+
+    std::vector<double> u( x.begin(), x.end() );
+    std::vector<double> v( y.begin(), y.end() );
+
+    ALEPH_ASSERT_THROW( std::abs( Euclidean<float, double>()( d1.begin(), d2.begin(), d1.size() ) - Euclidean<double>()( u.data(), v.data(), u.size() ) ) < 1e-12 );
+    ALEPH_ASSERT_THROW( std::abs( Manhattan<float, double>()( d1.begin(), d2.begin(), d1.size() ) - Manhattan<double>()( u.data(), v.data(), u.size() ) ) < 1e-12 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testPackedHammingDistance()
+{
+  ALEPH_TEST_BEGIN( "Packed Hamming distance" );
+
+  using namespace aleph::geometry::distances::detail;
+
+  std::mt19937_64 rng( 42 );
+
+  auto generic = makeHammingWordsKernel( InstructionSet::Generic );
+
+  PackedHamming<> functor;
+
+  ALEPH_ASSERT_THROW( functor.name() == "Packed Hamming distance" );
+
+  for( std::size_t n = 0; n < 40; n++ )
+  {
+    std::vector<std::uint64_t> x( n );
+    std::vector<std::uint64_t> y( n );
+
+    std::generate( x.begin(), x.end(), [&rng] () { return rng(); } );
+    std::generate( y.begin(), y.end(), [&rng] () { return rng(); } );
+
+    // Unpacking the bits makes it possible to compare the distance to the
+    // ordinary Hamming distance.
+    std::vector<double> u;
+    std::vector<double> v;
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      for( std::size_t j = 0; j < 64; j++ )
+      {
+        u.push_back( static_cast<double>( ( x[i] >> j ) & 1u ) );
+        v.push_back( static_cast<double>( ( y[i] >> j ) & 1u ) );
+      }
+    }
+
+    auto expected = static_cast<std::uint64_t>( Hamming<double>()( u.begin(), v.begin(), u.size() ) );
+
+    ALEPH_ASSERT_EQUAL( n > 0 ? generic( x.data(), y.data(), n ) : 0, expected );
+    ALEPH_ASSERT_EQUAL( functor( x.begin(), y.begin(), n ), expected );
+    ALEPH_ASSERT_EQUAL( functor( x.begin(), x.begin(), n ), 0 );
+
+    for( auto instructionSet : { InstructionSet::AVX2, InstructionSet::AVX512 } )
+      ALEPH_ASSERT_EQUAL( makeHammingWordsKernel( instructionSet )( x.data(), y.data(), n ), expected );
+
+    // Non-contiguous ranges use the element-wise calculation
+    std::list<std::uint64_t> a( x.begin(), x.end() );
+    std::list<std::uint64_t> b( y.begin(), y.end() );
+
+    ALEPH_ASSERT_EQUAL( functor( a.begin(), b.begin(), n ), expected );
+  }
+
+  {
+    std::vector<std::uint32_t> x = { 0xFFFFFFFF, 0x0 };
+    std::vector<std::uint32_t> y = { 0x0000FFFF, 0x1 };
+
+    ALEPH_ASSERT_EQUAL( PackedHamming<std::uint32_t>()( x.begin(), y.begin(), x.size() ), 17 );
+  }
+
+  ALEPH_TEST_END();
+}
+
 int main(int, char**)
 {
   testEuclideanDistance<float> ();
@@ -74,4 +337,21 @@ int main(int, char**)
 
   testManhattanDistance<float> ();
   testManhattanDistance<double>();
+
+  testPackedHammingDistance();
+
+  testKernels<float> ();
+  testKernels<double>();
+
+  testBatchedDistances<float,  Euclidean<float> > ();
+  testBatchedDistances<double, Euclidean<double> >();
+  testBatchedDistances<float,  Hamming<float> >   ();
+  testBatchedDistances<double, Hamming<double> >  ();
+  testBatchedDistances<float,  Manhattan<float> > ();
+  testBatchedDistances<double, Manhattan<double> >();
+
+  testMixedPrecision();
+
+  testBatchedDistances<float, Euclidean<float, double> >();
+  testBatchedDistances<float, Manhattan<float, double> >();
 }
@@ -4,8 +4,16 @@
 
 #include <aleph/persistentHomology/Calculation.hh>
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <random>
 #include <vector>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 template <class T> void test()
 {
   ALEPH_TEST_BEGIN( "Simple directed networks" );
@@ -81,8 +89,128 @@ template <class T> void test()
   ALEPH_TEST_END();
 }
 
+/**
+  Calculates all simplices of the Dowker source complex by checking every
+  subset of vertices. A subset is weighted by the smallest value, over all
+  base points, of the largest graph distance to its vertices.
+*/
+
+template <class T> std::map<std::vector<unsigned>, T> dowkerSimplices( std::vector< std::vector<T> > M, T R, unsigned dimension )
+{
+  auto n = static_cast<unsigned>( M.size() );
+
+  for( unsigned k = 0; k < n; k++ )
+    for( unsigned i = 0; i < n; i++ )
+      for( unsigned j = 0; j < n; j++ )
+        M[i][j] = std::min( M[i][j], M[i][k] + M[k][j] );
+
+  std::map<std::vector<unsigned>, T> simplices;
+
+  for( unsigned mask = 1; mask < ( 1u << n ); mask++ )
+  {
+    std::vector<unsigned> vertices;
+    for( unsigned i = 0; i < n; i++ )
+      if( mask & ( 1u << i ) )
+        vertices.push_back( i );
+
+    if( dimension != 0 && vertices.size() > dimension + 1 )
+      continue;
+
+    bool admissible = false;
+    T weight        = std::numeric_limits<T>::max();
+
+    for( unsigned p = 0; p < n; p++ )
+    {
+      T w = std::numeric_limits<T>::lowest();
+
+      for( auto&& v : vertices )
+        w = std::max( w, M[p][v] );
+
+      if( w <= R )
+      {
+        admissible = true;
+        weight     = std::min( weight, w );
+      }
+    }
+
+    if( admissible )
+      simplices[vertices] = weight;
+  }
+
+  return simplices;
+}
+
+template <class T> void testRandomNetworks()
+{
+  ALEPH_TEST_BEGIN( "Random directed networks" );
+
+  using Matrix = std::vector< std::vector<T> >;
+
+  std::mt19937 rng( 42 );
+  std::uniform_int_distribution<int> distribution( 1, 20 );
+
+  Matrix M( 9, std::vector<T>( 9 ) );
+
+  for( std::size_t i = 0; i < M.size(); i++ )
+    for( std::size_t j = 0; j < M.size(); j++ )
+      M[i][j] = i == j ? T(0) : T( distribution( rng ) );
+
+  for( unsigned dimension : { 0u, 1u, 2u } )
+  {
+    auto expected = dowkerSimplices( M, T(12), dimension );
+
+    for( int numThreads : { 1, 3 } )
+    {
+#ifdef _OPENMP
+      omp_set_num_threads( numThreads );
+#else
+      (void) numThreads;
+#endif
+
+      auto K = aleph::geometry::buildDowkerSourceCompplex<Matrix, unsigned>( M, T(12), dimension );
+
+      ALEPH_ASSERT_EQUAL( K.size(), expected.size() );
+
+      for( auto&& s : K )
+      {
+        std::vector<unsigned> vertices( s.begin(), s.end() );
+        std::sort( vertices.begin(), vertices.end() );
+
+        ALEPH_ASSERT_THROW( expected.find( vertices ) != expected.end() );
+        ALEPH_ASSERT_EQUAL( expected[vertices], s.data() );
+      }
+
+      // Faces have to precede their cofaces
+      for( std::size_t i = 0; i < K.size(); i++ )
+      {
+        auto&& s = K.at(i);
+        for( std::size_t j = 0; j < s.boundarySize(); j++ )
+          ALEPH_ASSERT_THROW( K.index( s.face(j) ) < i );
+      }
+
+      // The sink complex of the transposed network is the source complex
+      // of the original network.
+      Matrix N( M.size(), std::vector<T>( M.size() ) );
+
+      for( std::size_t i = 0; i < M.size(); i++ )
+        for( std::size_t j = 0; j < M.size(); j++ )
+          N[i][j] = M[j][i];
+
+      auto pairs = aleph::geometry::admissiblePairs( N, T(12) );
+      auto L     = aleph::geometry::buildDowkerSinkSourceComplexes<unsigned, T>( pairs, dimension ).second;
+
+      ALEPH_ASSERT_THROW( K == L );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
 int main( int, char** )
 {
   test<float> ();
   test<double>();
+
+  testRandomNetworks<float> ();
+  testRandomNetworks<double>();
 }
@@ -0,0 +1,132 @@
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+using namespace aleph::topology;
+using namespace aleph;
+
+template <class Data, class Vertex> void faceViews()
+{
+  ALEPH_TEST_BEGIN( "Face views" );
+
+  using Simplex = Simplex<Data, Vertex>;
+
+  Simplex s = { 0, 1, 2, 3 };
+  Simplex v = { 0 };
+
+  ALEPH_ASSERT_EQUAL( s.boundarySize(), 4 );
+  ALEPH_ASSERT_EQUAL( v.boundarySize(), 0 );
+
+  // The views have to enumerate the faces in the same order as the
+  // boundary iterator does.
+
+  std::vector<Simplex> faces( s.begin_boundary(), s.end_boundary() );
+
+  ALEPH_ASSERT_EQUAL( faces.size(), s.boundarySize() );
+
+  typename Simplex::vertex_container_type buffer;
+
+  for( std::size_t i = 0; i < s.boundarySize(); i++ )
+  {
+    auto face = s.face( i );
+
+    ALEPH_ASSERT_THROW( face == faces[i] );
+    ALEPH_ASSERT_THROW( face != s );
+    ALEPH_ASSERT_EQUAL( face.size(),      3 );
+    ALEPH_ASSERT_EQUAL( face.dimension(), 2 );
+    ALEPH_ASSERT_EQUAL( face.omitted(),   i );
+    ALEPH_ASSERT_EQUAL( std::distance( face.begin(), face.end() ), 3 );
+
+    for( std::size_t j = 0; j < face.size(); j++ )
+      ALEPH_ASSERT_EQUAL( face[j], faces[i][j] );
+
+    ALEPH_ASSERT_THROW( Simplex( face.begin(), face.end() ) == faces[i] );
+
+    s.face( i, buffer );
+
+    ALEPH_ASSERT_THROW( Simplex( buffer.begin(), buffer.end() ) == faces[i] );
+  }
+
+  ALEPH_EXPECT_EXCEPTION( s.face( 4 ), std::out_of_range );
+
+  ALEPH_TEST_END();
+}
+
+template <class Data, class Vertex> void faceQueries()
+{
+  ALEPH_TEST_BEGIN( "Face queries" );
+
+  using Simplex           = Simplex<Data, Vertex>;
+  using SimplicialComplex = SimplicialComplex<Simplex>;
+
+  std::vector<Simplex> simplices
+    = { {0}, {1}, {2}, {3}, {0,1}, {0,2}, {1,2}, {0,1,2}, {2,3} };
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  for( auto&& s : K )
+  {
+    for( std::size_t i = 0; i < s.boundarySize(); i++ )
+    {
+      auto face = s.face( i );
+      auto it   = K.find( face );
+
+      ALEPH_ASSERT_THROW( K.contains( face ) );
+      ALEPH_ASSERT_THROW( it != K.end() );
+      ALEPH_ASSERT_THROW( face == *it );
+      ALEPH_ASSERT_EQUAL( K.index( face ), K.index( *it ) );
+    }
+  }
+
+  // Faces that are not part of the complex must not be found, even if
+  // they are lexicographically close to existing simplices.
+
+  Simplex t = { 1, 2, 3 };
+
+  ALEPH_ASSERT_THROW( K.contains( t.face( 0 ) ) );
+  ALEPH_ASSERT_THROW( K.contains( t.face( 1 ) ) == false );
+  ALEPH_ASSERT_THROW( K.find( t.face( 1 ) ) == K.end() );
+  ALEPH_EXPECT_EXCEPTION( K.index( t.face( 1 ) ), std::runtime_error );
+
+  // The boundary matrix uses face queries, so its columns have to match
+  // the indices of the faces.
+
+  auto M = makeBoundaryMatrix( K );
+
+  for( std::size_t j = 0; j < K.size(); j++ )
+  {
+    auto&& s    = K.at( j );
+    auto column = M.getColumn( static_cast<unsigned>( j ) );
+
+    std::vector<unsigned> expected;
+
+    for( auto it = s.begin_boundary(); it != s.end_boundary(); ++it )
+      expected.push_back( static_cast<unsigned>( K.index( *it ) ) );
+
+    std::sort( expected.begin(), expected.end() );
+
+    ALEPH_ASSERT_THROW( column == expected );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  faceViews<double, unsigned>();
+  faceViews<double, short   >();
+  faceViews<float,  unsigned>();
+  faceViews<float,  short   >();
+
+  faceQueries<double, unsigned>();
+  faceQueries<double, short   >();
+  faceQueries<float,  unsigned>();
+  faceQueries<float,  short   >();
+}
@@ -0,0 +1,133 @@
+#include <tests/Base.hh>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/Filter.hh>
+#include <aleph/topology/FilteredView.hh>
+#include <aleph/topology/Skeleton.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+using namespace distances;
+
+/** Checks that a view contains the same simplices as a complex, in the same order */
+template <class View, class SimplicialComplex> void checkEquality( const View& V, const SimplicialComplex& K )
+{
+  ALEPH_ASSERT_EQUAL( V.size(), K.size() );
+  ALEPH_ASSERT_THROW( std::equal( V.begin(), V.end(), K.begin() ) );
+
+  for( std::size_t i = 0; i < K.size(); i++ )
+  {
+    ALEPH_ASSERT_THROW( V.at(i) == K.at(i) );
+    ALEPH_ASSERT_EQUAL( V.index( K.at(i) ), i );
+    ALEPH_ASSERT_THROW( V.contains( K.at(i) ) );
+    ALEPH_ASSERT_THROW( *V.find( K.at(i) ) == K.at(i) );
+  }
+
+  if( !K.empty() )
+    ALEPH_ASSERT_EQUAL( V.dimension(), K.dimension() );
+
+  ALEPH_ASSERT_THROW( makeBoundaryMatrix( V ) == makeBoundaryMatrix( K ) );
+  ALEPH_ASSERT_THROW( calculatePersistenceDiagrams( V ) == calculatePersistenceDiagrams( K ) );
+}
+
+template <class T> void test()
+{
+  using PointCloud        = PointCloud<T>;
+  using Distance          = Euclidean<T>;
+  using Wrapper           = BruteForce<PointCloud, Distance>;
+  using RipsSkeleton      = RipsSkeleton<Wrapper>;
+  using SimplicialComplex = typename RipsSkeleton::SimplicialComplex;
+  using Simplex           = typename SimplicialComplex::ValueType;
+
+  auto pointCloud = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/S1.txt" ) );
+
+  Wrapper wrapper( pointCloud );
+  RipsSkeleton ripsSkeleton;
+  RipsExpander<SimplicialComplex> ripsExpander;
+
+  auto K = ripsSkeleton( wrapper, T(1.2) );
+  K      = ripsExpander( K, 2 );
+  K      = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( filtrations::Data<Simplex>() );
+
+  {
+    ALEPH_TEST_BEGIN( "Skeleton views" );
+
+    Skeleton skeleton;
+
+    for( std::size_t k = 0; k <= 3; k++ )
+      checkEquality( skeleton.view( k, K ), skeleton( k, K ) );
+
+    auto V = skeleton.view( 1, K );
+
+    ALEPH_ASSERT_THROW( V.contains( K.at( K.size() - 1 ) ) == false );
+    ALEPH_ASSERT_THROW( V.find( K.at( K.size() - 1 ) ) == V.end() );
+    ALEPH_EXPECT_EXCEPTION( V.index( K.at( K.size() - 1 ) ), std::runtime_error );
+    ALEPH_EXPECT_EXCEPTION( V.at( V.size() ), std::out_of_range );
+
+    ALEPH_TEST_END();
+  }
+
+  {
+    ALEPH_TEST_BEGIN( "Filter views" );
+
+    Filter filter;
+
+    // Sweep over thresholds, similar to a parameter study. Since the
+    // complex is filtered by weights, every sublevel set is closed.
+    for( auto threshold : { T(0.1), T(0.5), T(1.0), T(1.2) } )
+    {
+      auto predicate = [threshold] ( const Simplex& s )
+      {
+        return s.data() <= threshold;
+      };
+
+      auto V = filter.view( K, predicate );
+      auto L = filter( K, predicate );
+
+      checkEquality( V, L );
+    }
+
+    // Views of an empty complex as well as empty views of a complex have
+    // to be supported.
+
+    auto V = makeFilteredView( K, [] ( const Simplex& ) { return false; } );
+
+    ALEPH_ASSERT_THROW( V.empty() );
+    ALEPH_ASSERT_THROW( V.begin() == V.end() );
+    ALEPH_EXPECT_EXCEPTION( V.dimension(), std::runtime_error );
+
+    SimplicialComplex E;
+    auto W = makeFilteredView( E, [] ( const Simplex& ) { return true; } );
+
+    ALEPH_ASSERT_THROW( W.empty() );
+    ALEPH_ASSERT_THROW( W.contains( K.at(0) ) == false );
+
+    ALEPH_TEST_END();
+  }
+}
+
+int main()
+{
+  test<float> ();
+  test<double>();
+}
@@ -0,0 +1,253 @@
+#include <tests/Base.hh>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/HNSW.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+#include <aleph/geometry/distances/Manhattan.hh>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+using namespace aleph::containers;
+using namespace aleph::geometry;
+using namespace aleph;
+
+/**
+  Creates a high-dimensional point cloud that consists of several
+  Gaussian clusters.
+*/
+
+template <class T> PointCloud<T> clusters( std::size_t n, std::size_t d, unsigned seed )
+{
+  std::mt19937 rng( seed );
+  std::uniform_real_distribution<T> uniform( T(0), T(10) );
+  std::normal_distribution<T> normal( T(0), T(1) );
+
+  std::vector< std::vector<T> > centres( 8, std::vector<T>( d ) );
+
+  for( auto&& centre : centres )
+    std::generate( centre.begin(), centre.end(), [&] () { return uniform( rng ); } );
+
+  PointCloud<T> pc( n, d );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    auto p = centres[ i % centres.size() ];
+
+    for( auto&& x : p )
+      x += normal( rng );
+
+    pc.set( i, p.begin(), p.end() );
+  }
+
+  return pc;
+}
+
+/** @returns Fraction of the expected indices that are contained in the actual indices */
+double recall( std::vector< std::vector<std::size_t> > actual, std::vector< std::vector<std::size_t> > expected )
+{
+  std::size_t found = 0;
+  std::size_t total = 0;
+
+  for( std::size_t i = 0; i < expected.size(); i++ )
+  {
+    std::sort( actual[i].begin(), actual[i].end() );
+    std::sort( expected[i].begin(), expected[i].end() );
+
+    std::vector<std::size_t> common;
+
+    std::set_intersection( actual[i].begin(), actual[i].end(),
+                           expected[i].begin(), expected[i].end(),
+                           std::back_inserter( common ) );
+
+    found += common.size();
+    total += expected[i].size();
+  }
+
+  return total > 0 ? static_cast<double>( found ) / static_cast<double>( total ) : 1.0;
+}
+
+template <class T, class Distance> void testRecall()
+{
+  ALEPH_TEST_BEGIN( "HNSW: recall" );
+
+  auto pc = clusters<T>( 1000, 64, 42 );
+
+  BruteForce<PointCloud<T>, Distance> bruteForce( pc );
+
+  std::vector< std::vector<std::size_t> > expectedIndices;
+  std::vector< std::vector<T> > expectedDistances;
+
+  bruteForce.neighbourSearch( 10, expectedIndices, expectedDistances );
+
+  // Choose a radius such that every point has a few neighbours on
+  // average.
+  T radius = T();
+
+  for( auto&& distances : expectedDistances )
+    radius += distances.back();
+
+  radius /= static_cast<T>( expectedDistances.size() );
+
+  std::vector< std::vector<std::size_t> > expectedRadiusIndices;
+  std::vector< std::vector<T> > expectedRadiusDistances;
+
+  bruteForce.radiusSearch( radius, expectedRadiusIndices, expectedRadiusDistances );
+
+  for( int numThreads : { 1, 3 } )
+  {
+#ifdef _OPENMP
+    omp_set_num_threads( numThreads );
+#else
+    (void) numThreads;
+#endif
+
+    HNSW<PointCloud<T>, Distance> hnsw( pc, 12, 100, 50 );
+
+    ALEPH_ASSERT_EQUAL( hnsw.size(), pc.size() );
+
+    std::vector< std::vector<std::size_t> > indices;
+    std::vector< std::vector<T> > distances;
+
+    hnsw.neighbourSearch( 10, indices, distances );
+
+    ALEPH_ASSERT_EQUAL( indices.size(), pc.size() );
+    ALEPH_ASSERT_THROW( recall( indices, expectedIndices ) > 0.95 );
+
+    for( std::size_t i = 0; i < indices.size(); i++ )
+    {
+      ALEPH_ASSERT_EQUAL( indices[i].size(), 10 );
+      ALEPH_ASSERT_EQUAL( indices[i].front(), i );
+      ALEPH_ASSERT_THROW( std::is_sorted( distances[i].begin(), distances[i].end() ) );
+    }
+
+    hnsw.radiusSearch( radius, indices, distances );
+
+    ALEPH_ASSERT_THROW( recall( indices, expectedRadiusIndices ) > 0.95 );
+
+    // Approximate results must never contain points that are too far
+    // away.
+    for( auto&& D : distances )
+      ALEPH_ASSERT_THROW( std::all_of( D.begin(), D.end(), [&radius] ( T d ) { return d < radius; } ) );
+
+    // Increasing the size of the beam must not decrease the recall
+    auto previousRecall = recall( indices, expectedRadiusIndices );
+
+    hnsw.setEfSearch( 200 );
+    hnsw.radiusSearch( radius, indices, distances );
+
+    ALEPH_ASSERT_EQUAL( hnsw.efSearch(), 200 );
+    ALEPH_ASSERT_THROW( recall( indices, expectedRadiusIndices ) >= previousRecall );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testRipsSkeleton()
+{
+  ALEPH_TEST_BEGIN( "HNSW: Rips skeleton" );
+
+  using Distance   = distances::Euclidean<T>;
+  using PointCloud = PointCloud<T>;
+
+  auto pc = clusters<T>( 500, 32, 23 );
+
+  HNSW<PointCloud, Distance> hnsw( pc );
+  BruteForce<PointCloud, Distance> bruteForce( pc );
+
+  auto K = RipsSkeleton< HNSW<PointCloud, Distance> >()( hnsw, T(6) );
+  auto L = RipsSkeleton< BruteForce<PointCloud, Distance> >()( bruteForce, T(6) );
+
+  ALEPH_ASSERT_THROW( K.size() <= L.size() );
+  ALEPH_ASSERT_THROW( static_cast<double>( K.size() ) > 0.95 * static_cast<double>( L.size() ) );
+
+  for( auto&& s : K )
+    ALEPH_ASSERT_THROW( L.contains( s ) );
+
+  ALEPH_TEST_END();
+}
+
+void testDegenerateInputs()
+{
+  ALEPH_TEST_BEGIN( "HNSW: degenerate inputs" );
+
+  using Distance   = distances::Euclidean<double>;
+  using PointCloud = PointCloud<double>;
+
+  {
+    PointCloud pc( 0, 3 );
+    HNSW<PointCloud, Distance> hnsw( pc );
+
+    std::vector< std::vector<std::size_t> > indices;
+    std::vector< std::vector<double> > distances;
+
+    hnsw.neighbourSearch( 3, indices, distances );
+
+    ALEPH_ASSERT_THROW( indices.empty() );
+  }
+
+  // Small point clouds are searched exhaustively
+  {
+    auto pc = clusters<double>( 12, 5, 7 );
+
+    HNSW<PointCloud, Distance> hnsw( pc );
+    BruteForce<PointCloud, Distance> bruteForce( pc );
+
+    std::vector< std::vector<std::size_t> > indices;
+    std::vector< std::vector<double> > distances;
+
+    std::vector< std::vector<std::size_t> > expectedIndices;
+    std::vector< std::vector<double> > expectedDistances;
+
+    hnsw.neighbourSearch( 12, indices, distances );
+    bruteForce.neighbourSearch( 12, expectedIndices, expectedDistances );
+
+    ALEPH_ASSERT_THROW( indices == expectedIndices );
+    ALEPH_ASSERT_THROW( distances == expectedDistances );
+  }
+
+  // Copies of a point always find themselves
+  {
+    PointCloud pc( 50, 3 );
+
+    for( std::size_t i = 0; i < pc.size(); i++ )
+      pc.set( i, { 1.0, 2.0, 3.0 } );
+
+    HNSW<PointCloud, Distance> hnsw( pc, 4 );
+
+    std::vector< std::vector<std::size_t> > indices;
+    std::vector< std::vector<double> > distances;
+
+    hnsw.radiusSearch( 0.5, indices, distances );
+
+    for( std::size_t i = 0; i < indices.size(); i++ )
+      ALEPH_ASSERT_THROW( std::find( indices[i].begin(), indices[i].end(), i ) != indices[i].end() );
+  }
+
+  ALEPH_EXPECT_EXCEPTION( ( HNSW<PointCloud, Distance>( PointCloud( 10, 3 ), 1 ) ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testRecall<double, distances::Euclidean<double> >();
+  testRecall<float,  distances::Euclidean<float> > ();
+  testRecall<double, distances::Manhattan<double> >();
+
+  testRipsSkeleton<double>();
+  testRipsSkeleton<float> ();
+
+  testDegenerateInputs();
+}
@@ -0,0 +1,281 @@
+#include <tests/Base.hh>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <aleph/topology/CompactSimplicialComplex.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/io/Binary.hh>
+#include <aleph/topology/io/SimplicialComplexReader.hh>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+using namespace distances;
+
+/** Checks that two simplicial complexes have the same simplices in the same order */
+template <class SimplicialComplex> void checkEquality( const SimplicialComplex& K, const SimplicialComplex& L )
+{
+  ALEPH_ASSERT_EQUAL( K.size(), L.size() );
+
+  for( std::size_t i = 0; i < K.size(); i++ )
+  {
+    ALEPH_ASSERT_THROW( K.at(i) == L.at(i) );
+    ALEPH_ASSERT_EQUAL( K.at(i).data(), L.at(i).data() );
+  }
+}
+
+template <class T> void testRips()
+{
+  ALEPH_TEST_BEGIN( "Binary format: Rips complex" );
+
+  using PointCloud        = PointCloud<T>;
+  using Distance          = Euclidean<T>;
+  using Wrapper           = BruteForce<PointCloud, Distance>;
+  using RipsSkeleton      = RipsSkeleton<Wrapper>;
+  using SimplicialComplex = typename RipsSkeleton::SimplicialComplex;
+  using Simplex           = typename SimplicialComplex::ValueType;
+
+  auto pointCloud = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/S1.txt" ) );
+
+  Wrapper wrapper( pointCloud );
+  RipsSkeleton ripsSkeleton;
+  RipsExpander<SimplicialComplex> ripsExpander;
+
+  auto K = ripsSkeleton( wrapper, T(1.2) );
+  K      = ripsExpander( K, 2 );
+  K      = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( filtrations::Data<Simplex>() );
+
+  std::string filename = "/tmp/Rips.bin";
+
+  io::BinaryWriter writer;
+  writer( filename, K );
+
+  ALEPH_ASSERT_THROW( io::BinaryReader::isBinary( filename ) );
+
+  SimplicialComplex L;
+
+  io::BinaryReader reader;
+  reader( filename, L );
+
+  checkEquality( K, L );
+  ALEPH_ASSERT_THROW( reader.labels().empty() );
+
+  // The generic reader has to detect the format by itself
+  {
+    SimplicialComplex M;
+
+    io::SimplicialComplexReader reader;
+    reader( filename, M );
+
+    checkEquality( K, M );
+  }
+
+  // Mismatched data types must be detected
+  {
+    topology::SimplicialComplex< topology::Simplex<int, unsigned short> > M;
+    ALEPH_EXPECT_EXCEPTION( reader( filename, M ), std::runtime_error );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testCompact()
+{
+  ALEPH_TEST_BEGIN( "Binary format: compact simplicial complex" );
+
+  using PointCloud        = PointCloud<T>;
+  using Distance          = Euclidean<T>;
+  using Wrapper           = BruteForce<PointCloud, Distance>;
+  using RipsSkeleton      = RipsSkeleton<Wrapper>;
+  using SimplicialComplex = typename RipsSkeleton::SimplicialComplex;
+  using Simplex           = typename SimplicialComplex::ValueType;
+
+  auto pointCloud = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/S1.txt" ) );
+
+  Wrapper wrapper( pointCloud );
+  RipsSkeleton ripsSkeleton;
+  RipsExpander<SimplicialComplex> ripsExpander;
+
+  auto K = ripsSkeleton( wrapper, T(1.2) );
+  K      = ripsExpander( K, 2 );
+  K      = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( filtrations::Data<Simplex>() );
+
+  std::string filename = "/tmp/Rips_compact.bin";
+
+  io::BinaryWriter writer;
+  writer( filename, K );
+
+  // The complex refers to the mapped file, so the file has to use the
+  // layout of a compact complex, including its lexicographic order of
+  // simplices, which is required for looking up simplices.
+  auto check = [&K] ( const CompactSimplicialComplex<Simplex, T, std::uint32_t>& C )
+  {
+    ALEPH_ASSERT_EQUAL( C.size(), K.size() );
+    ALEPH_ASSERT_EQUAL( C.dimension(), K.dimension() );
+
+    for( std::size_t i = 0; i < K.size(); i++ )
+    {
+      ALEPH_ASSERT_THROW( C[i] == K.at(i) );
+      ALEPH_ASSERT_EQUAL( C[i].data(), K.at(i).data() );
+      ALEPH_ASSERT_EQUAL( C.index( K.at(i) ), i );
+    }
+  };
+
+  {
+    CompactSimplicialComplex<Simplex, T, std::uint32_t> C;
+
+    io::BinaryReader reader;
+    reader( filename, C );
+
+    check( C );
+
+    // Copies share the mapped file, which remains valid after the
+    // original complex has been destroyed.
+    auto D = C;
+    C      = CompactSimplicialComplex<Simplex, T, std::uint32_t>();
+
+    check( D );
+
+    // Compact complexes are stored without any conversion
+    io::BinaryWriter writer;
+    writer( "/tmp/Rips_compact_copy.bin", D );
+
+    SimplicialComplex L;
+    reader( "/tmp/Rips_compact_copy.bin", L );
+
+    checkEquality( K, L );
+  }
+
+  // Indices of a different size are converted
+  {
+    CompactSimplicialComplex<Simplex, T, std::uint64_t> C;
+
+    io::SimplicialComplexReader reader;
+    reader( filename, C );
+
+    ALEPH_ASSERT_EQUAL( C.size(), K.size() );
+
+    for( std::size_t i = 0; i < K.size(); i++ )
+    {
+      ALEPH_ASSERT_THROW( C[i] == K.at(i) );
+      ALEPH_ASSERT_EQUAL( C.index( K.at(i) ), i );
+    }
+  }
+
+  // Weights of a different type are rejected instead of being converted
+  {
+    CompactSimplicialComplex<Simplex, int, std::uint32_t> C;
+
+    io::BinaryReader reader;
+    ALEPH_EXPECT_EXCEPTION( reader( filename, C ), std::runtime_error );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testLabels()
+{
+  ALEPH_TEST_BEGIN( "Binary format: labels" );
+
+  using Simplex           = topology::Simplex<double, unsigned>;
+  using SimplicialComplex = topology::SimplicialComplex<Simplex>;
+
+  SimplicialComplex K = {
+    {0}, {1}, {2}, Simplex( {0,1}, 1.0 ), Simplex( {1,2}, 2.0 ), Simplex( {0,2}, 3.0 ), Simplex( {0,1,2}, 3.0 )
+  };
+
+  std::vector<std::string> labels = { "a", "", "some longer label" };
+  std::string filename            = "/tmp/Labels.bin";
+
+  io::BinaryWriter writer;
+  writer.setLabels( labels.begin(), labels.end() );
+  writer( filename, K );
+
+  SimplicialComplex L;
+
+  io::SimplicialComplexReader reader;
+  reader( filename, L );
+
+  checkEquality( K, L );
+  ALEPH_ASSERT_THROW( reader.labels() == labels );
+
+  ALEPH_TEST_END();
+}
+
+void testErrors()
+{
+  ALEPH_TEST_BEGIN( "Binary format: errors" );
+
+  using Simplex           = topology::Simplex<double, unsigned>;
+  using SimplicialComplex = topology::SimplicialComplex<Simplex>;
+
+  SimplicialComplex K = { {0}, {1}, {0,1} };
+  SimplicialComplex L;
+
+  io::BinaryWriter writer;
+  io::BinaryReader reader;
+
+  // Empty complexes are permitted
+  writer( "/tmp/Empty.bin", L );
+  reader( "/tmp/Empty.bin", L );
+
+  ALEPH_ASSERT_THROW( L.empty() );
+
+  // Truncated files are rejected
+  writer( "/tmp/Truncated.bin", K );
+
+  std::string contents;
+
+  {
+    std::ifstream in( "/tmp/Truncated.bin", std::ios::binary );
+    contents.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  }
+
+  {
+    std::ofstream out( "/tmp/Truncated.bin", std::ios::binary );
+    out.write( contents.data(), static_cast<std::streamsize>( contents.size() - 16 ) );
+  }
+
+  ALEPH_ASSERT_THROW( io::BinaryReader::isBinary( "/tmp/Truncated.bin" ) );
+  ALEPH_EXPECT_EXCEPTION( reader( "/tmp/Truncated.bin", L ), std::runtime_error );
+
+  // Other files are not detected
+  ALEPH_ASSERT_THROW( io::BinaryReader::isBinary( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple.net" ) ) == false );
+  ALEPH_EXPECT_EXCEPTION( reader( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple.net" ), L ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testRips<float> ();
+  testRips<double>();
+
+  testCompact<float> ();
+  testCompact<double>();
+
+  testLabels();
+  testErrors();
+}
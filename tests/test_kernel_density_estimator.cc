@@ -23,6 +23,20 @@ void test1D()
     ALEPH_ASSERT_THROW( std::abs( densities[i] - density ) < 1e-4 );
   }
 
+  // Single precision data must result in the same densities because
+  // the estimator always accumulates in double precision.
+  std::vector<float> singlePrecisionData( data.begin(), data.end() );
+
+  for( std::size_t i = 0; i < data.size(); i++ )
+  {
+    double density = kde( singlePrecisionData.begin(), singlePrecisionData.end(),
+                          singlePrecisionData[i],
+                          aleph::math::kernels::Gaussian( std::sqrt( 2.25 ) ),
+                          aleph::math::norms::Identity() );
+
+    ALEPH_ASSERT_THROW( std::abs( densities[i] - density ) < 1e-4 );
+  }
+
   ALEPH_TEST_END();
 }
 
@@ -4,12 +4,16 @@
 
 #include <aleph/geometry/BruteForce.hh>
 #include <aleph/geometry/FLANN.hh>
+#include <aleph/geometry/KDTree.hh>
 #include <aleph/geometry/NearestNeighbours.hh>
 
 #include <aleph/geometry/distances/Euclidean.hh>
+#include <aleph/geometry/distances/Manhattan.hh>
 
 #include <tests/Base.hh>
 
+#include <algorithm>
+#include <random>
 #include <vector>
 
 #include <cassert>
@@ -86,6 +90,66 @@ template <class T> void test()
   testInternal< FLANN<PointCloud, Distance> >( pointCloud );
 #endif
   testInternal< BruteForce<PointCloud, Distance> >( pointCloud );
+  testInternal< KDTree<PointCloud, Distance> >( pointCloud );
+
+  ALEPH_TEST_END();
+}
+
+template <class T, class Distance> void testKDTree( std::size_t n, std::size_t d )
+{
+  ALEPH_TEST_BEGIN( "kd-tree: comparison with brute-force calculation" );
+
+  using PointCloud = PointCloud<T>;
+
+  // Coordinates are drawn from a small set of values, which results in
+  // many duplicate points and ties
+  PointCloud pointCloud( n, d );
+
+  std::mt19937 rng( 42 );
+  std::uniform_int_distribution<int> distribution( 0, 9 );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    std::vector<T> p( d );
+
+    for( auto&& x : p )
+      x = T( distribution( rng ) ) / T( 3 );
+
+    pointCloud.set( i, p.begin(), p.end() );
+  }
+
+  BruteForce<PointCloud, Distance> bruteForce( pointCloud );
+  KDTree<PointCloud, Distance> kdTree( pointCloud, 4 );
+
+  std::vector< std::vector<std::size_t> > I1, I2;
+  std::vector< std::vector<T> > D1, D2;
+
+  for( auto r : { T( 0.5 ), T( 1.0 ), T( 2.5 ) } )
+  {
+    bruteForce.radiusSearch( r, I1, D1 );
+    kdTree.radiusSearch( r, I2, D2 );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      ALEPH_ASSERT_THROW( std::is_sorted( D2[i].begin(), D2[i].end() ) );
+
+      std::sort( I1[i].begin(), I1[i].end() );
+      std::sort( I2[i].begin(), I2[i].end() );
+      std::sort( D1[i].begin(), D1[i].end() );
+
+      ALEPH_ASSERT_THROW( I1[i] == I2[i] );
+      ALEPH_ASSERT_THROW( D1[i] == D2[i] );
+    }
+  }
+
+  for( unsigned k : { 1, 3, 10 } )
+  {
+    bruteForce.neighbourSearch( k, I1, D1 );
+    kdTree.neighbourSearch( k, I2, D2 );
+
+    for( std::size_t i = 0; i < n; i++ )
+      ALEPH_ASSERT_THROW( D1[i] == D2[i] );
+  }
 
   ALEPH_TEST_END();
 }
@@ -94,4 +158,8 @@ int main()
 {
   test<float> ();
   test<double>();
+
+  testKDTree<double, Euclidean<double> >( 500, 3 );
+  testKDTree<float,  Manhattan<float> > ( 400, 5 );
+  testKDTree<double, Euclidean<double> >( 300, 1 );
 }
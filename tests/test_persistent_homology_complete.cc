@@ -15,6 +15,7 @@
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/topology/representations/Compressed.hh>
 #include <aleph/topology/representations/List.hh>
 #include <aleph/topology/representations/Set.hh>
 #include <aleph/topology/representations/Vector.hh>
@@ -104,20 +105,25 @@ template <class T> void test()
   auto diagrams3 = testInternal<representations::List<Index> >( K );
   auto diagrams1 = testInternal<representations::Set<Index> >( K );
   auto diagrams2 = testInternal<representations::Vector<Index> >( K );
+  auto diagrams4 = testInternal<representations::Compressed<Index> >( K );
 
   ALEPH_ASSERT_THROW( diagrams1.size() == diagrams2.size() );
   ALEPH_ASSERT_THROW( diagrams2.size() == diagrams3.size() );
+  ALEPH_ASSERT_THROW( diagrams3.size() == diagrams4.size() );
 
   for( std::size_t i = 0; i < diagrams1.size(); i++ )
   {
     auto&& D1 = diagrams1.at(i);
     auto&& D2 = diagrams2.at(i);
     auto&& D3 = diagrams3.at(i);
+    auto&& D4 = diagrams4.at(i);
 
     ALEPH_ASSERT_THROW( D1.dimension() == D2.dimension() );
     ALEPH_ASSERT_THROW( D2.dimension() == D3.dimension() );
+    ALEPH_ASSERT_THROW( D3.dimension() == D4.dimension() );
     ALEPH_ASSERT_THROW( D1 == D2 );
     ALEPH_ASSERT_THROW( D2 == D3 );
+    ALEPH_ASSERT_THROW( D3 == D4 );
   }
 
   ALEPH_TEST_END();
@@ -1,11 +1,20 @@
+#include <aleph/containers/BitPointCloud.hh>
+#include <aleph/containers/MappedPointCloud.hh>
 #include <aleph/containers/PointCloud.hh>
 
 #include <tests/Base.hh>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include <cstdint>
+
 using namespace aleph::containers;
 using namespace aleph;
 
@@ -101,15 +110,211 @@ template <class T> void testAccess()
   ALEPH_TEST_END();
 }
 
+template <class T> void testViews()
+{
+  ALEPH_TEST_BEGIN( "Point cloud views and alignment" );
+
+  auto pc
+    = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_comma_separated.txt" ) );
+
+  PointCloud<T> padded( pc.size(), pc.dimension(), true );
+
+  ALEPH_ASSERT_EQUAL( pc.stride(), pc.dimension() );
+  ALEPH_ASSERT_EQUAL( padded.stride() * sizeof(T), PointCloud<T>::alignment );
+
+  for( std::size_t i = 0; i < pc.size(); i++ )
+  {
+    auto p = pc[i];
+    auto q = pc.point( i );
+
+    ALEPH_ASSERT_EQUAL( q.size(), pc.dimension() );
+    ALEPH_ASSERT_THROW( std::equal( p.begin(), p.end(), q.begin() ) );
+    ALEPH_ASSERT_THROW( q[0] == p[0] );
+
+    padded.set( i, q.begin(), q.end() );
+  }
+
+  ALEPH_ASSERT_THROW( pc == padded );
+  ALEPH_ASSERT_THROW( padded == PointCloud<T>( padded ) );
+
+  // Every point of a padded point cloud is aligned, and the padding
+  // consists of zeroes.
+  for( std::size_t i = 0; i < padded.size(); i++ )
+  {
+    auto p       = padded.point( i );
+    auto address = reinterpret_cast<std::uintptr_t>( p.data() );
+
+    ALEPH_ASSERT_EQUAL( address % PointCloud<T>::alignment, 0 );
+    ALEPH_ASSERT_THROW( std::all_of( p.end(), p.begin() + padded.stride(), [] ( T x ) { return x == T(); } ) );
+  }
+
+  ALEPH_ASSERT_EQUAL( reinterpret_cast<std::uintptr_t>( pc.data() ) % PointCloud<T>::alignment, 0 );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testParser()
+{
+  ALEPH_TEST_BEGIN( "Point cloud parser" );
+
+  std::string filename = "/tmp/Point_cloud.txt";
+
+  {
+    std::ofstream out( filename );
+
+    // Comments, empty lines, and a final row without a newline
+    out << "# Comment\n"
+        << "1, 2, 3\n"
+        << "\n"
+        << "   \t\n"
+        << "4 5\t6\r\n"
+        << "# Another comment\n"
+        << "7:8:9";
+  }
+
+  auto pc = load<T>( filename );
+
+  ALEPH_ASSERT_EQUAL( pc.size(),      3 );
+  ALEPH_ASSERT_EQUAL( pc.dimension(), 3 );
+
+  for( std::size_t i = 0; i < pc.size(); i++ )
+  {
+    auto p = pc.point( i );
+
+    for( std::size_t j = 0; j < p.size(); j++ )
+      ALEPH_ASSERT_EQUAL( p[j], static_cast<T>( 3 * i + j + 1 ) );
+  }
+
+  {
+    std::ofstream out( filename );
+
+    out << "1 2 3\n"
+        << "4 5\n";
+  }
+
+  ALEPH_EXPECT_EXCEPTION( load<T>( filename ), std::runtime_error );
+  ALEPH_ASSERT_THROW( load<T>( "/tmp/Nonexistent_point_cloud.txt" ).empty() );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testBinaryFormats()
+{
+  ALEPH_TEST_BEGIN( "Binary point cloud formats" );
+
+  auto pc
+    = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_comma_separated.txt" ) );
+
+  {
+    std::string filename = "/tmp/Iris.npy";
+    saveNumPy( filename, pc );
+
+    auto mapped = loadNumPy<T>( filename );
+
+    ALEPH_ASSERT_EQUAL( mapped.size(),      pc.size() );
+    ALEPH_ASSERT_EQUAL( mapped.dimension(), pc.dimension() );
+    ALEPH_ASSERT_THROW( mapped == pc );
+
+    // Modifications must not change the file
+    mapped.set( 0, { T(1), T(2), T(3), T(4) } );
+
+    ALEPH_ASSERT_THROW( loadNumPy<T>( filename ) == pc );
+
+    // Copies use their own memory
+    auto copy = mapped;
+    copy.set( 0, { T(0), T(0), T(0), T(0) } );
+
+    ALEPH_ASSERT_THROW( !( copy == mapped ) );
+
+    // Type mismatches are detected
+    using Other = typename std::conditional<std::is_same<T, float>::value, double, float>::type;
+    ALEPH_EXPECT_EXCEPTION( loadNumPy<Other>( filename ), std::runtime_error );
+  }
+
+  {
+    std::string filename = "/tmp/Iris.bin";
+    saveRaw( filename, pc );
+
+    auto mapped = loadRaw<T>( filename, pc.dimension() );
+
+    ALEPH_ASSERT_THROW( mapped == pc );
+    ALEPH_EXPECT_EXCEPTION( loadRaw<T>( filename, 7 ), std::runtime_error );
+  }
+
+  ALEPH_EXPECT_EXCEPTION( loadNumPy<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_comma_separated.txt" ) ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+void testBitPointCloud()
+{
+  ALEPH_TEST_BEGIN( "Bit point cloud" );
+
+  // Uses more than one word per point, with some unused bits
+  BitPointCloud pc( 3, 70 );
+
+  ALEPH_ASSERT_EQUAL( pc.size(),       3 );
+  ALEPH_ASSERT_EQUAL( pc.bits(),      70 );
+  ALEPH_ASSERT_EQUAL( pc.dimension(),  2 );
+  ALEPH_ASSERT_THROW( pc.empty() == false );
+
+  std::vector<int> p( 70 );
+
+  for( std::size_t j = 0; j < p.size(); j++ )
+    p[j] = j % 3 == 0 || j == 68;
+
+  pc.set( 1, p.begin(), p.end() );
+
+  {
+    std::vector<int> q;
+    pc.get( 1, std::back_inserter( q ) );
+
+    ALEPH_ASSERT_THROW( p == q );
+  }
+
+  // Other points remain unchanged
+  ALEPH_ASSERT_EQUAL( pc[0].size(), 2 );
+  ALEPH_ASSERT_THROW( std::all_of( pc[0].begin(), pc[0].end(), [] ( std::uint64_t w ) { return w == 0; } ) );
+  ALEPH_ASSERT_THROW( std::all_of( pc[2].begin(), pc[2].end(), [] ( std::uint64_t w ) { return w == 0; } ) );
+
+  ALEPH_ASSERT_THROW( pc.bit( 1, 0 ) );
+  ALEPH_ASSERT_THROW( pc.bit( 1, 1 ) == false );
+  ALEPH_ASSERT_THROW( pc.bit( 1, 68 ) );
+
+  ALEPH_ASSERT_EQUAL( pc[1].begin()[0], 0x9249249249249249ull );
+  ALEPH_ASSERT_EQUAL( pc[1].begin()[1], 0x34ull );
+
+  // Setting a point again must clear the previous bits
+  {
+    std::vector<int> q( 70 );
+    pc.set( 1, q.begin(), q.end() );
+
+    ALEPH_ASSERT_THROW( pc == BitPointCloud( 3, 70 ) );
+  }
+
+  ALEPH_EXPECT_EXCEPTION( pc.set( 3, p.begin(), p.end() ), std::runtime_error );
+  ALEPH_EXPECT_EXCEPTION( pc.set( 0, { 1, 0, 1 } ),          std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
 int main()
 {
   std::cerr << "-- float\n";
 
   testFormats<float> ();
   testAccess<float>  ();
+  testViews<float>   ();
+  testParser<float>  ();
+  testBinaryFormats<float>();
 
   std::cerr << "-- double\n";
 
   testFormats<double>();
   testAccess<double> ();
+  testViews<double>  ();
+  testParser<double> ();
+  testBinaryFormats<double>();
+
+  testBitPointCloud();
 }
@@ -22,3 +22,20 @@ numpy_diagram = np.array(diagram)
 for point, np_point in zip(diagram, numpy_diagram):
     assert point.x == np_point[0]
     assert point.y == np_point[1]
+
+# Point clouds in single and double precision, as well as transposed
+# arrays, which cannot be used without copying, result in the same
+# persistence diagrams.
+X = np.array([[0.0, 0.0], [1.0, 0.0], [0.0, 2.0], [3.0, 3.0]])
+
+diagrams = [
+  al.calculatePersistenceDiagrams(X, 5.0, 2),
+  al.calculatePersistenceDiagrams(X.astype(np.float32), 5.0, 2),
+  al.calculatePersistenceDiagrams(np.asfortranarray(X), 5.0, 2)
+]
+
+for D in diagrams[1:]:
+    for d1, d2 in zip(diagrams[0], D):
+        for p1, p2 in zip(d1, d2):
+            assert abs(p1.x - p2.x) < 1e-6
+            assert abs(p1.y - p2.y) < 1e-6 or p1.y == p2.y
@@ -0,0 +1,151 @@
+#include <tests/Base.hh>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/RepresentativeCycles.hh>
+
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/Conversions.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/representations/Vector.hh>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+using namespace distances;
+
+using namespace aleph::persistentHomology::algorithms;
+
+/**
+  Checks that a chain is a cycle, i.e. that its boundary vanishes, and
+  that its youngest simplex is the creator.
+*/
+
+template <class Matrix, class Index> void checkCycle( const Matrix& M, Index creator, const std::vector<Index>& cycle )
+{
+  ALEPH_ASSERT_THROW( cycle.empty() == false );
+  ALEPH_ASSERT_EQUAL( cycle.back(), creator );
+
+  std::vector<Index> boundary;
+
+  for( auto&& simplex : cycle )
+  {
+    ALEPH_ASSERT_EQUAL( M.getDimension( simplex ), M.getDimension( creator ) );
+
+    auto column = M.getColumn( simplex );
+
+    std::vector<Index> result;
+    std::set_symmetric_difference( boundary.begin(), boundary.end(),
+                                   column.begin(), column.end(),
+                                   std::back_inserter( result ) );
+
+    boundary.swap( result );
+  }
+
+  ALEPH_ASSERT_THROW( boundary.empty() );
+}
+
+template <class ReductionAlgorithm, class T> void test()
+{
+  ALEPH_TEST_BEGIN( "Representative cycles" );
+
+  using PointCloud        = PointCloud<T>;
+  using Distance          = Euclidean<T>;
+  using Wrapper           = BruteForce<PointCloud, Distance>;
+  using RipsSkeleton      = RipsSkeleton<Wrapper>;
+  using SimplicialComplex = typename RipsSkeleton::SimplicialComplex;
+  using Simplex           = typename SimplicialComplex::ValueType;
+  using Representation    = representations::Vector<unsigned>;
+
+  auto pointCloud = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/S1.txt" ) );
+
+  Wrapper wrapper( pointCloud );
+  RipsSkeleton ripsSkeleton;
+  RipsExpander<SimplicialComplex> ripsExpander;
+
+  auto K = ripsSkeleton( wrapper, T(1.2) );
+  K      = ripsExpander( K, 2 );
+  K      = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( filtrations::Data<Simplex>() );
+
+  auto M = makeBoundaryMatrix<Representation>( K );
+
+  auto result  = calculateRepresentativeCycles<ReductionAlgorithm>( M, 0u, true );
+  auto pairing = result.first;
+  auto cycles  = result.second;
+
+  ALEPH_ASSERT_THROW( pairing == calculatePersistencePairing<ReductionAlgorithm>( M ) );
+  ALEPH_ASSERT_EQUAL( cycles.size(), pairing.size() );
+
+  unsigned numEssential = 0;
+
+  for( auto&& pair : pairing )
+  {
+    ALEPH_ASSERT_THROW( cycles.contains( pair.first ) );
+    checkCycle( M, pair.first, cycles.get( pair.first ) );
+
+    if( pair.second == std::numeric_limits<unsigned>::max() )
+      ++numEssential;
+  }
+
+  // There is one connected component and, for the chosen threshold, one
+  // cycle of the circle.
+  ALEPH_ASSERT_EQUAL( numEssential, 2 );
+
+  ALEPH_TEST_END();
+
+  ALEPH_TEST_BEGIN( "Representative cycles with threshold" );
+
+  unsigned threshold = 10;
+
+  auto significantCycles = calculateRepresentativeCycles<ReductionAlgorithm>( M, threshold, true ).second;
+  auto finiteCycles      = calculateRepresentativeCycles<ReductionAlgorithm>( M, threshold ).second;
+
+  ALEPH_ASSERT_THROW( significantCycles.size() < cycles.size() );
+  ALEPH_ASSERT_EQUAL( significantCycles.size(), finiteCycles.size() + numEssential );
+
+  for( auto&& pair : pairing )
+  {
+    bool essential   = pair.second == std::numeric_limits<unsigned>::max();
+    bool significant = essential || pair.second - pair.first >= threshold;
+
+    ALEPH_ASSERT_EQUAL( significantCycles.contains( pair.first ), significant );
+    ALEPH_ASSERT_EQUAL( finiteCycles.contains( pair.first ), significant && !essential );
+
+    if( significant )
+      ALEPH_ASSERT_THROW( significantCycles.get( pair.first ) == cycles.get( pair.first ) );
+  }
+
+  ALEPH_EXPECT_EXCEPTION( calculateRepresentativeCycles<ReductionAlgorithm>( M.dualize() ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  test<Standard, float> ();
+  test<Standard, double>();
+  test<Twist,    float> ();
+  test<Twist,    double>();
+}
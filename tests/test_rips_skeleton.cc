@@ -1,16 +1,22 @@
 #include <aleph/config/FLANN.hh>
 
+#include <aleph/containers/BitPointCloud.hh>
 #include <aleph/containers/PointCloud.hh>
 
 #include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/CoverTree.hh>
 #include <aleph/geometry/FLANN.hh>
 #include <aleph/geometry/RipsSkeleton.hh>
 
 #include <aleph/geometry/distances/Euclidean.hh>
+#include <aleph/geometry/distances/Hamming.hh>
+#include <aleph/geometry/distances/PackedHamming.hh>
 
 #include <tests/Base.hh>
 
 #include <algorithm>
+#include <cmath>
+#include <random>
 #include <vector>
 
 using namespace aleph::containers;
@@ -52,8 +58,108 @@ template <class T> void test()
   ALEPH_TEST_END();
 }
 
+void testBinary()
+{
+  ALEPH_TEST_BEGIN( "Rips skeleton of binary vectors" );
+
+  std::size_t n    = 150;
+  std::size_t bits = 100;
+
+  BitPointCloud packed( n, bits );
+  PointCloud<double> unpacked( n, bits );
+
+  std::mt19937 rng( 42 );
+  std::bernoulli_distribution distribution( 0.3 );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    std::vector<double> p( bits );
+
+    for( auto&& x : p )
+      x = distribution( rng ) ? 1.0 : 0.0;
+
+    packed.set( i, p.begin(), p.end() );
+    unpacked.set( i, p.begin(), p.end() );
+  }
+
+  using BruteForce     = BruteForce<BitPointCloud, distances::PackedHamming<> >;
+  using CoverTreeIndex = CoverTreeIndex<BitPointCloud, distances::PackedHamming<> >;
+  using Reference      = aleph::geometry::BruteForce<PointCloud<double>, distances::Hamming<double> >;
+
+  BruteForce bruteForce( packed );
+  CoverTreeIndex coverTree( packed );
+  Reference reference( unpacked );
+
+  auto K = RipsSkeleton<BruteForce>()( bruteForce, 40 );
+  auto L = RipsSkeleton<CoverTreeIndex>()( coverTree, 40 );
+  auto M = RipsSkeleton<Reference>()( reference, 40.0 );
+
+  ALEPH_ASSERT_THROW( K.size() > n );
+  ALEPH_ASSERT_EQUAL( K.size(), L.size() );
+  ALEPH_ASSERT_EQUAL( K.size(), M.size() );
+
+  // Distances are integers, so all weights have to coincide exactly
+  using Simplex = decltype(K)::ValueType;
+
+  for( auto&& s : M )
+  {
+    auto it = K.find( Simplex( s.begin(), s.end() ) );
+    auto jt = L.find( Simplex( s.begin(), s.end() ) );
+
+    ALEPH_ASSERT_THROW( it != K.end() );
+    ALEPH_ASSERT_THROW( jt != L.end() );
+    ALEPH_ASSERT_EQUAL( static_cast<double>( it->data() ), s.data() );
+    ALEPH_ASSERT_EQUAL( jt->data(), it->data() );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testMixedPrecision()
+{
+  ALEPH_TEST_BEGIN( "Rips skeleton with mixed-precision distances" );
+
+  auto filename = CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" );
+
+  auto pointCloudFloat  = load<float> ( filename );
+  auto pointCloudDouble = load<double>( filename );
+
+  using Mixed     = aleph::geometry::BruteForce<PointCloud<float>,  distances::Euclidean<float, double> >;
+  using Reference = aleph::geometry::BruteForce<PointCloud<double>, distances::Euclidean<double> >;
+
+  Mixed mixed( pointCloudFloat );
+  Reference reference( pointCloudDouble );
+
+  auto K = RipsSkeleton<Mixed>()( mixed, 1.0 );
+  auto L = RipsSkeleton<Reference>()( reference, 1.0 );
+
+  ALEPH_ASSERT_THROW( K.size() > pointCloudFloat.size() );
+
+  // Only coordinates are stored in single precision, so the weights have
+  // to coincide up to the rounding of the input values.
+  using Simplex = decltype(K)::ValueType;
+
+  for( auto&& s : L )
+  {
+    auto it = K.find( Simplex( s.begin(), s.end() ) );
+
+    if( it == K.end() )
+      continue;
+
+    ALEPH_ASSERT_THROW( std::abs( static_cast<double>( it->data() ) - s.data() ) < 1e-5 );
+  }
+
+  ALEPH_ASSERT_THROW( K.size() <= L.size() + L.size() / 100 );
+  ALEPH_ASSERT_THROW( L.size() <= K.size() + K.size() / 100 );
+
+  ALEPH_TEST_END();
+}
+
 int main()
 {
   test<float> ();
   test<double>();
+
+  testBinary();
+  testMixedPrecision();
 }
@@ -0,0 +1,195 @@
+#include <tests/Base.hh>
+
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+#include <aleph/topology/filtrations/LowerStar.hh>
+
+#include <aleph/utilities/ParallelSort.hh>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+using namespace aleph::topology;
+using namespace aleph;
+
+/**
+  Creates the full 2-skeleton on a set of vertices, with every simplex
+  being assigned the maximum of the weights of its vertices. The
+  simplices are shuffled and some of them are duplicated in order to
+  check the bulk-loading procedure.
+*/
+
+template <class Simplex> std::vector<Simplex> makeSimplices( const std::vector<typename Simplex::DataType>& weights )
+{
+  using DataType   = typename Simplex::DataType;
+  using VertexType = typename Simplex::VertexType;
+
+  auto n = static_cast<VertexType>( weights.size() );
+
+  std::vector<Simplex> simplices;
+
+  for( VertexType u = 0; u < n; u++ )
+  {
+    simplices.push_back( Simplex( u, weights[u] ) );
+
+    for( VertexType v = VertexType( u+1 ); v < n; v++ )
+    {
+      simplices.push_back( Simplex( {u,v}, std::max( weights[u], weights[v] ) ) );
+
+      for( VertexType w = VertexType( v+1 ); w < n; w++ )
+      {
+        DataType weight = std::max( { weights[u], weights[v], weights[w] } );
+        simplices.push_back( Simplex( {u,v,w}, weight ) );
+      }
+    }
+  }
+
+  std::mt19937 rng( 42 );
+
+  std::vector<Simplex> duplicates( simplices.begin(), simplices.begin() + n );
+  simplices.insert( simplices.end(), duplicates.begin(), duplicates.end() );
+
+  std::shuffle( simplices.begin(), simplices.end(), rng );
+  return simplices;
+}
+
+template <class SimplicialComplex, class Simplex, class Comparison> void checkOrder( const SimplicialComplex& K, std::vector<Simplex> simplices, Comparison comparison )
+{
+  std::sort( simplices.begin(), simplices.end() );
+  simplices.erase( std::unique( simplices.begin(), simplices.end() ), simplices.end() );
+  std::sort( simplices.begin(), simplices.end(), comparison );
+
+  ALEPH_ASSERT_EQUAL( K.size(), simplices.size() );
+  ALEPH_ASSERT_THROW( std::equal( K.begin(), K.end(), simplices.begin() ) );
+
+  for( std::size_t i = 0; i < simplices.size(); i++ )
+  {
+    ALEPH_ASSERT_EQUAL( K.index( simplices[i] ), i );
+    ALEPH_ASSERT_THROW( K.at(i).data() == simplices[i].data() );
+
+    // Faces have to precede their cofaces
+    for( std::size_t j = 0; j < simplices[i].boundarySize(); j++ )
+      ALEPH_ASSERT_THROW( K.index( simplices[i].face(j) ) < i );
+  }
+}
+
+template <class Data, class Vertex> void test()
+{
+  using Simplex           = Simplex<Data, Vertex>;
+  using SimplicialComplex = SimplicialComplex<Simplex>;
+
+  // This is sufficiently large to use the parallel sort, provided that
+  // more than one thread is available.
+  unsigned n = 50;
+
+  std::mt19937 rng( 23 );
+  std::uniform_real_distribution<double> distribution( 0.0, 1.0 );
+
+  std::vector<Data> weights;
+  weights.reserve( n );
+
+  for( unsigned i = 0; i < n; i++ )
+    weights.push_back( static_cast<Data>( distribution( rng ) ) );
+
+  auto simplices = makeSimplices<Simplex>( weights );
+
+  {
+    ALEPH_TEST_BEGIN( "Sorting by data" );
+
+    filtrations::Data<Simplex> filtration;
+
+    SimplicialComplex K( simplices.begin(), simplices.end() );
+    K.sort( filtration );
+
+    checkOrder( K, simplices, filtration );
+
+    ALEPH_TEST_END();
+  }
+
+  {
+    ALEPH_TEST_BEGIN( "Bulk loading with data filtration" );
+
+    filtrations::Data<Simplex> filtration;
+
+    SimplicialComplex K;
+    K.bulkLoad( simplices, filtration );
+
+    checkOrder( K, simplices, filtration );
+
+    // Bulk loading replaces the previous contents of the complex
+    K.bulkLoad( { {0}, {1}, {0,1}, {0} }, filtration );
+
+    ALEPH_ASSERT_EQUAL( K.size(), 3 );
+    ALEPH_ASSERT_THROW( K.contains( Simplex( {0,1} ) ) );
+    ALEPH_ASSERT_THROW( K.contains( Simplex( {1,2} ) ) == false );
+
+    ALEPH_TEST_END();
+  }
+
+  {
+    ALEPH_TEST_BEGIN( "Bulk loading with lower-star filtration" );
+
+    filtrations::LowerStar<Simplex> filtration( weights.begin(), weights.end() );
+
+    SimplicialComplex K;
+    K.bulkLoad( simplices, std::ref( filtration ) );
+
+    checkOrder( K, simplices, std::ref( filtration ) );
+
+    ALEPH_TEST_END();
+  }
+}
+
+void testStability()
+{
+  ALEPH_TEST_BEGIN( "Parallel sort stability" );
+
+  std::mt19937 rng( 0 );
+  std::uniform_int_distribution<unsigned> distribution( 0, 100 );
+
+  std::vector< std::pair<unsigned, unsigned> > values;
+
+  for( unsigned i = 0; i < 100000; i++ )
+    values.push_back( std::make_pair( distribution( rng ), i ) );
+
+  auto expected = values;
+
+  auto comparison = [] ( const std::pair<unsigned, unsigned>& a, const std::pair<unsigned, unsigned>& b )
+  {
+    return a.first < b.first;
+  };
+
+  std::stable_sort( expected.begin(), expected.end(), comparison );
+  aleph::utilities::parallelSort( values.begin(), values.end(), comparison );
+
+  ALEPH_ASSERT_THROW( values == expected );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  std::vector<int> numThreads = { 1, 3, 4 };
+
+  for( auto&& n : numThreads )
+  {
+#ifdef _OPENMP
+    omp_set_num_threads( n );
+#else
+    (void) n;
+#endif
+
+    testStability();
+
+    test<double, unsigned>();
+    test<float,  short   >();
+  }
+}
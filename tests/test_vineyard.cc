@@ -0,0 +1,189 @@
+#include <tests/Base.hh>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/Vineyard.hh>
+
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+
+#include <aleph/topology/Conversions.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/representations/Vector.hh>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace aleph;
+using namespace containers;
+using namespace geometry;
+using namespace topology;
+using namespace distances;
+
+using namespace aleph::persistentHomology::algorithms;
+
+template <class T> auto makeComplex() -> typename RipsSkeleton< BruteForce< PointCloud<T>, Euclidean<T> > >::SimplicialComplex
+{
+  using PointCloud        = PointCloud<T>;
+  using Distance          = Euclidean<T>;
+  using Wrapper           = BruteForce<PointCloud, Distance>;
+  using RipsSkeleton      = RipsSkeleton<Wrapper>;
+  using SimplicialComplex = typename RipsSkeleton::SimplicialComplex;
+  using Simplex           = typename SimplicialComplex::ValueType;
+
+  std::mt19937 rng( 42 );
+  std::uniform_real_distribution<T> distribution( T(0), T(1) );
+
+  PointCloud pointCloud( 20, 2 );
+
+  for( unsigned i = 0; i < 20; i++ )
+    pointCloud.set( i, { distribution( rng ), distribution( rng ) } );
+
+  Wrapper wrapper( pointCloud );
+  RipsSkeleton ripsSkeleton;
+  RipsExpander<SimplicialComplex> ripsExpander;
+
+  auto K = ripsSkeleton( wrapper, T(0.4) );
+  K      = ripsExpander( K, 2 );
+  K      = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( filtrations::Data<Simplex>() );
+  return K;
+}
+
+template <class T> void testTranspositions()
+{
+  ALEPH_TEST_BEGIN( "Vineyard: transpositions" );
+
+  using Representation = representations::Vector<unsigned>;
+  using Vineyard       = Vineyard<Representation>;
+
+  auto K = makeComplex<T>();
+  auto M = makeBoundaryMatrix<Representation>( K );
+
+  Vineyard vineyard( M );
+
+  ALEPH_ASSERT_EQUAL( vineyard.size(), M.getNumColumns() );
+  ALEPH_ASSERT_THROW( vineyard.pairing() == calculatePersistencePairing<Standard>( M ) );
+  ALEPH_ASSERT_THROW( vineyard.pairing( true ) == calculatePersistencePairing<Standard>( M, true ) );
+
+  std::mt19937 rng( 23 );
+  std::uniform_int_distribution<unsigned> distribution( 0, vineyard.size() - 2 );
+
+  unsigned numTranspositions = 0;
+  unsigned numSwitches       = 0;
+  unsigned numInvalid        = 0;
+
+  for( unsigned n = 0; n < 1000; n++ )
+  {
+    auto i = distribution( rng );
+
+    try
+    {
+      auto switched = vineyard.transpose( i );
+
+      numTranspositions += 1;
+      numSwitches       += switched ? 1 : 0;
+    }
+    catch( std::runtime_error& )
+    {
+      // The simplex at position i is a face of the simplex at position
+      // i+1, so they must not be exchanged.
+      numInvalid += 1;
+      continue;
+    }
+
+    auto B = vineyard.boundaryMatrix();
+
+    ALEPH_ASSERT_THROW( vineyard.pairing()       == calculatePersistencePairing<Standard>( B ) );
+    ALEPH_ASSERT_THROW( vineyard.pairing( true ) == calculatePersistencePairing<Standard>( B, true ) );
+  }
+
+  ALEPH_ASSERT_THROW( numTranspositions > 0 );
+  ALEPH_ASSERT_THROW( numSwitches       > 0 );
+  ALEPH_ASSERT_THROW( numInvalid        > 0 );
+
+  ALEPH_EXPECT_EXCEPTION( vineyard.transpose( vineyard.size() - 1 ), std::out_of_range );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testUpdate()
+{
+  ALEPH_TEST_BEGIN( "Vineyard: update" );
+
+  using Representation = representations::Vector<unsigned>;
+  using Vineyard       = Vineyard<Representation>;
+
+  auto K = makeComplex<T>();
+  auto M = makeBoundaryMatrix<Representation>( K );
+
+  Vineyard vineyard( M );
+
+  // A filtration is valid as long as all faces of a simplex precede it,
+  // so every order that is sorted by dimension is valid.
+  std::vector<unsigned> order( vineyard.size() );
+  std::vector<unsigned> keys( vineyard.size() );
+
+  std::mt19937 rng( 42 );
+
+  for( unsigned j = 0; j < vineyard.size(); j++ )
+  {
+    order[j] = j;
+    keys[j]  = static_cast<unsigned>( rng() );
+  }
+
+  std::sort( order.begin(), order.end(), [&] ( unsigned a, unsigned b )
+  {
+    auto da = M.getDimension( a );
+    auto db = M.getDimension( b );
+
+    return da < db || ( da == db && keys[a] < keys[b] );
+  } );
+
+  unsigned numTranspositions = 0;
+
+  vineyard.update( order, [&numTranspositions, &vineyard] ( unsigned sigma, unsigned tau, bool /* switched */ )
+  {
+    // The simplices have been exchanged already
+    ALEPH_ASSERT_EQUAL( vineyard.position( tau ) + 1, vineyard.position( sigma ) );
+    numTranspositions += 1;
+  } );
+
+  ALEPH_ASSERT_THROW( numTranspositions > 0 );
+  ALEPH_ASSERT_THROW( vineyard.order() == order );
+  ALEPH_ASSERT_THROW( vineyard.pairing() == calculatePersistencePairing<Standard>( vineyard.boundaryMatrix() ) );
+
+  // Returning to the original order must not change the pairing in the
+  // end, regardless of all intermediate changes.
+
+  std::vector<unsigned> identity( vineyard.size() );
+  std::iota( identity.begin(), identity.end(), 0u );
+
+  vineyard.update( identity );
+
+  ALEPH_ASSERT_THROW( vineyard.order() == identity );
+  ALEPH_ASSERT_THROW( vineyard.pairing() == calculatePersistencePairing<Standard>( M ) );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testTranspositions<float> ();
+  testTranspositions<double>();
+
+  testUpdate<float> ();
+  testUpdate<double>();
+}
@@ -13,9 +13,19 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <map>
+#include <random>
 #include <set>
+#include <utility>
 #include <vector>
 
+#include <cmath>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 template <class SimplicialComplex> std::vector<std::size_t> bettiNumbers( SimplicialComplex K )
 {
   using Simplex  = typename SimplicialComplex::ValueType;
@@ -124,6 +134,211 @@ template <class T> void testSphereReconstruction()
   ALEPH_TEST_END();
 }
 
+/**
+  Calculates the edges of a witness complex by checking every pair of
+  landmarks against every witness, following the definition.
+*/
+
+template <class Distance, class PointCloud> std::map<std::pair<std::size_t, std::size_t>, typename Distance::ResultType> witnessEdges( const PointCloud& pc, const std::vector<std::size_t>& landmarks, unsigned nu, typename Distance::ResultType R )
+{
+  using DataType = typename Distance::ResultType;
+
+  Distance dist;
+  aleph::geometry::distances::Traits<Distance> traits;
+
+  auto n = landmarks.size();
+  auto N = pc.size();
+  auto d = pc.dimension();
+
+  std::vector< std::vector<DataType> > D( N, std::vector<DataType>( n ) );
+  std::vector<DataType> smallest( N );
+
+  for( std::size_t k = 0; k < N; k++ )
+  {
+    for( std::size_t i = 0; i < n; i++ )
+      D[k][i] = traits.from( dist( pc[ landmarks[i] ].begin(), pc[k].begin(), d ) );
+
+    auto row = D[k];
+    std::sort( row.begin(), row.end() );
+    smallest[k] = row.at( nu - 1 );
+  }
+
+  std::map<std::pair<std::size_t, std::size_t>, DataType> edges;
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    for( std::size_t j = i+1; j < n; j++ )
+    {
+      auto min = std::numeric_limits<DataType>::max();
+
+      for( std::size_t k = 0; k < N; k++ )
+      {
+        if( std::max( D[k][i], D[k][j] ) <= R + smallest[k] )
+          min = std::min( min, std::max( D[k][i], D[k][j] ) );
+      }
+
+      if( min != std::numeric_limits<DataType>::max() )
+        edges[ std::make_pair(j,i) ] = min;
+    }
+  }
+
+  return edges;
+}
+
+template <class T> void testEdgesAndDirectSimplices()
+{
+  ALEPH_TEST_BEGIN( "Witness complexes: edges and direct simplices" );
+
+  using Distance   = aleph::geometry::distances::Euclidean<T>;
+  using PointCloud = aleph::containers::PointCloud<T>;
+
+  std::mt19937 rng( 42 );
+  std::uniform_real_distribution<T> distribution( T(-1), T(1) );
+
+  PointCloud pc( 300, 3 );
+
+  for( std::size_t i = 0; i < pc.size(); i++ )
+    pc.set( i, { distribution( rng ), distribution( rng ), distribution( rng ) } );
+
+  std::vector<std::size_t> landmarks;
+  aleph::geometry::generateRandomLandmarks( pc.size(), decltype(pc.size())( 25 ), std::back_inserter( landmarks ) );
+
+  for( unsigned nu : { 1u, 2u, 3u } )
+  {
+    for( T R : { T(0), T(0.1) } )
+    {
+      auto expected = witnessEdges<Distance>( pc, landmarks, nu, R );
+      auto K        = aleph::geometry::buildWitnessComplex<Distance>( pc, landmarks.begin(), landmarks.end(), 2, nu, R );
+      auto L        = aleph::geometry::buildDirectWitnessComplex<Distance>( pc, landmarks.begin(), landmarks.end(), 3, nu, R );
+
+      for( auto&& M : { K, L } )
+      {
+        std::map<std::pair<std::size_t, std::size_t>, T> edges;
+
+        for( auto&& s : M )
+          if( s.dimension() == 1 )
+            edges[ std::make_pair( s[0], s[1] ) ] = s.data();
+
+        ALEPH_ASSERT_THROW( edges == expected );
+      }
+
+      // Every simplex of the direct complex is witnessed by a single
+      // witness, so its faces are witnessed as well, and by values that
+      // are not larger.
+      ALEPH_ASSERT_THROW( L.size() <= aleph::geometry::buildWitnessComplex<Distance>( pc, landmarks.begin(), landmarks.end(), 3, nu, R ).size() );
+
+      for( std::size_t i = 0; i < L.size(); i++ )
+      {
+        auto&& s = L.at(i);
+
+        ALEPH_ASSERT_THROW( s.dimension() <= 3 );
+
+        for( auto it = s.begin_boundary(); it != s.end_boundary(); ++it )
+        {
+          ALEPH_ASSERT_THROW( L.index( *it ) < i );
+          ALEPH_ASSERT_THROW( L.find( *it )->data() <= s.data() );
+        }
+      }
+    }
+  }
+
+  ALEPH_EXPECT_EXCEPTION( aleph::geometry::buildWitnessComplex<Distance>( pc, landmarks.begin(), landmarks.end(), 2, 26 ), std::out_of_range );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testGreedyPermutation()
+{
+  ALEPH_TEST_BEGIN( "Witness complexes: greedy permutation" );
+
+  using Distance   = aleph::geometry::distances::Euclidean<T>;
+  using PointCloud = aleph::containers::PointCloud<T>;
+
+  std::mt19937 rng( 23 );
+  std::uniform_real_distribution<T> distribution( T(-1), T(1) );
+
+  PointCloud pc( 200, 2 );
+
+  for( std::size_t i = 0; i < pc.size(); i++ )
+    pc.set( i, { distribution( rng ), distribution( rng ) } );
+
+  // Reference implementation that calculates the distances to all
+  // previous landmarks for every point
+  std::vector<std::size_t> expected = { 17 };
+
+  Distance dist;
+  aleph::geometry::distances::Traits<Distance> traits;
+
+  while( expected.size() < pc.size() )
+  {
+    std::size_t index = 0;
+    auto max          = std::numeric_limits<T>::lowest();
+
+    for( std::size_t i = 0; i < pc.size(); i++ )
+    {
+      auto min = std::numeric_limits<T>::max();
+
+      for( auto&& j : expected )
+        min = std::min( min, dist( pc[i].begin(), pc[j].begin(), pc.dimension() ) );
+
+      if( min > max )
+      {
+        max   = min;
+        index = i;
+      }
+    }
+
+    expected.push_back( index );
+  }
+
+  for( int numThreads : { 1, 3, 4 } )
+  {
+#ifdef _OPENMP
+    omp_set_num_threads( numThreads );
+#else
+    (void) numThreads;
+#endif
+
+    std::vector<std::size_t> landmarks;
+    std::vector<T> radii;
+
+    aleph::geometry::generateMaxMinLandmarks( pc, pc.size(), 17, std::back_inserter( landmarks ), std::back_inserter( radii ), Distance() );
+
+    ALEPH_ASSERT_THROW( landmarks == expected );
+    ALEPH_ASSERT_EQUAL( radii.size(), landmarks.size() );
+    ALEPH_ASSERT_EQUAL( radii.front(), std::numeric_limits<T>::max() );
+
+    // Insertion radii are the distances to the nearest previous landmark
+    // and can only decrease.
+    for( std::size_t k = 1; k < landmarks.size(); k++ )
+    {
+      auto min = std::numeric_limits<T>::max();
+
+      for( std::size_t j = 0; j < k; j++ )
+        min = std::min( min, traits.from( dist( pc[ landmarks[k] ].begin(), pc[ landmarks[j] ].begin(), pc.dimension() ) ) );
+
+      ALEPH_ASSERT_THROW( std::abs( radii[k] - min ) < T(1e-6) );
+      ALEPH_ASSERT_THROW( radii[k] <= radii[k-1] );
+    }
+
+    // A prefix of the permutation is obtained by selecting fewer landmarks
+    landmarks.clear();
+    radii.clear();
+
+    aleph::geometry::generateMaxMinLandmarks( pc, 10, 17, std::back_inserter( landmarks ), std::back_inserter( radii ), Distance() );
+
+    ALEPH_ASSERT_THROW( std::equal( landmarks.begin(), landmarks.end(), expected.begin() ) );
+  }
+
+  std::vector<std::size_t> landmarks;
+  std::vector<T> radii;
+
+  ALEPH_EXPECT_EXCEPTION( aleph::geometry::generateMaxMinLandmarks( pc, pc.size() + 1, 0, std::back_inserter( landmarks ), std::back_inserter( radii ), Distance() ), std::out_of_range );
+  ALEPH_EXPECT_EXCEPTION( aleph::geometry::generateMaxMinLandmarks( pc, 1, pc.size(), std::back_inserter( landmarks ), std::back_inserter( radii ), Distance() ), std::out_of_range );
+
+  ALEPH_TEST_END();
+}
+
 int main(int, char**)
 {
   test<float> ();
@@ -131,4 +346,10 @@ int main(int, char**)
 
   testSphereReconstruction<float> ();
   testSphereReconstruction<double>();
+
+  testEdgesAndDirectSimplices<float> ();
+  testEdgesAndDirectSimplices<double>();
+
+  testGreedyPermutation<float> ();
+  testGreedyPermutation<double>();
 }